@@ -179,3 +179,22 @@ CHECK_CXX_SOURCE_COMPILES("
     " HAVE_MMAP
 )
 GR_ADD_COND_DEF(HAVE_MMAP)
+
+CHECK_CXX_SOURCE_COMPILES("
+    #include <unistd.h>
+    int main(){pread(0, 0, 0, 0); return 0;}
+    " HAVE_PREAD
+)
+GR_ADD_COND_DEF(HAVE_PREAD)
+
+########################################################################
+CHECK_CXX_SOURCE_COMPILES("
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+    int main(){
+        return __NR_io_uring_setup + __NR_io_uring_enter + __NR_io_uring_register +
+               IORING_OP_READ + IORING_REGISTER_PROBE + IORING_FEAT_NODROP;
+    }
+    " HAVE_IO_URING
+)
+GR_ADD_COND_DEF(HAVE_IO_URING)
@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+#
+# Copyright 2020 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along
+# with this program; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+
+"""
+Measure how long a lock()/unlock() reconfiguration takes as the
+flowgraph grows, and how much an untouched branch keeps processing
+while it happens.
+
+The graph is one source feeding NBRANCHES chains of NSTAGES blocks.
+Each trial swaps the sink at the end of the first chain.
+"""
+
+from __future__ import print_function
+from __future__ import division
+from __future__ import unicode_literals
+from gnuradio import gr, blocks
+from gnuradio.eng_arg import intx
+from argparse import ArgumentParser
+import time
+
+
+class fanout(gr.top_block):
+    def __init__(self, nbranches, nstages):
+        gr.top_block.__init__(self)
+
+        src = blocks.null_source(gr.sizeof_float)
+        self.tails = []
+        for b in range(nbranches):
+            upstream = src
+            for s in range(nstages):
+                op = blocks.multiply_const_ff(1.0)
+                self.connect(upstream, op)
+                upstream = op
+            self.tails.append(upstream)
+
+        self.sink = blocks.null_sink(gr.sizeof_float)
+        self.connect(self.tails[0], self.sink)
+        for t in self.tails[1:]:
+            self.connect(t, blocks.null_sink(gr.sizeof_float))
+
+    def swap_sink(self):
+        sink = blocks.null_sink(gr.sizeof_float)
+        self.lock()
+        self.disconnect(self.tails[0], self.sink)
+        self.connect(self.tails[0], sink)
+        self.unlock()
+        self.sink = sink
+
+
+def main():
+    parser = ArgumentParser()
+    parser.add_argument("-b", "--branches", type=intx, nargs="+",
+                        default=[1, 2, 5, 10, 20, 40],
+                        help="branch counts to measure (default=%(default)s)")
+    parser.add_argument("-s", "--nstages", type=intx, default=4,
+                        help="blocks per branch (default=%(default)s)")
+    parser.add_argument("-t", "--trials", type=intx, default=20,
+                        help="reconfigurations per graph (default=%(default)s)")
+    args = parser.parse_args()
+
+    print("%8s %8s %12s %12s %16s" % ("branches", "blocks", "median [ms]",
+                                     "max [ms]", "untouched items"))
+    for nbranches in args.branches:
+        tb = fanout(nbranches, args.nstages)
+        probe = tb.tails[-1]
+        tb.start()
+        time.sleep(0.2)
+
+        latencies = []
+        untouched = 0
+        for i in range(args.trials):
+            before = probe.nitems_written(0)
+            t0 = time.time()
+            tb.swap_sink()
+            latencies.append(time.time() - t0)
+            untouched += probe.nitems_written(0) - before
+
+        tb.stop()
+        tb.wait()
+
+        latencies.sort()
+        print("%8d %8d %12.3f %12.3f %16d" % (
+            nbranches, nbranches * (args.nstages + 1) + 1,
+            1e3 * latencies[len(latencies) // 2], 1e3 * latencies[-1],
+            untouched // args.trials))
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -103,6 +103,13 @@ public:
 
     void reset_nitem_counter() { d_abs_write_offset = 0; }
 
+    /*!
+     * \brief Start counting written items, and the items read by every
+     * reader, at \p nitems. Only meant for a buffer nothing has been
+     * written to yet.
+     */
+    void set_nitem_counter(uint64_t nitems);
+
     size_t get_sizeof_item() { return d_sizeof_item; }
 
     /*!
@@ -160,6 +160,10 @@ public:
      * equal number of calls to lock() and unlock() have occurred, the
      * flowgraph will be reconfigured.
      *
+     * The flowgraph is not stopped; it keeps running with its old
+     * connections until the final unlock(), and is then paused only
+     * where its connections change. See gr::top_block::unlock().
+     *
      * N.B. lock() and unlock() may not be called from a flowgraph
      * thread (E.g., gr::block::work method) or deadlock will occur
      * when reconfiguration happens.
@@ -0,0 +1,143 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_RUNTIME_IO_ENGINE_H
+#define INCLUDED_GR_RUNTIME_IO_ENGINE_H
+
+#include <gnuradio/api.h>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace gr {
+
+/*!
+ * \brief Asynchronous read/write submission for blocks doing bulk I/O.
+ * \ingroup misc
+ *
+ * \details
+ * Blocks that stream to or from files and sockets queue requests on
+ * an io_engine and collect the results later, so the work() thread
+ * never sleeps in a system call while the device is busy.
+ *
+ * On Linux builds with io_uring support the requests are handed to
+ * the kernel in batches, one system call per submit(), and buffers
+ * given to register_buffers() are pinned once instead of on every
+ * request. Everywhere else, or when the kernel refuses to set up a
+ * ring, a worker thread runs the requests one after another with
+ * pread/pwrite.
+ *
+ * Requests on pipes, sockets and ttys use CURRENT_POSITION as the
+ * offset. Requests run in any order unless they are linked: a request
+ * with link set holds back the next one of the same submit() until it
+ * is done. Through io_uring, a linked request that fails or transfers
+ * less than len cancels the rest of its chain with -ECANCELED.
+ *
+ * A request and its buffer belong to the engine from submit() until
+ * wait() or poll() has reported it done. All requests must be
+ * complete before the engine is destroyed.
+ */
+class GR_RUNTIME_API io_engine : boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<io_engine> sptr;
+
+    enum op_type {
+        OP_READ = 0, //!< read len bytes at offset
+        OP_WRITE     //!< write len bytes at offset
+    };
+
+    //! Offset for the descriptor's own position, as read() and write() use
+    static const uint64_t CURRENT_POSITION = ~(uint64_t)0;
+
+    struct request {
+        op_type op;
+        int fd;
+        void* buf;
+        size_t len;
+        uint64_t offset; //!< file offset, or CURRENT_POSITION
+        int buf_index;   //!< index into register_buffers(), or -1
+        bool link;       //!< start the next request only after this one
+
+        // Filled in on completion
+        int64_t result; //!< bytes transferred, or -errno
+        bool done;
+
+        request()
+            : op(OP_READ),
+              fd(-1),
+              buf(0),
+              len(0),
+              offset(0),
+              buf_index(-1),
+              link(false),
+              result(0),
+              done(false)
+        {
+        }
+    };
+
+    /*!
+     * \brief Make an engine that can hold \p queue_depth requests in flight.
+     *
+     * \param queue_depth requests handed to the kernel at once; more
+     *                    can be submitted, they are queued.
+     * \param allow_io_uring use io_uring if it is available; false
+     *                    always selects the worker thread.
+     */
+    static sptr make(unsigned int queue_depth = 64, bool allow_io_uring = true);
+
+    virtual ~io_engine();
+
+    /*!
+     * \brief Queue \p nreqs requests.
+     *
+     * Each request is reset to not done before it is queued.
+     */
+    virtual void submit(request* const* reqs, size_t nreqs) = 0;
+
+    //! Block until \p req is done.
+    virtual void wait(request* req) = 0;
+
+    //! Collect finished requests and return whether \p req is done.
+    virtual bool poll(request* req) = 0;
+
+    /*!
+     * \brief Pin \p bufs, each \p len bytes long, for the lifetime
+     * of the engine.
+     *
+     * Requests whose buf lies in bufs[i] can then set buf_index to i.
+     * Returns false if buffers cannot be registered here; buf_index
+     * is ignored in that case and requests still work. Must not be
+     * called with requests in flight.
+     */
+    virtual bool register_buffers(const std::vector<void*>& bufs, size_t len) = 0;
+
+    //! True if requests go through io_uring.
+    virtual bool uses_io_uring() const = 0;
+};
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_RUNTIME_IO_ENGINE_H */
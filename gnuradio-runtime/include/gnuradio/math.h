@@ -71,6 +71,23 @@ GR_RUNTIME_API float fast_atan2f(float y, float x);
 
 static inline float fast_atan2f(gr_complex z) { return fast_atan2f(z.imag(), z.real()); }
 
+/*!
+ * \brief Fast arc tangent of a vector of complex values
+ * \ingroup misc
+ *
+ * \param z input vectors
+ * \param angle output angles in radians, scaled by \p scale
+ * \param n number of values
+ * \param scale factor applied to every angle
+ *
+ * Computes scale * fast_atan2f(z[i]) for \p n values. A polynomial
+ * replaces the table so the loop can use SIMD instructions; the
+ * maximum error is below that of the table, about 5e-7 radians. Zero,
+ * infinite and NaN inputs give the same results as fast_atan2f().
+ */
+GR_RUNTIME_API void
+fast_atan2f(const gr_complex* z, float* angle, unsigned int n, float scale = 1.0f);
+
 /* This bounds x by +/- clip without a branch */
 static inline float branchless_clip(float x, float clip)
 {
@@ -97,6 +97,9 @@ public:
      * equal number of calls to lock() and unlock() have occurred, the
      * flowgraph will be reconfigured.
      *
+     * lock() does not stop the flowgraph; it keeps running with its old
+     * connections until the final unlock().
+     *
      * N.B. lock() and unlock() may not be called from a flowgraph
      * thread (E.g., block::work method) or deadlock will occur
      * when reconfiguration happens.
@@ -108,6 +111,10 @@ public:
      * equal number of calls to lock() and unlock() have occurred, the
      * flowgraph will be reconfigured.
      *
+     * Reconfiguration only pauses the blocks that are removed or whose
+     * stream or message connections change. The other blocks keep
+     * running, and keep their buffers, item counts and tags.
+     *
      * N.B. lock() and unlock() may not be called from a flowgraph thread
      * (E.g., block::work method) or deadlock will occur when
      * reconfiguration happens.
@@ -197,6 +197,14 @@ void buffer::update_write_pointer(int nitems)
     d_abs_write_offset += nitems;
 }
 
+void buffer::set_nitem_counter(uint64_t nitems)
+{
+    gr::thread::scoped_lock guard(*mutex());
+    d_abs_write_offset = nitems;
+    for (size_t i = 0; i < d_readers.size(); i++)
+        d_readers[i]->d_abs_read_offset = nitems;
+}
+
 void buffer::set_done(bool done)
 {
     gr::thread::scoped_lock guard(*mutex());
@@ -211,6 +219,9 @@ buffer_add_reader(buffer_sptr buf, int nzero_preload, block_sptr link, int delay
 
     buffer_reader_sptr r(
         new buffer_reader(buf, buf->index_sub(buf->d_write_index, nzero_preload), link));
+    // A reader added to a buffer that is already in use starts counting
+    // where the writer is, so tag offsets line up.
+    r->d_abs_read_offset = buf->d_abs_write_offset;
     r->declare_sample_delay(delay);
     buf->d_readers.push_back(r.get());
 
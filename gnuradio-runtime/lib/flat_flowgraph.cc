@@ -33,6 +33,7 @@
 #include <boost/format.hpp>
 #include <iostream>
 #include <map>
+#include <set>
 
 namespace gr {
 
@@ -225,6 +226,10 @@ void flat_flowgraph::connect_block_inputs(basic_block_sptr block)
 
 void flat_flowgraph::merge_connections(flat_flowgraph_sptr old_ffg)
 {
+    // The blocks returned by calc_changed_blocks() must not be running
+    // while this is called; other blocks may keep running, nothing they
+    // use is touched.
+
     // Allocate block details if needed.  Only new blocks that aren't pruned out
     // by flattening will need one; existing blocks still in the new flowgraph will
     // already have one.
@@ -313,28 +318,87 @@ void flat_flowgraph::merge_connections(flat_flowgraph_sptr old_ffg)
             // Make sure all buffers are aligned
             setup_buffer_alignment(block);
         }
+    }
 
-        // Connect message ports connetions
-        for (msg_edge_viter_t i = d_msg_edges.begin(); i != d_msg_edges.end(); i++) {
-            GR_LOG_DEBUG(
-                d_debug_logger,
-                boost::format("flat_fg connecting msg primitives: (%s, %s)->(%s, %s)\n") %
-                    i->src().block() % i->src().port() % i->dst().block() %
-                    i->dst().port());
-            i->src().block()->message_port_sub(
-                i->src().port(),
-                pmt::cons(i->dst().block()->alias_pmt(), i->dst().port()));
-        }
+    // The rest of the graph keeps its item counts across a
+    // reconfiguration, so start the outputs of new blocks in step with
+    // their inputs; tags propagated through them then land on the right
+    // items. Going sources first, a new block fed by another new block
+    // sees the counts of that block's outputs, which set_nitem_counter()
+    // moves together with the readers attached above.
+    basic_block_vector_t sorted = topological_sort(d_blocks);
+    for (basic_block_viter_t p = sorted.begin(); p != sorted.end(); p++) {
+        if (old_ffg->has_block_p(*p))
+            continue;
 
-        // Now deal with the fact that the block details might have
-        // changed numbers of inputs and outputs vs. in the old
-        // flowgraph.
+        block_sptr block = cast_to_block_sptr(*p);
+        block_detail_sptr detail = block->detail();
+        uint64_t nitems = 0;
+        if (detail->ninputs() > 0)
+            nitems =
+                static_cast<uint64_t>(detail->nitems_read(0) * block->relative_rate());
+        for (int i = 0; i < detail->noutputs(); i++)
+            detail->output(i)->set_nitem_counter(nitems);
+    }
 
-        block->detail()->reset_nitem_counters();
-        block->detail()->clear_tags();
+    // Connect message ports connetions
+    for (msg_edge_viter_t i = d_msg_edges.begin(); i != d_msg_edges.end(); i++) {
+        GR_LOG_DEBUG(
+            d_debug_logger,
+            boost::format("flat_fg connecting msg primitives: (%s, %s)->(%s, %s)\n") %
+                i->src().block() % i->src().port() % i->dst().block() % i->dst().port());
+        i->src().block()->message_port_sub(
+            i->src().port(), pmt::cons(i->dst().block()->alias_pmt(), i->dst().port()));
     }
 }
 
+template <class E>
+static bool has_edge(const std::vector<E>& edges, const E& e)
+{
+    for (size_t i = 0; i < edges.size(); i++)
+        if (edges[i].src() == e.src() && edges[i].dst() == e.dst())
+            return true;
+    return false;
+}
+
+basic_block_vector_t flat_flowgraph::calc_changed_blocks(flat_flowgraph_sptr old_ffg)
+{
+    std::set<basic_block_sptr> changed;
+
+    // Blocks that are going away
+    for (basic_block_viter_t p = old_ffg->d_blocks.begin(); p != old_ffg->d_blocks.end();
+         p++)
+        if (!has_block_p(*p))
+            changed.insert(*p);
+
+    // Both ends of an edge that was added or removed; their buffer
+    // readers and message subscribers are about to change.
+    for (edge_viter_t e = old_ffg->d_edges.begin(); e != old_ffg->d_edges.end(); e++)
+        if (!has_edge(d_edges, *e)) {
+            changed.insert(e->src().block());
+            changed.insert(e->dst().block());
+        }
+    for (edge_viter_t e = d_edges.begin(); e != d_edges.end(); e++)
+        if (!has_edge(old_ffg->d_edges, *e)) {
+            changed.insert(e->src().block());
+            changed.insert(e->dst().block());
+        }
+    for (msg_edge_viter_t e = old_ffg->d_msg_edges.begin();
+         e != old_ffg->d_msg_edges.end();
+         e++)
+        if (!has_edge(d_msg_edges, *e)) {
+            changed.insert(e->src().block());
+            changed.insert(e->dst().block());
+        }
+    for (msg_edge_viter_t e = d_msg_edges.begin(); e != d_msg_edges.end(); e++)
+        if (!has_edge(old_ffg->d_msg_edges, *e)) {
+            changed.insert(e->src().block());
+            changed.insert(e->dst().block());
+        }
+
+    return basic_block_vector_t(changed.begin(), changed.end());
+}
+
 void flat_flowgraph::setup_buffer_alignment(block_sptr block)
 {
     const int alignment = volk_get_alignment();
@@ -53,6 +53,10 @@ public:
     // Merge applicable connections from existing flat flowgraph
     void merge_connections(flat_flowgraph_sptr sfg);
 
+    // Blocks whose connections differ between sfg and this flowgraph,
+    // including the blocks only present in sfg
+    basic_block_vector_t calc_changed_blocks(flat_flowgraph_sptr sfg);
+
     // Return a string list of edges
     std::string edge_list();
 
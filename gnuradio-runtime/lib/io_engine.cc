@@ -0,0 +1,507 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_engine.h>
+#include <gnuradio/thread/thread.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <string>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_IO_H
+#include <io.h>
+#endif
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace gr {
+
+const uint64_t io_engine::CURRENT_POSITION;
+
+io_engine::~io_engine() {}
+
+namespace {
+
+/*
+ * Fallback: one thread running the requests in submission order, so
+ * links need no extra work.
+ */
+class io_engine_thread : public io_engine
+{
+private:
+    std::deque<request*> d_queue;
+    bool d_done;
+    gr::thread::mutex d_mutex;
+    gr::thread::condition_variable d_cond;
+    gr::thread::thread d_thread;
+
+    static int64_t execute(const request& req)
+    {
+        ssize_t r;
+        do {
+            if (req.offset == CURRENT_POSITION) {
+                r = req.op == OP_READ ? ::read(req.fd, req.buf, req.len)
+                                      : ::write(req.fd, req.buf, req.len);
+                continue;
+            }
+            switch (req.op) {
+            case OP_READ:
+#ifdef HAVE_PREAD
+                r = pread(req.fd, req.buf, req.len, req.offset);
+#else
+                r = lseek(req.fd, req.offset, SEEK_SET) < 0
+                        ? -1
+                        : ::read(req.fd, req.buf, req.len);
+#endif
+                break;
+            case OP_WRITE:
+#ifdef HAVE_PREAD
+                r = pwrite(req.fd, req.buf, req.len, req.offset);
+#else
+                r = lseek(req.fd, req.offset, SEEK_SET) < 0
+                        ? -1
+                        : ::write(req.fd, req.buf, req.len);
+#endif
+                break;
+            default:
+                errno = EINVAL;
+                r = -1;
+            }
+        } while (r < 0 && errno == EINTR);
+
+        return r < 0 ? -errno : r;
+    }
+
+    void run()
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        while (true) {
+            while (d_queue.empty() && !d_done)
+                d_cond.wait(lock);
+            if (d_queue.empty())
+                return;
+
+            request* req = d_queue.front();
+            d_queue.pop_front();
+
+            lock.unlock();
+            int64_t r = execute(*req);
+            lock.lock();
+
+            req->result = r;
+            req->done = true;
+            d_cond.notify_all();
+        }
+    }
+
+public:
+    io_engine_thread() : d_done(false)
+    {
+        d_thread = gr::thread::thread(&io_engine_thread::run, this);
+    }
+
+    ~io_engine_thread()
+    {
+        {
+            gr::thread::scoped_lock lock(d_mutex);
+            d_done = true;
+            d_cond.notify_all();
+        }
+        d_thread.join();
+    }
+
+    void submit(request* const* reqs, size_t nreqs)
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        for (size_t i = 0; i < nreqs; i++) {
+            reqs[i]->done = false;
+            d_queue.push_back(reqs[i]);
+        }
+        d_cond.notify_all();
+    }
+
+    void wait(request* req)
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        while (!req->done)
+            d_cond.wait(lock);
+    }
+
+    bool poll(request* req)
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        return req->done;
+    }
+
+    bool register_buffers(const std::vector<void*>&, size_t) { return false; }
+
+    bool uses_io_uring() const { return false; }
+};
+
+#ifdef HAVE_IO_URING
+/*
+ * io_uring through the raw system calls, so there is no dependency
+ * on liburing. Submitters share the submission queue under
+ * d_sq_mutex; whoever waits reaps every completion it finds under
+ * d_cq_mutex, so a completion is never lost to another waiter.
+ */
+class io_engine_uring : public io_engine
+{
+private:
+    int d_fd;
+    void* d_sq_ring;
+    size_t d_sq_ring_size;
+    void* d_cq_ring;
+    size_t d_cq_ring_size;
+    io_uring_sqe* d_sqes;
+    size_t d_sqes_size;
+
+    unsigned* d_sq_head;
+    unsigned* d_sq_tail;
+    unsigned d_sq_mask;
+    unsigned d_sq_entries;
+    unsigned* d_sq_array;
+
+    unsigned* d_cq_head;
+    unsigned* d_cq_tail;
+    unsigned d_cq_mask;
+    io_uring_cqe* d_cqes;
+
+    std::vector<char*> d_fixed; // registered buffers
+    size_t d_fixed_len;
+
+    gr::thread::mutex d_sq_mutex;
+    gr::thread::mutex d_cq_mutex;
+
+    static int sys_setup(unsigned entries, io_uring_params* p)
+    {
+        return syscall(__NR_io_uring_setup, entries, p);
+    }
+
+    int sys_enter(unsigned to_submit, unsigned min_complete, unsigned flags)
+    {
+        return syscall(
+            __NR_io_uring_enter, d_fd, to_submit, min_complete, flags, NULL, 0);
+    }
+
+    int sys_register(unsigned opcode, const void* arg, unsigned nr_args)
+    {
+        return syscall(__NR_io_uring_register, d_fd, opcode, arg, nr_args);
+    }
+
+    // Whether the kernel implements every opcode prep() uses
+    bool probe_ops()
+    {
+        const unsigned nops = 256;
+        std::vector<char> mem(sizeof(io_uring_probe) + nops * sizeof(io_uring_probe_op));
+        io_uring_probe* probe = (io_uring_probe*)&mem[0];
+        if (sys_register(IORING_REGISTER_PROBE, probe, nops) < 0)
+            return false; // before 5.6, which also lacks IORING_OP_READ/WRITE
+
+        const unsigned ops[] = {
+            IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED
+        };
+        for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+            if (ops[i] > probe->last_op ||
+                !(probe->ops[ops[i]].flags & IO_URING_OP_SUPPORTED))
+                return false;
+        }
+        return true;
+    }
+
+    void unmap()
+    {
+        if (d_sqes)
+            munmap(d_sqes, d_sqes_size);
+        if (d_cq_ring && d_cq_ring != d_sq_ring)
+            munmap(d_cq_ring, d_cq_ring_size);
+        if (d_sq_ring)
+            munmap(d_sq_ring, d_sq_ring_size);
+        ::close(d_fd);
+    }
+
+    bool is_fixed(const request& req) const
+    {
+        return req.buf_index >= 0 && (size_t)req.buf_index < d_fixed.size() &&
+               (char*)req.buf >= d_fixed[req.buf_index] &&
+               (char*)req.buf + req.len <= d_fixed[req.buf_index] + d_fixed_len;
+    }
+
+    void prep(io_uring_sqe* sqe, request* req)
+    {
+        memset(sqe, 0, sizeof(*sqe));
+        bool fixed = is_fixed(*req);
+        switch (req->op) {
+        case OP_READ:
+            sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            break;
+        case OP_WRITE:
+            sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            break;
+        }
+        sqe->fd = req->fd;
+        sqe->addr = (uint64_t)(uintptr_t)req->buf;
+        sqe->len = req->len;
+        sqe->off = req->offset; // -1 for CURRENT_POSITION
+        if (fixed)
+            sqe->buf_index = req->buf_index;
+        if (req->link)
+            sqe->flags |= IOSQE_IO_LINK;
+        sqe->user_data = (uint64_t)(uintptr_t)req;
+    }
+
+    // Called with d_sq_mutex held
+    void enter_submit(unsigned n)
+    {
+        while (n > 0) {
+            int r = sys_enter(n, 0, 0);
+            if (r < 0) {
+                if (errno == EBUSY) {
+                    // Completions backed up; make room ourselves in case
+                    // nobody else is waiting.
+                    gr::thread::scoped_lock lock(d_cq_mutex);
+                    reap();
+                    continue;
+                }
+                if (errno == EINTR || errno == EAGAIN) {
+                    gr::thread::thread::yield();
+                    continue;
+                }
+                throw std::runtime_error(std::string("io_engine: io_uring_enter: ") +
+                                         strerror(errno));
+            }
+            n -= r;
+        }
+    }
+
+    // Called with d_cq_mutex held
+    void reap()
+    {
+        unsigned head = *d_cq_head;
+        unsigned tail = __atomic_load_n(d_cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = d_cqes[head & d_cq_mask];
+            request* req = (request*)(uintptr_t)cqe.user_data;
+            req->result = cqe.res;
+            req->done = true;
+            head++;
+        }
+        __atomic_store_n(d_cq_head, head, __ATOMIC_RELEASE);
+    }
+
+public:
+    io_engine_uring(unsigned int queue_depth)
+        : d_fd(-1),
+          d_sq_ring(0),
+          d_sq_ring_size(0),
+          d_cq_ring(0),
+          d_cq_ring_size(0),
+          d_sqes(0),
+          d_sqes_size(0),
+          d_fixed_len(0)
+    {
+        io_uring_params p;
+        memset(&p, 0, sizeof(p));
+        d_fd = sys_setup(queue_depth, &p);
+        if (d_fd < 0)
+            throw std::runtime_error(std::string("io_engine: io_uring_setup: ") +
+                                     strerror(errno));
+
+        // Without NODROP an overflowing completion queue loses results;
+        // a kernel that has it may still lack the opcodes we submit.
+        if (!(p.features & IORING_FEAT_NODROP) || !probe_ops()) {
+            ::close(d_fd);
+            throw std::runtime_error("io_engine: io_uring too old");
+        }
+
+        d_sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        d_cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        if (p.features & IORING_FEAT_SINGLE_MMAP)
+            d_sq_ring_size = d_cq_ring_size =
+                std::max(d_sq_ring_size, d_cq_ring_size);
+        d_sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+
+        d_sq_ring = mmap(0,
+                         d_sq_ring_size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE,
+                         d_fd,
+                         IORING_OFF_SQ_RING);
+        if (d_sq_ring == MAP_FAILED) {
+            d_sq_ring = 0;
+            unmap();
+            throw std::runtime_error("io_engine: cannot map submission queue");
+        }
+
+        if (p.features & IORING_FEAT_SINGLE_MMAP) {
+            d_cq_ring = d_sq_ring;
+        } else {
+            d_cq_ring = mmap(0,
+                             d_cq_ring_size,
+                             PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             d_fd,
+                             IORING_OFF_CQ_RING);
+            if (d_cq_ring == MAP_FAILED) {
+                d_cq_ring = 0;
+                unmap();
+                throw std::runtime_error("io_engine: cannot map completion queue");
+            }
+        }
+
+        void* sqes = mmap(0,
+                          d_sqes_size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE,
+                          d_fd,
+                          IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            unmap();
+            throw std::runtime_error("io_engine: cannot map submission entries");
+        }
+        d_sqes = (io_uring_sqe*)sqes;
+
+        char* sq = (char*)d_sq_ring;
+        d_sq_head = (unsigned*)(sq + p.sq_off.head);
+        d_sq_tail = (unsigned*)(sq + p.sq_off.tail);
+        d_sq_mask = *(unsigned*)(sq + p.sq_off.ring_mask);
+        d_sq_entries = p.sq_entries;
+        d_sq_array = (unsigned*)(sq + p.sq_off.array);
+
+        char* cq = (char*)d_cq_ring;
+        d_cq_head = (unsigned*)(cq + p.cq_off.head);
+        d_cq_tail = (unsigned*)(cq + p.cq_off.tail);
+        d_cq_mask = *(unsigned*)(cq + p.cq_off.ring_mask);
+        d_cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+    }
+
+    ~io_engine_uring() { unmap(); }
+
+    void submit(request* const* reqs, size_t nreqs)
+    {
+        gr::thread::scoped_lock lock(d_sq_mutex);
+
+        // Everything is submitted before returning, so the queue is
+        // empty on entry; a batch larger than the queue goes in chunks,
+        // which also ends any chain of linked requests.
+        unsigned tail = *d_sq_tail;
+        unsigned queued = 0;
+        for (size_t i = 0; i < nreqs; i++) {
+            if (queued == d_sq_entries) {
+                enter_submit(queued);
+                queued = 0;
+            }
+
+            reqs[i]->done = false;
+            unsigned idx = tail & d_sq_mask;
+            prep(&d_sqes[idx], reqs[i]);
+            d_sq_array[idx] = idx;
+            tail++;
+            queued++;
+            __atomic_store_n(d_sq_tail, tail, __ATOMIC_RELEASE);
+        }
+        enter_submit(queued);
+    }
+
+    void wait(request* req)
+    {
+        gr::thread::scoped_lock lock(d_cq_mutex);
+        reap();
+        while (!req->done) {
+            if (sys_enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                throw std::runtime_error(std::string("io_engine: io_uring_enter: ") +
+                                         strerror(errno));
+            reap();
+        }
+    }
+
+    bool poll(request* req)
+    {
+        gr::thread::scoped_lock lock(d_cq_mutex);
+        reap();
+        return req->done;
+    }
+
+    bool register_buffers(const std::vector<void*>& bufs, size_t len)
+    {
+        gr::thread::scoped_lock lock(d_sq_mutex);
+
+        if (!d_fixed.empty()) {
+            sys_register(IORING_UNREGISTER_BUFFERS, NULL, 0);
+            d_fixed.clear();
+        }
+
+        std::vector<iovec> iov(bufs.size());
+        for (size_t i = 0; i < bufs.size(); i++) {
+            iov[i].iov_base = bufs[i];
+            iov[i].iov_len = len;
+        }
+        // Fails with ENOMEM when over RLIMIT_MEMLOCK
+        if (iov.empty() ||
+            sys_register(IORING_REGISTER_BUFFERS, &iov[0], iov.size()) < 0)
+            return false;
+
+        for (size_t i = 0; i < bufs.size(); i++)
+            d_fixed.push_back((char*)bufs[i]);
+        d_fixed_len = len;
+        return true;
+    }
+
+    bool uses_io_uring() const { return true; }
+};
+#endif /* HAVE_IO_URING */
+
+} /* anonymous namespace */
+
+io_engine::sptr io_engine::make(unsigned int queue_depth, bool allow_io_uring)
+{
+    if (queue_depth == 0)
+        throw std::invalid_argument("io_engine: queue_depth must be > 0");
+
+#ifdef HAVE_IO_URING
+    if (allow_io_uring) {
+        try {
+            return sptr(new io_engine_uring(queue_depth));
+        } catch (std::runtime_error&) {
+            // Not permitted (seccomp, containers) or too old a kernel
+        }
+    }
+#endif
+
+    return sptr(new io_engine_thread());
+}
+
+} /* namespace gr */
@@ -0,0 +1,175 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/bulk_random.h>
+#include <gnuradio/math.h>
+#include <gnuradio/xoroshiro128p.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cstring>
+
+namespace gr {
+
+namespace {
+const float TWO_POW_M24 = 1.0f / 16777216.0f;
+const float LN_2 = 0.69314718056f;
+
+inline int round_up(int n, int multiple)
+{
+    return (n + multiple - 1) / multiple * multiple;
+}
+} // namespace
+
+bulk_random::bulk_random(uint64_t seed)
+{
+    size_t alignment = volk_get_alignment();
+    d_radius = (float*)volk_malloc(BLOCK * sizeof(float), alignment);
+    d_angle = (float*)volk_malloc(BLOCK * sizeof(float), alignment);
+    d_re = (float*)volk_malloc(BLOCK * sizeof(float), alignment);
+    d_im = (float*)volk_malloc(BLOCK * sizeof(float), alignment);
+    reseed(seed);
+}
+
+bulk_random::~bulk_random()
+{
+    volk_free(d_radius);
+    volk_free(d_angle);
+    volk_free(d_re);
+    volk_free(d_im);
+}
+
+void bulk_random::reseed(uint64_t seed)
+{
+    // Jump first so no stream repeats a plain xoroshiro128p_seed()
+    // sequence another user of the same seed may be drawing from.
+    uint64_t state[2];
+    xoroshiro128p_seed(state, seed);
+    for (int l = 0; l < NSTREAMS; l++) {
+        xoroshiro128p_jump(state);
+        d_s0[l] = state[0];
+        d_s1[l] = state[1];
+    }
+}
+
+/*
+ * Writes n values offset + scale * k with k uniform in [0, 2^24);
+ * n must be a multiple of 2 * NSTREAMS. Each stream step yields bits
+ * 40..63 and 16..39 of its output; the low bits of xoroshiro128+
+ * are the weak ones.
+ */
+void bulk_random::uniform(float* out, int n, float scale, float offset)
+{
+    uint64_t s0[NSTREAMS], s1[NSTREAMS];
+    memcpy(s0, d_s0, sizeof(s0));
+    memcpy(s1, d_s1, sizeof(s1));
+
+    for (int i = 0; i < n; i += 2 * NSTREAMS) {
+        for (int l = 0; l < NSTREAMS; l++) {
+            const uint64_t a = s0[l];
+            uint64_t b = s1[l];
+            const uint64_t r = a + b;
+
+            b ^= a;
+            s0[l] = ((a << 55) | (a >> 9)) ^ b ^ (b << 14);
+            s1[l] = (b << 36) | (b >> 28);
+
+            out[i + l] = offset + scale * (float)(int32_t)(r >> 40);
+            out[i + NSTREAMS + l] =
+                offset + scale * (float)(int32_t)((r >> 16) & 0xFFFFFF);
+        }
+    }
+
+    memcpy(d_s0, s0, sizeof(s0));
+    memcpy(d_s1, s1, sizeof(s1));
+}
+
+void bulk_random::fill_uniform(float* out, int n, float low, float high)
+{
+    const float scale = (high - low) * TWO_POW_M24;
+    const int nfull = n - n % (2 * NSTREAMS);
+
+    uniform(out, nfull, scale, low);
+    if (nfull < n) {
+        uniform(d_re, 2 * NSTREAMS, scale, low);
+        memcpy(out + nfull, d_re, (n - nfull) * sizeof(float));
+    }
+}
+
+/*
+ * Fills d_re and d_im with m Gaussian values each:
+ * radius sqrt(-2 ln u1) with u1 in (0, 1], angle 2 pi u2.
+ */
+void bulk_random::gaussian_block(int m, float stddev)
+{
+    uniform(d_radius, m, TWO_POW_M24, TWO_POW_M24);
+    uniform(d_angle, m, 2.0f * GR_M_PI * TWO_POW_M24, -GR_M_PI);
+
+    volk_32f_log2_32f(d_radius, d_radius, m);
+    const float k = -2.0f * LN_2 * stddev * stddev;
+    for (int i = 0; i < m; i++) {
+        // the approximate log2 may come out just above zero near 1
+        float v = k * d_radius[i];
+        d_radius[i] = v > 0.0f ? v : 0.0f;
+    }
+    volk_32f_sqrt_32f(d_radius, d_radius, m);
+
+    volk_32f_cos_32f(d_re, d_angle, m);
+    volk_32f_sin_32f(d_im, d_angle, m);
+    volk_32f_x2_multiply_32f(d_re, d_re, d_radius, m);
+    volk_32f_x2_multiply_32f(d_im, d_im, d_radius, m);
+}
+
+void bulk_random::fill_gaussian(float* out, int n, float stddev)
+{
+    int done = 0;
+    while (done < n) {
+        int m = std::min((int)BLOCK, round_up((n - done + 1) / 2, 2 * NSTREAMS));
+        gaussian_block(m, stddev);
+
+        int nre = std::min(m, n - done);
+        memcpy(out + done, d_re, nre * sizeof(float));
+        done += nre;
+
+        int nim = std::min(m, n - done);
+        memcpy(out + done, d_im, nim * sizeof(float));
+        done += nim;
+    }
+}
+
+void bulk_random::fill_complex_gaussian(gr_complex* out, int n, float stddev)
+{
+    int done = 0;
+    while (done < n) {
+        int m = std::min((int)BLOCK, round_up(n - done, 2 * NSTREAMS));
+        gaussian_block(m, stddev);
+
+        int take = std::min(m, n - done);
+        volk_32f_x2_interleave_32fc(out + done, d_re, d_im, take);
+        done += take;
+    }
+}
+
+} /* namespace gr */
@@ -21,7 +21,9 @@
  */
 
 #include <gnuradio/math.h> // declaration is in here
+#include <stdint.h>
 #include <cmath>
+#include <cstring>
 
 namespace gr {
 
@@ -170,4 +172,76 @@ float fast_atan2f(float y, float x)
 #endif
 }
 
+/*****************************************************************************
+ Vector version
+
+ The same octant reduction as above, but with the table replaced by a
+ minimax polynomial for atan(z), 0 <= z <= 1 (maximum error 2.5e-7),
+ and every branch replaced by arithmetic or bit operations so the
+ compiler can vectorize the loop. A float operation under a condition
+ keeps GCC from vectorizing unless -fno-trapping-math is given, so
+ the octant selection swaps bit patterns and the quadrant corrections
+ are computed as s * base + (1 - 2s) * angle with s either 0 or 1,
+ which is exact. The build compiles this file with -ftree-vectorize;
+ at plain -O2 GCC leaves the loop scalar, slower than the table.
+*****************************************************************************/
+
+static inline uint32_t float_bits(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static inline float bits_float(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+void fast_atan2f(const gr_complex* z, float* angle, unsigned int n, float scale)
+{
+    const float* p = (const float*)z;
+
+    for (size_t i = 0; i < n; i++) {
+        const float x = p[2 * i];
+        const float y = p[2 * i + 1];
+        const float x_abs = fabsf(x);
+        const float y_abs = fabsf(y);
+        const uint32_t x_bits = float_bits(x_abs);
+        const uint32_t y_bits = float_bits(y_abs);
+
+        /* normalize to +/- 45 degree range */
+        const int steep = y_abs > x_abs;
+        const uint32_t swap = (x_bits ^ y_bits) & (0u - steep);
+        const uint32_t den_bits = x_bits ^ swap;
+        /* don't divide by zero: 0 / 1 when both are zero */
+        const uint32_t one_bits = (uint32_t)(den_bits == 0) * 0x3f800000u;
+        const float den = bits_float(den_bits | one_bits);
+        const float ratio = bits_float(y_bits ^ swap) / den;
+
+        const float r2 = ratio * ratio;
+        float a = 6.81179772e-3f;
+        a = a * r2 - 3.36042678e-2f;
+        a = a * r2 + 7.96237848e-2f;
+        a = a * r2 - 1.32333532e-1f;
+        a = a * r2 + 1.98078207e-1f;
+        a = a * r2 - 3.33173691e-1f;
+        a = a * r2 + 9.99996112e-1f;
+        a *= ratio;
+
+        /* 90 - angle above 45 degrees, 180 - angle left of the y axis */
+        const float s = (float)steep;
+        const float w = (float)(x < 0.0f);
+        a = s * 1.57079632679489661923f + (1.0f - 2.0f * s) * a;
+        a = w * 3.14159265358979323846f + (1.0f - 2.0f * w) * a;
+
+        /* negate below the x axis; zero when neither |x| nor |y| is > 0 */
+        a = bits_float(float_bits(a) ^ ((uint32_t)(y < 0.0f) << 31)) * scale;
+        const uint32_t nonzero = (x_abs > 0.0f) | (y_abs > 0.0f);
+        angle[i] = bits_float(float_bits(a) & (0u - nonzero));
+    }
+}
+
 } /* namespace gr */
@@ -0,0 +1,121 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/bulk_random.h>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+static void moments(const float* x, size_t n, size_t stride, double& mean, double& var)
+{
+    double sum = 0, sum2 = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < n; i += stride) {
+        sum += x[i];
+        sum2 += (double)x[i] * x[i];
+        count++;
+    }
+    mean = sum / count;
+    var = sum2 / count - mean * mean;
+}
+
+BOOST_AUTO_TEST_CASE(t_uniform)
+{
+    gr::bulk_random rng(42);
+    std::vector<float> x(1000003);
+    rng.fill_uniform(&x[0], x.size(), -1.0f, 1.0f);
+
+    float lo = 1, hi = -1;
+    for (size_t i = 0; i < x.size(); i++) {
+        lo = std::min(lo, x[i]);
+        hi = std::max(hi, x[i]);
+    }
+    BOOST_CHECK(lo >= -1.0f && lo < -0.999f);
+    BOOST_CHECK(hi < 1.0f && hi > 0.999f);
+
+    double mean, var;
+    moments(&x[0], x.size(), 1, mean, var);
+    BOOST_CHECK_SMALL(mean, 5e-3);
+    BOOST_CHECK_CLOSE(var, 1.0 / 3.0, 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(t_gaussian)
+{
+    gr::bulk_random rng(7);
+    std::vector<float> x(1000001);
+    rng.fill_gaussian(&x[0], x.size(), 2.0f);
+
+    double mean, var;
+    moments(&x[0], x.size(), 1, mean, var);
+    BOOST_CHECK_SMALL(mean, 1e-2);
+    BOOST_CHECK_CLOSE(var, 4.0, 1.0);
+
+    // Tails: P(|x| > 3 sigma) = 0.0027
+    size_t outside = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        BOOST_REQUIRE(std::isfinite(x[i]));
+        if (std::abs(x[i]) > 6.0f)
+            outside++;
+    }
+    BOOST_CHECK_CLOSE(outside / (double)x.size(), 0.0027, 10.0);
+}
+
+BOOST_AUTO_TEST_CASE(t_complex_gaussian)
+{
+    gr::bulk_random rng(3);
+    std::vector<gr_complex> x(500000);
+    rng.fill_complex_gaussian(&x[0], x.size(), 0.5f);
+
+    const float* f = reinterpret_cast<const float*>(&x[0]);
+    double mean, var;
+    moments(f, 2 * x.size(), 2, mean, var);
+    BOOST_CHECK_SMALL(mean, 1e-2);
+    BOOST_CHECK_CLOSE(var, 0.25, 1.0);
+    moments(f + 1, 2 * x.size() - 1, 2, mean, var);
+    BOOST_CHECK_SMALL(mean, 1e-2);
+    BOOST_CHECK_CLOSE(var, 0.25, 1.0);
+
+    // Real and imaginary parts are uncorrelated
+    double cross = 0;
+    for (size_t i = 0; i < x.size(); i++)
+        cross += x[i].real() * x[i].imag();
+    BOOST_CHECK_SMALL(cross / x.size(), 2e-3);
+}
+
+BOOST_AUTO_TEST_CASE(t_reproducible)
+{
+    gr::bulk_random a(1234), b(1234), c(4321);
+    std::vector<float> x(1000), y(1000), z(1000);
+    a.fill_gaussian(&x[0], x.size());
+    b.fill_gaussian(&y[0], y.size());
+    c.fill_gaussian(&z[0], z.size());
+    BOOST_CHECK(x == y);
+    BOOST_CHECK(x != z);
+
+    a.reseed(1234);
+    a.fill_gaussian(&y[0], y.size());
+    BOOST_CHECK(x == y);
+}
@@ -28,6 +28,7 @@
 #include <boost/test/unit_test.hpp>
 #include <cmath>
 #include <limits>
+#include <vector>
 
 #ifdef _MSC_VER
 #define ISNAN _isnan
@@ -132,3 +133,56 @@ BOOST_AUTO_TEST_CASE(t2)
     gr_atan2f = gr::fast_atan2f(y, x);
     BOOST_CHECK(ISNAN(gr_atan2f));
 }
+
+BOOST_AUTO_TEST_CASE(t3)
+{
+    // Vector version against the libm atan2 around a circle, with
+    // magnitudes from tiny to huge
+    static const unsigned int N = 100000;
+    std::vector<gr_complex> z(N);
+    std::vector<float> angle(N);
+
+    const float mags[] = { 1e-30f, 1e-3f, 1.0f, 3.7f, 1e30f };
+    for (size_t m = 0; m < sizeof(mags) / sizeof(mags[0]); m++) {
+        for (unsigned int i = 0; i < N; i++) {
+            double t = -GR_M_PI + GR_M_TWOPI * i / N;
+            z[i] = gr_complex(mags[m] * cos(t), mags[m] * sin(t));
+        }
+        gr::fast_atan2f(&z[0], &angle[0], N);
+
+        float max_err = 0;
+        for (unsigned int i = 0; i < N; i++) {
+            double err = fabs(angle[i] - atan2((double)z[i].imag(), (double)z[i].real()));
+            if (err > GR_M_PI) // +pi vs. -pi on the negative x axis
+                err = fabs(err - GR_M_TWOPI);
+            max_err = std::max(max_err, (float)err);
+        }
+        BOOST_CHECK_SMALL(max_err, 1e-6f);
+    }
+
+    // Scaling
+    z[0] = gr_complex(0, 1);
+    gr::fast_atan2f(&z[0], &angle[0], 1, 2.0f);
+    BOOST_CHECK_CLOSE(angle[0], (float)GR_M_PI, 1e-4);
+}
+
+BOOST_AUTO_TEST_CASE(t4)
+{
+    // Zero, INF and NAN handling must match the scalar version
+    float inf = std::numeric_limits<float>::infinity();
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    const float xs[] = { 0, -0.0f, 1, -1, inf, -inf, nan, -nan };
+
+    for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); i++) {
+        for (size_t j = 0; j < sizeof(xs) / sizeof(xs[0]); j++) {
+            gr_complex z(xs[i], xs[j]);
+            float v;
+            gr::fast_atan2f(&z, &v, 1);
+            float s = gr::fast_atan2f(xs[j], xs[i]);
+            if (ISNAN(s))
+                BOOST_CHECK(ISNAN(v));
+            else
+                BOOST_CHECK_CLOSE(s, v, 0.0001);
+        }
+    }
+}
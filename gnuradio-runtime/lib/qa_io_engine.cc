@@ -0,0 +1,173 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_engine.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+static const char* test_file = "qa_gr_io_engine.data";
+static const size_t BLOCK = 4096;
+static const size_t NBLOCKS = 40; // more than the queue depth below
+
+static void write_read_back(gr::io_engine::sptr engine, bool fixed)
+{
+    int fd = open(test_file, O_RDWR | O_CREAT | O_TRUNC, 0664);
+    BOOST_REQUIRE(fd >= 0);
+
+    std::vector<char> wdata(BLOCK * NBLOCKS);
+    for (size_t i = 0; i < wdata.size(); i++)
+        wdata[i] = (char)(i * 7 + i / BLOCK);
+    std::vector<char> rdata(wdata.size());
+
+    std::vector<void*> bufs;
+    bufs.push_back(&wdata[0]);
+    bufs.push_back(&rdata[0]);
+    if (fixed)
+        engine->register_buffers(bufs, wdata.size());
+
+    // Write the blocks in reverse order in one batch
+    std::vector<gr::io_engine::request> reqs(NBLOCKS);
+    std::vector<gr::io_engine::request*> ptrs(NBLOCKS);
+    for (size_t i = 0; i < NBLOCKS; i++) {
+        size_t b = NBLOCKS - 1 - i;
+        reqs[i].op = gr::io_engine::OP_WRITE;
+        reqs[i].fd = fd;
+        reqs[i].buf = &wdata[b * BLOCK];
+        reqs[i].len = BLOCK;
+        reqs[i].offset = b * BLOCK;
+        reqs[i].buf_index = fixed ? 0 : -1;
+        ptrs[i] = &reqs[i];
+    }
+    engine->submit(&ptrs[0], NBLOCKS);
+    for (size_t i = 0; i < NBLOCKS; i++) {
+        engine->wait(ptrs[i]);
+        BOOST_CHECK(reqs[i].done);
+        BOOST_CHECK_EQUAL((int64_t)BLOCK, reqs[i].result);
+    }
+
+    for (size_t i = 0; i < NBLOCKS; i++) {
+        reqs[i].op = gr::io_engine::OP_READ;
+        reqs[i].buf = &rdata[i * BLOCK];
+        reqs[i].offset = i * BLOCK;
+        reqs[i].buf_index = fixed ? 1 : -1;
+    }
+    engine->submit(&ptrs[0], NBLOCKS);
+    for (size_t i = NBLOCKS; i > 0; i--) {
+        engine->wait(ptrs[i - 1]);
+        BOOST_CHECK_EQUAL((int64_t)BLOCK, reqs[i - 1].result);
+    }
+    BOOST_CHECK(wdata == rdata);
+
+    // Past the end of the file
+    reqs[0].offset = wdata.size();
+    engine->submit(&ptrs[0], 1);
+    engine->wait(ptrs[0]);
+    BOOST_CHECK_EQUAL(0, reqs[0].result);
+    BOOST_CHECK(engine->poll(ptrs[0]));
+
+    close(fd);
+    unlink(test_file);
+}
+
+// Linked writes into a pipe arrive in order
+static void pipe_in_order(gr::io_engine::sptr engine)
+{
+    int fds[2];
+    BOOST_REQUIRE(pipe(fds) == 0);
+
+    const size_t n = 8; // fits the pipe buffer
+    std::vector<char> wdata(n * 512);
+    for (size_t i = 0; i < wdata.size(); i++)
+        wdata[i] = (char)(i * 3 + i / 512);
+    std::vector<char> rdata(wdata.size());
+
+    std::vector<gr::io_engine::request> reqs(n);
+    std::vector<gr::io_engine::request*> ptrs(n);
+    for (size_t i = 0; i < n; i++) {
+        reqs[i].op = gr::io_engine::OP_WRITE;
+        reqs[i].fd = fds[1];
+        reqs[i].buf = &wdata[i * 512];
+        reqs[i].len = 512;
+        reqs[i].offset = gr::io_engine::CURRENT_POSITION;
+        reqs[i].link = i + 1 < n;
+        ptrs[i] = &reqs[i];
+    }
+    engine->submit(&ptrs[0], n);
+    for (size_t i = 0; i < n; i++) {
+        engine->wait(ptrs[i]);
+        BOOST_CHECK_EQUAL(512, reqs[i].result);
+    }
+
+    gr::io_engine::request req;
+    gr::io_engine::request* p = &req;
+    req.op = gr::io_engine::OP_READ;
+    req.fd = fds[0];
+    req.buf = &rdata[0];
+    req.len = rdata.size();
+    req.offset = gr::io_engine::CURRENT_POSITION;
+    engine->submit(&p, 1);
+    engine->wait(p);
+    BOOST_CHECK_EQUAL((int64_t)rdata.size(), req.result);
+    BOOST_CHECK(wdata == rdata);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(t_default)
+{
+    write_read_back(gr::io_engine::make(16), false);
+    write_read_back(gr::io_engine::make(16), true);
+    pipe_in_order(gr::io_engine::make(16));
+}
+
+BOOST_AUTO_TEST_CASE(t_thread)
+{
+    gr::io_engine::sptr engine = gr::io_engine::make(16, false);
+    BOOST_CHECK(!engine->uses_io_uring());
+    write_read_back(engine, false);
+    write_read_back(engine, true);
+    pipe_in_order(engine);
+}
+
+BOOST_AUTO_TEST_CASE(t_error)
+{
+    gr::io_engine::sptr engine = gr::io_engine::make(4);
+
+    char c;
+    gr::io_engine::request req;
+    gr::io_engine::request* p = &req;
+    req.op = gr::io_engine::OP_READ;
+    req.fd = -1;
+    req.buf = &c;
+    req.len = 1;
+    engine->submit(&p, 1);
+    engine->wait(p);
+    BOOST_CHECK(req.result < 0);
+}
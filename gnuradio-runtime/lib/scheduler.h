@@ -61,6 +61,19 @@ public:
      * \brief Block until the graph is done.
      */
     virtual void wait() = 0;
+
+    /*!
+     * \brief Stop executing \p blocks and wait until they are idle.
+     *
+     * Blocks not in \p blocks keep running. Used to rewire part of a
+     * running graph.
+     */
+    virtual void pause_blocks(const basic_block_vector_t& blocks) = 0;
+
+    /*!
+     * \brief Start executing every block of \p ffg that is not running.
+     */
+    virtual void resume(flat_flowgraph_sptr ffg) = 0;
 };
 
 } /* namespace gr */
@@ -36,18 +36,33 @@ class tpb_container
     block_sptr d_block;
     int d_max_noutput_items;
     thread::barrier_sptr d_start_sync;
+    scheduler_tpb* d_sched;
+    scheduler_tpb::worker_sptr d_worker;
 
 public:
     tpb_container(block_sptr block,
                   int max_noutput_items,
-                  thread::barrier_sptr start_sync)
-        : d_block(block), d_max_noutput_items(max_noutput_items), d_start_sync(start_sync)
+                  thread::barrier_sptr start_sync,
+                  scheduler_tpb* sched,
+                  scheduler_tpb::worker_sptr worker)
+        : d_block(block),
+          d_max_noutput_items(max_noutput_items),
+          d_start_sync(start_sync),
+          d_sched(sched),
+          d_worker(worker)
     {
     }
 
     void operator()()
     {
-        tpb_thread_body body(d_block, d_start_sync, d_max_noutput_items);
+        // Report the thread as finished however the body exits
+        try {
+            tpb_thread_body body(d_block, d_start_sync, d_max_noutput_items);
+        } catch (...) {
+            d_sched->thread_finished(d_worker);
+            throw;
+        }
+        d_sched->thread_finished(d_worker);
     }
 };
 
@@ -57,17 +72,24 @@ scheduler_sptr scheduler_tpb::make(flat_flowgraph_sptr ffg, int max_noutput_item
 }
 
 scheduler_tpb::scheduler_tpb(flat_flowgraph_sptr ffg, int max_noutput_items)
-    : scheduler(ffg, max_noutput_items)
+    : scheduler(ffg, max_noutput_items),
+      d_max_noutput_items(max_noutput_items),
+      d_nrunning(0),
+      d_nstarted(0)
 {
-    int block_max_noutput_items;
+    resume(ffg);
+}
 
-    // Get a topologically sorted vector of all the blocks in use.
-    // Being topologically sorted probably isn't going to matter, but
-    // there's a non-zero chance it might help...
+scheduler_tpb::~scheduler_tpb()
+{
+    // The threads refer back to us, so they must be gone first
+    stop();
+    wait();
+}
 
-    basic_block_vector_t used_blocks = ffg->calc_used_blocks();
-    used_blocks = ffg->topological_sort(used_blocks);
-    block_vector_t blocks = flat_flowgraph::make_block_vector(used_blocks);
+void scheduler_tpb::start_threads(const block_vector_t& blocks)
+{
+    int block_max_noutput_items;
 
     // Ensure that the done flag is clear on all blocks
 
@@ -79,27 +101,114 @@ scheduler_tpb::scheduler_tpb(flat_flowgraph_sptr ffg, int max_noutput_items)
         boost::make_shared<thread::barrier>(blocks.size() + 1);
 
     // Fire off a thead for each block
-
-    for (size_t i = 0; i < blocks.size(); i++) {
-        std::stringstream name;
-        name << "thread-per-block[" << i << "]: " << blocks[i];
-
-        // If set, use internal value instead of global value
-        if (blocks[i]->is_set_max_noutput_items()) {
-            block_max_noutput_items = blocks[i]->max_noutput_items();
-        } else {
-            block_max_noutput_items = max_noutput_items;
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+
+        for (size_t i = 0; i < blocks.size(); i++) {
+            std::stringstream name;
+            name << "thread-per-block[" << d_nstarted++ << "]: " << blocks[i];
+
+            // If set, use internal value instead of global value
+            if (blocks[i]->is_set_max_noutput_items()) {
+                block_max_noutput_items = blocks[i]->max_noutput_items();
+            } else {
+                block_max_noutput_items = d_max_noutput_items;
+            }
+
+            worker_sptr w = boost::make_shared<worker>();
+            w->finished = false;
+            w->thread = gr::thread::thread(thread::thread_body_wrapper<tpb_container>(
+                tpb_container(blocks[i], block_max_noutput_items, start_sync, this, w),
+                name.str()));
+            d_workers[blocks[i]] = w;
+            d_nrunning++;
         }
-        d_threads.create_thread(thread::thread_body_wrapper<tpb_container>(
-            tpb_container(blocks[i], block_max_noutput_items, start_sync), name.str()));
     }
     start_sync->wait();
 }
 
-scheduler_tpb::~scheduler_tpb() { stop(); }
+void scheduler_tpb::thread_finished(worker_sptr w)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    w->finished = true;
+    d_nrunning--;
+    d_cond.notify_all();
+}
+
+void scheduler_tpb::stop()
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    for (worker_map_t::iterator i = d_workers.begin(); i != d_workers.end(); i++)
+        i->second->thread.interrupt();
+}
+
+void scheduler_tpb::wait()
+{
+    worker_map_t workers;
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        while (d_nrunning > 0)
+            d_cond.wait(lock);
+        workers.swap(d_workers);
+    }
+
+    for (worker_map_t::iterator i = workers.begin(); i != workers.end(); i++)
+        i->second->thread.join();
+}
+
+void scheduler_tpb::pause_blocks(const basic_block_vector_t& blocks)
+{
+    std::vector<worker_sptr> paused;
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        for (size_t i = 0; i < blocks.size(); i++) {
+            worker_map_t::iterator w = d_workers.find(cast_to_block_sptr(blocks[i]));
+            if (w != d_workers.end()) {
+                paused.push_back(w->second);
+                d_workers.erase(w);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < paused.size(); i++)
+        paused[i]->thread.interrupt();
+    for (size_t i = 0; i < paused.size(); i++)
+        paused[i]->thread.join();
+}
+
+void scheduler_tpb::resume(flat_flowgraph_sptr ffg)
+{
+    // Get a topologically sorted vector of all the blocks in use.
+    // Being topologically sorted probably isn't going to matter, but
+    // there's a non-zero chance it might help...
+
+    basic_block_vector_t used_blocks = ffg->calc_used_blocks();
+    used_blocks = ffg->topological_sort(used_blocks);
+    block_vector_t blocks = flat_flowgraph::make_block_vector(used_blocks);
+
+    // Pick out the blocks without a live thread; threads that already
+    // ran to completion are reaped here.
+    block_vector_t idle;
+    std::vector<worker_sptr> finished;
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        for (size_t i = 0; i < blocks.size(); i++) {
+            worker_map_t::iterator w = d_workers.find(blocks[i]);
+            if (w != d_workers.end()) {
+                if (!w->second->finished)
+                    continue;
+                finished.push_back(w->second);
+                d_workers.erase(w);
+            }
+            idle.push_back(blocks[i]);
+        }
+    }
 
-void scheduler_tpb::stop() { d_threads.interrupt_all(); }
+    for (size_t i = 0; i < finished.size(); i++)
+        finished[i]->thread.join();
 
-void scheduler_tpb::wait() { d_threads.join_all(); }
+    if (!idle.empty())
+        start_threads(idle);
+}
 
 } /* namespace gr */
@@ -24,16 +24,38 @@
 
 #include "scheduler.h"
 #include <gnuradio/api.h>
-#include <gnuradio/thread/thread_group.h>
+#include <gnuradio/thread/thread.h>
+#include <map>
 
 namespace gr {
 
 /*!
  * \brief Concrete scheduler that uses a kernel thread-per-block
+ *
+ * Threads are tracked per block so that part of the graph can be
+ * paused and resumed while the rest keeps running.
  */
 class GR_RUNTIME_API scheduler_tpb : public scheduler
 {
-    gr::thread::thread_group d_threads;
+private:
+    struct worker {
+        gr::thread::thread thread;
+        bool finished;
+    };
+    typedef boost::shared_ptr<worker> worker_sptr;
+    typedef std::map<block_sptr, worker_sptr> worker_map_t;
+
+    int d_max_noutput_items;
+    gr::thread::mutex d_mutex; // protects d_workers and d_nrunning
+    gr::thread::condition_variable d_cond;
+    worker_map_t d_workers;
+    int d_nrunning;
+    unsigned int d_nstarted;
+
+    void start_threads(const block_vector_t& blocks);
+    void thread_finished(worker_sptr w);
+
+    friend class tpb_container;
 
 protected:
     /*!
@@ -58,6 +80,10 @@ public:
      * \brief Block until the graph is done.
      */
     void wait();
+
+    void pause_blocks(const basic_block_vector_t& blocks);
+
+    void resume(flat_flowgraph_sptr ffg);
 };
 
 } /* namespace gr */
@@ -158,9 +158,9 @@ void top_block_impl::wait_for_jobs()
 // thread or deadlock will occur when reconfiguration happens
 void top_block_impl::lock()
 {
+    // The running graph is left alone until unlock(); edits only touch
+    // the hierarchy, which is flattened again there.
     gr::thread::scoped_lock lock(d_mutex);
-    if (d_scheduler)
-        d_scheduler->stop();
     d_lock_count++;
 }
 
@@ -186,16 +186,19 @@ void top_block_impl::unlock()
  */
 void top_block_impl::restart()
 {
-    wait_for_jobs();
-
     // Create new simple flow graph
     flat_flowgraph_sptr new_ffg = d_owner->flatten();
-    new_ffg->validate();               // check consistency, sanity, etc
+    new_ffg->validate(); // check consistency, sanity, etc
+
+    // Only the blocks whose connections change are stopped; the rest
+    // keep their threads and buffers and run on undisturbed.
+    basic_block_vector_t changed = new_ffg->calc_changed_blocks(d_ffg);
+    d_scheduler->pause_blocks(changed);
+
     new_ffg->merge_connections(d_ffg); // reuse buffers, etc
     d_ffg = new_ffg;
 
-    // Create a new scheduler to execute it
-    d_scheduler = make_scheduler(d_ffg, d_max_noutput_items);
+    d_scheduler->resume(d_ffg);
     d_retry_wait = true;
 }
 
@@ -22,9 +22,24 @@
 
 
 import time
+import numpy
 import pmt
 from gnuradio import gr, gr_unittest, blocks
 
+class start_counter(gr.sync_block):
+    def __init__(self):
+        gr.sync_block.__init__(self, "start_counter",
+                               [numpy.float32], [numpy.float32])
+        self.nstarts = 0
+
+    def start(self):
+        self.nstarts += 1
+        return True
+
+    def work(self, input_items, output_items):
+        output_items[0][:] = input_items[0]
+        return len(output_items[0])
+
 class test_flowgraph (gr_unittest.TestCase):
 
     def setUp (self):
@@ -54,6 +69,59 @@ class test_flowgraph (gr_unittest.TestCase):
         data = pmt.u8vector_elements(pmt.cdr(dbg.get_message(0)))
         self.assertEqual((1, 2, 3), data)
 
+    def test_001(self):
+        # Rewiring one branch must not restart the other one
+        src = blocks.null_source(gr.sizeof_float)
+        cnt_a, snk_a = start_counter(), blocks.null_sink(gr.sizeof_float)
+        cnt_b, snk_b = start_counter(), blocks.null_sink(gr.sizeof_float)
+        self.tb.connect(src, cnt_a, snk_a)
+        self.tb.connect(src, cnt_b, snk_b)
+
+        self.tb.start()
+        time.sleep(0.1)
+
+        self.tb.lock()
+        snk_b2 = blocks.null_sink(gr.sizeof_float)
+        self.tb.disconnect(cnt_b, snk_b)
+        self.tb.connect(cnt_b, snk_b2)
+        self.tb.unlock()
+
+        time.sleep(0.1)
+        self.tb.stop()
+        self.tb.wait()
+
+        self.assertEqual(cnt_a.nstarts, 1)
+        self.assertEqual(cnt_b.nstarts, 2)
+        self.assertGreater(snk_b2.nitems_read(0), 0)
+
+    def test_002(self):
+        # A chain of new blocks picks up the item count of the running
+        # block feeding it, whatever order the blocks are merged in
+        src = blocks.null_source(gr.sizeof_float)
+        thr = blocks.throttle(gr.sizeof_float, 1e6)
+        hd = blocks.head(gr.sizeof_float, 1000000)
+        snk = blocks.null_sink(gr.sizeof_float)
+        self.tb.connect(src, thr, hd, snk)
+
+        self.tb.start()
+        time.sleep(0.1)
+
+        self.tb.lock()
+        cp1 = blocks.copy(gr.sizeof_float)
+        cp2 = blocks.copy(gr.sizeof_float)
+        snk2 = blocks.null_sink(gr.sizeof_float)
+        self.tb.disconnect(hd, snk)
+        self.tb.connect(hd, cp1, cp2, snk2)
+        self.tb.unlock()
+
+        self.tb.wait()
+
+        self.assertGreater(snk.nitems_read(0), 0)
+        self.assertEqual(cp1.nitems_written(0), hd.nitems_written(0))
+        self.assertEqual(cp2.nitems_read(0), cp1.nitems_written(0))
+        self.assertEqual(snk2.nitems_read(0), cp2.nitems_written(0))
+        self.assertEqual(snk2.nitems_read(0), 1000000)
+
 if __name__ == '__main__':
     gr_unittest.run(test_flowgraph, 'test_flowgraph.xml')
 
@@ -23,6 +23,7 @@
 #ifndef INCLUDED_ANALOG_AGC_H
 #define INCLUDED_ANALOG_AGC_H
 
+#include <gnuradio/analog/agc_kernel.h>
 #include <gnuradio/analog/api.h>
 #include <gnuradio/gr_complex.h>
 #include <cmath>
@@ -71,22 +72,29 @@ public:
     {
         gr_complex output = input * _gain;
 
-        _gain += _rate * (_reference - std::sqrt(output.real() * output.real() +
-                                                 output.imag() * output.imag()));
-        if (_max_gain > 0.0 && _gain > _max_gain) {
-            _gain = _max_gain;
-        }
+        update(std::sqrt(output.real() * output.real() + output.imag() * output.imag()));
         return output;
     }
 
     void scaleN(gr_complex output[], const gr_complex input[], unsigned n)
     {
-        for (unsigned i = 0; i < n; i++) {
-            output[i] = scale(input[i]);
-        }
+        agc_kernel::scale_chunks(output, input, n, [this](float level) {
+            const float gain = _gain;
+            update(std::fabs(gain) * level);
+            return gain;
+        });
     }
 
 protected:
+    //! Adjust the gain for an output of magnitude \p level
+    void update(float level)
+    {
+        _gain += _rate * (_reference - level);
+        if (_max_gain > 0.0 && _gain > _max_gain) {
+            _gain = _max_gain;
+        }
+    }
+
     float _rate;      // adjustment rate
     float _reference; // reference value
     float _gain;      // current gain
@@ -130,19 +138,28 @@ public:
     float scale(float input)
     {
         float output = input * _gain;
-        _gain += (_reference - fabsf(output)) * _rate;
-        if (_max_gain > 0.0 && _gain > _max_gain)
-            _gain = _max_gain;
+        update(fabsf(output));
         return output;
     }
 
     void scaleN(float output[], const float input[], unsigned n)
     {
-        for (unsigned i = 0; i < n; i++)
-            output[i] = scale(input[i]);
+        agc_kernel::scale_chunks(output, input, n, [this](float level) {
+            const float gain = _gain;
+            update(fabsf(gain) * level);
+            return gain;
+        });
     }
 
 protected:
+    //! Adjust the gain for an output of magnitude \p level
+    void update(float level)
+    {
+        _gain += (_reference - level) * _rate;
+        if (_max_gain > 0.0 && _gain > _max_gain)
+            _gain = _max_gain;
+    }
+
     float _rate;      // adjustment rate
     float _reference; // reference value
     float _gain;      // current gain
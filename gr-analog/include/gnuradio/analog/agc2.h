@@ -23,6 +23,7 @@
 #ifndef INCLUDED_ANALOG_AGC2_H
 #define INCLUDED_ANALOG_AGC2_H
 
+#include <gnuradio/analog/agc_kernel.h>
 #include <gnuradio/analog/api.h>
 #include <gnuradio/gr_complex.h>
 #include <math.h>
@@ -77,8 +78,24 @@ public:
     {
         gr_complex output = input * _gain;
 
-        float tmp = -_reference +
-                    sqrt(output.real() * output.real() + output.imag() * output.imag());
+        update(sqrt(output.real() * output.real() + output.imag() * output.imag()));
+        return output;
+    }
+
+    void scaleN(gr_complex output[], const gr_complex input[], unsigned n)
+    {
+        agc_kernel::scale_chunks(output, input, n, [this](float level) {
+            const float gain = _gain;
+            update(fabsf(gain) * level);
+            return gain;
+        });
+    }
+
+protected:
+    //! Adjust the gain for an output of magnitude \p level
+    void update(float level)
+    {
+        float tmp = -_reference + level;
         float rate = _decay_rate;
         if ((tmp) > _gain) {
             rate = _attack_rate;
@@ -93,16 +110,8 @@ public:
         if (_max_gain > 0.0 && _gain > _max_gain) {
             _gain = _max_gain;
         }
-        return output;
     }
 
-    void scaleN(gr_complex output[], const gr_complex input[], unsigned n)
-    {
-        for (unsigned i = 0; i < n; i++)
-            output[i] = scale(input[i]);
-    }
-
-protected:
     float _attack_rate; // attack rate for fast changing signals
     float _decay_rate;  // decay rate for slow changing signals
     float _reference;   // reference value
@@ -149,8 +158,24 @@ public:
     float scale(float input)
     {
         float output = input * _gain;
+        update(fabsf(output));
+        return output;
+    }
 
-        float tmp = (fabsf(output)) - _reference;
+    void scaleN(float output[], const float input[], unsigned n)
+    {
+        agc_kernel::scale_chunks(output, input, n, [this](float level) {
+            const float gain = _gain;
+            update(fabsf(gain) * level);
+            return gain;
+        });
+    }
+
+protected:
+    //! Adjust the gain for an output of magnitude \p level
+    void update(float level)
+    {
+        float tmp = level - _reference;
         float rate = _decay_rate;
         if (fabsf(tmp) > _gain) {
             rate = _attack_rate;
@@ -164,16 +189,8 @@ public:
         if (_max_gain > 0.0 && _gain > _max_gain) {
             _gain = _max_gain;
         }
-        return output;
     }
 
-    void scaleN(float output[], const float input[], unsigned n)
-    {
-        for (unsigned i = 0; i < n; i++)
-            output[i] = scale(input[i]);
-    }
-
-protected:
     float _attack_rate; // attack_rate for fast changing signals
     float _decay_rate;  // decay rate for slow changing signals
     float _reference;   // reference value
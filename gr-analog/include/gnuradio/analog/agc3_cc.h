@@ -40,6 +40,11 @@ namespace analog {
  * IIR model for tracking purposes.
  *
  * For Power the absolute value of the complex number is used.
+ *
+ * With an \p iir_update_decim above 1, the gain is held between
+ * updates by default. set_interpolate_gain() ramps it linearly from
+ * one update to the next instead, which avoids spurs at multiples of
+ * the update rate.
  */
 class ANALOG_API agc3_cc : virtual public sync_block
 {
@@ -68,12 +73,19 @@ public:
     virtual float reference() const = 0;
     virtual float gain() const = 0;
     virtual float max_gain() const = 0;
+    virtual bool interpolate_gain() const = 0;
 
     virtual void set_attack_rate(float rate) = 0;
     virtual void set_decay_rate(float rate) = 0;
     virtual void set_reference(float reference) = 0;
     virtual void set_gain(float gain) = 0;
     virtual void set_max_gain(float max_gain) = 0;
+
+    /*!
+     * \brief Ramp the gain between updates instead of holding it.
+     * Only matters if \p iir_update_decim is above 1.
+     */
+    virtual void set_interpolate_gain(bool interpolate) = 0;
 };
 
 } /* namespace analog */
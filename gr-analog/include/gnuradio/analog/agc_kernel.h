@@ -0,0 +1,142 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_ANALOG_AGC_KERNEL_H
+#define INCLUDED_ANALOG_AGC_KERNEL_H
+
+#include <gnuradio/analog/api.h>
+#include <gnuradio/gr_complex.h>
+
+namespace gr {
+namespace analog {
+namespace kernel {
+
+/*!
+ * \brief Envelope detection and gain application shared by the AGC
+ * loops.
+ * \ingroup level_controllers_blk
+ *
+ * \details
+ * An AGC splits into three stages: detect the envelope of the input,
+ * run the gain loop on the envelope, and scale the input by the gain.
+ * Only the loop is sequential. The first and last stages work on
+ * whole buffers here, with volk or loops the compiler vectorizes, so
+ * the loops in agc_cc, agc2_cc and the AGC blocks only carry the
+ * gain recursion sample by sample.
+ *
+ * Loops that update their gain less often than once per sample can
+ * hold the gain over each update interval (apply_gain()) or ramp it
+ * linearly from one update to the next (apply_gain_ramp()), which
+ * avoids the spurs a stepped gain puts at multiples of the update
+ * rate.
+ */
+class ANALOG_API agc_kernel
+{
+public:
+    //! Samples a loop processes per pass, sized for buffers on the stack
+    static const unsigned int CHUNK_SIZE = 256;
+
+    //! out[i] = |in[i]|
+    static void magnitude(float out[], const gr_complex in[], unsigned int n);
+
+    //! out[i] = |in[i]|
+    static void magnitude(float out[], const float in[], unsigned int n);
+
+    /*!
+     * \brief Fast envelope approximation.
+     *
+     * out[i] = max(|re|, |im|) + 0.4 * min(|re|, |im|) of in[i], which
+     * is within about 8% of |in[i]|.
+     */
+    static void envelope(float out[], const gr_complex in[], unsigned int n);
+
+    /*!
+     * \brief Sliding window maximum.
+     *
+     * out[i] = max(in[i], ..., in[i + window - 1]) for i < \p n, so \p in
+     * holds n + window - 1 values. \p scratch holds as many. The cost
+     * does not depend on \p window.
+     */
+    static void sliding_max(float out[],
+                            float scratch[],
+                            const float in[],
+                            unsigned int n,
+                            unsigned int window);
+
+    //! out[i] = in[i] * gains[i]
+    static void apply_gains(gr_complex out[],
+                            const gr_complex in[],
+                            const float gains[],
+                            unsigned int n);
+
+    //! out[i] = in[i] * gains[i]
+    static void
+    apply_gains(float out[], const float in[], const float gains[], unsigned int n);
+
+    //! out[i] = in[i] * gain
+    static void
+    apply_gain(gr_complex out[], const gr_complex in[], float gain, unsigned int n);
+
+    /*!
+     * \brief Scale by a gain ramp.
+     *
+     * out[i] = in[i] * (from + (to - from) * (i + 1) / n), so the last
+     * sample gets the gain \p to.
+     */
+    static void apply_gain_ramp(
+        gr_complex out[], const gr_complex in[], float from, float to, unsigned int n);
+
+    /*!
+     * \brief Run a per-sample gain loop over \p n samples.
+     *
+     * Works through the input CHUNK_SIZE samples at a time: takes the
+     * magnitude of the chunk, calls \p loop(level) once per sample in
+     * order, and scales the chunk by the gains it returned. \p loop
+     * returns the gain for the sample whose input magnitude is \p level
+     * and then advances the loop, so only it runs sample by sample.
+     */
+    template <typename T, typename Loop>
+    static void scale_chunks(T output[], const T input[], unsigned int n, Loop loop)
+    {
+        float level[CHUNK_SIZE];
+        float gains[CHUNK_SIZE];
+
+        while (n > 0) {
+            const unsigned int m = n < CHUNK_SIZE ? n : CHUNK_SIZE;
+            magnitude(level, input, m);
+            for (unsigned int i = 0; i < m; i++) {
+                gains[i] = loop(level[i]);
+            }
+            apply_gains(output, input, gains, m);
+
+            output += m;
+            input += m;
+            n -= m;
+        }
+    }
+};
+
+} /* namespace kernel */
+} /* namespace analog */
+} /* namespace gr */
+
+#endif /* INCLUDED_ANALOG_AGC_KERNEL_H */
@@ -25,9 +25,10 @@
 #endif
 
 #include <float.h>
-#include <vector>
+#include <cmath>
 
 #include "agc3_cc_impl.h"
+#include <gnuradio/analog/agc_kernel.h>
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
 
@@ -58,7 +59,8 @@ agc3_cc_impl::agc3_cc_impl(float attack_rate,
       d_gain(gain),
       d_max_gain(65536),
       d_reset(true),
-      d_iir_update_decim(iir_update_decim)
+      d_iir_update_decim(iir_update_decim),
+      d_interpolate_gain(false)
 {
     set_output_multiple(iir_update_decim * 4);
     const int alignment_multiple = volk_get_alignment() / sizeof(gr_complex);
@@ -75,21 +77,16 @@ int agc3_cc_impl::work(int noutput_items,
     const gr_complex* in = (const gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
 
-#ifdef __GNUC__
-    // Compute a linear average on reset (no expected)
-    if (__builtin_expect(d_reset, false)) {
-        float mags[noutput_items] __attribute__((aligned(16)));
-        volk_32fc_magnitude_32f(mags, &in[0], noutput_items);
-#else
+    if (d_mags.size() < (size_t)noutput_items) {
+        d_mags.resize(noutput_items);
+        d_gains.resize(noutput_items);
+    }
+
     // Compute a linear average on reset (no expected)
-    if (!d_reset) {
-        _declspec(align(16)) std::vector<float> mags(noutput_items);
-        volk_32fc_magnitude_32f(&mags[0], &in[0], noutput_items);
-#endif
+    if (d_reset) {
         float mag(0.0);
-        for (int i = 0; i < noutput_items; i++) {
-            mag += mags[i];
-        }
+        kernel::agc_kernel::magnitude(&d_mags[0], in, noutput_items);
+        volk_32f_accumulator_s32f(&mag, &d_mags[0], noutput_items);
         d_gain = d_reference * (noutput_items / mag);
 
         if (d_gain < 0.0)
@@ -100,36 +97,27 @@ int agc3_cc_impl::work(int noutput_items,
         }
 
         // scale output values
-        for (int i = 0; i < noutput_items; i++) {
-            out[i] = in[i] * d_gain;
-        }
+        kernel::agc_kernel::apply_gain(out, in, d_gain, noutput_items);
         d_reset = false;
     } else {
         // Otherwise perform a normal iir update
-#ifdef _MSC_VER
-        __declspec(align(16)) std::vector<float> mag_sq(noutput_items /
-                                                        d_iir_update_decim);
-        __declspec(align(16)) std::vector<float> inv_mag(noutput_items /
-                                                         d_iir_update_decim);
-#else
-        float mag_sq[noutput_items / d_iir_update_decim] __attribute__((aligned(16)));
-        float inv_mag[noutput_items / d_iir_update_decim] __attribute__((aligned(16)));
-#endif
+        const int nupdates = noutput_items / d_iir_update_decim;
 
         // generate squared magnitudes at decimated rate (gather operation)
-        for (int i = 0; i < noutput_items / d_iir_update_decim; i++) {
+        for (int i = 0; i < nupdates; i++) {
             int idx = i * d_iir_update_decim;
-            mag_sq[i] = in[idx].real() * in[idx].real() + in[idx].imag() * in[idx].imag();
+            d_mags[i] = in[idx].real() * in[idx].real() + in[idx].imag() * in[idx].imag();
         }
 
         // compute inverse square roots
-        volk_32f_invsqrt_32f(&inv_mag[0], &mag_sq[0], noutput_items / d_iir_update_decim);
+        volk_32f_invsqrt_32f(&d_mags[0], &d_mags[0], nupdates);
 
-        // apply updates
-        for (int i = 0; i < noutput_items / d_iir_update_decim; i++) {
-            float magi = inv_mag[i];
+        // run the loop at the decimated rate
+        const float last_gain = d_gain;
+        for (int i = 0; i < nupdates; i++) {
+            float magi = d_mags[i];
 #if defined(_MSC_VER) && _MSC_VER < 1900
-            if (!_finite(magi)) {
+            if (_finite(magi)) {
 #else
             if (std::isfinite(magi)) {
 #endif
@@ -138,8 +126,25 @@ int agc3_cc_impl::work(int noutput_items,
             } else {
                 d_gain = d_gain * (1 - d_decay);
             }
-            for (int j = i * d_iir_update_decim; j < (i + 1) * d_iir_update_decim; j++) {
-                out[j] = in[j] * d_gain;
+            d_gains[i] = d_gain;
+        }
+
+        // apply updates
+        if (d_iir_update_decim == 1) {
+            kernel::agc_kernel::apply_gains(out, in, &d_gains[0], noutput_items);
+        } else if (d_interpolate_gain) {
+            float from = last_gain;
+            for (int i = 0; i < nupdates; i++) {
+                const int j = i * d_iir_update_decim;
+                kernel::agc_kernel::apply_gain_ramp(
+                    &out[j], &in[j], from, d_gains[i], d_iir_update_decim);
+                from = d_gains[i];
+            }
+        } else {
+            for (int i = 0; i < nupdates; i++) {
+                const int j = i * d_iir_update_decim;
+                kernel::agc_kernel::apply_gain(
+                    &out[j], &in[j], d_gains[i], d_iir_update_decim);
             }
         }
     }
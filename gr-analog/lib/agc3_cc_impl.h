@@ -24,6 +24,7 @@
 #define INCLUDED_ANALOG_AGC3_IMPL_CC_H
 
 #include <gnuradio/analog/agc3_cc.h>
+#include <vector>
 
 namespace gr {
 namespace analog {
@@ -43,12 +44,14 @@ public:
     float reference() const { return d_reference; }
     float gain() const { return d_gain; }
     float max_gain() const { return d_max_gain; }
+    bool interpolate_gain() const { return d_interpolate_gain; }
 
     void set_attack_rate(float rate) { d_attack = rate; }
     void set_decay_rate(float rate) { d_decay = rate; }
     void set_reference(float reference) { d_reference = reference; }
     void set_gain(float gain) { d_gain = gain; }
     void set_max_gain(float max_gain) { d_max_gain = max_gain; }
+    void set_interpolate_gain(bool interpolate) { d_interpolate_gain = interpolate; }
 
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
@@ -62,6 +65,10 @@ private:
     float d_max_gain;
     bool d_reset;
     int d_iir_update_decim;
+    bool d_interpolate_gain;
+
+    std::vector<float> d_mags;  // magnitudes, or inverse magnitudes per update
+    std::vector<float> d_gains; // gain after each update
 };
 
 } /* namespace analog */
@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/analog/agc_kernel.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gr {
+namespace analog {
+namespace kernel {
+
+// The loops without a volk kernel work on plain floats with size_t
+// counters so the compiler vectorizes them.
+
+void agc_kernel::magnitude(float out[], const gr_complex in[], unsigned int n)
+{
+    volk_32fc_magnitude_32f(out, in, n);
+}
+
+void agc_kernel::magnitude(float out[], const float in[], unsigned int n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = std::fabs(in[i]);
+}
+
+void agc_kernel::envelope(float out[], const gr_complex in[], unsigned int n)
+{
+    const float* x = (const float*)in;
+    for (size_t i = 0; i < n; i++) {
+        const float r_abs = std::fabs(x[2 * i]);
+        const float i_abs = std::fabs(x[2 * i + 1]);
+        out[i] = std::max(r_abs, i_abs) + 0.4f * std::min(r_abs, i_abs);
+    }
+}
+
+/*
+ * van Herk / Gil-Werman: cut the input into blocks of window values.
+ * A window then covers the tail of one block and the head of the
+ * next, so its maximum is the larger of a suffix maximum and a prefix
+ * maximum, each computed in one pass per block.
+ */
+void agc_kernel::sliding_max(
+    float out[], float scratch[], const float in[], unsigned int n, unsigned int window)
+{
+    const size_t len = n + window - 1;
+
+    // Prefix maxima from the start of each block
+    for (size_t b = 0; b < len; b += window) {
+        const size_t end = std::min(b + window, len);
+        float m = in[b];
+        for (size_t i = b; i < end; i++) {
+            m = std::max(m, in[i]);
+            scratch[i] = m;
+        }
+    }
+
+    // Suffix maxima to the end of each block, for the windows' starts
+    for (size_t b = 0; b < n; b += window) {
+        const size_t end = std::min(b + window, len);
+        float m = in[end - 1];
+        for (size_t i = end; i-- > b;) {
+            m = std::max(m, in[i]);
+            if (i < n)
+                out[i] = m;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+        out[i] = std::max(out[i], scratch[i + window - 1]);
+}
+
+void agc_kernel::apply_gains(gr_complex out[],
+                             const gr_complex in[],
+                             const float gains[],
+                             unsigned int n)
+{
+    volk_32fc_32f_multiply_32fc(out, in, gains, n);
+}
+
+void agc_kernel::apply_gains(float out[],
+                             const float in[],
+                             const float gains[],
+                             unsigned int n)
+{
+    volk_32f_x2_multiply_32f(out, in, gains, n);
+}
+
+void agc_kernel::apply_gain(gr_complex out[],
+                            const gr_complex in[],
+                            float gain,
+                            unsigned int n)
+{
+    const float* x = (const float*)in;
+    float* y = (float*)out;
+    for (size_t i = 0; i < 2 * (size_t)n; i++)
+        y[i] = x[i] * gain;
+}
+
+void agc_kernel::apply_gain_ramp(
+    gr_complex out[], const gr_complex in[], float from, float to, unsigned int n)
+{
+    const float* x = (const float*)in;
+    float* y = (float*)out;
+    const float step = (to - from) / n;
+    for (size_t i = 0; i < n; i++) {
+        // an int converts to float in vector registers, a size_t does not
+        const float gain = from + step * (int)(i + 1);
+        y[2 * i] = x[2 * i] * gain;
+        y[2 * i + 1] = x[2 * i + 1] * gain;
+    }
+}
+
+} /* namespace kernel */
+} /* namespace analog */
+} /* namespace gr */
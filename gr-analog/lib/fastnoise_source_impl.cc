@@ -26,6 +26,7 @@
 #endif
 
 #include "fastnoise_source_impl.h"
+#include "noise_fill.h"
 #include <gnuradio/io_signature.h>
 #include <gnuradio/xoroshiro128p.h>
 #include <stdexcept>
@@ -45,21 +46,7 @@ fastnoise_source<T>::make(noise_type_t type, float ampl, long seed, long samples
 template <>
 void fastnoise_source_impl<gr_complex>::generate()
 {
-    int noutput_items = d_samples.size();
-    switch (d_type) {
-    case GR_UNIFORM:
-        for (int i = 0; i < noutput_items; i++)
-            d_samples[i] = gr_complex(d_ampl * ((d_rng.ran1() * 2.0) - 1.0),
-                                      d_ampl * ((d_rng.ran1() * 2.0) - 1.0));
-        break;
-
-    case GR_GAUSSIAN:
-        for (int i = 0; i < noutput_items; i++)
-            d_samples[i] = d_ampl * d_rng.rayleigh_complex();
-        break;
-    default:
-        throw std::runtime_error("invalid type");
-    }
+    fill_noise(d_rng, d_type, d_ampl, d_samples.data(), d_samples.size());
 }
 
 template <class T>
@@ -71,7 +58,8 @@ fastnoise_source_impl<T>::fastnoise_source_impl(noise_type_t type,
                  io_signature::make(0, 0, 0),
                  io_signature::make(1, 1, sizeof(T))),
       d_type(type),
-      d_ampl(ampl)
+      d_ampl(ampl),
+      d_rng(seed)
 {
     d_samples.resize(samples);
     xoroshiro128p_seed(d_state, (uint64_t)seed);
@@ -88,7 +76,8 @@ fastnoise_source_impl<gr_complex>::fastnoise_source_impl(noise_type_t type,
                  io_signature::make(0, 0, 0),
                  io_signature::make(1, 1, sizeof(gr_complex))),
       d_type(type),
-      d_ampl(ampl / sqrtf(2.0f))
+      d_ampl(ampl / sqrtf(2.0f)),
+      d_rng(seed)
 {
     d_samples.resize(samples);
     xoroshiro128p_seed(d_state, (uint64_t)seed);
@@ -128,30 +117,10 @@ void fastnoise_source_impl<gr_complex>::set_amplitude(float ampl)
 template <class T>
 void fastnoise_source_impl<T>::generate()
 {
-    int noutput_items = d_samples.size();
-    switch (d_type) {
-    case GR_UNIFORM:
-        for (int i = 0; i < noutput_items; i++)
-            d_samples[i] = (T)(d_ampl * ((d_rng.ran1() * 2.0) - 1.0));
-        break;
-
-    case GR_GAUSSIAN:
-        for (int i = 0; i < noutput_items; i++)
-            d_samples[i] = (T)(d_ampl * d_rng.gasdev());
-        break;
-
-    case GR_LAPLACIAN:
-        for (int i = 0; i < noutput_items; i++)
-            d_samples[i] = (T)(d_ampl * d_rng.laplacian());
-        break;
-
-    case GR_IMPULSE: // FIXME changeable impulse settings
-        for (int i = 0; i < noutput_items; i++)
-            d_samples[i] = (T)(d_ampl * d_rng.impulse(9));
-        break;
-    default:
-        throw std::runtime_error("invalid type");
-    }
+    std::vector<float> buf(d_samples.size());
+    fill_noise(d_rng, d_type, d_ampl, buf.data(), buf.size());
+    for (size_t i = 0; i < buf.size(); i++)
+        d_samples[i] = (T)buf[i];
 }
 
 
@@ -174,7 +143,9 @@ int fastnoise_source_impl<T>::work(int noutput_items,
 template <class T>
 T fastnoise_source_impl<T>::sample()
 {
-    size_t idx = xoroshiro128p_next(d_state) % d_samples.size();
+    // Scale the top 32 bits to the pool size; avoids a 64-bit division
+    uint64_t r = xoroshiro128p_next(d_state) >> 32;
+    size_t idx = (r * d_samples.size()) >> 32;
     return d_samples[idx];
 }
 
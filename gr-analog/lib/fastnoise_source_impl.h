@@ -25,7 +25,7 @@
 #define FASTNOISE_SOURCE_IMPL_H
 
 #include <gnuradio/analog/fastnoise_source.h>
-#include <gnuradio/random.h>
+#include <gnuradio/bulk_random.h>
 #include <vector>
 
 namespace gr {
@@ -37,7 +37,7 @@ class fastnoise_source_impl : public fastnoise_source<T>
 private:
     noise_type_t d_type;
     float d_ampl;
-    gr::random d_rng;
+    gr::bulk_random d_rng;
     std::vector<T> d_samples;
     uint64_t d_state[2];
 
@@ -25,7 +25,9 @@
 #endif
 
 #include "feedforward_agc_cc_impl.h"
+#include <gnuradio/analog/agc_kernel.h>
 #include <gnuradio/io_signature.h>
+#include <algorithm>
 #include <stdexcept>
 
 namespace gr {
@@ -51,36 +53,30 @@ feedforward_agc_cc_impl::feedforward_agc_cc_impl(int nsamples, float reference)
 
 feedforward_agc_cc_impl::~feedforward_agc_cc_impl() {}
 
-// approximate sqrt(x^2 + y^2)
-inline static float envelope(gr_complex x)
-{
-    float r_abs = std::fabs(x.real());
-    float i_abs = std::fabs(x.imag());
-
-    if (r_abs > i_abs)
-        return r_abs + 0.4 * i_abs;
-    else
-        return i_abs + 0.4 * r_abs;
-}
-
 int feedforward_agc_cc_impl::work(int noutput_items,
                                   gr_vector_const_void_star& input_items,
                                   gr_vector_void_star& output_items)
 {
     const gr_complex* in = (const gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
-    int nsamples = d_nsamples;
-    float gain;
+    const int ninput = noutput_items + d_nsamples - 1;
+
+    if (d_env.size() < (size_t)ninput) {
+        d_env.resize(ninput);
+        d_scratch.resize(ninput);
+        d_gains.resize(ninput);
+    }
+
+    // Peak of the approximate envelope over the window of each output
+    kernel::agc_kernel::envelope(&d_env[0], in, ninput);
+    kernel::agc_kernel::sliding_max(
+        &d_gains[0], &d_scratch[0], &d_env[0], noutput_items, d_nsamples);
 
     for (int i = 0; i < noutput_items; i++) {
-        // float max_env = 1e-12;	// avoid divide by zero
-        float max_env = 1e-4; // avoid divide by zero, indirectly set max gain
-        for (int j = 0; j < nsamples; j++) {
-            max_env = std::max(max_env, envelope(in[i + j]));
-        }
-        gain = d_reference / max_env;
-        out[i] = gain * in[i];
+        // avoid divide by zero, indirectly set max gain
+        d_gains[i] = d_reference / std::max(d_gains[i], 1e-4f);
     }
+    kernel::agc_kernel::apply_gains(out, in, &d_gains[0], noutput_items);
     return noutput_items;
 }
 
@@ -24,6 +24,7 @@
 #define INCLUDED_ANALOG_FEEDFORWARD_AGC_CC_IMPL_H
 
 #include <gnuradio/analog/feedforward_agc_cc.h>
+#include <vector>
 
 namespace gr {
 namespace analog {
@@ -34,6 +35,10 @@ private:
     int d_nsamples;
     float d_reference;
 
+    std::vector<float> d_env;     // envelope of the input and history
+    std::vector<float> d_scratch; // for the sliding maximum
+    std::vector<float> d_gains;
+
 public:
     feedforward_agc_cc_impl(int nsamples, float reference);
     ~feedforward_agc_cc_impl();
@@ -0,0 +1,99 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef NOISE_FILL_H
+#define NOISE_FILL_H
+
+#include <gnuradio/analog/noise_type.h>
+#include <gnuradio/bulk_random.h>
+#include <gnuradio/math.h>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace analog {
+
+/*!
+ * Fills \p out with \p n values of the given noise type, scaled by
+ * \p ampl. Shared by noise_source and fastnoise_source; the Laplacian
+ * and impulse shapes are the transforms gr::random applies.
+ */
+inline void
+fill_noise(gr::bulk_random& rng, noise_type_t type, float ampl, float* out, int n)
+{
+    const float TWO_POW_M24 = 1.0f / 16777216.0f;
+
+    switch (type) {
+    case GR_UNIFORM:
+        rng.fill_uniform(out, n, -ampl, ampl);
+        break;
+
+    case GR_GAUSSIAN:
+        rng.fill_gaussian(out, n, ampl);
+        break;
+
+    // fill_uniform() returns multiples of 2^-24 in [0, 1), which can
+    // be 0; the logs below are taken of values in (0, 1] instead.
+    case GR_LAPLACIAN:
+        rng.fill_uniform(out, n);
+        for (int i = 0; i < n; i++) {
+            float z = out[i];
+            out[i] = ampl * (z >= 0.5f ? -logf(2.0f * (1.0f - z))
+                                       : logf(2.0f * (z + TWO_POW_M24)));
+        }
+        break;
+
+    case GR_IMPULSE: // FIXME changeable impulse settings
+        rng.fill_uniform(out, n);
+        for (int i = 0; i < n; i++) {
+            float z = -GR_M_SQRT2 * logf(out[i] + TWO_POW_M24);
+            out[i] = fabsf(z) <= 9 ? 0.0f : ampl * z;
+        }
+        break;
+
+    default:
+        throw std::runtime_error("invalid type");
+    }
+}
+
+//! Complex variant; \p ampl applies to each of I and Q.
+inline void
+fill_noise(gr::bulk_random& rng, noise_type_t type, float ampl, gr_complex* out, int n)
+{
+    switch (type) {
+    case GR_UNIFORM:
+        rng.fill_uniform(reinterpret_cast<float*>(out), 2 * n, -ampl, ampl);
+        break;
+
+    case GR_GAUSSIAN:
+        rng.fill_complex_gaussian(out, n, ampl);
+        break;
+
+    default:
+        throw std::runtime_error("invalid type");
+    }
+}
+
+} /* namespace analog */
+} /* namespace gr */
+
+#endif /* NOISE_FILL_H */
@@ -26,6 +26,7 @@
 #endif
 
 #include "noise_source_impl.h"
+#include "noise_fill.h"
 #include <gnuradio/io_signature.h>
 #include <stdexcept>
 
@@ -98,37 +99,26 @@ int noise_source_impl<T>::work(int noutput_items,
 
     T* out = (T*)output_items[0];
 
-    switch (d_type) {
-    case GR_UNIFORM:
-        for (int i = 0; i < noutput_items; i++) {
-            out[i] = (T)(d_ampl * ((d_rng.ran1() * 2.0) - 1.0));
-        }
-        break;
-
-    case GR_GAUSSIAN:
-        for (int i = 0; i < noutput_items; i++) {
-            out[i] = (T)(d_ampl * d_rng.gasdev());
-        }
-        break;
-
-    case GR_LAPLACIAN:
-        for (int i = 0; i < noutput_items; i++) {
-            out[i] = (T)(d_ampl * d_rng.laplacian());
-        }
-        break;
-
-    case GR_IMPULSE: // FIXME changeable impulse settings
-        for (int i = 0; i < noutput_items; i++) {
-            out[i] = (T)(d_ampl * d_rng.impulse(9));
-        }
-        break;
-    default:
-        throw std::runtime_error("invalid type");
+    d_buf.resize(noutput_items);
+    fill_noise(d_rng, d_type, d_ampl, &d_buf[0], noutput_items);
+    for (int i = 0; i < noutput_items; i++) {
+        out[i] = (T)d_buf[i];
     }
 
     return noutput_items;
 }
 
+template <>
+int noise_source_impl<float>::work(int noutput_items,
+                                   gr_vector_const_void_star& input_items,
+                                   gr_vector_void_star& output_items)
+{
+    gr::thread::scoped_lock l(this->d_setlock);
+
+    fill_noise(d_rng, d_type, d_ampl, (float*)output_items[0], noutput_items);
+    return noutput_items;
+}
+
 template <>
 int noise_source_impl<gr_complex>::work(int noutput_items,
                                         gr_vector_const_void_star& input_items,
@@ -136,27 +126,7 @@ int noise_source_impl<gr_complex>::work(int noutput_items,
 {
     gr::thread::scoped_lock l(this->d_setlock);
 
-    gr_complex* out = (gr_complex*)output_items[0];
-
-    switch (d_type) {
-
-    case GR_UNIFORM:
-        for (int i = 0; i < noutput_items; i++) {
-            out[i] = gr_complex(d_ampl * ((d_rng.ran1() * 2.0) - 1.0),
-                                d_ampl * ((d_rng.ran1() * 2.0) - 1.0));
-        }
-        break;
-
-    case GR_GAUSSIAN:
-        for (int i = 0; i < noutput_items; i++) {
-            out[i] = d_ampl * d_rng.rayleigh_complex();
-        }
-        break;
-
-    default:
-        throw std::runtime_error("invalid type");
-    }
-
+    fill_noise(d_rng, d_type, d_ampl, (gr_complex*)output_items[0], noutput_items);
     return noutput_items;
 }
 
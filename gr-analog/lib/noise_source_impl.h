@@ -25,7 +25,8 @@
 #define NOISE_SOURCE_IMPL_H
 
 #include <gnuradio/analog/noise_source.h>
-#include <gnuradio/random.h>
+#include <gnuradio/bulk_random.h>
+#include <vector>
 
 namespace gr {
 namespace analog {
@@ -35,7 +36,8 @@ class noise_source_impl : public noise_source<T>
 {
     noise_type_t d_type;
     float d_ampl;
-    gr::random d_rng;
+    gr::bulk_random d_rng;
+    std::vector<float> d_buf;
 
 public:
     noise_source_impl(noise_type_t type, float ampl, long seed = 0);
@@ -29,6 +29,7 @@
 #include <gnuradio/math.h>
 #include <gnuradio/sincos.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace gr {
@@ -98,22 +99,48 @@ int pll_carriertracking_cc_impl::work(int noutput_items,
 
     float error;
     float t_imag, t_real;
-
-    for (int i = 0; i < noutput_items; i++) {
-        gr::sincosf(d_phase, &t_imag, &t_real);
-        optr[i] = iptr[i] * gr_complex(t_real, -t_imag);
-
-        error = phase_detector(iptr[i], d_phase);
-
-        advance_loop(error);
-        phase_wrap();
-        frequency_limit();
-
-        d_locksig = d_locksig * (1.0 - d_alpha) +
-                    d_alpha * (iptr[i].real() * t_real + iptr[i].imag() * t_imag);
-
-        if ((d_squelch_enable) && !lock_detector())
-            optr[i] = 0;
+    const int batch = batch_size();
+    if (d_errors.size() < (size_t)batch)
+        d_errors.resize(batch);
+
+    int i = 0;
+    while (i < noutput_items) {
+        const int n = std::min(batch, noutput_items - i);
+        if (n == 1) {
+            gr::sincosf(d_phase, &t_imag, &t_real);
+            optr[i] = iptr[i] * gr_complex(t_real, -t_imag);
+
+            error = phase_detector(iptr[i], d_phase);
+
+            advance_loop(error);
+            phase_wrap();
+            frequency_limit();
+
+            d_locksig = d_locksig * (1.0 - d_alpha) +
+                        d_alpha * (iptr[i].real() * t_real + iptr[i].imag() * t_imag);
+
+            if ((d_squelch_enable) && !lock_detector())
+                optr[i] = 0;
+            i++;
+            continue;
+        }
+
+        // Rotate by the NCO as it is at the start of the batch; the
+        // phase of each rotated sample is its phase error.
+        derotate(&optr[i], &iptr[i], n);
+        gr::fast_atan2f(&optr[i], &d_errors[0], n);
+
+        for (int k = 0; k < n; k++) {
+            advance_loop(d_errors[k]);
+            phase_wrap();
+            frequency_limit();
+
+            d_locksig = d_locksig * (1.0 - d_alpha) + d_alpha * optr[i + k].real();
+
+            if ((d_squelch_enable) && !lock_detector())
+                optr[i + k] = 0;
+        }
+        i += n;
     }
     return noutput_items;
 }
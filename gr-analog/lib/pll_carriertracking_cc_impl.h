@@ -24,6 +24,7 @@
 #define INCLUDED_ANALOG_PLL_CARRIERTRACKING_CC_IMPL_H
 
 #include <gnuradio/analog/pll_carriertracking_cc.h>
+#include <vector>
 
 namespace gr {
 namespace analog {
@@ -33,6 +34,7 @@ class pll_carriertracking_cc_impl : public pll_carriertracking_cc
 private:
     float d_locksig, d_lock_threshold;
     bool d_squelch_enable;
+    std::vector<float> d_errors; // batch phase errors
 
     float mod_2pi(float in);
     float phase_detector(gr_complex sample, float ref_phase);
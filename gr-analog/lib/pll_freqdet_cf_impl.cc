@@ -28,6 +28,7 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace gr {
@@ -74,16 +75,39 @@ int pll_freqdet_cf_impl::work(int noutput_items,
     float* optr = (float*)output_items[0];
 
     float error;
-    int size = noutput_items;
-
-    while (size-- > 0) {
-        *optr++ = d_freq;
-
-        error = phase_detector(*iptr++, d_phase);
+    const int batch = batch_size();
+    if (d_errors.size() < (size_t)batch) {
+        d_rot.resize(batch);
+        d_errors.resize(batch);
+    }
 
-        advance_loop(error);
-        phase_wrap();
-        frequency_limit();
+    int i = 0;
+    while (i < noutput_items) {
+        const int n = std::min(batch, noutput_items - i);
+        if (n == 1) {
+            optr[i] = d_freq;
+
+            error = phase_detector(iptr[i], d_phase);
+
+            advance_loop(error);
+            phase_wrap();
+            frequency_limit();
+            i++;
+            continue;
+        }
+
+        // Phase errors against the NCO as it is at the start of the batch
+        derotate(&d_rot[0], &iptr[i], n);
+        gr::fast_atan2f(&d_rot[0], &d_errors[0], n);
+
+        for (int k = 0; k < n; k++) {
+            optr[i + k] = d_freq;
+
+            advance_loop(d_errors[k]);
+            phase_wrap();
+            frequency_limit();
+        }
+        i += n;
     }
     return noutput_items;
 }
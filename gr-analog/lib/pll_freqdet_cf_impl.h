@@ -24,6 +24,7 @@
 #define INCLUDED_ANALOG_PLL_FREQDET_CF_IMPL_H
 
 #include <gnuradio/analog/pll_freqdet_cf.h>
+#include <vector>
 
 namespace gr {
 namespace analog {
@@ -31,6 +32,9 @@ namespace analog {
 class pll_freqdet_cf_impl : public pll_freqdet_cf
 {
 private:
+    std::vector<gr_complex> d_rot; // batch input rotated by the NCO
+    std::vector<float> d_errors;   // batch phase errors
+
     float phase_detector(gr_complex sample, float ref_phase);
 
 public:
@@ -29,6 +29,7 @@
 #include <gnuradio/math.h>
 #include <gnuradio/sincos.h>
 #include <math.h>
+#include <algorithm>
 
 namespace gr {
 namespace analog {
@@ -75,17 +76,39 @@ int pll_refout_cc_impl::work(int noutput_items,
 
     float error;
     float t_imag, t_real;
-    int size = noutput_items;
-
-    while (size-- > 0) {
-        gr::sincosf(d_phase, &t_imag, &t_real);
-        *optr++ = gr_complex(t_real, t_imag);
-
-        error = phase_detector(*iptr++, d_phase);
+    const int batch = batch_size();
+    if (d_errors.size() < (size_t)batch) {
+        d_rot.resize(batch);
+        d_errors.resize(batch);
+    }
 
-        advance_loop(error);
-        phase_wrap();
-        frequency_limit();
+    int i = 0;
+    while (i < noutput_items) {
+        const int n = std::min(batch, noutput_items - i);
+        if (n == 1) {
+            gr::sincosf(d_phase, &t_imag, &t_real);
+            optr[i] = gr_complex(t_real, t_imag);
+
+            error = phase_detector(iptr[i], d_phase);
+
+            advance_loop(error);
+            phase_wrap();
+            frequency_limit();
+            i++;
+            continue;
+        }
+
+        // The NCO and the phase errors as it is at the start of the batch
+        nco(&optr[i], n);
+        derotate(&d_rot[0], &iptr[i], n);
+        gr::fast_atan2f(&d_rot[0], &d_errors[0], n);
+
+        for (int k = 0; k < n; k++) {
+            advance_loop(d_errors[k]);
+            phase_wrap();
+            frequency_limit();
+        }
+        i += n;
     }
     return noutput_items;
 }
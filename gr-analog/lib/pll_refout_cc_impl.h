@@ -24,6 +24,7 @@
 #define INCLUDED_ANALOG_PLL_REFOUT_CC_IMPL_H
 
 #include <gnuradio/analog/pll_refout_cc.h>
+#include <vector>
 
 namespace gr {
 namespace analog {
@@ -31,6 +32,9 @@ namespace analog {
 class pll_refout_cc_impl : public pll_refout_cc
 {
 private:
+    std::vector<gr_complex> d_rot; // batch input rotated by the NCO
+    std::vector<float> d_errors;   // batch phase errors
+
     float mod_2pi(float in);
     float phase_detector(gr_complex sample, float ref_phase);
 
@@ -28,10 +28,15 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
 #include <volk/volk.h>
+#include <algorithm>
 
 namespace gr {
 namespace analog {
 
+// Samples per pass: the products stay in L1 between the multiply and
+// the arc tangent.
+static const int CHUNK_SIZE = 512;
+
 quadrature_demod_cf::sptr quadrature_demod_cf::make(float gain)
 {
     return gnuradio::get_initial_sptr(new quadrature_demod_cf_impl(gain));
@@ -41,7 +46,8 @@ quadrature_demod_cf_impl::quadrature_demod_cf_impl(float gain)
     : sync_block("quadrature_demod_cf",
                  io_signature::make(1, 1, sizeof(gr_complex)),
                  io_signature::make(1, 1, sizeof(float))),
-      d_gain(gain)
+      d_gain(gain),
+      d_prod(CHUNK_SIZE)
 {
     const int alignment_multiple = volk_get_alignment() / sizeof(gr_complex);
     set_alignment(std::max(1, alignment_multiple));
@@ -58,10 +64,10 @@ int quadrature_demod_cf_impl::work(int noutput_items,
     gr_complex* in = (gr_complex*)input_items[0];
     float* out = (float*)output_items[0];
 
-    std::vector<gr_complex> tmp(noutput_items);
-    volk_32fc_x2_multiply_conjugate_32fc(&tmp[0], &in[1], &in[0], noutput_items);
-    for (int i = 0; i < noutput_items; i++) {
-        out[i] = d_gain * gr::fast_atan2f(imag(tmp[i]), real(tmp[i]));
+    for (int i = 0; i < noutput_items; i += CHUNK_SIZE) {
+        const int n = std::min(CHUNK_SIZE, noutput_items - i);
+        volk_32fc_x2_multiply_conjugate_32fc(&d_prod[0], &in[i + 1], &in[i], n);
+        gr::fast_atan2f(&d_prod[0], &out[i], n, d_gain);
     }
 
     return noutput_items;
@@ -24,6 +24,7 @@
 #define INCLUDED_ANALOG_QUADRATURE_DEMOD_CF_IMPL_H
 
 #include <gnuradio/analog/quadrature_demod_cf.h>
+#include <vector>
 
 namespace gr {
 namespace analog {
@@ -32,6 +33,7 @@ class quadrature_demod_cf_impl : public quadrature_demod_cf
 {
 private:
     float d_gain;
+    std::vector<gr_complex> d_prod; // per chunk s[n] * conj(s[n-1])
 
 public:
     quadrature_demod_cf_impl(float gain);
@@ -20,6 +20,7 @@
 # Boston, MA 02110-1301, USA.
 #
 
+import random
 
 from gnuradio import gr, gr_unittest, analog, blocks
 
@@ -485,6 +486,33 @@ class test_agc(gr_unittest.TestCase):
         result = [abs(x) for x in dst_data[N-M:]]
         self.assertFloatTuplesAlmostEqual(result, M*[ref,], 4)
 
+    def test_007(self):
+        ''' Test the complex AGC loop with decimated, interpolated updates '''
+        tb = self.tb
+
+        sampling_freq = 100
+        N = int(5*sampling_freq)
+        src1 = analog.sig_source_c(sampling_freq, analog.GR_SIN_WAVE,
+                                   sampling_freq * 0.10, 100)
+        dst1 = blocks.vector_sink_c()
+        head = blocks.head(gr.sizeof_gr_complex, N)
+
+        ref = 1
+        agc = analog.agc3_cc(1e-2, 1e-3, ref, 1, 4)
+        self.assertFalse(agc.interpolate_gain())
+        agc.set_interpolate_gain(True)
+        self.assertTrue(agc.interpolate_gain())
+
+        tb.connect(src1, head)
+        tb.connect(head, agc)
+        tb.connect(agc, dst1)
+
+        tb.run()
+        dst_data = dst1.data()
+        M = 100
+        result = [abs(x) for x in dst_data[N-M:]]
+        self.assertFloatTuplesAlmostEqual(result, M*[ref,], 4)
+
     def test_100(self):
         ''' Test complex feedforward agc with constant input '''
 
@@ -504,6 +532,38 @@ class test_agc(gr_unittest.TestCase):
 
         self.assertComplexTuplesAlmostEqual(expected_result, dst_data, 4)
 
+    def test_101(self):
+        ''' Test complex feedforward agc against a direct computation '''
+
+        length = 16
+        reference = 2.0
+
+        random.seed(0)
+        input_data = [complex(random.uniform(-1, 1), random.uniform(-1, 1))
+                      for i in range(1000)]
+
+        def envelope(x):
+            r, i = abs(x.real), abs(x.imag)
+            return max(r, i) + 0.4 * min(r, i)
+
+        # each output is the oldest sample of its window; the block's
+        # history zero pads the start of the input
+        padded = (length-1)*[0,] + input_data
+        expected_result = []
+        for i in range(len(input_data)):
+            max_env = max([1e-4,] + [envelope(x) for x in padded[i:i+length]])
+            expected_result.append(reference / max_env * padded[i])
+
+        src = blocks.vector_source_c(input_data)
+        agc = analog.feedforward_agc_cc(length, reference)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(src, agc, dst)
+
+        self.tb.run()
+        dst_data = dst.data()
+
+        self.assertComplexTuplesAlmostEqual(expected_result, dst_data, 4)
+
 
 if __name__ == '__main__':
     gr_unittest.run(test_agc, "test_agc.xml")
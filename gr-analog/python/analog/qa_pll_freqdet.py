@@ -159,5 +159,32 @@ class test_pll_freqdet(gr_unittest.TestCase):
 
         self.assertFloatTuplesAlmostEqual(expected_result, dst_data, 3)
 
+    def test_pll_freqdet_block(self):
+        # Block mode tracks the same tone as the per-sample loop
+        sampling_freq = 10e3
+        freq = sampling_freq / 1000
+
+        loop_bw = 2 * math.pi / 1000.0
+        maxf = 1
+        minf = -1
+
+        src = analog.sig_source_c(sampling_freq, analog.GR_COS_WAVE, freq, 1.0)
+        pll = analog.pll_freqdet_cf(loop_bw, maxf, minf)
+        pll.set_block_size(64)
+        self.assertGreater(pll.batch_size(), 1)
+        head = blocks.head(gr.sizeof_float, 4000)
+        dst = blocks.vector_sink_f()
+
+        self.tb.connect(src, pll, head)
+        self.tb.connect(head, dst)
+
+        self.tb.run()
+        dst_data = dst.data()[2000:]
+
+        # convert it from normalized frequency to absolute frequency (Hz)
+        dst_data = [i*(sampling_freq / (2*math.pi)) for i in dst_data]
+
+        self.assertFloatTuplesAlmostEqual(len(dst_data)*[freq,], dst_data, 1)
+
 if __name__ == '__main__':
     gr_unittest.run(test_pll_freqdet, "test_pll_freqdet.xml")
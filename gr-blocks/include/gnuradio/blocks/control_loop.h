@@ -24,6 +24,7 @@
 #define GR_BLOCKS_CONTROL_LOOP
 
 #include <gnuradio/blocks/api.h>
+#include <gnuradio/gr_complex.h>
 
 namespace gr {
 namespace blocks {
@@ -57,6 +58,20 @@ namespace blocks {
  * #frequency_limit to easily keep the phase and frequency
  * estimates within our set bounds (phase_wrap keeps it within
  * +/-2pi).
+ *
+ * Loops normally rotate the input by the NCO, detect the error and
+ * advance the loop one sample at a time, with a sine and cosine per
+ * sample. In block mode (#set_block_size), a loop instead rotates a
+ * batch of samples at once with #derotate, holding the NCO phase and
+ * frequency from the start of the batch, then detects the errors and
+ * advances the loop over the batch. The rotation is vectorized, but
+ * the loop sees each error up to a batch late. That delay costs phase
+ * margin, so #batch_size limits the batch to
+ * max_batch_gain() / alpha samples and falls back to the exact per
+ * sample loop when that is below 2. For the default damping, alpha is
+ * about 2.8 times the loop bandwidth, so a loop bandwidth of 2pi/100
+ * runs sample by sample, 2pi/300 allows batches of up to 4 samples and
+ * 2pi/1000 up to 14.
  */
 class BLOCKS_API control_loop
 {
@@ -65,9 +80,10 @@ protected:
     float d_max_freq, d_min_freq;
     float d_damping, d_loop_bw;
     float d_alpha, d_beta;
+    int d_block_size;
 
 public:
-    control_loop(void) {}
+    control_loop(void) : d_block_size(1) {}
     control_loop(float loop_bw, float max_freq, float min_freq);
     virtual ~control_loop();
 
@@ -116,6 +132,36 @@ public:
      */
     void frequency_limit();
 
+    /*! \brief Number of samples the loop may process as one batch.
+     *
+     * \details
+     * This is the block size, reduced so that the batch delay stays
+     * within max_batch_gain() of the loop gain alpha. A result of 1
+     * means the loop runs sample by sample.
+     */
+    int batch_size() const;
+
+    /*! \brief Rotate a batch of samples by the NCO.
+     *
+     * \details
+     * Sets out[k] = in[k] * exp(-j(phase + k * freq)) for \p n
+     * samples, with the current phase and frequency. \p out may be
+     * the same as \p in. The loop state is not changed.
+     */
+    void derotate(gr_complex* out, const gr_complex* in, int n) const;
+
+    /*! \brief Generate a batch of NCO output.
+     *
+     * \details
+     * Sets out[k] = exp(j(phase + k * freq)) for \p n samples. The
+     * loop state is not changed.
+     */
+    void nco(gr_complex* out, int n) const;
+
+    /*! \brief Largest batch delay, as a multiple of 1/alpha samples.
+     */
+    static float max_batch_gain();
+
     /*******************************************************************
      * SET FUNCTIONS
      *******************************************************************/
@@ -223,6 +269,19 @@ public:
      */
     void set_min_freq(float freq);
 
+    /*!
+     * \brief Set the block size for block mode.
+     *
+     * \details
+     * A block size of 1, the default, runs the loop sample by sample.
+     * A larger size lets the loop rotate up to \p block_size samples
+     * at a time; see batch_size() for how much of it the loop
+     * bandwidth allows.
+     *
+     * \param block_size    (int) new block size, at least 1
+     */
+    void set_block_size(int block_size);
+
     /*******************************************************************
      * GET FUNCTIONS
      *******************************************************************/
@@ -266,6 +325,11 @@ public:
      * \brief Get the control loop's minimum frequency.
      */
     float get_min_freq() const;
+
+    /*!
+     * \brief Get the block size for block mode.
+     */
+    int block_size() const;
 };
 
 // This is a table of tanh(x) for x in [-2, 2] used in tanh_lut.
@@ -33,6 +33,25 @@ namespace blocks {
 /*!
  * \brief Write stream to file.
  * \ingroup file_operators_blk
+ *
+ * \details
+ * By default items are written with stdio from the scheduler thread.
+ * With \p nbuffers > 0 the sink instead copies items into a ring of
+ * \p nbuffers aligned buffers of \p buffer_size bytes each, and full
+ * buffers are written asynchronously through a gr::io_engine
+ * (io_uring where available). A slow or stalling
+ * file system then no longer holds up the flowgraph. If the ring is
+ * full the incoming items are dropped; nitems_dropped() counts them,
+ * and each overflow is reported on the "overflow" message port as a
+ * dict holding the stream \p offset of the first dropped item and the
+ * number of items \p dropped.
+ *
+ * In that mode \p direct_io opens the file for O_DIRECT writes,
+ * bypassing the page cache, and \p preallocate reserves that many
+ * bytes of disk space up front (without changing the file size) so
+ * the file system does not have to allocate while recording. Both
+ * are skipped with a warning where unsupported. set_unbuffered() has
+ * no effect on the asynchronous mode.
  */
 class BLOCKS_API file_sink : virtual public sync_block, virtual public file_sink_base
 {
@@ -46,8 +65,25 @@ public:
      * \param filename name of the file to open and write output to.
      * \param append if true, data is appended to the file instead of
      *        overwriting the initial content.
+     * \param nbuffers number of write buffers; 0 writes synchronously.
+     * \param buffer_size size of each write buffer in bytes (rounded up
+     *        to a multiple of 4096).
+     * \param direct_io write with O_DIRECT (asynchronous mode only).
+     * \param preallocate bytes of disk space to reserve when a file is
+     *        opened (asynchronous mode only).
+     */
+    static sptr make(size_t itemsize,
+                     const char* filename,
+                     bool append = false,
+                     unsigned int nbuffers = 0,
+                     size_t buffer_size = 4 * 1024 * 1024,
+                     bool direct_io = false,
+                     uint64_t preallocate = 0);
+
+    /*!
+     * \brief Number of items dropped because the write buffers were full.
      */
-    static sptr make(size_t itemsize, const char* filename, bool append = false);
+    virtual uint64_t nitems_dropped() = 0;
 };
 
 } /* namespace blocks */
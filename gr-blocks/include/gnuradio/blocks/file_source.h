@@ -29,6 +29,29 @@
 namespace gr {
 namespace blocks {
 
+/*!
+ * \brief How gr::blocks::file_source moves data out of the file.
+ *
+ * \li FILE_IO_STDIO: buffered reads through stdio (the default).
+ * \li FILE_IO_MMAP: copy straight out of the page cache through a
+ *     sliding memory-mapped window with sequential access advice.
+ * \li FILE_IO_MMAP_POPULATE: like FILE_IO_MMAP, but prefault each
+ *     window when it is mapped.
+ * \li FILE_IO_DIRECT: unbuffered (O_DIRECT) aligned reads kept in
+ *     flight ahead of time on a gr::io_engine (io_uring where
+ *     available); meant for fast storage arrays.
+ *
+ * The mmap and direct modes need a regular file. For anything else,
+ * or where the platform lacks support, the source falls back to
+ * FILE_IO_STDIO and logs a warning.
+ */
+enum file_io_mode {
+    FILE_IO_STDIO = 0,
+    FILE_IO_MMAP,
+    FILE_IO_MMAP_POPULATE,
+    FILE_IO_DIRECT,
+};
+
 /*!
  * \brief Read stream from file
  * \ingroup file_operators_blk
@@ -59,12 +82,14 @@ public:
      * \param repeat  repeat file from start
      * \param offset  begin this many items into file
      * \param len     produce only items (offset, offset+len)
+     * \param io_mode how to read the file (see ::file_io_mode)
      */
     static sptr make(size_t itemsize,
                      const char* filename,
                      bool repeat = false,
                      uint64_t offset = 0,
-                     uint64_t len = 0);
+                     uint64_t len = 0,
+                     file_io_mode io_mode = FILE_IO_STDIO);
 
     /*!
      * \brief seek file to \p seek_point relative to \p whence
@@ -77,6 +102,8 @@ public:
     /*!
      * \brief Opens a new file.
      *
+     * The file is read with the io_mode the block was created with.
+     *
      * \param filename        name of the file to source from
      * \param repeat  repeat file from start
      * \param offset  begin this many items into file
@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_BLOCKS_REPACK_BITS_H
+#define INCLUDED_GR_BLOCKS_REPACK_BITS_H
+
+#include <gnuradio/blocks/api.h>
+#include <stdint.h>
+
+namespace gr {
+namespace blocks {
+namespace kernel {
+
+/*!
+ * \brief Unpacks the low \p k bits of each of \p nbytes bytes into
+ * one byte per bit.
+ *
+ * Writes k*nbytes bytes, each 0 or 1, to \p bits; the bits of each
+ * byte are written most significant first if \p msb_first is set,
+ * least significant first otherwise. For k <= 8 every input byte is
+ * a single table lookup.
+ * \ingroup byte_operators_blk
+ */
+BLOCKS_API void unpack_bits(unsigned char* bits,
+                            const unsigned char* bytes,
+                            int nbytes,
+                            unsigned k,
+                            bool msb_first = true);
+
+/*!
+ * \brief Packs k*nbytes bytes, one bit each in the LSB, into \p
+ * nbytes bytes of \p k bits.
+ *
+ * The inverse of unpack_bits(). For k <= 8 the bits of each output
+ * byte are gathered with a single 64 bit multiply.
+ * \ingroup byte_operators_blk
+ */
+BLOCKS_API void pack_bits(unsigned char* bytes,
+                          const unsigned char* bits,
+                          int nbytes,
+                          unsigned k,
+                          bool msb_first = true);
+
+/*!
+ * \brief Regroups a stream of k bit words into l bit words.
+ * \ingroup byte_operators_blk
+ *
+ * \details
+ * Each input word contributes its low k bits to a bit stream and
+ * each output word takes the next l bits of it, for any k and l in
+ * [1, 32]. Input and output words are read and written most
+ * significant bit first or least significant bit first,
+ * independently. Bits that do not fill an output word are held for
+ * the next call.
+ *
+ * Byte unpacking (l == 1) and packing (k == 1) go through
+ * unpack_bits() and pack_bits(); other ratios move a whole word at a
+ * time through a 64 bit accumulator.
+ */
+class BLOCKS_API repack_bits
+{
+public:
+    repack_bits(unsigned k, unsigned l, bool msb_in = true, bool msb_out = true);
+
+    //! Change the word sizes; bits already held are kept.
+    void set_k_and_l(unsigned k, unsigned l);
+    unsigned k() const { return d_k; }
+    unsigned l() const { return d_l; }
+
+    /*!
+     * \brief Repack up to \p ninputs words of \p in into at most \p
+     * noutputs words of \p out.
+     *
+     * Returns the number of words written and sets \p nconsumed to the
+     * number of input words used. An input word is taken whenever fewer
+     * than l bits are held, even after \p noutputs words have been
+     * written, so up to l-1+k bits can be left held (see pending()).
+     */
+    int repack(unsigned char* out,
+               int noutputs,
+               const unsigned char* in,
+               int ninputs,
+               int& nconsumed);
+    int repack(
+        int16_t* out, int noutputs, const int16_t* in, int ninputs, int& nconsumed);
+    int repack(
+        int32_t* out, int noutputs, const int32_t* in, int ninputs, int& nconsumed);
+
+    //! Number of bits held for the next output word.
+    unsigned pending() const { return d_nbits; }
+
+    /*!
+     * \brief Returns the held bits as one output word, padded with
+     * zeros, and clears them.
+     *
+     * Only meaningful when fewer than l bits are pending.
+     */
+    uint32_t flush();
+
+    //! Drops any held bits.
+    void reset();
+
+private:
+    unsigned d_k;
+    unsigned d_l;
+    bool d_msb_in;
+    bool d_msb_out;
+    uint64_t d_acc;   // held bits, in the low d_nbits bits
+    unsigned d_nbits; // number of held bits
+
+    template <class IN_T, class OUT_T>
+    int repack_words(
+        OUT_T* out, int noutputs, const IN_T* in, int ninputs, int& nconsumed);
+};
+
+} /* namespace kernel */
+} /* namespace blocks */
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_BLOCKS_REPACK_BITS_H */
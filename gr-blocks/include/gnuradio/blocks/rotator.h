@@ -25,42 +25,86 @@
 
 #include <gnuradio/blocks/api.h>
 #include <gnuradio/gr_complex.h>
+#include <gnuradio/math.h>
 #include <volk/volk.h>
+#include <algorithm>
 #include <cmath>
 
 namespace gr {
 namespace blocks {
 
+/*!
+ * \brief Rotates complex samples by a steadily advancing phase.
+ *
+ * \details
+ * The phase is advanced by complex multiplication. To keep rounding
+ * from accumulating, it is recomputed exactly from a double-precision
+ * angle every RESYNC samples, so the output phase stays locked to
+ * n * increment over arbitrarily long runs. rotateN() hands each
+ * stretch between resynchronizations to VOLK, whose kernels step
+ * several consecutive phases in parallel SIMD lanes.
+ */
 class rotator
 {
 private:
     gr_complex d_phase;
     gr_complex d_phase_incr;
-    unsigned int d_counter;
+    unsigned int d_counter; // samples since the last resynchronization
+    double d_base;          // phase, in radians, at the last resynchronization
+    double d_incr;          // radians per sample
+
+    enum { RESYNC = 512 };
+
+    void resync()
+    {
+        d_base = std::fmod(d_base + d_counter * d_incr, 2 * GR_M_PI);
+        d_counter = 0;
+        d_phase = gr_complex(std::cos(d_base), std::sin(d_base));
+    }
 
 public:
-    rotator() : d_phase(1), d_phase_incr(1), d_counter(0) {}
+    rotator() : d_phase(1), d_phase_incr(1), d_counter(0), d_base(0), d_incr(0) {}
 
-    void set_phase(gr_complex phase) { d_phase = phase / std::abs(phase); }
-    void set_phase_incr(gr_complex incr) { d_phase_incr = incr / std::abs(incr); }
+    void set_phase(gr_complex phase)
+    {
+        d_phase = phase / std::abs(phase);
+        d_base = std::arg(std::complex<double>(phase));
+        d_counter = 0;
+    }
 
-    gr_complex rotate(gr_complex in)
+    void set_phase_incr(gr_complex incr)
     {
-        d_counter++;
+        resync(); // the samples so far went at the old increment
+        d_phase_incr = incr / std::abs(incr);
+        d_incr = std::arg(std::complex<double>(d_phase_incr));
+    }
 
+    gr_complex rotate(gr_complex in)
+    {
         gr_complex z = in * d_phase; // rotate in by phase
         d_phase *= d_phase_incr;     // incr our phase (complex mult == add phases)
 
-        if ((d_counter % 512) == 0)
-            d_phase /=
-                std::abs(d_phase); // Normalize to ensure multiplication is rotation
+        if (++d_counter == RESYNC)
+            resync();
 
         return z;
     }
 
+    /*!
+     * \brief Rotate \p n samples; \p out may be the same as \p in.
+     */
     void rotateN(gr_complex* out, const gr_complex* in, int n)
     {
-        volk_32fc_s32fc_x2_rotator_32fc(out, in, d_phase_incr, &d_phase, n);
+        while (n > 0) {
+            int m = std::min<int>(n, RESYNC - d_counter);
+            volk_32fc_s32fc_x2_rotator_32fc(out, in, d_phase_incr, &d_phase, m);
+            out += m;
+            in += m;
+            n -= m;
+            d_counter += m;
+            if (d_counter == RESYNC)
+                resync();
+        }
     }
 };
 
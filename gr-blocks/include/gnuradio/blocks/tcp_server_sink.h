@@ -29,6 +29,21 @@
 namespace gr {
 namespace blocks {
 
+/*!
+ * \brief What tcp_server_sink does when a client falls behind.
+ *
+ * \li TCP_OVERFLOW_BLOCK: wait for the client; the slowest client sets
+ *     the pace of the flowgraph (the historical behaviour).
+ * \li TCP_OVERFLOW_DROP_OLDEST: discard the oldest data queued for
+ *     that client to make room.
+ * \li TCP_OVERFLOW_DISCONNECT: close that client's connection.
+ */
+enum tcp_overflow_policy {
+    TCP_OVERFLOW_BLOCK = 0,
+    TCP_OVERFLOW_DROP_OLDEST,
+    TCP_OVERFLOW_DISCONNECT
+};
+
 /*!
  * \brief Send stream through a TCP socket.
  * \ingroup networking_tools_blk
@@ -37,6 +52,17 @@ namespace blocks {
  * Listen for incoming TCP connection(s). Duplicate data for each
  * opened connection. Optionally can wait until first client connects
  * before streaming starts.
+ *
+ * Every client has its own queue of up to \p buffer_size bytes that
+ * is written out asynchronously, so clients are served independently
+ * of each other and of work(). The \p policy decides what happens
+ * when a queue is full; with anything but TCP_OVERFLOW_BLOCK a slow
+ * client can never hold up the flowgraph. Data is always dropped in
+ * whole items.
+ *
+ * On stop, clients get about a second to take what is queued for
+ * them; under any policy, those that have not by then are
+ * disconnected.
  */
 class BLOCKS_API tcp_server_sink : virtual public gr::sync_block
 {
@@ -54,9 +80,30 @@ public:
      *                     streaming starts. In non blocking mode
      *                     (noblock=true), drop data onto floor if no client
      *                     is connected.
+     * \param policy       What to do with a client whose queue is full.
+     * \param buffer_size  Bytes queued per client at most.
      */
-    static sptr
-    make(size_t itemsize, const std::string& host, int port, bool noblock = false);
+    static sptr make(size_t itemsize,
+                     const std::string& host,
+                     int port,
+                     bool noblock = false,
+                     tcp_overflow_policy policy = TCP_OVERFLOW_BLOCK,
+                     size_t buffer_size = 4 * 1024 * 1024);
+
+    //! Number of connected clients.
+    virtual int num_clients() = 0;
+
+    /*!
+     * \brief Statistics for each connected client.
+     *
+     * Returns a list holding one dict per client with the keys
+     * "address" (string), "bytes_sent", "bytes_dropped" and
+     * "bytes_queued" (uint64).
+     */
+    virtual pmt::pmt_t client_stats() = 0;
+
+    //! Clients disconnected for falling behind, or at stop, so far.
+    virtual uint64_t clients_dropped() = 0;
 };
 
 } /* namespace blocks */
@@ -29,9 +29,32 @@
 namespace gr {
 namespace blocks {
 
+/*!
+ * \brief Header carried at the start of each datagram received by
+ * udp_source; it is stripped from the output.
+ *
+ * \li UDP_HEADER_NONE: the datagram is all payload.
+ * \li UDP_HEADER_SEQNUM64: 64-bit packet counter in little-endian
+ *     byte order, as written by most PC-based streamers.
+ * \li UDP_HEADER_SEQNUM32_BE: 32-bit packet counter in network byte
+ *     order.
+ */
+enum udp_header_type { UDP_HEADER_NONE = 0, UDP_HEADER_SEQNUM64, UDP_HEADER_SEQNUM32_BE };
+
 /*!
  * \brief Read stream from an UDP socket.
  * \ingroup networking_tools_blk
+ *
+ * \details
+ * Datagrams are drained from the socket in batches (recvmmsg where
+ * available) into a ring of packet buffers that work() copies from.
+ *
+ * Lost packets are not passed over silently. With a sequence number
+ * \p header, a jump in the counter marks how many packets the network
+ * or the kernel dropped; without one, only packets dropped here
+ * because the ring was full can be counted. Either way the first item
+ * after the gap carries a "udp_gap" tag whose value (uint64) is the
+ * number of packets missing, and packets_lost() keeps the total.
  */
 class BLOCKS_API udp_source : virtual public sync_block
 {
@@ -51,12 +74,21 @@ public:
      * \param payload_size UDP payload size by default set to 1472 =
      *                     (1500 MTU - (8 byte UDP header) - (20 byte IP header))
      * \param eof          Interpret zero-length packet as EOF (default: true)
+     * \param header       Sequence number header in front of each payload
+     *                     (counted in \p payload_size)
+     * \param rcvbuf_size  Socket receive buffer (SO_RCVBUF) in bytes, or 0 to
+     *                     keep the system default
+     * \param busy_poll_us Busy-poll the device for this many microseconds on
+     *                     receive (SO_BUSY_POLL, Linux), or 0 to not
      */
     static sptr make(size_t itemsize,
                      const std::string& host,
                      int port,
                      int payload_size = 1472,
-                     bool eof = true);
+                     bool eof = true,
+                     udp_header_type header = UDP_HEADER_NONE,
+                     int rcvbuf_size = 0,
+                     int busy_poll_us = 0);
 
     /*! \brief Change the connection to a new destination
      *
@@ -77,6 +109,12 @@ public:
 
     /*! \brief return the port number of the socket */
     virtual int get_port() = 0;
+
+    /*! \brief Number of packets received so far */
+    virtual uint64_t packets_received() = 0;
+
+    /*! \brief Number of packets found missing so far */
+    virtual uint64_t packets_lost() = 0;
 };
 
 } /* namespace blocks */
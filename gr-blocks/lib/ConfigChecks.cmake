@@ -76,3 +76,33 @@ CHECK_CXX_SOURCE_COMPILES("
     " HAVE_COSF
 )
 GR_ADD_COND_DEF(HAVE_COSF)
+
+########################################################################
+CHECK_CXX_SOURCE_COMPILES("
+    #include <sys/mman.h>
+    int main(){mmap(0, 0, 0, 0, 0, 0); madvise(0, 0, 0); return 0;}
+    " HAVE_MMAP
+)
+GR_ADD_COND_DEF(HAVE_MMAP)
+
+CHECK_CXX_SOURCE_COMPILES("
+    #include <unistd.h>
+    int main(){char c; pread(0, &c, 1, 0); return 0;}
+    " HAVE_PREAD
+)
+GR_ADD_COND_DEF(HAVE_PREAD)
+
+CHECK_CXX_SOURCE_COMPILES("
+    #include <fcntl.h>
+    int main(){fallocate(0, FALLOC_FL_KEEP_SIZE, 0, 0); return 0;}
+    " HAVE_FALLOCATE
+)
+GR_ADD_COND_DEF(HAVE_FALLOCATE)
+
+########################################################################
+CHECK_CXX_SOURCE_COMPILES("
+    #include <sys/socket.h>
+    int main(){recvmmsg(0, 0, 0, 0, 0); return 0;}
+    " HAVE_RECVMMSG
+)
+GR_ADD_COND_DEF(HAVE_RECVMMSG)
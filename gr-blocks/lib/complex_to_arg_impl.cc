@@ -56,10 +56,7 @@ int complex_to_arg_impl::work(int noutput_items,
     int noi = noutput_items * d_vlen;
 
     // The fast_atan2f is faster than Volk
-    for (int i = 0; i < noi; i++) {
-        //    out[i] = std::arg (in[i]);
-        out[i] = gr::fast_atan2f(in[i]);
-    }
+    gr::fast_atan2f(in, out, noi);
 
     return noutput_items;
 }
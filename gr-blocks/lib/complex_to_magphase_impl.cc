@@ -59,10 +59,7 @@ int complex_to_magphase_impl::work(int noutput_items,
     volk_32fc_magnitude_32f_u(out0, in, noi);
 
     // The fast_atan2f is faster than Volk
-    for (int i = 0; i < noi; i++) {
-        //    out[i] = std::arg (in[i]);
-        out1[i] = gr::fast_atan2f(in[i]);
-    }
+    gr::fast_atan2f(in, out1, noi);
 
     return noutput_items;
 }
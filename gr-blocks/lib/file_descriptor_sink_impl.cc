@@ -51,35 +51,76 @@ file_descriptor_sink_impl::file_descriptor_sink_impl(size_t itemsize, int fd)
                  io_signature::make(1, 1, itemsize),
                  io_signature::make(0, 0, 0)),
       d_itemsize(itemsize),
-      d_fd(fd)
+      d_fd(fd),
+      d_engine(io_engine::make(1)),
+      d_busy(0)
 {
 }
 
-file_descriptor_sink_impl::~file_descriptor_sink_impl() { close(d_fd); }
+file_descriptor_sink_impl::~file_descriptor_sink_impl()
+{
+    finish_write();
+    close(d_fd);
+}
+
+bool file_descriptor_sink_impl::stop()
+{
+    finish_write();
+    return true;
+}
+
+/*
+ * Waits for the write in flight, pushing out the rest after a short
+ * write. Returns false, having reported it, if the write failed.
+ */
+bool file_descriptor_sink_impl::finish_write()
+{
+    size_t written = 0;
+    while (d_busy > 0) {
+        d_engine->wait(&d_req);
+        int64_t r = d_req.result;
+        if (r == -EINTR) {
+            r = 0;
+        } else if (r < 0) {
+            errno = -r;
+            perror("file_descriptor_sink");
+            d_busy = 0;
+            return false;
+        }
+
+        written += r;
+        if (written == d_busy) {
+            d_busy = 0;
+            break;
+        }
+        d_req.buf = &d_buf[written];
+        d_req.len = d_busy - written;
+        io_engine::request* req = &d_req;
+        d_engine->submit(&req, 1);
+    }
+    return true;
+}
 
 int file_descriptor_sink_impl::work(int noutput_items,
                                     gr_vector_const_void_star& input_items,
                                     gr_vector_void_star& output_items)
 {
-    char* inbuf = (char*)input_items[0];
-    unsigned long byte_size = noutput_items * d_itemsize;
-
-    while (byte_size > 0) {
-        ssize_t r;
-
-        r = write(d_fd, inbuf, byte_size);
-        if (r == -1) {
-            if (errno == EINTR)
-                continue;
-            else {
-                perror("file_descriptor_sink");
-                return -1; // indicate we're done
-            }
-        } else {
-            byte_size -= r;
-            inbuf += r;
-        }
-    }
+    const char* inbuf = (const char*)input_items[0];
+    const size_t byte_size = noutput_items * d_itemsize;
+
+    if (!finish_write())
+        return -1; // indicate we're done
+
+    d_buf.assign(inbuf, inbuf + byte_size);
+    d_busy = byte_size;
+
+    d_req.op = io_engine::OP_WRITE;
+    d_req.fd = d_fd;
+    d_req.buf = &d_buf[0];
+    d_req.len = byte_size;
+    d_req.offset = io_engine::CURRENT_POSITION;
+    io_engine::request* req = &d_req;
+    d_engine->submit(&req, 1);
 
     return noutput_items;
 }
@@ -24,6 +24,8 @@
 #define INCLUDED_GR_FILE_DESCRIPTOR_SINK_IMPL_H
 
 #include <gnuradio/blocks/file_descriptor_sink.h>
+#include <gnuradio/io_engine.h>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -34,10 +36,21 @@ private:
     size_t d_itemsize;
     int d_fd;
 
+    // The write of the previous call's input runs while the next
+    // input is produced
+    io_engine::sptr d_engine;
+    io_engine::request d_req;
+    std::vector<char> d_buf;
+    size_t d_busy; // bytes of d_buf being written, 0 if none
+
+    bool finish_write();
+
 public:
     file_descriptor_sink_impl(size_t itemsize, int fd);
     ~file_descriptor_sink_impl();
 
+    bool stop();
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items);
@@ -32,6 +32,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <cstdio>
 #include <stdexcept>
 
@@ -42,6 +43,9 @@
 namespace gr {
 namespace blocks {
 
+// Bytes read ahead at a time
+static const size_t s_buffer_size = 64 * 1024;
+
 file_descriptor_source::sptr
 file_descriptor_source::make(size_t itemsize, int fd, bool repeat)
 {
@@ -58,53 +62,86 @@ file_descriptor_source_impl::file_descriptor_source_impl(size_t itemsize,
       d_itemsize(itemsize),
       d_fd(fd),
       d_repeat(repeat),
-      d_residue(new unsigned char[itemsize]),
-      d_residue_len(0)
+      d_engine(io_engine::make(1)),
+      d_buf(std::max<size_t>(1, s_buffer_size / itemsize) * itemsize),
+      d_head(0),
+      d_tail(0),
+      d_reading(false)
 {
 }
 
 file_descriptor_source_impl::~file_descriptor_source_impl()
 {
+    if (d_reading)
+        d_engine->wait(&d_req);
     close(d_fd);
-    delete[] d_residue;
 }
 
-int file_descriptor_source_impl::read_items(char* buf, int nitems)
+void file_descriptor_source_impl::start_read()
 {
-    assert(nitems > 0);
-    assert(d_residue_len < d_itemsize);
+    // Keep the partial item, if any, at the front
+    if (d_head > 0) {
+        memmove(&d_buf[0], &d_buf[d_head], d_tail - d_head);
+        d_tail -= d_head;
+        d_head = 0;
+    }
 
-    int nbytes_read = 0;
+    d_req.op = io_engine::OP_READ;
+    d_req.fd = d_fd;
+    d_req.buf = &d_buf[d_tail];
+    d_req.len = d_buf.size() - d_tail;
+    d_req.offset = io_engine::CURRENT_POSITION;
+    io_engine::request* req = &d_req;
+    d_engine->submit(&req, 1);
+    d_reading = true;
+}
 
-    if (d_residue_len > 0) {
-        memcpy(buf, d_residue, d_residue_len);
-        nbytes_read = d_residue_len;
-        d_residue_len = 0;
-    }
+/*
+ * Waits for the read in flight and returns its result: bytes read, 0
+ * at end of file, or -1 with errno set.
+ */
+int file_descriptor_source_impl::finish_read()
+{
+    d_engine->wait(&d_req);
+    d_reading = false;
 
-    int r = read(d_fd, buf + nbytes_read, nitems * d_itemsize - nbytes_read);
-    if (r <= 0) {
-        handle_residue(buf, nbytes_read);
-        return r;
+    if (d_req.result < 0) {
+        errno = -d_req.result;
+        return -1;
     }
+    d_tail += d_req.result;
+    return d_req.result;
+}
 
-    r = handle_residue(buf, r + nbytes_read);
+int file_descriptor_source_impl::read_items(char* buf, int nitems)
+{
+    assert(nitems > 0);
+
+    if (d_tail - d_head < d_itemsize) {
+        if (!d_reading)
+            start_read();
+
+        int r = finish_read();
+        if (r <= 0)
+            return r;
 
-    if (r == 0) // block until we get something
-        return read_items(buf, nitems);
+        if (d_tail - d_head < d_itemsize) // block until we get something
+            return read_items(buf, nitems);
+    }
 
-    return r;
+    return handle_residue(buf, std::min<size_t>(nitems * d_itemsize, d_tail - d_head));
 }
 
+/*
+ * Outputs the whole items in the first nbytes_read buffered bytes; a
+ * partial item stays buffered until the rest of it is read.
+ */
 int file_descriptor_source_impl::handle_residue(char* buf, int nbytes_read)
 {
     assert(nbytes_read >= 0);
     int nitems_read = nbytes_read / d_itemsize;
-    d_residue_len = nbytes_read % d_itemsize;
-    if (d_residue_len > 0) {
-        // fprintf (stderr, "handle_residue: %d\n", d_residue_len);
-        memcpy(d_residue, buf + nbytes_read - d_residue_len, d_residue_len);
-    }
+    memcpy(buf, &d_buf[d_head], nitems_read * d_itemsize);
+    d_head += nitems_read * d_itemsize;
     return nitems_read;
 }
 
@@ -146,6 +183,13 @@ int file_descriptor_source_impl::work(int noutput_items,
     if (nread == 0) // EOF
         return -1;
 
+    // Read ahead while reads come back full, i.e. while the data is
+    // there. After a short read the writer is idle; the next call then
+    // waits for it as a plain read() would, and no read is left
+    // pending when the flowgraph stops.
+    if (!d_reading && d_req.result == (int64_t)d_req.len)
+        start_read();
+
     return nread;
 }
 
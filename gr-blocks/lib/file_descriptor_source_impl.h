@@ -24,6 +24,8 @@
 #define INCLUDED_GR_FILE_DESCRIPTOR_SOURCE_IMPL_H
 
 #include <gnuradio/blocks/file_descriptor_source.h>
+#include <gnuradio/io_engine.h>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -35,13 +37,22 @@ private:
     int d_fd;
     bool d_repeat;
 
-    unsigned char* d_residue;
-    unsigned long d_residue_len;
+    // Bytes read but not yet output, at d_buf[d_head, d_tail); a
+    // partial item waits there for the rest of it.
+    io_engine::sptr d_engine;
+    io_engine::request d_req;
+    std::vector<char> d_buf;
+    size_t d_head;
+    size_t d_tail;
+    bool d_reading; // d_req is in flight
+
+    void start_read();
+    int finish_read();
 
 protected:
     int read_items(char* buf, int nitems);
     int handle_residue(char* buf, int nbytes_read);
-    void flush_residue() { d_residue_len = 0; }
+    void flush_residue() { d_head = d_tail = 0; }
 
 public:
     file_descriptor_source_impl(size_t itemsize, int fd, bool repeat);
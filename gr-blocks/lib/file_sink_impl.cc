@@ -26,34 +26,141 @@
 
 #include "file_sink_impl.h"
 #include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <algorithm>
 #include <stdexcept>
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_IO_H
+#include <io.h>
+#endif
+
 namespace gr {
 namespace blocks {
 
-file_sink::sptr file_sink::make(size_t itemsize, const char* filename, bool append)
+// Alignment of the write buffers, their sizes and, with O_DIRECT, of
+// the file offsets written to
+static const size_t s_write_align = 4096;
+
+file_sink::sptr file_sink::make(size_t itemsize,
+                                const char* filename,
+                                bool append,
+                                unsigned int nbuffers,
+                                size_t buffer_size,
+                                bool direct_io,
+                                uint64_t preallocate)
 {
-    return gnuradio::get_initial_sptr(new file_sink_impl(itemsize, filename, append));
+    return gnuradio::get_initial_sptr(new file_sink_impl(
+        itemsize, filename, append, nbuffers, buffer_size, direct_io, preallocate));
 }
 
-file_sink_impl::file_sink_impl(size_t itemsize, const char* filename, bool append)
+file_sink_impl::file_sink_impl(size_t itemsize,
+                               const char* filename,
+                               bool append,
+                               unsigned int nbuffers,
+                               size_t buffer_size,
+                               bool direct_io,
+                               uint64_t preallocate)
     : sync_block(
           "file_sink", io_signature::make(1, 1, itemsize), io_signature::make(0, 0, 0)),
       file_sink_base(filename, true, append),
-      d_itemsize(itemsize)
+      d_itemsize(itemsize),
+      d_buffer_size(0),
+      d_direct_io(direct_io),
+      d_preallocate(preallocate),
+      d_head(0),
+      d_count(0),
+      d_fd(-1),
+      d_direct(false),
+      d_offset(0),
+      d_errno(0),
+      d_dropped(0),
+      d_overflow_offset(0),
+      d_overflow_count(0),
+      d_overflow_port(pmt::mp("overflow"))
+{
+    message_port_register_out(d_overflow_port);
+
+    if (nbuffers > 0) {
+        if (buffer_size < itemsize)
+            throw std::invalid_argument("file_sink: buffer_size smaller than an item");
+
+        d_buffer_size = (buffer_size + s_write_align - 1) / s_write_align * s_write_align;
+        d_ring.resize(nbuffers);
+        std::vector<void*> bufs;
+        for (size_t i = 0; i < d_ring.size(); i++) {
+            d_ring[i].data = (char*)volk_malloc(d_buffer_size, s_write_align);
+            d_ring[i].len = 0;
+            d_ring[i].direct = false;
+            if (!d_ring[i].data) {
+                for (size_t j = 0; j < i; j++)
+                    volk_free(d_ring[j].data);
+                throw std::bad_alloc();
+            }
+            bufs.push_back(d_ring[i].data);
+        }
+
+        d_engine = io_engine::make(nbuffers);
+        d_engine->register_buffers(bufs, d_buffer_size);
+    }
+}
+
+file_sink_impl::~file_sink_impl()
 {
+    if (!d_ring.empty())
+        drain();
+    for (size_t i = 0; i < d_ring.size(); i++)
+        volk_free(d_ring[i].data);
 }
 
-file_sink_impl::~file_sink_impl() {}
+bool file_sink_impl::stop()
+{
+    if (!d_ring.empty()) {
+        drain();
+        report_overflow();
+    }
+    return true;
+}
+
+uint64_t file_sink_impl::nitems_dropped()
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    return d_dropped;
+}
 
 int file_sink_impl::work(int noutput_items,
                          gr_vector_const_void_star& input_items,
                          gr_vector_void_star& output_items)
 {
-    char* inbuf = (char*)input_items[0];
-    int nwritten = 0;
+    const char* inbuf = (const char*)input_items[0];
+
+    if (d_ring.empty()) {
+        do_update(); // update d_fp is reqd
+        return sync_work(noutput_items, inbuf);
+    }
 
+    // Everything queued so far belongs to the old file
+    bool updated = d_updated;
+    if (updated)
+        drain();
     do_update(); // update d_fp is reqd
+    if (updated)
+        setup_fd();
+
+    if (!d_fp)
+        return noutput_items; // drop output on the floor
+
+    return async_work(noutput_items, inbuf);
+}
+
+int file_sink_impl::sync_work(int noutput_items, const char* inbuf)
+{
+    int nwritten = 0;
 
     if (!d_fp)
         return noutput_items; // drop output on the floor
@@ -79,5 +186,199 @@ int file_sink_impl::work(int noutput_items,
     return nwritten;
 }
 
+int file_sink_impl::async_work(int noutput_items, const char* inbuf)
+{
+    // Retire whatever has finished without waiting for the rest
+    while (d_count > 0 && d_engine->poll(&d_ring[d_head].req))
+        complete_head();
+
+    if (d_errno) {
+        std::stringstream s;
+        s << "file_sink write failed: " << strerror(d_errno) << std::endl;
+        throw std::runtime_error(s.str());
+    }
+
+    // Only whole items are taken
+    size_t space = 0;
+    if (d_count < d_ring.size())
+        space = (d_ring.size() - d_count) * d_buffer_size -
+                d_ring[(d_head + d_count) % d_ring.size()].len;
+    int nitems = std::min<size_t>(noutput_items, space / d_itemsize);
+
+    if (nitems > 0 && d_overflow_count > 0)
+        report_overflow();
+
+    size_t nbytes = nitems * d_itemsize;
+    while (nbytes) {
+        write_buffer& b = d_ring[(d_head + d_count) % d_ring.size()];
+        size_t n = std::min(nbytes, d_buffer_size - b.len);
+        memcpy(b.data + b.len, inbuf, n);
+        b.len += n;
+        inbuf += n;
+        nbytes -= n;
+        if (b.len == d_buffer_size)
+            submit_fill();
+    }
+
+    if (nitems < noutput_items) {
+        if (d_overflow_count == 0)
+            d_overflow_offset = nitems_read(0) + nitems;
+        d_overflow_count += noutput_items - nitems;
+
+        gr::thread::scoped_lock lock(d_mutex);
+        d_dropped += noutput_items - nitems;
+    }
+
+    return noutput_items;
+}
+
+void file_sink_impl::submit_fill()
+{
+    const size_t i = (d_head + d_count) % d_ring.size();
+    write_buffer& b = d_ring[i];
+    if (b.len == 0)
+        return;
+
+    // O_DIRECT needs whole blocks; only the last buffer before a
+    // close or file switch is short.
+    if (d_direct && b.len % s_write_align) {
+        while (d_count > 0)
+            complete_head();
+        set_direct(false);
+    }
+
+    b.direct = d_direct;
+    b.req.op = io_engine::OP_WRITE;
+    b.req.fd = d_fd;
+    b.req.buf = b.data;
+    b.req.len = b.len;
+    b.req.offset = d_offset;
+    b.req.buf_index = i;
+    d_offset += b.len;
+
+    io_engine::request* req = &b.req;
+    d_engine->submit(&req, 1);
+    d_count++;
+}
+
+void file_sink_impl::complete_head()
+{
+    write_buffer& b = d_ring[d_head];
+
+    size_t written = 0;
+    while (true) {
+        d_engine->wait(&b.req);
+        int64_t r = b.req.result;
+        if (r == -EINVAL && b.direct) {
+            if (d_direct) {
+                GR_LOG_WARN(d_logger, "O_DIRECT write rejected, writing buffered");
+                set_direct(false);
+            }
+            b.direct = false;
+            r = 0;
+        } else if (r <= 0) {
+            d_errno = r < 0 ? -r : EIO;
+            break;
+        }
+
+        // Short write; push out the rest
+        written += r;
+        if (written == b.len)
+            break;
+        b.req.buf = b.data + written;
+        b.req.len = b.len - written;
+        b.req.offset += r;
+        io_engine::request* req = &b.req;
+        d_engine->submit(&req, 1);
+    }
+
+    b.len = 0;
+    d_head = (d_head + 1) % d_ring.size();
+    d_count--;
+}
+
+void file_sink_impl::drain()
+{
+    submit_fill();
+    while (d_count > 0)
+        complete_head();
+}
+
+void file_sink_impl::report_overflow()
+{
+    if (d_overflow_count == 0)
+        return;
+    const uint64_t offset = d_overflow_offset;
+    const uint64_t count = d_overflow_count;
+    d_overflow_count = 0;
+
+    GR_LOG_WARN(d_logger,
+                boost::format("write buffers full, dropped %1% items at offset %2%") %
+                    count % offset);
+
+    pmt::pmt_t msg = pmt::make_dict();
+    msg = pmt::dict_add(msg, pmt::mp("offset"), pmt::from_uint64(offset));
+    msg = pmt::dict_add(msg, pmt::mp("dropped"), pmt::from_uint64(count));
+    message_port_pub(d_overflow_port, msg);
+}
+
+void file_sink_impl::setup_fd()
+{
+    d_fd = d_fp ? fileno(d_fp) : -1;
+    d_direct = false;
+    if (d_fd < 0)
+        return;
+
+    off_t end = lseek(d_fd, 0, SEEK_END);
+    d_offset = end;
+
+#ifdef F_SETFL
+    // Writes complete in any order, so they go to explicit offsets
+    // rather than relying on O_APPEND.
+    int flags = fcntl(d_fd, F_GETFL);
+    if (flags >= 0 && (flags & O_APPEND))
+        fcntl(d_fd, F_SETFL, flags & ~O_APPEND);
+#endif
+
+#ifdef HAVE_FALLOCATE
+    if (d_preallocate > 0 &&
+        fallocate(d_fd, FALLOC_FL_KEEP_SIZE, end, d_preallocate) != 0) {
+        GR_LOG_WARN(d_logger,
+                    boost::format("could not preallocate file: %s") % strerror(errno));
+    }
+#else
+    if (d_preallocate > 0) {
+        GR_LOG_WARN(d_logger, "preallocation not supported here");
+    }
+#endif
+
+    if (d_direct_io) {
+        if (end % s_write_align) {
+            GR_LOG_WARN(d_logger, "file end not aligned, not using O_DIRECT");
+        } else {
+            set_direct(true);
+        }
+    }
+}
+
+void file_sink_impl::set_direct(bool direct)
+{
+#ifdef O_DIRECT
+    int flags = fcntl(d_fd, F_GETFL);
+    if (flags >= 0)
+        flags = direct ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+    if (flags < 0 || fcntl(d_fd, F_SETFL, flags) != 0) {
+        GR_LOG_WARN(d_logger,
+                    boost::format("could not change O_DIRECT: %s") % strerror(errno));
+        direct = false;
+    }
+    d_direct = direct;
+#else
+    if (direct) {
+        GR_LOG_WARN(d_logger, "O_DIRECT not supported here");
+    }
+#endif
+}
+
 } /* namespace blocks */
 } /* namespace gr */
@@ -24,6 +24,9 @@
 #define INCLUDED_GR_FILE_SINK_IMPL_H
 
 #include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/io_engine.h>
+#include <gnuradio/thread/thread.h>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -31,12 +34,57 @@ namespace blocks {
 class file_sink_impl : public file_sink
 {
 private:
+    struct write_buffer {
+        char* data;
+        size_t len;
+        bool direct; // written with O_DIRECT set
+        io_engine::request req;
+    };
+
     size_t d_itemsize;
 
+    // Asynchronous mode; the ring is empty when writing synchronously
+    size_t d_buffer_size;
+    bool d_direct_io;
+    uint64_t d_preallocate;
+    std::vector<write_buffer> d_ring;
+    size_t d_head;     // oldest buffer being written
+    size_t d_count;    // buffers being written
+    int d_fd;          // descriptor the writes go to
+    bool d_direct;     // d_fd currently has O_DIRECT set
+    uint64_t d_offset; // file offset of the next write
+    int d_errno;
+    io_engine::sptr d_engine;
+
+    gr::thread::mutex d_mutex; // guards d_dropped
+    uint64_t d_dropped;
+    uint64_t d_overflow_offset;
+    uint64_t d_overflow_count;
+    pmt::pmt_t d_overflow_port;
+
+    int sync_work(int noutput_items, const char* inbuf);
+    int async_work(int noutput_items, const char* inbuf);
+    void setup_fd();
+    void set_direct(bool direct);
+    void submit_fill();
+    void complete_head();
+    void drain();
+    void report_overflow();
+
 public:
-    file_sink_impl(size_t itemsize, const char* filename, bool append = false);
+    file_sink_impl(size_t itemsize,
+                   const char* filename,
+                   bool append,
+                   unsigned int nbuffers,
+                   size_t buffer_size,
+                   bool direct_io,
+                   uint64_t preallocate);
     ~file_sink_impl();
 
+    bool stop();
+
+    uint64_t nitems_dropped();
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items);
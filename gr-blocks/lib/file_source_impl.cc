@@ -25,14 +25,25 @@
 #endif
 
 #include "file_source_impl.h"
+#include <gnuradio/io_engine.h>
 #include <gnuradio/io_signature.h>
-#include <gnuradio/thread/thread.h>
+#include <volk/volk.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <cstdio>
 #include <stdexcept>
+#include <vector>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 #ifdef _MSC_VER
 #define GR_FSEEK _fseeki64
@@ -52,28 +63,303 @@
 namespace gr {
 namespace blocks {
 
+namespace {
+
+// mmap_reader: size of the mapped window
+const size_t mmap_window = 64 * 1024 * 1024;
+
+// direct_reader: alignment, size and number of read-ahead blocks
+const size_t direct_align = 4096;
+const size_t direct_block_size = 4 * 1024 * 1024;
+const size_t direct_nblocks = 4;
+
+/*
+ * Plain stdio reads; works on anything fopen can open.
+ */
+class stdio_reader : public file_reader
+{
+private:
+    FILE* d_fp;
+
+public:
+    stdio_reader(FILE* fp) : d_fp(fp) {}
+    ~stdio_reader() { fclose(d_fp); }
+
+    size_t read(char* out, size_t nbytes) { return fread(out, 1, nbytes, d_fp); }
+
+    bool seek(uint64_t offset) { return GR_FSEEK(d_fp, offset, SEEK_SET) == 0; }
+};
+
+#ifdef HAVE_MMAP
+/*
+ * Copies out of a sliding read-only mapping of the file. Only one
+ * window is mapped at a time so arbitrarily large files work on 32-bit
+ * hosts too; the kernel is asked to start reading the next window
+ * while the current one is being consumed.
+ */
+class mmap_reader : public file_reader
+{
+private:
+    FILE* d_fp;
+    int d_fd;
+    uint64_t d_size;
+    bool d_populate;
+    char* d_map;
+    uint64_t d_map_offset;
+    size_t d_map_len;
+    uint64_t d_pos;
+
+    void unmap()
+    {
+        if (d_map) {
+            munmap(d_map, d_map_len);
+            d_map = NULL;
+        }
+    }
+
+    void remap()
+    {
+        unmap();
+
+        const uint64_t page = sysconf(_SC_PAGESIZE);
+        d_map_offset = d_pos - d_pos % page;
+        d_map_len = std::min<uint64_t>(mmap_window, d_size - d_map_offset);
+
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        if (d_populate)
+            flags |= MAP_POPULATE;
+#endif
+        void* p = mmap(NULL, d_map_len, PROT_READ, flags, d_fd, d_map_offset);
+        if (p == MAP_FAILED)
+            throw std::runtime_error(std::string("file_source: mmap failed: ") +
+                                     strerror(errno));
+        d_map = (char*)p;
+
+#ifdef MADV_SEQUENTIAL
+        madvise(d_map, d_map_len, MADV_SEQUENTIAL);
+#endif
+#ifdef POSIX_FADV_WILLNEED
+        if (d_map_offset + d_map_len < d_size)
+            posix_fadvise(
+                d_fd, d_map_offset + d_map_len, mmap_window, POSIX_FADV_WILLNEED);
+#endif
+    }
+
+public:
+    mmap_reader(FILE* fp, uint64_t size, bool populate)
+        : d_fp(fp),
+          d_fd(GR_FILENO(fp)),
+          d_size(size),
+          d_populate(populate),
+          d_map(NULL),
+          d_map_offset(0),
+          d_map_len(0),
+          d_pos(0)
+    {
+        // Fail here rather than in the first call to work()
+        remap();
+    }
+
+    ~mmap_reader()
+    {
+        unmap();
+        fclose(d_fp);
+    }
+
+    size_t read(char* out, size_t nbytes)
+    {
+        size_t copied = 0;
+        while (nbytes && d_pos < d_size) {
+            if (d_pos < d_map_offset || d_pos >= d_map_offset + d_map_len)
+                remap();
+
+            size_t n = std::min<uint64_t>(nbytes, d_map_offset + d_map_len - d_pos);
+            memcpy(out, d_map + (d_pos - d_map_offset), n);
+            out += n;
+            d_pos += n;
+            copied += n;
+            nbytes -= n;
+        }
+        return copied;
+    }
+
+    bool seek(uint64_t offset)
+    {
+        if (offset > d_size)
+            return false;
+        // The window is moved lazily; seeking within it is free, which
+        // keeps repeating a short file cheap.
+        d_pos = offset;
+        return true;
+    }
+};
+#endif /* HAVE_MMAP */
+
+#ifdef HAVE_PREAD
+/*
+ * Aligned block reads kept in flight on an io_engine, filling a ring
+ * of buffers ahead of the read position. With O_DIRECT the page cache
+ * is bypassed and the storage streams straight into the ring; work()
+ * then only copies out of it.
+ */
+class direct_reader : public file_reader
+{
+private:
+    struct block {
+        char* data;
+        io_engine::request req;
+    };
+
+    int d_fd;
+    uint64_t d_size;
+    io_engine::sptr d_engine;
+    std::vector<block> d_blocks;
+    size_t d_head;  // oldest block in flight
+    size_t d_count; // blocks in flight
+    uint64_t d_pos;  // next byte handed to read()
+    uint64_t d_next; // next offset to submit a read for
+
+    // Queue reads for every free block
+    void fill()
+    {
+        io_engine::request* reqs[direct_nblocks];
+        size_t n = 0;
+        while (d_count < direct_nblocks && d_next < d_size) {
+            size_t i = (d_head + d_count) % direct_nblocks;
+            io_engine::request& req = d_blocks[i].req;
+            req.offset = d_next;
+            reqs[n++] = &req;
+            d_next += direct_block_size;
+            d_count++;
+        }
+        if (n)
+            d_engine->submit(reqs, n);
+    }
+
+    // Forget the read-ahead and continue at the aligned block holding offset
+    void restart(uint64_t offset)
+    {
+        for (; d_count > 0; d_count--) {
+            d_engine->wait(&d_blocks[d_head].req);
+            d_head = (d_head + 1) % direct_nblocks;
+        }
+        d_head = 0;
+        d_next = offset - offset % direct_align;
+    }
+
+public:
+    direct_reader(int fd, uint64_t size)
+        : d_fd(fd),
+          d_size(size),
+          d_blocks(direct_nblocks),
+          d_head(0),
+          d_count(0),
+          d_pos(0),
+          d_next(0)
+    {
+        std::vector<void*> bufs;
+        for (size_t i = 0; i < direct_nblocks; i++) {
+            d_blocks[i].data = (char*)volk_malloc(direct_block_size, direct_align);
+            if (!d_blocks[i].data) {
+                for (size_t j = 0; j < i; j++)
+                    volk_free(d_blocks[j].data);
+                ::close(d_fd);
+                throw std::bad_alloc();
+            }
+            io_engine::request& req = d_blocks[i].req;
+            req.op = io_engine::OP_READ;
+            req.fd = d_fd;
+            req.buf = d_blocks[i].data;
+            req.len = direct_block_size;
+            req.buf_index = i;
+            bufs.push_back(d_blocks[i].data);
+        }
+
+        d_engine = io_engine::make(direct_nblocks);
+        d_engine->register_buffers(bufs, direct_block_size);
+    }
+
+    ~direct_reader()
+    {
+        restart(0);
+        for (size_t i = 0; i < direct_nblocks; i++)
+            volk_free(d_blocks[i].data);
+        ::close(d_fd);
+    }
+
+    size_t read(char* out, size_t nbytes)
+    {
+        size_t copied = 0;
+        while (nbytes && d_pos < d_size) {
+            fill();
+
+            block& b = d_blocks[d_head];
+            d_engine->wait(&b.req);
+            if (b.req.result < 0)
+                throw std::runtime_error(std::string("file_source: read failed: ") +
+                                         strerror(-b.req.result));
+            if (b.req.result == 0)
+                throw std::runtime_error("file_source: file shrank while reading");
+
+            const uint64_t end = b.req.offset + b.req.result;
+            if (d_pos < end) {
+                size_t n = std::min<uint64_t>(nbytes, end - d_pos);
+                memcpy(out, b.data + (d_pos - b.req.offset), n);
+                out += n;
+                d_pos += n;
+                copied += n;
+                nbytes -= n;
+            }
+            if (d_pos >= end) {
+                d_head = (d_head + 1) % direct_nblocks;
+                d_count--;
+                // A short read before the end leaves the blocks behind
+                // it at the wrong offsets.
+                if (b.req.result < (int64_t)direct_block_size && end < d_size)
+                    restart(d_pos);
+            }
+        }
+        return copied;
+    }
+
+    bool seek(uint64_t offset)
+    {
+        if (offset > d_size)
+            return false;
+
+        restart(offset);
+        d_pos = offset;
+        return true;
+    }
+};
+#endif /* HAVE_PREAD */
+
+} /* anonymous namespace */
+
 file_source::sptr file_source::make(size_t itemsize,
                                     const char* filename,
                                     bool repeat,
                                     uint64_t start_offset_items,
-                                    uint64_t length_items)
+                                    uint64_t length_items,
+                                    file_io_mode io_mode)
 {
     return gnuradio::get_initial_sptr(new file_source_impl(
-        itemsize, filename, repeat, start_offset_items, length_items));
+        itemsize, filename, repeat, start_offset_items, length_items, io_mode));
 }
 
 file_source_impl::file_source_impl(size_t itemsize,
                                    const char* filename,
                                    bool repeat,
                                    uint64_t start_offset_items,
-                                   uint64_t length_items)
+                                   uint64_t length_items,
+                                   file_io_mode io_mode)
     : sync_block(
           "file_source", io_signature::make(0, 0, 0), io_signature::make(1, 1, itemsize)),
       d_itemsize(itemsize),
       d_start_offset_items(start_offset_items),
       d_length_items(length_items),
-      d_fp(0),
-      d_new_fp(0),
+      d_io_mode(io_mode),
       d_repeat(repeat),
       d_updated(false),
       d_file_begin(true),
@@ -88,17 +374,13 @@ file_source_impl::file_source_impl(size_t itemsize,
     _id = pmt::string_to_symbol(str.str());
 }
 
-file_source_impl::~file_source_impl()
-{
-    if (d_fp)
-        fclose((FILE*)d_fp);
-    if (d_new_fp)
-        fclose((FILE*)d_new_fp);
-}
+file_source_impl::~file_source_impl() {}
 
 bool file_source_impl::seek(int64_t seek_point, int whence)
 {
-    if (d_seekable) {
+    gr::thread::scoped_lock lock(fp_mutex);
+
+    if (d_seekable && d_reader) {
         seek_point += d_start_offset_items;
 
         switch (whence) {
@@ -120,7 +402,7 @@ bool file_source_impl::seek(int64_t seek_point, int whence)
             GR_LOG_WARN(d_logger, "bad seek point");
             return 0;
         }
-        return GR_FSEEK((FILE*)d_fp, seek_point * d_itemsize, SEEK_SET) == 0;
+        return d_reader->seek(seek_point * d_itemsize);
     } else {
         GR_LOG_WARN(d_logger, "file not seekable");
         return 0;
@@ -136,20 +418,19 @@ void file_source_impl::open(const char* filename,
     // obtain exclusive access for duration of this function
     gr::thread::scoped_lock lock(fp_mutex);
 
-    if (d_new_fp) {
-        fclose(d_new_fp);
-        d_new_fp = 0;
-    }
+    d_new_reader.reset();
 
-    if ((d_new_fp = fopen(filename, "rb")) == NULL) {
+    FILE* fp;
+    if ((fp = fopen(filename, "rb")) == NULL) {
         GR_LOG_ERROR(d_logger, boost::format("%s: %s") % filename % strerror(errno));
         throw std::runtime_error("can't open file");
     }
 
     struct GR_STAT st;
 
-    if (GR_FSTAT(GR_FILENO(d_new_fp), &st)) {
+    if (GR_FSTAT(GR_FILENO(fp), &st)) {
         GR_LOG_ERROR(d_logger, boost::format("%s: %s") % filename % strerror(errno));
+        fclose(fp);
         throw std::runtime_error("can't fstat file");
     }
     if (S_ISREG(st.st_mode)) {
@@ -162,8 +443,8 @@ void file_source_impl::open(const char* filename,
 
     if (d_seekable) {
         // Check to ensure the file will be consumed according to item size
-        GR_FSEEK(d_new_fp, 0, SEEK_END);
-        file_size = GR_FTELL(d_new_fp);
+        GR_FSEEK(fp, 0, SEEK_END);
+        file_size = GR_FTELL(fp);
 
         // Make sure there will be at least one item available
         if ((file_size / d_itemsize) < (start_offset_items + 1)) {
@@ -172,7 +453,7 @@ void file_source_impl::open(const char* filename,
             } else {
                 GR_LOG_WARN(d_logger, "file is too small");
             }
-            fclose(d_new_fp);
+            fclose(fp);
             throw std::runtime_error("file is too small");
         }
     } else {
@@ -196,9 +477,11 @@ void file_source_impl::open(const char* filename,
         GR_LOG_WARN(d_logger, "file too short, will read fewer than requested items");
     }
 
+    d_new_reader.reset(make_reader(fp, filename, file_size, d_seekable));
+
     // Rewind to start offset
     if (d_seekable) {
-        GR_FSEEK(d_new_fp, start_offset_items * d_itemsize, SEEK_SET);
+        d_new_reader->seek(start_offset_items * d_itemsize);
     }
 
     d_updated = true;
@@ -208,15 +491,65 @@ void file_source_impl::open(const char* filename,
     d_items_remaining = length_items;
 }
 
+file_reader* file_source_impl::make_reader(FILE* fp,
+                                           const char* filename,
+                                           uint64_t file_size,
+                                           bool seekable)
+{
+    if (d_io_mode == FILE_IO_STDIO)
+        return new stdio_reader(fp);
+
+    if (!seekable) {
+        GR_LOG_WARN(d_logger, "not a regular file, falling back to stdio reads");
+        return new stdio_reader(fp);
+    }
+
+    switch (d_io_mode) {
+#ifdef HAVE_MMAP
+    case FILE_IO_MMAP:
+    case FILE_IO_MMAP_POPULATE:
+        try {
+            return new mmap_reader(fp, file_size, d_io_mode == FILE_IO_MMAP_POPULATE);
+        } catch (...) {
+            fclose(fp);
+            throw;
+        }
+#endif
+
+#ifdef HAVE_PREAD
+    case FILE_IO_DIRECT: {
+        int fd = -1;
+#ifdef O_DIRECT
+        fd = ::open(filename, O_RDONLY | O_DIRECT);
+        if (fd < 0)
+            GR_LOG_WARN(d_logger,
+                        boost::format("%s: O_DIRECT not supported (%s), "
+                                      "reading through the page cache") %
+                            filename % strerror(errno));
+#endif
+        if (fd < 0)
+            fd = dup(GR_FILENO(fp));
+        fclose(fp);
+        if (fd < 0) {
+            GR_LOG_ERROR(d_logger, boost::format("%s: %s") % filename % strerror(errno));
+            throw std::runtime_error("can't open file");
+        }
+        return new direct_reader(fd, file_size);
+    }
+#endif
+
+    default:
+        GR_LOG_WARN(d_logger, "I/O mode not supported here, falling back to stdio reads");
+        return new stdio_reader(fp);
+    }
+}
+
 void file_source_impl::close()
 {
     // obtain exclusive access for duration of this function
     gr::thread::scoped_lock lock(fp_mutex);
 
-    if (d_new_fp != NULL) {
-        fclose(d_new_fp);
-        d_new_fp = NULL;
-    }
+    d_new_reader.reset();
     d_updated = true;
 }
 
@@ -225,11 +558,7 @@ void file_source_impl::do_update()
     if (d_updated) {
         gr::thread::scoped_lock lock(fp_mutex); // hold while in scope
 
-        if (d_fp)
-            fclose(d_fp);
-
-        d_fp = d_new_fp; // install new file pointer
-        d_new_fp = 0;
+        d_reader = std::move(d_new_reader); // install new reader
         d_updated = false;
         d_file_begin = true;
     }
@@ -244,8 +573,8 @@ int file_source_impl::work(int noutput_items,
     char* o = (char*)output_items[0];
     uint64_t size = noutput_items;
 
-    do_update(); // update d_fp is reqd
-    if (d_fp == NULL)
+    do_update(); // update d_reader is reqd
+    if (!d_reader)
         throw std::runtime_error("work with file not open");
 
     gr::thread::scoped_lock lock(fp_mutex); // hold for the rest of this function
@@ -269,8 +598,8 @@ int file_source_impl::work(int noutput_items,
         uint64_t nitems_to_read = std::min(size, d_items_remaining);
 
         // Since the bounds of the file are known, unexpected nitems is an error
-        if (nitems_to_read != fread(o, d_itemsize, nitems_to_read, (FILE*)d_fp))
-            throw std::runtime_error("fread error");
+        if (nitems_to_read * d_itemsize != d_reader->read(o, nitems_to_read * d_itemsize))
+            throw std::runtime_error("read error");
 
         size -= nitems_to_read;
         d_items_remaining -= nitems_to_read;
@@ -281,7 +610,7 @@ int file_source_impl::work(int noutput_items,
 
             // Repeat: rewind and request tag
             if (d_repeat && d_seekable) {
-                GR_FSEEK(d_fp, d_start_offset_items * d_itemsize, SEEK_SET);
+                d_reader->seek(d_start_offset_items * d_itemsize);
                 d_items_remaining = d_length_items;
                 if (d_add_begin_tag != pmt::PMT_NIL) {
                     d_file_begin = true;
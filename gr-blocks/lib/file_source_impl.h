@@ -25,10 +25,29 @@
 
 #include <gnuradio/blocks/file_source.h>
 #include <boost/thread/mutex.hpp>
+#include <memory>
 
 namespace gr {
 namespace blocks {
 
+/*!
+ * \brief Byte stream out of an open file, one per file_io_mode.
+ *
+ * Implementations live in file_source_impl.cc. Positions are byte
+ * offsets from the start of the file.
+ */
+class file_reader
+{
+public:
+    virtual ~file_reader() {}
+
+    //! Copy up to \p nbytes into \p out; returns the bytes copied.
+    virtual size_t read(char* out, size_t nbytes) = 0;
+
+    //! Move the read position to \p offset; returns false on failure.
+    virtual bool seek(uint64_t offset) = 0;
+};
+
 class BLOCKS_API file_source_impl : public file_source
 {
 private:
@@ -36,8 +55,9 @@ private:
     uint64_t d_start_offset_items;
     uint64_t d_length_items;
     uint64_t d_items_remaining;
-    FILE* d_fp;
-    FILE* d_new_fp;
+    file_io_mode d_io_mode;
+    std::unique_ptr<file_reader> d_reader;
+    std::unique_ptr<file_reader> d_new_reader;
     bool d_repeat;
     bool d_updated;
     bool d_file_begin;
@@ -49,13 +69,16 @@ private:
     pmt::pmt_t _id;
 
     void do_update();
+    file_reader*
+    make_reader(FILE* fp, const char* filename, uint64_t file_size, bool seekable);
 
 public:
     file_source_impl(size_t itemsize,
                      const char* filename,
                      bool repeat,
                      uint64_t offset,
-                     uint64_t len);
+                     uint64_t len,
+                     file_io_mode io_mode);
     ~file_source_impl();
 
     bool seek(int64_t seek_point, int whence);
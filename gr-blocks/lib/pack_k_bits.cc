@@ -25,6 +25,7 @@
 #endif
 
 #include <gnuradio/blocks/pack_k_bits.h>
+#include <gnuradio/blocks/repack_bits.h>
 #include <iostream>
 #include <stdexcept>
 
@@ -42,26 +43,18 @@ pack_k_bits::~pack_k_bits() {}
 
 void pack_k_bits::pack(unsigned char* bytes, const unsigned char* bits, int nbytes) const
 {
-    for (int i = 0; i < nbytes; i++) {
-        bytes[i] = 0x00;
-        for (unsigned int j = 0; j < d_k; j++) {
-            bytes[i] |= (0x01 & bits[i * d_k + j]) << (d_k - j - 1);
-        }
-    }
+    pack_bits(bytes, bits, nbytes, d_k, true);
 }
 
 void pack_k_bits::pack_rev(unsigned char* bytes,
                            const unsigned char* bits,
                            int nbytes) const
 {
-    for (int i = 0; i < nbytes; i++) {
-        bytes[i] = 0x00;
-        for (unsigned int j = 0; j < d_k; j++) {
-            bytes[i] |= (0x01 & bits[i * d_k + j]) << j;
-        }
-    }
+    pack_bits(bytes, bits, nbytes, d_k, false);
 }
 
+int pack_k_bits::k() const { return d_k; }
+
 } /* namespace kernel */
 } /* namespace blocks */
 } /* namespace gr */
@@ -28,6 +28,7 @@
 #include "packed_to_unpacked_impl.h"
 #include <gnuradio/io_signature.h>
 #include <assert.h>
+#include <algorithm>
 
 namespace gr {
 namespace blocks {
@@ -48,7 +49,9 @@ packed_to_unpacked_impl<T>::packed_to_unpacked_impl(unsigned int bits_per_chunk,
             io_signature::make(1, -1, sizeof(T))),
       d_bits_per_chunk(bits_per_chunk),
       d_endianness(endianness),
-      d_index(0)
+      d_repackers(1,
+                  kernel::repack_bits(
+                      sizeof(T) * 8, bits_per_chunk, endianness == GR_MSB_FIRST, true))
 {
     assert(bits_per_chunk <= this->d_bits_per_type);
     assert(bits_per_chunk > 0);
@@ -61,90 +64,52 @@ packed_to_unpacked_impl<T>::~packed_to_unpacked_impl()
 {
 }
 
+template <class T>
+bool packed_to_unpacked_impl<T>::check_topology(int ninputs, int noutputs)
+{
+    if (ninputs != noutputs)
+        return false;
+    d_repackers.assign(ninputs,
+                       kernel::repack_bits(d_bits_per_type,
+                                           d_bits_per_chunk,
+                                           d_endianness == GR_MSB_FIRST,
+                                           true));
+    return true;
+}
+
 template <class T>
 void packed_to_unpacked_impl<T>::forecast(int noutput_items,
                                           gr_vector_int& ninput_items_required)
 {
-    int input_required = (int)ceil((d_index + noutput_items * d_bits_per_chunk) /
-                                   (1.0 * this->d_bits_per_type));
+    int bits = noutput_items * d_bits_per_chunk - d_repackers[0].pending();
+    int input_required = std::max(0, bits + (int)d_bits_per_type - 1) / d_bits_per_type;
     unsigned ninputs = ninput_items_required.size();
     for (unsigned int i = 0; i < ninputs; i++) {
         ninput_items_required[i] = input_required;
-        // printf("Forecast wants %d needs %d\n",noutput_items,ninput_items_required[i]);
     }
 }
 
-template <class T>
-unsigned int packed_to_unpacked_impl<T>::get_bit_le(const T* in_vector,
-                                                    unsigned int bit_addr)
-{
-    T x = in_vector[bit_addr >> this->d_log2_l_type];
-    return (x >> (bit_addr & (this->d_bits_per_type - 1))) & 1;
-}
-
-template <class T>
-unsigned int packed_to_unpacked_impl<T>::get_bit_be(const T* in_vector,
-                                                    unsigned int bit_addr)
-{
-    T x = in_vector[bit_addr >> this->d_log2_l_type];
-    return (x >>
-            ((this->d_bits_per_type - 1) - (bit_addr & (this->d_bits_per_type - 1)))) &
-           1;
-}
-
 template <class T>
 int packed_to_unpacked_impl<T>::general_work(int noutput_items,
                                              gr_vector_int& ninput_items,
                                              gr_vector_const_void_star& input_items,
                                              gr_vector_void_star& output_items)
 {
-    unsigned int index_tmp = d_index;
-
     assert(input_items.size() == output_items.size());
     int nstreams = input_items.size();
 
+    // The streams move in lock step so that each holds the same number
+    // of leftover bits.
+    int ninputs = *std::min_element(ninput_items.begin(), ninput_items.end());
+    int nread = 0;
+    int nwritten = 0;
     for (int m = 0; m < nstreams; m++) {
-        const T* in = (T*)input_items[m];
-        T* out = (T*)output_items[m];
-        index_tmp = d_index;
-
-        // per stream processing
-
-        switch (d_endianness) {
-        case GR_MSB_FIRST:
-            for (int i = 0; i < noutput_items; i++) {
-                // printf("here msb %d\n",i);
-                T x = 0;
-                for (unsigned int j = 0; j < d_bits_per_chunk; j++, index_tmp++)
-                    x = (x << 1) | get_bit_be(in, index_tmp);
-                out[i] = x;
-            }
-            break;
-
-        case GR_LSB_FIRST:
-            for (int i = 0; i < noutput_items; i++) {
-                // printf("here lsb %d\n",i);
-                T x = 0;
-                for (unsigned int j = 0; j < d_bits_per_chunk; j++, index_tmp++)
-                    x = (x << 1) | get_bit_le(in, index_tmp);
-                out[i] = x;
-            }
-            break;
-
-        default:
-            assert(0);
-        }
-
-        // printf("almost got to end\n");
-        assert(ninput_items[m] >=
-               (int)((d_index + (this->d_bits_per_type - 1)) >> this->d_log2_l_type));
+        nwritten = d_repackers[m].repack(
+            (T*)output_items[m], noutput_items, (const T*)input_items[m], ninputs, nread);
     }
 
-    d_index = index_tmp;
-    this->consume_each(d_index >> this->d_log2_l_type);
-    d_index = d_index & (this->d_bits_per_type - 1);
-    // printf("got to end\n");
-    return noutput_items;
+    this->consume_each(nread);
+    return nwritten;
 }
 
 template class packed_to_unpacked<std::uint8_t>;
@@ -24,8 +24,9 @@
 #ifndef PACKED_TO_UNPACKED_IMPL_H
 #define PACKED_TO_UNPACKED_IMPL_H
 
-#include <gnuradio/blocks/log2_const.h>
 #include <gnuradio/blocks/packed_to_unpacked.h>
+#include <gnuradio/blocks/repack_bits.h>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -36,11 +37,8 @@ class packed_to_unpacked_impl : public packed_to_unpacked<T>
 private:
     unsigned int d_bits_per_chunk;
     endianness_t d_endianness;
-    unsigned int d_index;
     const unsigned int d_bits_per_type = sizeof(T) * 8;
-    const unsigned int d_log2_l_type = log2_const<sizeof(T) * 8>();
-    unsigned int get_bit_le(const T* in_vector, unsigned int bit_addr);
-    unsigned int get_bit_be(const T* in_vector, unsigned int bit_addr);
+    std::vector<kernel::repack_bits> d_repackers; // one per stream
 
 public:
     packed_to_unpacked_impl(unsigned int bits_per_chunk, endianness_t endianness);
@@ -52,7 +50,7 @@ public:
                      gr_vector_const_void_star& input_items,
                      gr_vector_void_star& output_items);
 
-    bool check_topology(int ninputs, int noutputs) { return ninputs == noutputs; }
+    bool check_topology(int ninputs, int noutputs);
 };
 
 } /* namespace blocks */
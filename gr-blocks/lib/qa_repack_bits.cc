@@ -0,0 +1,169 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/blocks/repack_bits.h>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using gr::blocks::kernel::repack_bits;
+
+// Bit by bit reference: split words of k bits into a bit stream
+static std::vector<int> to_bits(const std::vector<uint32_t>& words, unsigned k, bool msb)
+{
+    std::vector<int> bits;
+    for (size_t i = 0; i < words.size(); i++)
+        for (unsigned j = 0; j < k; j++)
+            bits.push_back((words[i] >> (msb ? k - 1 - j : j)) & 1);
+    return bits;
+}
+
+static std::vector<uint32_t> from_bits(const std::vector<int>& bits, unsigned l, bool msb)
+{
+    std::vector<uint32_t> words;
+    for (size_t i = 0; i + l <= bits.size(); i += l) {
+        uint32_t w = 0;
+        for (unsigned j = 0; j < l; j++)
+            w |= (uint32_t)bits[i + j] << (msb ? l - 1 - j : j);
+        words.push_back(w);
+    }
+    return words;
+}
+
+BOOST_AUTO_TEST_CASE(t_unpack_pack)
+{
+    srand(1);
+    for (unsigned k = 1; k <= 8; k++) {
+        for (int msb = 0; msb < 2; msb++) {
+            for (int n = 0; n < 40; n++) {
+                std::vector<unsigned char> bytes(n);
+                std::vector<uint32_t> words(n);
+                for (int i = 0; i < n; i++) {
+                    bytes[i] = rand() & 0xff; // bits above k are ignored
+                    words[i] = bytes[i] & ((1 << k) - 1);
+                }
+                std::vector<int> ref = to_bits(words, k, msb);
+
+                // one byte of slack to catch writes past the end
+                std::vector<unsigned char> bits(n * k + 1, 0xaa);
+                gr::blocks::kernel::unpack_bits(&bits[0], bytes.data(), n, k, msb);
+                for (int i = 0; i < n * (int)k; i++)
+                    BOOST_REQUIRE_EQUAL(ref[i], bits[i]);
+                BOOST_REQUIRE_EQUAL(0xaa, bits[n * k]);
+
+                // garbage above the LSB must be ignored
+                for (int i = 0; i < n * (int)k; i++)
+                    bits[i] |= 0xf0;
+                std::vector<unsigned char> packed(n + 1, 0xaa);
+                gr::blocks::kernel::pack_bits(&packed[0], bits.data(), n, k, msb);
+                for (int i = 0; i < n; i++)
+                    BOOST_REQUIRE_EQUAL(words[i], packed[i]);
+                BOOST_REQUIRE_EQUAL(0xaa, packed[n]);
+            }
+        }
+    }
+}
+
+template <class T>
+static void check_repack(unsigned k, unsigned l, bool msb_in, bool msb_out)
+{
+    const int N = 500;
+    std::vector<uint32_t> words(N);
+    std::vector<T> in(N);
+    for (int i = 0; i < N; i++) {
+        in[i] = (T)((unsigned)rand() ^ ((unsigned)rand() << 16));
+        words[i] = (uint32_t)in[i] & (uint32_t)((uint64_t(1) << k) - 1);
+    }
+    std::vector<uint32_t> ref = from_bits(to_bits(words, k, msb_in), l, msb_out);
+
+    // Feed it in ragged pieces, with the output space sometimes short
+    repack_bits r(k, l, msb_in, msb_out);
+    std::vector<T> out(ref.size() + 1);
+    int nin = 0, nout = 0;
+    while (nin < N || nout < (int)ref.size()) {
+        int n_in = std::min(N - nin, rand() % 17);
+        int n_out = std::min((int)ref.size() - nout, rand() % 23);
+        int consumed;
+        nout += r.repack(&out[nout], n_out, &in[nin], n_in, consumed);
+        nin += consumed;
+        BOOST_REQUIRE(nout <= (int)ref.size());
+    }
+    const uint32_t lmask = (uint32_t)((uint64_t(1) << l) - 1);
+    for (size_t i = 0; i < ref.size(); i++)
+        BOOST_REQUIRE_EQUAL(ref[i], (uint32_t)out[i] & lmask);
+    BOOST_REQUIRE_EQUAL((N * k) % l, r.pending());
+}
+
+BOOST_AUTO_TEST_CASE(t_repack_bytes)
+{
+    srand(2);
+    for (unsigned k = 1; k <= 8; k++)
+        for (unsigned l = 1; l <= 8; l++)
+            for (int m = 0; m < 4; m++)
+                check_repack<unsigned char>(k, l, m & 1, m & 2);
+}
+
+BOOST_AUTO_TEST_CASE(t_repack_words)
+{
+    srand(3);
+    const unsigned sizes[] = { 1, 3, 7, 8, 13, 16 };
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 6; j++) {
+            check_repack<int16_t>(sizes[i], sizes[j], true, false);
+            check_repack<int16_t>(sizes[i], sizes[j], false, false);
+        }
+        check_repack<int32_t>(sizes[i], 32, true, true);
+        check_repack<int32_t>(32, sizes[i], false, true);
+    }
+    check_repack<int32_t>(32, 31, true, true);
+    check_repack<int32_t>(29, 32, false, false);
+}
+
+BOOST_AUTO_TEST_CASE(t_flush)
+{
+    // 0b101 then 0b1 (msb first) -> 0b1011 padded to 0b10110000
+    const unsigned char in[] = { 0x5, 0x1 };
+    unsigned char out[2];
+    int consumed;
+
+    repack_bits msb(3, 8, false, true);
+    BOOST_REQUIRE_EQUAL(0, msb.repack(out, 2, in, 1, consumed));
+    msb.set_k_and_l(1, 8);
+    BOOST_REQUIRE_EQUAL(0, msb.repack(out, 2, in + 1, 1, consumed));
+    BOOST_REQUIRE_EQUAL(4u, msb.pending());
+    BOOST_REQUIRE_EQUAL(0xb0u, msb.flush());
+    BOOST_REQUIRE_EQUAL(0u, msb.pending());
+
+    repack_bits lsb(3, 8, false, false);
+    lsb.repack(out, 2, in, 2, consumed);
+    BOOST_REQUIRE_EQUAL(6u, lsb.pending());
+    BOOST_REQUIRE_EQUAL(0x0du, lsb.flush());
+
+    BOOST_CHECK_THROW(repack_bits(0, 8), std::out_of_range);
+    BOOST_CHECK_THROW(repack_bits(8, 33), std::out_of_range);
+}
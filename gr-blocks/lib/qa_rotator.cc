@@ -30,6 +30,7 @@
 #include <gnuradio/math.h>
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 // error vector magnitude
@@ -102,3 +103,49 @@ BOOST_AUTO_TEST_CASE(t2)
     delete[] output;
     delete[] input;
 }
+
+BOOST_AUTO_TEST_CASE(t3)
+{
+    // Long run in uneven blocks, mixed with single-sample rotations and
+    // a frequency change: the phase has to stay locked to the exact one.
+    static const unsigned int N = 20000000;
+    static const unsigned int BLOCK = 4093;
+
+    gr::blocks::rotator r;
+    gr_complex* input = new gr_complex[BLOCK];
+    gr_complex* output = new gr_complex[BLOCK];
+    for (unsigned i = 0; i < BLOCK; i++)
+        input[i] = gr_complex(1.0f, 0.0f);
+
+    const gr_complex incr[2] = { gr_expj(2 * GR_M_PI / 1003.7),
+                                 gr_expj(-2 * GR_M_PI / 77.1) };
+
+    r.set_phase(gr_complex(1, 0));
+    double phase = 0;
+    float max_err = 0;
+    for (unsigned n = 0; n < N;) {
+        // Exactly the increment the rotator multiplies by
+        const gr_complex step = incr[(n / (N / 4)) % 2];
+        const double phase_incr = std::arg(std::complex<double>(step));
+        r.set_phase_incr(step);
+
+        r.rotateN(output, input, BLOCK);
+        for (unsigned i = 0; i < BLOCK; i++) {
+            gr_complex expected =
+                gr_expj(std::fmod(phase + i * phase_incr, 2 * GR_M_PI));
+            max_err = std::max(max_err, std::abs(expected - output[i]));
+        }
+        phase = std::fmod(phase + BLOCK * phase_incr, 2 * GR_M_PI);
+
+        for (unsigned i = 0; i < 7; i++) {
+            max_err = std::max(
+                max_err, std::abs(gr_expj(phase) - r.rotate(gr_complex(1.0f, 0.0f))));
+            phase = std::fmod(phase + phase_incr, 2 * GR_M_PI);
+        }
+        n += BLOCK + 7;
+    }
+    BOOST_CHECK(max_err <= 0.0001);
+
+    delete[] output;
+    delete[] input;
+}
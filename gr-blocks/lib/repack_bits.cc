@@ -0,0 +1,279 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/repack_bits.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// Packing loads eight bit bytes into one 64 bit word and needs to know
+// which of them ends up in the low byte.
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || \
+    defined(_M_IX86) || defined(_M_X64)
+#define GR_REPACK_BITS_SWAR
+#endif
+
+namespace gr {
+namespace blocks {
+namespace kernel {
+
+namespace {
+
+struct bit_tables {
+    unsigned char unpack_msb[256][8]; // byte j is bit 7-j
+    unsigned char unpack_lsb[256][8]; // byte j is bit j
+    unsigned char reverse[256];
+
+    bit_tables()
+    {
+        for (unsigned b = 0; b < 256; b++) {
+            reverse[b] = 0;
+            for (unsigned j = 0; j < 8; j++) {
+                unpack_msb[b][j] = (b >> (7 - j)) & 1;
+                unpack_lsb[b][j] = (b >> j) & 1;
+                reverse[b] |= ((b >> j) & 1) << (7 - j);
+            }
+        }
+    }
+};
+
+const bit_tables& tables()
+{
+    static const bit_tables t;
+    return t;
+}
+
+// Reverse the order of the low k bits of v
+inline uint32_t reverse_bits(uint32_t v, unsigned k, const unsigned char* rev)
+{
+    uint32_t r = ((uint32_t)rev[v & 0xff] << 24) |
+                 ((uint32_t)rev[(v >> 8) & 0xff] << 16) |
+                 ((uint32_t)rev[(v >> 16) & 0xff] << 8) | rev[v >> 24];
+    return r >> (32 - k);
+}
+
+// Number of leading words of n, k bits each, that can be followed by
+// an 8 byte access without running past the end of the k*n bytes.
+inline int n_wide(int n, unsigned k)
+{
+    return std::max(0, n - (int)((8 + k - 1) / k) + 1);
+}
+
+} // namespace
+
+void unpack_bits(unsigned char* bits,
+                 const unsigned char* bytes,
+                 int nbytes,
+                 unsigned k,
+                 bool msb_first)
+{
+    if (k > 8) {
+        for (int i = 0; i < nbytes; i++) {
+            unsigned t = bytes[i];
+            for (unsigned j = 0; j < k; j++)
+                *bits++ = (t >> (msb_first ? k - 1 - j : j)) & 0x01;
+        }
+        return;
+    }
+
+    // Each byte is a table entry of 8 bits. All of it is stored while
+    // the bytes past the first k are overwritten by the next entry.
+    const bit_tables& t = tables();
+    const int nfast = n_wide(nbytes, k);
+    int i = 0;
+    if (msb_first) {
+        const unsigned shift = 8 - k;
+        for (; i < nfast; i++)
+            memcpy(bits + i * k, t.unpack_msb[(bytes[i] << shift) & 0xff], 8);
+        for (; i < nbytes; i++)
+            memcpy(bits + i * k, t.unpack_msb[(bytes[i] << shift) & 0xff], k);
+    } else {
+        for (; i < nfast; i++)
+            memcpy(bits + i * k, t.unpack_lsb[bytes[i]], 8);
+        for (; i < nbytes; i++)
+            memcpy(bits + i * k, t.unpack_lsb[bytes[i]], k);
+    }
+}
+
+void pack_bits(unsigned char* bytes,
+               const unsigned char* bits,
+               int nbytes,
+               unsigned k,
+               bool msb_first)
+{
+    int i = 0;
+#ifdef GR_REPACK_BITS_SWAR
+    if (k <= 8) {
+        // With 0/1 in each of the first k bytes of w, the multiply
+        // moves bit 0 of byte j to bit 63-j (or 56+j) of the product
+        // without carries between them.
+        const uint64_t keep = 0x0101010101010101ULL >> (8 * (8 - k));
+        const int nfast = n_wide(nbytes, k);
+        uint64_t w;
+        if (msb_first) {
+            for (; i < nfast; i++) {
+                memcpy(&w, bits + i * k, 8);
+                bytes[i] = (unsigned char)(((w & keep) * 0x8040201008040201ULL) >>
+                                           (64 - k));
+            }
+        } else {
+            for (; i < nfast; i++) {
+                memcpy(&w, bits + i * k, 8);
+                bytes[i] = (unsigned char)(((w & keep) * 0x0102040810204080ULL) >> 56);
+            }
+        }
+    }
+#endif
+
+    for (; i < nbytes; i++) {
+        unsigned char b = 0x00;
+        for (unsigned j = 0; j < k; j++)
+            b |= (0x01 & bits[i * k + j]) << (msb_first ? k - j - 1 : j);
+        bytes[i] = b;
+    }
+}
+
+repack_bits::repack_bits(unsigned k, unsigned l, bool msb_in, bool msb_out)
+    : d_msb_in(msb_in), d_msb_out(msb_out), d_acc(0), d_nbits(0)
+{
+    set_k_and_l(k, l);
+}
+
+void repack_bits::set_k_and_l(unsigned k, unsigned l)
+{
+    if (k < 1 || k > 32 || l < 1 || l > 32)
+        throw std::out_of_range("repack_bits: k and l must be in [1, 32]");
+    d_k = k;
+    d_l = l;
+}
+
+void repack_bits::reset()
+{
+    d_acc = 0;
+    d_nbits = 0;
+}
+
+uint32_t repack_bits::flush()
+{
+    const uint64_t lmask = (uint64_t(1) << d_l) - 1;
+    uint64_t w = d_msb_out ? d_acc << (d_l - d_nbits) : d_acc;
+    reset();
+    return (uint32_t)(w & lmask);
+}
+
+template <class IN_T, class OUT_T>
+int repack_bits::repack_words(
+    OUT_T* out, int noutputs, const IN_T* in, int ninputs, int& nconsumed)
+{
+    int nin = 0;
+    int nout = 0;
+
+    if (sizeof(IN_T) == 1 && sizeof(OUT_T) == 1 && d_nbits == 0) {
+        if (d_l == 1 && d_k <= 8) {
+            nin = std::min(ninputs, noutputs / (int)d_k);
+            nout = nin * d_k;
+            unpack_bits(
+                (unsigned char*)out, (const unsigned char*)in, nin, d_k, d_msb_in);
+        } else if (d_k == 1 && d_l <= 8) {
+            nout = std::min(noutputs, ninputs / (int)d_l);
+            nin = nout * d_l;
+            pack_bits(
+                (unsigned char*)out, (const unsigned char*)in, nout, d_l, d_msb_out);
+        }
+    }
+
+    // The accumulator never holds more than l-1+k <= 63 bits: input is
+    // only taken while there are fewer than l bits.
+    const uint64_t kmask = (uint64_t(1) << d_k) - 1;
+    const uint64_t lmask = (uint64_t(1) << d_l) - 1;
+    const bool reverse = d_msb_in != d_msb_out;
+    const unsigned char* rev = tables().reverse;
+
+    if (d_msb_out) { // the first bit of the stream is the most significant
+        while (true) {
+            if (d_nbits >= d_l) {
+                if (nout == noutputs)
+                    break;
+                d_nbits -= d_l;
+                out[nout++] = (OUT_T)((d_acc >> d_nbits) & lmask);
+            } else {
+                if (nin == ninputs)
+                    break;
+                uint32_t v = (uint32_t)(in[nin++] & kmask);
+                if (reverse)
+                    v = reverse_bits(v, d_k, rev);
+                d_acc = (d_acc << d_k) | v;
+                d_nbits += d_k;
+            }
+        }
+    } else { // the first bit of the stream is the least significant
+        while (true) {
+            if (d_nbits >= d_l) {
+                if (nout == noutputs)
+                    break;
+                out[nout++] = (OUT_T)(d_acc & lmask);
+                d_acc >>= d_l;
+                d_nbits -= d_l;
+            } else {
+                if (nin == ninputs)
+                    break;
+                uint32_t v = (uint32_t)(in[nin++] & kmask);
+                if (reverse)
+                    v = reverse_bits(v, d_k, rev);
+                d_acc |= (uint64_t)v << d_nbits;
+                d_nbits += d_k;
+            }
+        }
+    }
+
+    nconsumed = nin;
+    return nout;
+}
+
+int repack_bits::repack(unsigned char* out,
+                        int noutputs,
+                        const unsigned char* in,
+                        int ninputs,
+                        int& nconsumed)
+{
+    return repack_words(out, noutputs, in, ninputs, nconsumed);
+}
+
+int repack_bits::repack(
+    int16_t* out, int noutputs, const int16_t* in, int ninputs, int& nconsumed)
+{
+    return repack_words(out, noutputs, in, ninputs, nconsumed);
+}
+
+int repack_bits::repack(
+    int32_t* out, int noutputs, const int32_t* in, int ninputs, int& nconsumed)
+{
+    return repack_words(out, noutputs, in, ninputs, nconsumed);
+}
+
+} /* namespace kernel */
+} /* namespace blocks */
+} /* namespace gr */
@@ -52,14 +52,17 @@ repack_bits_bb_impl::repack_bits_bb_impl(int k,
       d_k(k),
       d_l(l),
       d_packet_mode(!len_tag_key.empty()),
-      d_in_index(0),
-      d_out_index(0),
       d_align_output(align_output),
-      d_endianness(endianness)
+      d_endianness(endianness),
+      d_repacker(1, 1, endianness == GR_MSB_FIRST, endianness == GR_MSB_FIRST)
 {
     if (d_k > 8 || d_k < 1 || d_l > 8 || d_l < 1) {
         throw std::invalid_argument("k and l must be in [1, 8]");
     }
+    if (endianness != GR_MSB_FIRST && endianness != GR_LSB_FIRST) {
+        throw std::invalid_argument("repack_bits_bb: unrecognized endianness value.");
+    }
+    d_repacker.set_k_and_l(d_k, d_l);
 
     set_relative_rate((uint64_t)d_k, (uint64_t)d_l);
 }
@@ -69,6 +72,7 @@ void repack_bits_bb_impl::set_k_and_l(int k, int l)
     gr::thread::scoped_lock guard(d_setlock);
     d_k = k;
     d_l = l;
+    d_repacker.set_k_and_l(d_k, d_l);
     set_relative_rate((uint64_t)d_k, (uint64_t)d_l);
 }
 
@@ -93,82 +97,22 @@ int repack_bits_bb_impl::work(int noutput_items,
     gr::thread::scoped_lock guard(d_setlock);
     const unsigned char* in = (const unsigned char*)input_items[0];
     unsigned char* out = (unsigned char*)output_items[0];
-    int bytes_to_write = noutput_items;
+    int n_read;
 
     if (d_packet_mode) { // noutput_items could be larger than necessary
+        // Each packet starts on a fresh input and output byte
         int bytes_to_read = ninput_items[0];
-        bytes_to_write = bytes_to_read * d_k / d_l;
-        if (!d_align_output && (((bytes_to_read * d_k) % d_l) != 0)) {
-            bytes_to_write++;
+        int n_written =
+            d_repacker.repack(out, bytes_to_read * d_k / d_l, in, bytes_to_read, n_read);
+        if (!d_align_output && d_repacker.pending()) {
+            out[n_written++] = d_repacker.flush();
         }
+        d_repacker.reset();
+        return n_written;
     }
 
-    int n_read = 0;
-    int n_written = 0;
-    switch (d_endianness) {
-    case GR_LSB_FIRST:
-        while (n_written < bytes_to_write && n_read < ninput_items[0]) {
-            if (d_out_index == 0) { // Starting a fresh byte
-                out[n_written] = 0;
-            }
-            out[n_written] |= ((in[n_read] >> d_in_index) & 0x01) << d_out_index;
-
-            d_in_index = (d_in_index + 1) % d_k;
-            d_out_index = (d_out_index + 1) % d_l;
-            if (d_in_index == 0) {
-                n_read++;
-                d_in_index = 0;
-            }
-            if (d_out_index == 0) {
-                n_written++;
-                d_out_index = 0;
-            }
-        }
-
-        if (d_packet_mode) {
-            if (d_out_index) {
-                n_written++;
-                d_out_index = 0;
-            }
-        } else {
-            consume_each(n_read);
-        }
-        break;
-
-
-    case GR_MSB_FIRST:
-        while (n_written < bytes_to_write && n_read < ninput_items[0]) {
-            if (d_out_index == 0) { // Starting a fresh byte
-                out[n_written] = 0;
-            }
-            out[n_written] |= ((in[n_read] >> (d_k - 1 - d_in_index)) & 0x01)
-                              << (d_l - 1 - d_out_index);
-
-            d_in_index = (d_in_index + 1) % d_k;
-            d_out_index = (d_out_index + 1) % d_l;
-            if (d_in_index == 0) {
-                n_read++;
-                d_in_index = 0;
-            }
-            if (d_out_index == 0) {
-                n_written++;
-                d_out_index = 0;
-            }
-        }
-
-        if (d_packet_mode) {
-            if (d_out_index) {
-                n_written++;
-                d_out_index = 0;
-            }
-        } else {
-            consume_each(n_read);
-        }
-        break;
-
-    default:
-        throw std::runtime_error("repack_bits_bb: unrecognized endianness value.");
-    }
+    int n_written = d_repacker.repack(out, noutput_items, in, ninput_items[0], n_read);
+    consume_each(n_read);
 
     return n_written;
 }
@@ -23,6 +23,7 @@
 #ifndef INCLUDED_BLOCKS_REPACK_BITS_BB_IMPL_H
 #define INCLUDED_BLOCKS_REPACK_BITS_BB_IMPL_H
 
+#include <gnuradio/blocks/repack_bits.h>
 #include <gnuradio/blocks/repack_bits_bb.h>
 
 namespace gr {
@@ -34,11 +35,10 @@ private:
     int d_k; //! Bits on input stream
     int d_l; //! Bits on output stream
     const bool d_packet_mode;
-    int d_in_index;      // Current bit of input byte
-    int d_out_index;     // Current bit of output byte
     bool d_align_output; //! true if the output shall be aligned, false if the input shall
                          //! be aligned
     endianness_t d_endianness;
+    kernel::repack_bits d_repacker;
 
 protected:
     int calculate_output_stream_length(const gr_vector_int& ninput_items);
@@ -29,7 +29,6 @@
 #include <gnuradio/thread/thread.h>
 #include <stdio.h>
 #include <string.h>
-#include <boost/array.hpp>
 #include <boost/asio.hpp>
 #include <boost/format.hpp>
 #include <algorithm>
@@ -38,25 +37,43 @@
 namespace gr {
 namespace blocks {
 
-tcp_server_sink::sptr
-tcp_server_sink::make(size_t itemsize, const std::string& host, int port, bool noblock)
+namespace {
+// Most queued chunks handed to one gathered write
+const size_t max_gather = 64;
+
+// How long stop() waits for clients that may be dropped anyway
+const int linger_ms = 1000;
+} // namespace
+
+tcp_server_sink::sptr tcp_server_sink::make(size_t itemsize,
+                                            const std::string& host,
+                                            int port,
+                                            bool noblock,
+                                            tcp_overflow_policy policy,
+                                            size_t buffer_size)
 {
-    return gnuradio::get_initial_sptr(
-        new tcp_server_sink_impl(itemsize, host, port, noblock));
+    return gnuradio::get_initial_sptr(new tcp_server_sink_impl(
+        itemsize, host, port, noblock, policy, buffer_size));
 }
 
 tcp_server_sink_impl::tcp_server_sink_impl(size_t itemsize,
                                            const std::string& host,
                                            int port,
-                                           bool noblock)
+                                           bool noblock,
+                                           tcp_overflow_policy policy,
+                                           size_t buffer_size)
     : sync_block("tcp_server_sink",
                  io_signature::make(1, 1, itemsize),
                  io_signature::make(0, 0, 0)),
       d_itemsize(itemsize),
+      d_policy(policy),
+      d_buffer_size(buffer_size),
       d_acceptor(d_io_service),
-      d_buf(new uint8_t[BUF_SIZE]),
-      d_writing(0)
+      d_clients_dropped(0)
 {
+    if (buffer_size < itemsize)
+        throw std::invalid_argument("tcp_server_sink: buffer_size smaller than an item");
+
     std::string s__port = (boost::format("%d") % port).str();
     std::string s__host = host.empty() ? std::string("localhost") : host;
     boost::asio::ip::tcp::resolver resolver(d_io_service);
@@ -70,65 +87,205 @@ tcp_server_sink_impl::tcp_server_sink_impl(size_t itemsize,
     d_acceptor.listen();
 
     if (!noblock) {
-        d_socket.reset(new boost::asio::ip::tcp::socket(d_io_service));
-        d_acceptor.accept(*d_socket, d_endpoint);
-        d_sockets.insert(d_socket.release());
+        client_sptr c(new client(d_io_service));
+        d_acceptor.accept(c->socket, d_endpoint);
+        add_client(c);
     }
 
-    d_socket.reset(new boost::asio::ip::tcp::socket(d_io_service));
-    d_acceptor.async_accept(*d_socket,
+    start_accept();
+    d_io_serv_thread =
+        boost::thread(boost::bind(&boost::asio::io_service::run, &d_io_service));
+}
+
+tcp_server_sink_impl::~tcp_server_sink_impl()
+{
+    d_io_service.reset();
+    d_io_service.stop();
+    d_io_serv_thread.join();
+
+    boost::system::error_code ec;
+    d_acceptor.close(ec);
+    for (std::list<client_sptr>::iterator i = d_clients.begin(); i != d_clients.end();
+         ++i)
+        (*i)->socket.close(ec);
+    d_clients.clear();
+    d_pending.reset();
+}
+
+void tcp_server_sink_impl::add_client(client_sptr c)
+{
+    boost::system::error_code ec;
+    boost::asio::ip::tcp::endpoint peer = c->socket.remote_endpoint(ec);
+    if (!ec)
+        c->address = (boost::format("%s:%d") % peer.address().to_string() %
+                      peer.port())
+                         .str();
+    d_clients.push_back(c);
+}
+
+void tcp_server_sink_impl::start_accept()
+{
+    d_pending.reset(new client(d_io_service));
+    d_acceptor.async_accept(d_pending->socket,
                             boost::bind(&tcp_server_sink_impl::do_accept,
                                         this,
                                         boost::asio::placeholders::error));
-    d_io_serv_thread =
-        boost::thread(boost::bind(&boost::asio::io_service::run, &d_io_service));
 }
 
 void tcp_server_sink_impl::do_accept(const boost::system::error_code& error)
 {
     if (!error) {
-        gr::thread::scoped_lock guard(d_writing_mut);
-        d_sockets.insert(d_socket.release());
-        d_socket.reset(new boost::asio::ip::tcp::socket(d_io_service));
-        d_acceptor.async_accept(*d_socket,
-                                boost::bind(&tcp_server_sink_impl::do_accept,
-                                            this,
-                                            boost::asio::placeholders::error));
+        {
+            gr::thread::scoped_lock guard(d_mutex);
+            add_client(d_pending);
+        }
+        start_accept();
     }
 }
 
+// Called with d_mutex held
+void tcp_server_sink_impl::start_write(client_sptr c)
+{
+    if (c->closed || c->inflight > 0 || c->queue.empty())
+        return;
+
+    // Only this client's socket is touched, and it has no other
+    // operation outstanding, so this is safe from either thread.
+    std::vector<boost::asio::const_buffer> bufs;
+    for (size_t i = 0; i < c->queue.size() && i < max_gather; i++)
+        bufs.push_back(boost::asio::buffer(*c->queue[i]));
+    c->inflight = bufs.size();
+
+    boost::asio::async_write(c->socket,
+                             bufs,
+                             boost::bind(&tcp_server_sink_impl::do_write,
+                                         this,
+                                         boost::asio::placeholders::error,
+                                         boost::asio::placeholders::bytes_transferred,
+                                         c));
+}
+
 void tcp_server_sink_impl::do_write(const boost::system::error_code& error,
                                     size_t len,
-                                    std::set<boost::asio::ip::tcp::socket*>::iterator i)
-{
-    {
-        gr::thread::scoped_lock guard(d_writing_mut);
-        --d_writing;
-        if (error) {
-            delete *i;
-            d_sockets.erase(i);
-        }
+                                    client_sptr c)
+{
+    gr::thread::scoped_lock guard(d_mutex);
+
+    c->sent += len;
+    for (; c->inflight > 0; c->inflight--) {
+        c->queued -= c->queue.front()->size();
+        c->queue.pop_front();
     }
-    d_writing_cond.notify_one();
+
+    if (error)
+        close_client(c);
+    else
+        start_write(c);
+    d_cond.notify_all();
 }
 
-tcp_server_sink_impl::~tcp_server_sink_impl()
+// Called with d_mutex held
+void tcp_server_sink_impl::close_client(client_sptr c)
+{
+    if (c->closed)
+        return;
+    c->closed = true;
+    d_clients.remove(c);
+
+    // Chunks being written stay until the write handler runs
+    c->queue.resize(c->inflight);
+
+    // Close from the io_service thread, never under a running write
+    d_io_service.post(boost::bind(&tcp_server_sink_impl::do_close, this, c));
+}
+
+void tcp_server_sink_impl::do_close(client_sptr c)
+{
+    boost::system::error_code ec;
+    c->socket.close(ec);
+}
+
+// How many of nitems every client can take without overflowing;
+// only TCP_OVERFLOW_BLOCK ever waits for room. Called with d_mutex held.
+size_t tcp_server_sink_impl::max_items(size_t nitems, gr::thread::scoped_lock& lock)
+{
+    if (d_policy != TCP_OVERFLOW_BLOCK)
+        return nitems;
+
+    while (true) {
+        size_t room = nitems * d_itemsize;
+        for (std::list<client_sptr>::iterator i = d_clients.begin();
+             i != d_clients.end();
+             ++i)
+            room = std::min(room, d_buffer_size - (*i)->queued);
+
+        if (room >= d_itemsize || d_clients.empty())
+            return d_clients.empty() ? nitems : room / d_itemsize;
+        d_cond.wait(lock);
+    }
+}
+
+bool tcp_server_sink_impl::stop()
 {
-    gr::thread::scoped_lock guard(d_writing_mut);
-    while (d_writing) {
-        d_writing_cond.wait(guard);
+    gr::thread::scoped_lock guard(d_mutex);
+
+    // Let the clients catch up with what has been queued, but don't
+    // let one that stopped reading hold up shutdown
+    boost::system_time deadline =
+        boost::get_system_time() + boost::posix_time::milliseconds(linger_ms);
+    while (true) {
+        bool busy = false;
+        for (std::list<client_sptr>::iterator i = d_clients.begin();
+             i != d_clients.end();
+             ++i)
+            busy |= (*i)->queued > 0;
+        if (!busy)
+            return true;
+
+        if (!d_cond.timed_wait(guard, deadline))
+            break;
     }
 
-    for (std::set<boost::asio::ip::tcp::socket*>::iterator i = d_sockets.begin();
-         i != d_sockets.end();
+    std::list<client_sptr> clients(d_clients);
+    for (std::list<client_sptr>::iterator i = clients.begin(); i != clients.end(); ++i) {
+        if ((*i)->queued > 0) {
+            GR_LOG_WARN(d_logger,
+                        boost::format("client %s did not catch up, disconnecting") %
+                            (*i)->address);
+            close_client(*i);
+            d_clients_dropped++;
+        }
+    }
+    return true;
+}
+
+int tcp_server_sink_impl::num_clients()
+{
+    gr::thread::scoped_lock guard(d_mutex);
+    return d_clients.size();
+}
+
+pmt::pmt_t tcp_server_sink_impl::client_stats()
+{
+    gr::thread::scoped_lock guard(d_mutex);
+
+    pmt::pmt_t stats = pmt::PMT_NIL;
+    for (std::list<client_sptr>::iterator i = d_clients.begin(); i != d_clients.end();
          ++i) {
-        delete *i;
+        pmt::pmt_t d = pmt::make_dict();
+        d = pmt::dict_add(d, pmt::mp("address"), pmt::mp((*i)->address));
+        d = pmt::dict_add(d, pmt::mp("bytes_sent"), pmt::from_uint64((*i)->sent));
+        d = pmt::dict_add(d, pmt::mp("bytes_dropped"), pmt::from_uint64((*i)->dropped));
+        d = pmt::dict_add(d, pmt::mp("bytes_queued"), pmt::from_uint64((*i)->queued));
+        stats = pmt::list_add(stats, d);
     }
-    d_sockets.clear();
+    return stats;
+}
 
-    d_io_service.reset();
-    d_io_service.stop();
-    d_io_serv_thread.join();
+uint64_t tcp_server_sink_impl::clients_dropped()
+{
+    gr::thread::scoped_lock guard(d_mutex);
+    return d_clients_dropped;
 }
 
 int tcp_server_sink_impl::work(int noutput_items,
@@ -137,28 +294,56 @@ int tcp_server_sink_impl::work(int noutput_items,
 {
     const char* in = (const char*)input_items[0];
 
-    gr::thread::scoped_lock guard(d_writing_mut);
-    while (d_writing) {
-        d_writing_cond.wait(guard);
-    }
+    gr::thread::scoped_lock guard(d_mutex);
 
-    size_t data_len = std::min(size_t(BUF_SIZE), noutput_items * d_itemsize);
-    data_len -= data_len % d_itemsize;
-    memcpy(d_buf.get(), in, data_len);
-    for (std::set<boost::asio::ip::tcp::socket*>::iterator i = d_sockets.begin();
-         i != d_sockets.end();
-         ++i) {
-        boost::asio::async_write(**i,
-                                 boost::asio::buffer(d_buf.get(), data_len),
-                                 boost::bind(&tcp_server_sink_impl::do_write,
-                                             this,
-                                             boost::asio::placeholders::error,
-                                             boost::asio::placeholders::bytes_transferred,
-                                             i));
+    // A chunk never exceeds a client's queue, so an idle client
+    // always has room for it
+    const size_t max_chunk = std::min<size_t>(BUF_SIZE, d_buffer_size);
+    size_t nitems =
+        std::min<size_t>(noutput_items, std::max<size_t>(1, max_chunk / d_itemsize));
+    nitems = max_items(nitems, guard);
+    if (d_clients.empty())
+        return nitems; // drop data onto the floor
+
+    // One copy, shared by every client queue
+    const size_t len = nitems * d_itemsize;
+    chunk_sptr chunk(new std::vector<char>(in, in + len));
+
+    std::list<client_sptr> clients(d_clients);
+    for (std::list<client_sptr>::iterator i = clients.begin(); i != clients.end(); ++i) {
+        client_sptr c = *i;
+
+        if (c->queued + len > d_buffer_size) {
+            if (d_policy == TCP_OVERFLOW_DISCONNECT) {
+                GR_LOG_WARN(d_logger,
+                            boost::format("client %s fell behind, disconnecting") %
+                                c->address);
+                close_client(c);
+                d_clients_dropped++;
+                continue;
+            }
+
+            // TCP_OVERFLOW_DROP_OLDEST: make room behind the chunks
+            // being written; if those alone fill the queue the new
+            // chunk goes instead.
+            while (c->queue.size() > c->inflight && c->queued + len > d_buffer_size) {
+                std::deque<chunk_sptr>::iterator oldest = c->queue.begin() + c->inflight;
+                c->queued -= (*oldest)->size();
+                c->dropped += (*oldest)->size();
+                c->queue.erase(oldest);
+            }
+            if (c->queued + len > d_buffer_size) {
+                c->dropped += len;
+                continue;
+            }
+        }
+
+        c->queue.push_back(chunk);
+        c->queued += len;
+        start_write(c);
     }
-    d_writing = d_sockets.size();
 
-    return data_len / d_itemsize;
+    return nitems;
 }
 
 } /* namespace blocks */
@@ -25,8 +25,10 @@
 
 #include <gnuradio/blocks/tcp_server_sink.h>
 #include <boost/asio.hpp>
-#include <boost/ptr_container/ptr_vector.hpp>
-#include <set>
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -34,36 +36,75 @@ namespace blocks {
 class tcp_server_sink_impl : public tcp_server_sink
 {
 private:
+    typedef boost::shared_ptr<const std::vector<char>> chunk_sptr;
+
+    // One connection and the data queued for it. Queued chunks are
+    // shared between all clients; the first inflight of them are
+    // being written.
+    struct client {
+        boost::asio::ip::tcp::socket socket;
+        std::string address;
+        std::deque<chunk_sptr> queue;
+        size_t queued;   // bytes in queue
+        size_t inflight; // chunks in the current write
+        bool closed;
+        uint64_t sent;
+        uint64_t dropped;
+
+        client(boost::asio::io_service& io)
+            : socket(io), queued(0), inflight(0), closed(false), sent(0), dropped(0)
+        {
+        }
+    };
+    typedef boost::shared_ptr<client> client_sptr;
+
     size_t d_itemsize;
+    tcp_overflow_policy d_policy;
+    size_t d_buffer_size;
 
     boost::asio::io_service d_io_service;
     gr::thread::thread d_io_serv_thread;
     boost::asio::ip::tcp::endpoint d_endpoint;
-    std::unique_ptr<boost::asio::ip::tcp::socket> d_socket;
-    std::set<boost::asio::ip::tcp::socket*> d_sockets;
+    client_sptr d_pending; // socket the next accept goes to
+    std::list<client_sptr> d_clients;
     boost::asio::ip::tcp::acceptor d_acceptor;
+    uint64_t d_clients_dropped;
 
-    boost::shared_ptr<uint8_t[]> d_buf;
     enum {
         BUF_SIZE = 256 * 1024,
     };
 
-    int d_writing;
-    boost::condition_variable d_writing_cond;
-    boost::mutex d_writing_mut;
+    // Guards the clients and their queues; d_cond is signalled
+    // whenever a queue shrinks.
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
 
+    void add_client(client_sptr c);
+    void start_accept();
     void do_accept(const boost::system::error_code& error);
+    void start_write(client_sptr c);
     void do_write(const boost::system::error_code& error,
                   std::size_t len,
-                  std::set<boost::asio::ip::tcp::socket*>::iterator);
+                  client_sptr c);
+    void close_client(client_sptr c);
+    void do_close(client_sptr c);
+    size_t max_items(size_t nitems, gr::thread::scoped_lock& lock);
 
 public:
     tcp_server_sink_impl(size_t itemsize,
                          const std::string& host,
                          int port,
-                         bool noblock);
+                         bool noblock,
+                         tcp_overflow_policy policy,
+                         size_t buffer_size);
     ~tcp_server_sink_impl();
 
+    bool stop();
+
+    int num_clients();
+    pmt::pmt_t client_stats();
+    uint64_t clients_dropped();
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items);
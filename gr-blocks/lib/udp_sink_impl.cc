@@ -27,6 +27,7 @@
 #include "udp_sink_impl.h"
 #include <gnuradio/io_signature.h>
 #include <gnuradio/thread/thread.h>
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 #include <boost/array.hpp>
@@ -37,6 +38,9 @@
 namespace gr {
 namespace blocks {
 
+// Payloads sent per system call
+static const unsigned int s_batch = 64;
+
 udp_sink::sptr udp_sink::make(
     size_t itemsize, const std::string& host, int port, int payload_size, bool eof)
 {
@@ -51,8 +55,17 @@ udp_sink_impl::udp_sink_impl(
       d_itemsize(itemsize),
       d_payload_size(payload_size),
       d_eof(eof),
-      d_connected(false)
+      d_connected(false),
+      d_engine(io_engine::make(s_batch)),
+      d_reqs(s_batch),
+      d_req_ptrs(s_batch)
 {
+    for (unsigned int i = 0; i < s_batch; i++) {
+        d_reqs[i].op = io_engine::OP_WRITE;
+        d_reqs[i].offset = io_engine::CURRENT_POSITION;
+        d_req_ptrs[i] = &d_reqs[i];
+    }
+
     // Get the destination address
     connect(host, port);
 }
@@ -82,6 +95,9 @@ void udp_sink_impl::connect(const std::string& host, int port)
         boost::asio::socket_base::reuse_address roption(true);
         d_socket->set_option(roption);
 
+        // Connected, so that a plain write() reaches d_endpoint
+        d_socket->connect(d_endpoint);
+
         d_connected = true;
     }
 }
@@ -112,26 +128,44 @@ int udp_sink_impl::work(int noutput_items,
                         gr_vector_void_star& output_items)
 {
     const char* in = (const char*)input_items[0];
-    ssize_t r = 0, bytes_sent = 0, bytes_to_send = 0;
-    ssize_t total_size = noutput_items * d_itemsize;
+    size_t bytes_sent = 0;
+    size_t total_size = noutput_items * d_itemsize;
 
     gr::thread::scoped_lock guard(d_mutex); // protect d_socket
 
+    if (!d_connected)
+        return noutput_items; // discarded for lack of connection
+
+    // Hand the payloads over s_batch at a time. They are linked so that
+    // they leave in order, and all are done before the input is released.
     while (bytes_sent < total_size) {
-        bytes_to_send = std::min((ssize_t)d_payload_size, (total_size - bytes_sent));
-
-        if (d_connected) {
-            try {
-                r = d_socket->send_to(
-                    boost::asio::buffer((void*)(in + bytes_sent), bytes_to_send),
-                    d_endpoint);
-            } catch (std::exception& e) {
-                GR_LOG_ERROR(d_logger, boost::format("send error: %s") % e.what());
-                return -1;
-            }
-        } else
-            r = bytes_to_send; // discarded for lack of connection
-        bytes_sent += r;
+        unsigned int n = 0;
+        while (n < s_batch && bytes_sent < total_size) {
+            io_engine::request& req = d_reqs[n++];
+            req.fd = d_socket->native_handle();
+            req.buf = (void*)(in + bytes_sent);
+            req.len = std::min((size_t)d_payload_size, total_size - bytes_sent);
+            req.link = true;
+            bytes_sent += req.len;
+        }
+        d_reqs[n - 1].link = false;
+
+        d_engine->submit(&d_req_ptrs[0], n);
+        int error = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            d_engine->wait(&d_reqs[i]);
+            // A connected socket reports an ICMP port unreachable from
+            // an earlier payload as ECONNREFUSED, which also cancels the
+            // rest of the chain. Nobody is listening; those are lost,
+            // as they would be on an unconnected socket.
+            int64_t r = d_reqs[i].result;
+            if (r < 0 && r != -ECONNREFUSED && r != -ECANCELED && !error)
+                error = -r;
+        }
+        if (error) {
+            GR_LOG_ERROR(d_logger, boost::format("send error: %s") % strerror(error));
+            return -1;
+        }
     }
 
     return noutput_items;
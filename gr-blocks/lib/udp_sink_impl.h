@@ -24,7 +24,9 @@
 #define INCLUDED_GR_UDP_SINK_IMPL_H
 
 #include <gnuradio/blocks/udp_sink.h>
+#include <gnuradio/io_engine.h>
 #include <boost/asio.hpp>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -43,6 +45,11 @@ private:
     boost::asio::ip::udp::endpoint d_endpoint;
     boost::asio::io_service d_io_service;
 
+    // One request per payload, submitted as a linked batch
+    io_engine::sptr d_engine;
+    std::vector<io_engine::request> d_reqs;
+    std::vector<io_engine::request*> d_req_ptrs;
+
 public:
     udp_sink_impl(
         size_t itemsize, const std::string& host, int port, int payload_size, bool eof);
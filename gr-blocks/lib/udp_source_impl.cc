@@ -31,35 +31,91 @@
 #include <errno.h>
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
 #include <stdexcept>
 
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+
 namespace gr {
 namespace blocks {
 
-const int udp_source_impl::BUF_SIZE_PAYLOADS =
-    gr::prefs::singleton()->get_long("udp_blocks", "buf_size_payloads", 50);
+namespace {
+// Most datagrams taken from the socket per system call
+const int max_batch = 32;
+} // namespace
 
-udp_source::sptr udp_source::make(
-    size_t itemsize, const std::string& ipaddr, int port, int payload_size, bool eof)
+const int udp_source_impl::BUF_SIZE_PAYLOADS =
+    gr::prefs::singleton()->get_long("udp_blocks", "buf_size_payloads", 256);
+
+udp_source::sptr udp_source::make(size_t itemsize,
+                                  const std::string& ipaddr,
+                                  int port,
+                                  int payload_size,
+                                  bool eof,
+                                  udp_header_type header,
+                                  int rcvbuf_size,
+                                  int busy_poll_us)
 {
-    return gnuradio::get_initial_sptr(
-        new udp_source_impl(itemsize, ipaddr, port, payload_size, eof));
+    return gnuradio::get_initial_sptr(new udp_source_impl(itemsize,
+                                                          ipaddr,
+                                                          port,
+                                                          payload_size,
+                                                          eof,
+                                                          header,
+                                                          rcvbuf_size,
+                                                          busy_poll_us));
 }
 
-udp_source_impl::udp_source_impl(
-    size_t itemsize, const std::string& host, int port, int payload_size, bool eof)
+udp_source_impl::udp_source_impl(size_t itemsize,
+                                 const std::string& host,
+                                 int port,
+                                 int payload_size,
+                                 bool eof,
+                                 udp_header_type header,
+                                 int rcvbuf_size,
+                                 int busy_poll_us)
     : sync_block(
           "udp_source", io_signature::make(0, 0, 0), io_signature::make(1, 1, itemsize)),
       d_itemsize(itemsize),
       d_payload_size(payload_size),
       d_eof(eof),
       d_connected(false),
-      d_residual(0),
-      d_sent(0)
+      d_header(header),
+      d_header_size(0),
+      d_rcvbuf_size(rcvbuf_size),
+      d_busy_poll_us(busy_poll_us),
+      d_head(0),
+      d_count(0),
+      d_bytes(0),
+      d_sent(0),
+      d_have_seq(false),
+      d_next_seq(0),
+      d_overflow(0),
+      d_received(0),
+      d_lost(0),
+      d_gap_key(pmt::mp("udp_gap"))
 {
-    // Give us some more room to play.
-    d_rxbuf = new char[4 * d_payload_size];
-    d_residbuf = new char[BUF_SIZE_PAYLOADS * d_payload_size];
+    switch (header) {
+    case UDP_HEADER_NONE:
+        break;
+    case UDP_HEADER_SEQNUM64:
+        d_header_size = 8;
+        break;
+    case UDP_HEADER_SEQNUM32_BE:
+        d_header_size = 4;
+        break;
+    default:
+        throw std::invalid_argument("udp_source: unknown header type");
+    }
+    if (payload_size <= d_header_size)
+        throw std::invalid_argument("udp_source: payload_size too small for header");
+
+    const int nslots = std::max(BUF_SIZE_PAYLOADS, max_batch);
+    d_slots.resize((size_t)nslots * d_payload_size);
+    d_ring.resize(nslots);
+    d_scratch.resize(d_payload_size);
 
     connect(host, port);
 }
@@ -68,9 +124,6 @@ udp_source_impl::~udp_source_impl()
 {
     if (d_connected)
         disconnect();
-
-    delete[] d_rxbuf;
-    delete[] d_residbuf;
 }
 
 void udp_source_impl::connect(const std::string& host, int port)
@@ -95,9 +148,16 @@ void udp_source_impl::connect(const std::string& host, int port)
 
         boost::asio::socket_base::reuse_address roption(true);
         d_socket->set_option(roption);
+        set_socket_options();
 
         d_socket->bind(d_endpoint);
 
+        // The receive handler drains the socket until it would block
+        d_socket->non_blocking(true);
+
+        // A new sender starts its own count
+        d_have_seq = false;
+
         start_receive();
         d_udp_thread =
             gr::thread::thread(boost::bind(&udp_source_impl::run_io_service, this));
@@ -129,46 +189,209 @@ int udp_source_impl::get_port(void)
     return d_socket->local_endpoint().port();
 }
 
+uint64_t udp_source_impl::packets_received()
+{
+    boost::lock_guard<gr::thread::mutex> lock(d_udp_mutex);
+    return d_received;
+}
+
+uint64_t udp_source_impl::packets_lost()
+{
+    boost::lock_guard<gr::thread::mutex> lock(d_udp_mutex);
+    return d_lost;
+}
+
+void udp_source_impl::set_socket_options()
+{
+    if (d_rcvbuf_size > 0) {
+        boost::system::error_code ec;
+        d_socket->set_option(boost::asio::socket_base::receive_buffer_size(d_rcvbuf_size),
+                             ec);
+
+        // Linux silently caps the size at net.core.rmem_max
+        boost::asio::socket_base::receive_buffer_size actual;
+        d_socket->get_option(actual);
+        if (ec || actual.value() < d_rcvbuf_size) {
+            GR_LOG_WARN(d_logger,
+                        boost::format("receive buffer is %d bytes, asked for %d") %
+                            actual.value() % d_rcvbuf_size);
+        }
+    }
+
+    if (d_busy_poll_us > 0) {
+#ifdef SO_BUSY_POLL
+        int v = d_busy_poll_us;
+        if (setsockopt(
+                d_socket->native_handle(), SOL_SOCKET, SO_BUSY_POLL, &v, sizeof(v)) !=
+            0) {
+            GR_LOG_WARN(d_logger,
+                        boost::format("could not enable busy polling: %s") %
+                            strerror(errno));
+        }
+#else
+        GR_LOG_WARN(d_logger, "busy polling not supported here");
+#endif
+    }
+}
+
 void udp_source_impl::start_receive()
 {
-    d_socket->async_receive_from(
-        boost::asio::buffer((void*)d_rxbuf, d_payload_size),
-        d_endpoint_rcvd,
-        boost::bind(&udp_source_impl::handle_read,
-                    this,
-                    boost::asio::placeholders::error,
-                    boost::asio::placeholders::bytes_transferred));
+    // Only wait for the socket to become readable; handle_read takes
+    // everything that is queued in as few calls as possible.
+    d_socket->async_receive(boost::asio::null_buffers(),
+                            boost::bind(&udp_source_impl::handle_read,
+                                        this,
+                                        boost::asio::placeholders::error));
+}
+
+// Fill bufs[0..nbufs) with datagrams without blocking; returns the
+// number received and their lengths in lens.
+int udp_source_impl::receive_batch(char* const* bufs, int* lens, int nbufs)
+{
+#ifdef HAVE_RECVMMSG
+    struct mmsghdr msgs[max_batch];
+    struct iovec iov[max_batch];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < nbufs; i++) {
+        iov[i].iov_base = bufs[i];
+        iov[i].iov_len = d_payload_size;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int n = recvmmsg(d_socket->native_handle(), msgs, nbufs, MSG_DONTWAIT, NULL);
+    if (n < 0)
+        return 0;
+    for (int i = 0; i < n; i++)
+        lens[i] = msgs[i].msg_len;
+    return n;
+#else
+    boost::system::error_code ec;
+    int n = 0;
+    for (; n < nbufs; n++) {
+        lens[n] = d_socket->receive(boost::asio::buffer(bufs[n], d_payload_size), 0, ec);
+        if (ec)
+            break;
+    }
+    return n;
+#endif
+}
+
+// Returns the number of packets missing before the one carrying hdr
+uint64_t udp_source_impl::check_sequence(const unsigned char* hdr)
+{
+    uint64_t seq = 0;
+    uint64_t mask;
+    if (d_header == UDP_HEADER_SEQNUM64) {
+        for (int i = 7; i >= 0; i--)
+            seq = (seq << 8) | hdr[i];
+        mask = ~(uint64_t)0;
+    } else {
+        for (int i = 0; i < 4; i++)
+            seq = (seq << 8) | hdr[i];
+        mask = 0xffffffff;
+    }
+
+    uint64_t gap = 0;
+    if (d_have_seq && seq != d_next_seq) {
+        // A step backwards is a late or repeated packet, or the sender
+        // restarting; either way just follow it.
+        uint64_t diff = (seq - d_next_seq) & mask;
+        if (diff <= mask / 2)
+            gap = diff;
+    }
+    d_have_seq = true;
+    d_next_seq = (seq + 1) & mask;
+    return gap;
 }
 
-void udp_source_impl::handle_read(const boost::system::error_code& error,
-                                  size_t bytes_transferred)
+void udp_source_impl::handle_read(const boost::system::error_code& error)
 {
-    if (!error) {
+    if (error) {
+        start_receive();
+        return;
+    }
+
+    const size_t nslots = d_ring.size();
+    char* bufs[max_batch];
+    int lens[max_batch];
+
+    while (true) {
+        size_t tail, nfree;
         {
             boost::lock_guard<gr::thread::mutex> lock(d_udp_mutex);
-            if (d_eof && (bytes_transferred == 0)) {
-                // If we are using EOF notification, test for it and don't
-                // add anything to the output.
-                d_residual = WORK_DONE;
-                d_cond_wait.notify_one();
-                return;
+            tail = (d_head + d_count) % nslots;
+            nfree = nslots - d_count;
+        }
+
+        // Receive straight into the free slots after the tail. If the
+        // ring is full the packets still have to be taken off the
+        // socket, and are counted as lost.
+        int n = std::min<size_t>(std::min<size_t>(nfree, nslots - tail), max_batch);
+        const bool full = (n == 0);
+        if (full)
+            n = max_batch;
+        for (int i = 0; i < n; i++)
+            bufs[i] = full ? &d_scratch[0] : &d_slots[(tail + i) * d_payload_size];
+
+        int got = receive_batch(bufs, lens, n);
+        if (got == 0)
+            break;
+
+        if (full) {
+            if (d_overflow == 0) {
+                GR_LOG_WARN(d_logger, "Too much data; dropping packets.");
+            }
+            d_overflow += got;
+            boost::lock_guard<gr::thread::mutex> lock(d_udp_mutex);
+            d_received += got;
+            continue;
+        }
+
+        size_t nbytes = 0;
+        uint64_t lost = 0;
+        for (int i = 0; i < got; i++) {
+            packet& p = d_ring[tail + i];
+            p.data = bufs[i] + d_header_size;
+            p.len = 0;
+            p.gap = 0;
+            p.eof = false;
+
+            if (lens[i] == 0) {
+                // If we are using EOF notification, test for it and
+                // don't add anything to the output.
+                p.eof = d_eof;
+                continue;
+            }
+            if (lens[i] <= d_header_size)
+                continue;
+
+            p.len = lens[i] - d_header_size;
+            if (d_header_size) {
+                // The counter also covers what was dropped here
+                p.gap = check_sequence((const unsigned char*)bufs[i]);
+                d_overflow = 0;
             } else {
-                // Make sure we never go beyond the boundary of the
-                // residual buffer.  This will just drop the last bit of
-                // data in the buffer if we've run out of room.
-                if ((int)(d_residual + bytes_transferred) >=
-                    (BUF_SIZE_PAYLOADS * d_payload_size)) {
-                    GR_LOG_WARN(d_logger, "Too much data; dropping packet.");
-                } else {
-                    // otherwise, copy received data into local buffer for
-                    // copying later.
-                    memcpy(d_residbuf + d_residual, d_rxbuf, bytes_transferred);
-                    d_residual += bytes_transferred;
-                }
+                p.gap = d_overflow;
+                d_overflow = 0;
             }
-            d_cond_wait.notify_one();
+            nbytes += p.len;
+            lost += p.gap;
+        }
+
+        if (lost > 0) {
+            GR_LOG_DEBUG(d_debug_logger,
+                         boost::format("%1% packets missing") % lost);
         }
+
+        boost::lock_guard<gr::thread::mutex> lock(d_udp_mutex);
+        d_count += got;
+        d_bytes += nbytes;
+        d_received += got;
+        d_lost += lost;
+        d_cond_wait.notify_one();
     }
+
     start_receive();
 }
 
@@ -180,36 +403,91 @@ int udp_source_impl::work(int noutput_items,
 
     char* out = (char*)output_items[0];
 
-    // Use async receive_from to get data from UDP buffer and wait
-    // on a conditional signal before proceeding. We use this
-    // because the conditional wait is interruptible while a
-    // synchronous receive_from is not.
-    boost::unique_lock<boost::mutex> lock(d_udp_mutex);
+    // The receive handler runs in the io_service thread; wait on a
+    // conditional signal for it, with a timeout so the wait is
+    // interruptible and never blocks the work function for good.
+    size_t head, count, nbytes;
+    {
+        boost::unique_lock<boost::mutex> lock(d_udp_mutex);
+        if (d_bytes < d_itemsize)
+            d_cond_wait.timed_wait(lock, boost::posix_time::milliseconds(10));
+        head = d_head;
+        count = d_count;
+        nbytes = d_bytes;
+    }
 
-    // use timed_wait to avoid permanent blocking in the work function
-    d_cond_wait.timed_wait(lock, boost::posix_time::milliseconds(10));
+    // Whole items only; a split item waits for the rest of it. The
+    // filled packets are not touched by the receive handler.
+    const size_t want =
+        std::min<size_t>(d_itemsize * noutput_items, nbytes - nbytes % d_itemsize);
+    const size_t nslots = d_ring.size();
+    size_t copied = 0;
+    size_t dropped = 0;
+    size_t npkts = 0;
+    bool eof = false;
+
+    while (npkts < count) {
+        const packet& p = d_ring[(head + npkts) % nslots];
+        if (p.eof) {
+            // Hand out what came before it first
+            if (copied == 0) {
+                npkts++;
+                eof = true;
+            }
+            break;
+        }
+        if (copied == want) {
+            if (copied == 0) {
+                // Less than an item is left. If the stream ends after
+                // it, the item is never completed: drop it and finish.
+                size_t k = npkts;
+                while (k < count && !d_ring[(head + k) % nslots].eof) {
+                    dropped += d_ring[(head + k) % nslots].len;
+                    k++;
+                }
+                if (k < count) {
+                    dropped -= d_sent;
+                    d_sent = 0;
+                    npkts = k + 1;
+                    eof = true;
+                }
+            }
+            break;
+        }
 
-    if (d_residual < 0) {
-        return d_residual;
+        if (d_sent == 0 && p.gap > 0)
+            add_item_tag(0,
+                         nitems_written(0) + copied / d_itemsize,
+                         d_gap_key,
+                         pmt::from_uint64(p.gap),
+                         alias_pmt());
+
+        size_t n = std::min<size_t>(p.len - d_sent, want - copied);
+        memcpy(out + copied, p.data + d_sent, n);
+        copied += n;
+        d_sent += n;
+        if (d_sent == p.len) {
+            d_sent = 0;
+            npkts++;
+        }
     }
 
-    int bytes_left_in_buffer = (int)(d_residual - d_sent);
-    int bytes_to_send = std::min<int>(d_itemsize * noutput_items, bytes_left_in_buffer);
-
-    // Copy the received data in the residual buffer to the output stream
-    memcpy(out, d_residbuf + d_sent, bytes_to_send);
-    int nitems = bytes_to_send / d_itemsize;
+    {
+        boost::lock_guard<gr::thread::mutex> lock(d_udp_mutex);
+        d_head = (head + npkts) % nslots;
+        d_count -= npkts;
+        d_bytes -= copied + (eof ? dropped : 0);
+    }
 
-    // Keep track of where we are if we don't have enough output
-    // space to send all the data in the residbuf.
-    if (bytes_to_send == bytes_left_in_buffer) {
-        d_residual = 0;
-        d_sent = 0;
-    } else {
-        d_sent += bytes_to_send;
+    if (eof) {
+        if (dropped > 0)
+            GR_LOG_WARN(d_logger,
+                        boost::format("dropping %1% bytes of a partial item at EOF") %
+                            dropped);
+        return WORK_DONE;
     }
 
-    return nitems;
+    return copied / d_itemsize;
 }
 
 } /* namespace blocks */
@@ -27,6 +27,7 @@
 #include <gnuradio/thread/thread.h>
 #include <boost/asio.hpp>
 #include <boost/format.hpp>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -34,37 +35,69 @@ namespace blocks {
 class udp_source_impl : public udp_source
 {
 private:
+    struct packet {
+        char* data;    // payload, after any header
+        int len;       // payload bytes
+        uint64_t gap;  // packets missing before this one
+        bool eof;      // zero-length packet taken as EOF
+    };
+
     size_t d_itemsize;
     int d_payload_size; // maximum transmission unit (packet length)
     bool d_eof;         // look for an EOF signal
     bool d_connected;   // are we connected?
-    char* d_rxbuf;      // get UDP buffer items
-    char* d_residbuf;   // hold buffer between calls
-    ssize_t d_residual; // hold information about number of bytes stored in residbuf
-    ssize_t d_sent;     // track how much of d_residbuf we've outputted
+    udp_header_type d_header;
+    int d_header_size;
+    int d_rcvbuf_size;
+    int d_busy_poll_us;
+
+    // Ring of received packets; the receive handler fills free slots
+    // and work() empties filled ones, each without the lock held.
+    std::vector<char> d_slots;   // BUF_SIZE_PAYLOADS buffers of d_payload_size
+    std::vector<packet> d_ring;
+    size_t d_head;               // oldest filled packet
+    size_t d_count;              // filled packets
+    size_t d_bytes;              // payload bytes in filled packets
+    int d_sent;                  // bytes of the head packet already output
+    std::vector<char> d_scratch; // receives what does not fit in the ring
+
+    bool d_have_seq;
+    uint64_t d_next_seq;
+    uint64_t d_overflow; // dropped since the last packet stored
+    uint64_t d_received;
+    uint64_t d_lost;
+    pmt::pmt_t d_gap_key;
 
     static const int
-        BUF_SIZE_PAYLOADS; //!< The d_residbuf size in multiples of d_payload_size
+        BUF_SIZE_PAYLOADS; //!< The ring size in multiples of d_payload_size
 
     std::string d_host;
     unsigned short d_port;
 
     boost::asio::ip::udp::socket* d_socket;
     boost::asio::ip::udp::endpoint d_endpoint;
-    boost::asio::ip::udp::endpoint d_endpoint_rcvd;
     boost::asio::io_service d_io_service;
 
     gr::thread::condition_variable d_cond_wait;
     gr::thread::mutex d_udp_mutex;
     gr::thread::thread d_udp_thread;
 
+    void set_socket_options();
     void start_receive();
-    void handle_read(const boost::system::error_code& error, size_t bytes_transferred);
+    void handle_read(const boost::system::error_code& error);
+    int receive_batch(char* const* bufs, int* lens, int nbufs);
+    uint64_t check_sequence(const unsigned char* hdr);
     void run_io_service() { d_io_service.run(); }
 
 public:
-    udp_source_impl(
-        size_t itemsize, const std::string& host, int port, int payload_size, bool eof);
+    udp_source_impl(size_t itemsize,
+                    const std::string& host,
+                    int port,
+                    int payload_size,
+                    bool eof,
+                    udp_header_type header,
+                    int rcvbuf_size,
+                    int busy_poll_us);
     ~udp_source_impl();
 
     void connect(const std::string& host, int port);
@@ -73,6 +106,9 @@ public:
     int payload_size() { return d_payload_size; }
     int get_port();
 
+    uint64_t packets_received();
+    uint64_t packets_lost();
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items);
@@ -24,6 +24,7 @@
 #include "config.h"
 #endif
 
+#include <gnuradio/blocks/repack_bits.h>
 #include <gnuradio/blocks/unpack_k_bits.h>
 #include <gnuradio/io_signature.h>
 #include <iostream>
@@ -45,24 +46,14 @@ void unpack_k_bits::unpack(unsigned char* bits,
                            const unsigned char* bytes,
                            int nbytes) const
 {
-    int n = 0;
-    for (int i = 0; i < nbytes; i++) {
-        unsigned int t = bytes[i];
-        for (int j = d_k - 1; j >= 0; j--)
-            bits[n++] = (t >> j) & 0x01;
-    }
+    unpack_bits(bits, bytes, nbytes, d_k, true);
 }
 
 void unpack_k_bits::unpack_rev(unsigned char* bits,
                                const unsigned char* bytes,
                                int nbytes) const
 {
-    int n = 0;
-    for (int i = 0; i < nbytes; i++) {
-        unsigned int t = bytes[i];
-        for (unsigned int j = 0; j < d_k; j++)
-            bits[n++] = (t >> j) & 0x01;
-    }
+    unpack_bits(bits, bytes, nbytes, d_k, false);
 }
 
 int unpack_k_bits::k() const { return d_k; }
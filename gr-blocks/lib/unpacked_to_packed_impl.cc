@@ -28,6 +28,7 @@
 #include "unpacked_to_packed_impl.h"
 #include <gnuradio/io_signature.h>
 #include <assert.h>
+#include <algorithm>
 
 namespace gr {
 namespace blocks {
@@ -49,7 +50,9 @@ unpacked_to_packed_impl<T>::unpacked_to_packed_impl(unsigned int bits_per_chunk,
             io_signature::make(1, -1, sizeof(T))),
       d_bits_per_chunk(bits_per_chunk),
       d_endianness(endianness),
-      d_index(0)
+      d_repackers(1,
+                  kernel::repack_bits(
+                      bits_per_chunk, sizeof(T) * 8, true, endianness == GR_MSB_FIRST))
 {
     assert(bits_per_chunk <= d_bits_per_type);
     assert(bits_per_chunk > 0);
@@ -62,87 +65,52 @@ unpacked_to_packed_impl<T>::~unpacked_to_packed_impl()
 {
 }
 
+template <class T>
+bool unpacked_to_packed_impl<T>::check_topology(int ninputs, int noutputs)
+{
+    if (ninputs != noutputs)
+        return false;
+    d_repackers.assign(ninputs,
+                       kernel::repack_bits(d_bits_per_chunk,
+                                           d_bits_per_type,
+                                           true,
+                                           d_endianness == GR_MSB_FIRST));
+    return true;
+}
+
 template <class T>
 void unpacked_to_packed_impl<T>::forecast(int noutput_items,
                                           gr_vector_int& ninput_items_required)
 {
-    int input_required =
-        (int)ceil((d_index + noutput_items * 1.0 * d_bits_per_type) / d_bits_per_chunk);
+    int bits = noutput_items * d_bits_per_type - d_repackers[0].pending();
+    int input_required = std::max(0, bits + (int)d_bits_per_chunk - 1) / d_bits_per_chunk;
     unsigned ninputs = ninput_items_required.size();
     for (unsigned int i = 0; i < ninputs; i++) {
         ninput_items_required[i] = input_required;
     }
 }
 
-template <class T>
-unsigned int unpacked_to_packed_impl<T>::get_bit_be1(const T* in_vector,
-                                                     unsigned int bit_addr,
-                                                     unsigned int bits_per_chunk)
-{
-    unsigned int byte_addr = (int)bit_addr / bits_per_chunk;
-    T x = in_vector[byte_addr];
-    unsigned int residue = bit_addr - byte_addr * bits_per_chunk;
-    // printf("Bit addr %d  byte addr %d  residue %d  val
-    // %d\n",bit_addr,byte_addr,residue,(x>>(bits_per_chunk-1-residue))&1);
-    return (x >> (bits_per_chunk - 1 - residue)) & 1;
-}
-
 template <class T>
 int unpacked_to_packed_impl<T>::general_work(int noutput_items,
                                              gr_vector_int& ninput_items,
                                              gr_vector_const_void_star& input_items,
                                              gr_vector_void_star& output_items)
 {
-    unsigned int index_tmp = d_index;
-
     assert(input_items.size() == output_items.size());
     int nstreams = input_items.size();
 
+    // The streams move in lock step so that each holds the same number
+    // of leftover bits.
+    int ninputs = *std::min_element(ninput_items.begin(), ninput_items.end());
+    int nread = 0;
+    int nwritten = 0;
     for (int m = 0; m < nstreams; m++) {
-        const T* in = (T*)input_items[m];
-        T* out = (T*)output_items[m];
-        index_tmp = d_index;
-
-        // per stream processing
-
-        // assert((ninput_items[m]-d_index)*d_bits_per_chunk >=
-        // noutput_items*d_bits_per_type);
-
-        switch (d_endianness) {
-
-        case GR_MSB_FIRST:
-            for (int i = 0; i < noutput_items; i++) {
-                T tmp = 0;
-                for (unsigned int j = 0; j < d_bits_per_type; j++) {
-                    tmp = (tmp << 1) | get_bit_be1(in, index_tmp, d_bits_per_chunk);
-                    index_tmp++;
-                }
-                out[i] = tmp;
-            }
-            break;
-
-        case GR_LSB_FIRST:
-            for (int i = 0; i < noutput_items; i++) {
-                unsigned long tmp = 0;
-                for (unsigned int j = 0; j < d_bits_per_type; j++) {
-                    tmp = (tmp >> 1) | (get_bit_be1(in, index_tmp, d_bits_per_chunk)
-                                        << (d_bits_per_type - 1));
-                    index_tmp++;
-                }
-                out[i] = tmp;
-            }
-            break;
-
-        default:
-            assert(0);
-        }
+        nwritten = d_repackers[m].repack(
+            (T*)output_items[m], noutput_items, (const T*)input_items[m], ninputs, nread);
     }
 
-    d_index = index_tmp;
-    this->consume_each((int)(d_index / d_bits_per_chunk));
-    d_index = d_index % d_bits_per_chunk;
-
-    return noutput_items;
+    this->consume_each(nread);
+    return nwritten;
 }
 
 template class unpacked_to_packed<std::uint8_t>;
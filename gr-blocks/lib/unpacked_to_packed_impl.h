@@ -24,7 +24,9 @@
 #ifndef UNPACKED_TO_PACKED_IMPL_H
 #define UNPACKED_TO_PACKED_IMPL_H
 
+#include <gnuradio/blocks/repack_bits.h>
 #include <gnuradio/blocks/unpacked_to_packed.h>
+#include <vector>
 
 namespace gr {
 namespace blocks {
@@ -35,10 +37,8 @@ class unpacked_to_packed_impl : public unpacked_to_packed<T>
 private:
     unsigned int d_bits_per_chunk;
     endianness_t d_endianness;
-    unsigned int d_index;
     const unsigned int d_bits_per_type = sizeof(T) * 8;
-    unsigned int
-    get_bit_be1(const T* in_vector, unsigned int bit_addr, unsigned int bits_per_chunk);
+    std::vector<kernel::repack_bits> d_repackers; // one per stream
 
 public:
     unpacked_to_packed_impl(unsigned int bits_per_chunk, endianness_t endianness);
@@ -50,7 +50,7 @@ public:
                      gr_vector_const_void_star& input_items,
                      gr_vector_void_star& output_items);
 
-    bool check_topology(int ninputs, int noutputs) { return ninputs == noutputs; }
+    bool check_topology(int ninputs, int noutputs);
 };
 
 } /* namespace blocks */
@@ -55,5 +55,49 @@ class test_file_sink(gr_unittest.TestCase):
             result_data.fromfile(datafile, len(data))
             self.assertFloatTuplesAlmostEqual(expected_result, result_data)
 
+    def test_file_sink_async(self):
+        data = [float(x) for x in range(100000)]
+        expected_result = data
+
+        with tempfile.NamedTemporaryFile() as temp:
+            src = blocks.vector_source_f(data)
+            snk = blocks.file_sink(gr.sizeof_float, temp.name, False,
+                                   nbuffers=64, buffer_size=5000)
+            self.tb.connect(src, snk)
+            self.tb.run()
+
+            self.assertEqual(snk.nitems_dropped(), 0)
+
+            # Check file length (float: 4 * nsamples)
+            file_size = os.stat(temp.name).st_size
+            self.assertEqual(file_size, 4 * len(data))
+
+            # Check file contents
+            datafile = open(temp.name, 'rb')
+            result_data = array.array('f')
+            result_data.fromfile(datafile, len(data))
+            self.assertFloatTuplesAlmostEqual(expected_result, result_data)
+
+    def test_file_sink_async_direct(self):
+        data = [float(x) for x in range(10000)]
+        expected_result = data
+
+        with tempfile.NamedTemporaryFile() as temp:
+            src = blocks.vector_source_f(data)
+            snk = blocks.file_sink(gr.sizeof_float, temp.name, False,
+                                   nbuffers=16, buffer_size=4096,
+                                   direct_io=True, preallocate=1 << 20)
+            self.tb.connect(src, snk)
+            self.tb.run()
+
+            # Preallocation must not change the file size
+            file_size = os.stat(temp.name).st_size
+            self.assertEqual(file_size, 4 * len(data))
+
+            datafile = open(temp.name, 'rb')
+            result_data = array.array('f')
+            result_data.fromfile(datafile, len(data))
+            self.assertFloatTuplesAlmostEqual(expected_result, result_data)
+
 if __name__ == '__main__':
     gr_unittest.run(test_file_sink, "test_file_sink.xml")
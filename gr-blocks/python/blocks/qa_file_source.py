@@ -149,5 +149,36 @@ class test_file_source(gr_unittest.TestCase):
         self.assertEqual(str(tags[1].value), "1")
         self.assertEqual(tags[1].offset, 1000)
 
+    def test_file_source_io_modes(self):
+        expected_result = self._vector[100:100+600]
+
+        for mode in (blocks.FILE_IO_MMAP, blocks.FILE_IO_MMAP_POPULATE,
+                     blocks.FILE_IO_DIRECT):
+            tb = gr.top_block()
+            src = blocks.file_source(gr.sizeof_float, self._datafilename,
+                                     offset=100, len=600, io_mode=mode)
+            snk = blocks.vector_sink_f()
+            tb.connect(src, snk)
+            tb.run()
+
+            result_data = snk.data()
+            self.assertFloatTuplesAlmostEqual(expected_result, result_data)
+
+    def test_file_source_io_modes_repeat(self):
+        expected_result = 3 * self._vector[10:]
+
+        for mode in (blocks.FILE_IO_MMAP, blocks.FILE_IO_DIRECT):
+            tb = gr.top_block()
+            src = blocks.file_source(gr.sizeof_float, self._datafilename, True,
+                                     offset=10, io_mode=mode)
+            self.assertTrue(src.seek(0, os.SEEK_SET))
+            head = blocks.head(gr.sizeof_float, len(expected_result))
+            snk = blocks.vector_sink_f()
+            tb.connect(src, head, snk)
+            tb.run()
+
+            result_data = snk.data()
+            self.assertFloatTuplesAlmostEqual(expected_result, result_data)
+
 if __name__ == '__main__':
     gr_unittest.run(test_file_source, "test_file_source.xml")
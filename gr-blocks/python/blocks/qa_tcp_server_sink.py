@@ -22,11 +22,12 @@
 
 
 from gnuradio import gr, gr_unittest, blocks
+import pmt
 import os
 import socket
 from time import sleep
 
-from threading import Timer
+from threading import Thread, Timer
 from multiprocessing import Process
 
 class test_tcp_sink(gr_unittest.TestCase):
@@ -78,6 +79,113 @@ class test_tcp_sink(gr_unittest.TestCase):
         self.tb_snd = None
         p.join()
 
+    def _stalled_client(self, policy):
+        self.addr = '127.0.0.1'
+        self.itemsize = gr.sizeof_float
+        n_data = 4*1024*1024
+
+        src = blocks.null_source(self.itemsize)
+        hd = blocks.head(self.itemsize, n_data)
+        tcp_snd = blocks.tcp_server_sink(self.itemsize, self.addr, self.port, True,
+                                         policy, 64*1024)
+        self.tb_snd.connect(src, hd, tcp_snd)
+
+        # Connects but never reads
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+        sock.connect((self.addr, self.port))
+        for i in range(50):
+            if tcp_snd.num_clients() == 1:
+                break
+            sleep(0.01)
+        self.assertEqual(1, tcp_snd.num_clients())
+
+        # Must not be held up by the client
+        self.tb_snd.run()
+        return tcp_snd, sock
+
+    def test_drop_oldest(self):
+        self.port = 65511
+        tcp_snd, sock = self._stalled_client(blocks.TCP_OVERFLOW_DROP_OLDEST)
+        stats = tcp_snd.client_stats()
+        self.assertEqual(1, pmt.length(stats))
+        client = pmt.nth(0, stats)
+        dropped = pmt.to_uint64(pmt.dict_ref(client, pmt.intern("bytes_dropped"),
+                                             pmt.PMT_NIL))
+        self.assertTrue(dropped > 0)
+        self.assertEqual(0, tcp_snd.clients_dropped())
+        sock.close()
+
+    def test_disconnect(self):
+        self.port = 65512
+        tcp_snd, sock = self._stalled_client(blocks.TCP_OVERFLOW_DISCONNECT)
+        self.assertEqual(0, tcp_snd.num_clients())
+        self.assertEqual(1, tcp_snd.clients_dropped())
+        sock.close()
+
+    def _small_buffer(self, policy):
+        # A queue smaller than the chunks work() would otherwise build
+        self.addr = '127.0.0.1'
+        self.itemsize = gr.sizeof_float
+        n_data = 64*1024
+        buffer_size = 4*1024
+
+        src = blocks.vector_source_f([float(x) for x in range(n_data)], False)
+        tcp_snd = blocks.tcp_server_sink(self.itemsize, self.addr, self.port, True,
+                                         policy, buffer_size)
+        self.tb_snd.connect(src, tcp_snd)
+
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.connect((self.addr, self.port))
+        for i in range(50):
+            if tcp_snd.num_clients() == 1:
+                break
+            sleep(0.01)
+        self.assertEqual(1, tcp_snd.num_clients())
+
+        received = []
+        def reader():
+            while True:
+                data = sock.recv(65536)
+                if not data:
+                    break
+                received.append(data)
+        t = Thread(target=reader)
+        t.start()
+
+        self.tb_snd.run()
+        stats = tcp_snd.client_stats()
+        dropped = tcp_snd.clients_dropped()
+        del tcp_snd
+        self.tb_snd = None
+        t.join()
+        sock.close()
+
+        # The first chunk fits the idle client's empty queue
+        nbytes = sum(len(d) for d in received)
+        self.assertTrue(nbytes > 0)
+        self.assertEqual(0, nbytes % self.itemsize)
+        return n_data * self.itemsize, nbytes, stats, dropped
+
+    def test_small_buffer_drop_oldest(self):
+        self.port = 65513
+        total, nbytes, stats, dropped = \
+            self._small_buffer(blocks.TCP_OVERFLOW_DROP_OLDEST)
+        self.assertEqual(0, dropped)
+        self.assertEqual(1, pmt.length(stats))
+        client = pmt.nth(0, stats)
+        count = lambda k: pmt.to_uint64(pmt.dict_ref(client, pmt.intern(k),
+                                                     pmt.PMT_NIL))
+        self.assertEqual(total, count("bytes_sent") + count("bytes_dropped") +
+                         count("bytes_queued"))
+        self.assertTrue(count("bytes_sent") > 0)
+
+    def test_small_buffer_disconnect(self):
+        self.port = 65514
+        total, nbytes, stats, dropped = \
+            self._small_buffer(blocks.TCP_OVERFLOW_DISCONNECT)
+        self.assertTrue(nbytes <= total)
+
     def stop_rcv(self):
         self.timeout = True
         self.tb_rcv.stop()
@@ -22,9 +22,11 @@
 
 
 from gnuradio import gr, gr_unittest, blocks
+import pmt
 import numpy
 import os
 import socket
+import struct
 import time
 
 from threading import Timer, Thread
@@ -126,6 +128,62 @@ class test_udp_sink_source(gr_unittest.TestCase):
 
 
 
+    def test_source_partial_eof(self):
+        # A partial item just before EOF is dropped and the block finishes
+        port = 65527
+
+        src_data = [float(x) for x in range(10)]
+        send_data = numpy.array(src_data, dtype=numpy.float32).tobytes()
+
+        udp_rcv = blocks.udp_source(gr.sizeof_float, '127.0.0.1', port)
+        dst = blocks.vector_sink_f()
+        self.tb_rcv.connect(udp_rcv, dst)
+        self.tb_rcv.start()
+        time.sleep(0.5)
+        sendsock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sendsock.sendto(send_data + b'\x00\x01', ('127.0.0.1', port))
+        time.sleep(0.5)
+        sendsock.sendto(b'', ('127.0.0.1', port))
+        self.timeout = False
+        q = Timer(2.0, self.stop_rcv)
+        q.start()
+        self.tb_rcv.wait()
+        q.cancel()
+        sendsock.close()
+
+        self.assertFalse(self.timeout)
+        self.assertEqual(tuple(src_data), tuple(dst.data()))
+
+    def test_source_seqnum(self):
+        port = 65525
+
+        n_per_pkt = 10
+        seqs = [0, 1, 3, 4, 7]   # 2, 5 and 6 lost on the way
+        pkts = [numpy.arange(n_per_pkt, dtype=numpy.float32) + 100*s for s in seqs]
+        expected_result = tuple(float(x) for p in pkts for x in p)
+
+        udp_rcv = blocks.udp_source(gr.sizeof_float, '127.0.0.1', port,
+                                    4*n_per_pkt + 8, True,
+                                    blocks.UDP_HEADER_SEQNUM64, 1 << 20)
+        dst = blocks.vector_sink_f()
+        self.tb_rcv.connect(udp_rcv, dst)
+        self.tb_rcv.start()
+        time.sleep(0.5)
+        sendsock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        for s, p in zip(seqs, pkts):
+            sendsock.sendto(struct.pack('<Q', s) + p.tobytes(), ('127.0.0.1', port))
+        time.sleep(0.5)
+        sendsock.sendto(b'', ('127.0.0.1', port))
+        self.tb_rcv.wait()
+        sendsock.close()
+
+        self.assertEqual(expected_result, tuple(dst.data()))
+        gaps = [(t.offset, pmt.to_uint64(t.value)) for t in dst.tags()
+                if pmt.symbol_to_string(t.key) == 'udp_gap']
+        self.assertEqual([(2*n_per_pkt, 1), (4*n_per_pkt, 2)], gaps)
+        self.assertEqual(3, udp_rcv.packets_lost())
+        self.assertEqual(len(seqs) + 1, udp_rcv.packets_received())
+
     def test_003(self):
         port = 65530
 
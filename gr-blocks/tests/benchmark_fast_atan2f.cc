@@ -0,0 +1,138 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/math.h>
+
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#define ITERATIONS 20000000
+#define BLOCK_SIZE (4 * 1000) // fits in cache
+
+static double timeval_to_double(const struct timeval* tv)
+{
+    return (double)tv->tv_sec + (double)tv->tv_usec * 1e-6;
+}
+
+
+static void benchmark(void test(gr_complex* x, float* y), const char* implementation_name)
+{
+#ifdef HAVE_SYS_RESOURCE_H
+    struct rusage rusage_start;
+    struct rusage rusage_stop;
+#else
+    double clock_start;
+    double clock_end;
+#endif
+    static gr_complex input[BLOCK_SIZE];
+    static float output[BLOCK_SIZE];
+
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        input[i] = gr_complex(cos(0.37 * i), sin(0.37 * i));
+        output[i] = 0;
+    }
+
+    // get starting CPU usage
+#ifdef HAVE_SYS_RESOURCE_H
+    if (getrusage(RUSAGE_SELF, &rusage_start) < 0) {
+        perror("getrusage");
+        exit(1);
+    }
+#else
+    clock_start = (double)clock() * (1000000. / CLOCKS_PER_SEC);
+#endif
+    // do the actual work
+
+    test(input, output);
+
+    // get ending CPU usage
+
+#ifdef HAVE_SYS_RESOURCE_H
+    if (getrusage(RUSAGE_SELF, &rusage_stop) < 0) {
+        perror("getrusage");
+        exit(1);
+    }
+
+    // compute results
+
+    double user = timeval_to_double(&rusage_stop.ru_utime) -
+                  timeval_to_double(&rusage_start.ru_utime);
+
+    double sys = timeval_to_double(&rusage_stop.ru_stime) -
+                 timeval_to_double(&rusage_start.ru_stime);
+
+    double total = user + sys;
+#else
+    clock_end = (double)clock() * (1000000. / CLOCKS_PER_SEC);
+    double total = clock_end - clock_start;
+#endif
+
+    float max_err = 0;
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        double err = std::abs(
+            output[i] - std::atan2((double)input[i].imag(), (double)input[i].real()));
+        max_err = std::max(max_err, (float)err);
+    }
+
+    printf("%18s:  cpu: %6.3f  ns/value: %6.2f  max err: %9.3e\n",
+           implementation_name,
+           total,
+           total * 1e9 / ITERATIONS,
+           max_err);
+}
+
+// ----------------------------------------------------------------
+
+void atan2_loop(gr_complex* x, float* y)
+{
+    for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++) {
+        for (int j = 0; j < BLOCK_SIZE; j++) {
+            y[j] = gr::fast_atan2f(x[j]);
+        }
+    }
+}
+
+void atan2_n(gr_complex* x, float* y)
+{
+    for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++) {
+        gr::fast_atan2f(x, y, BLOCK_SIZE);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    benchmark(atan2_loop, "fast_atan2f");
+    benchmark(atan2_n, "fast_atan2f vector");
+}
@@ -0,0 +1,164 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/blocks/rotator.h>
+#include <gnuradio/expj.h>
+#include <gnuradio/math.h>
+
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#define ITERATIONS 20000000
+#define BLOCK_SIZE (10 * 1000) // fits in cache
+
+#define FREQ 5003.123
+
+static double timeval_to_double(const struct timeval* tv)
+{
+    return (double)tv->tv_sec + (double)tv->tv_usec * 1e-6;
+}
+
+
+static void benchmark(void test(gr_complex* x, gr_complex* y),
+                      const char* implementation_name)
+{
+#ifdef HAVE_SYS_RESOURCE_H
+    struct rusage rusage_start;
+    struct rusage rusage_stop;
+#else
+    double clock_start;
+    double clock_end;
+#endif
+    static gr_complex input[BLOCK_SIZE];
+    static gr_complex output[BLOCK_SIZE];
+
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        input[i] = gr_complex(1, 0);
+        output[i] = gr_complex(0, 0);
+    }
+
+    // get starting CPU usage
+#ifdef HAVE_SYS_RESOURCE_H
+    if (getrusage(RUSAGE_SELF, &rusage_start) < 0) {
+        perror("getrusage");
+        exit(1);
+    }
+#else
+    clock_start = (double)clock() * (1000000. / CLOCKS_PER_SEC);
+#endif
+    // do the actual work
+
+    test(input, output);
+
+    // get ending CPU usage
+
+#ifdef HAVE_SYS_RESOURCE_H
+    if (getrusage(RUSAGE_SELF, &rusage_stop) < 0) {
+        perror("getrusage");
+        exit(1);
+    }
+
+    // compute results
+
+    double user = timeval_to_double(&rusage_stop.ru_utime) -
+                  timeval_to_double(&rusage_start.ru_utime);
+
+    double sys = timeval_to_double(&rusage_stop.ru_stime) -
+                 timeval_to_double(&rusage_start.ru_stime);
+
+    double total = user + sys;
+#else
+    clock_end = (double)clock() * (1000000. / CLOCKS_PER_SEC);
+    double total = clock_end - clock_start;
+#endif
+
+    // The input is all ones, so the last output is the rotator phase
+    // after ITERATIONS - 1 steps of the (float) increment.
+    gr_complex incr = gr_expj(2 * GR_M_PI / FREQ);
+    double step = std::atan2((double)incr.imag(), (double)incr.real());
+    double expected = std::fmod((ITERATIONS - 1) * step, 2 * GR_M_PI);
+    gr_complex err = output[BLOCK_SIZE - 1] - gr_expj(expected);
+
+    printf("%18s:  cpu: %6.3f  steps/sec: %10.3e  phase err: %9.3e\n",
+           implementation_name,
+           total,
+           ITERATIONS / total,
+           std::abs(err));
+}
+
+// ----------------------------------------------------------------
+
+void rotate_loop(gr_complex* x, gr_complex* y)
+{
+    gr::blocks::rotator r;
+
+    r.set_phase_incr(gr_expj(2 * GR_M_PI / FREQ));
+
+    for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++) {
+        for (int j = 0; j < BLOCK_SIZE; j++) {
+            y[j] = r.rotate(x[j]);
+        }
+    }
+}
+
+void rotate_n(gr_complex* x, gr_complex* y)
+{
+    gr::blocks::rotator r;
+
+    r.set_phase_incr(gr_expj(2 * GR_M_PI / FREQ));
+
+    for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++) {
+        r.rotateN(y, x, BLOCK_SIZE);
+    }
+}
+
+void rotate_n_inplace(gr_complex* x, gr_complex* y)
+{
+    gr::blocks::rotator r;
+
+    r.set_phase_incr(gr_expj(2 * GR_M_PI / FREQ));
+
+    for (int i = 0; i < ITERATIONS / BLOCK_SIZE; i++) {
+        for (int j = 0; j < BLOCK_SIZE; j++)
+            y[j] = x[j];
+        r.rotateN(y, y, BLOCK_SIZE);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    benchmark(rotate_loop, "rotate");
+    benchmark(rotate_n, "rotateN");
+    benchmark(rotate_n_inplace, "rotateN in place");
+}
@@ -75,6 +75,28 @@ public:
     virtual void set_fDTs(float fDTs) = 0;
     virtual void set_K(float K) = 0;
     virtual void set_step(float step) = 0;
+
+    /*!
+     * \brief Number of samples between evaluations of the faders.
+     *
+     * The default of 1 evaluates every fader for every sample. With
+     * a larger period the channel taps are computed once per period
+     * and interpolated in between, which is accurate as long as the
+     * period is short against the coherence time (about 1/fDTs
+     * samples).
+     *
+     * Taps are computed a batch of up to 64 periods (at most 4096
+     * samples) ahead. Changing the period or the interpolation starts
+     * over from where the faders are, so the fading process skips
+     * forward by up to one batch plus two periods; its statistics are
+     * not affected.
+     */
+    virtual int tap_update_period() = 0;
+    virtual void set_tap_update_period(int period) = 0;
+
+    //! Interpolate taps with a cubic (Catmull-Rom) instead of a line.
+    virtual bool tap_interp_cubic() = 0;
+    virtual void set_tap_interp_cubic(bool cubic) = 0;
 };
 
 } /* namespace channels */
@@ -22,6 +22,7 @@
 
 #include "fading_model_impl.h"
 #include <gnuradio/io_signature.h>
+#include <volk/volk.h>
 
 
 namespace gr {
@@ -125,12 +126,8 @@ int fading_model_impl::work(int noutput_items,
 {
     const gr_complex* in = (const gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
-    std::vector<gr_complex> ftaps;
-    d_fader.next_samples(ftaps, noutput_items);
-    for (int i = 0; i < noutput_items; i++) {
-        out[i] = in[i] * ftaps[i];
-        // out[i] = in[i] * d_fader.next_sample();
-    }
+    d_fader.next_samples(out, noutput_items);
+    volk_32fc_x2_multiply_32fc(out, in, out, noutput_items);
     return noutput_items;
 }
 
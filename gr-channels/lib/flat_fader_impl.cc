@@ -22,10 +22,24 @@
 
 #include "flat_fader_impl.h"
 #include <gnuradio/math.h>
+#include <gnuradio/sincos.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
 
 namespace gr {
 namespace channels {
 
+/*
+ * Oscillators are evaluated as complex rotators, LANES consecutive
+ * samples at a time, so the inner loops carry no dependency between
+ * lanes and vectorize. Every BLOCK samples the rotators are rebuilt
+ * from the stored phases, which keeps rounding from building up, and
+ * the Doppler shifts pick up the current random walk angle.
+ */
+static const int LANES = 8;
+static const int BLOCK = 256; // a multiple of LANES
+
 flat_fader_impl::flat_fader_impl(unsigned int N, float fDTs, bool LOS, float K, int seed)
     : seed_1((int)seed),
       dist_1(-GR_M_PI, GR_M_PI),
@@ -47,7 +61,9 @@ flat_fader_impl::flat_fader_impl(unsigned int N, float fDTs, bool LOS, float K,
       d_psi(d_N + 1, 0),
       d_phi(d_N + 1, 0),
 
-      d_table(8 * 1024),
+      d_lanes(4 * LANES * (d_N + 1)),
+      d_dl(d_N + 1),
+      d_acc(2 * BLOCK),
 
       scale_sin(sqrtf(1.0 / d_N)),
       scale_los(sqrtf(d_K) / sqrtf(d_K + 1)),
@@ -60,56 +76,151 @@ flat_fader_impl::flat_fader_impl(unsigned int N, float fDTs, bool LOS, float K,
     }
 }
 
-#if FASTSINCOS == 1
-#define _GRFASTSIN(x) gr::fxpt::sin(gr::fxpt::float_to_fixed(x))
-#define _GRFASTCOS(x) gr::fxpt::cos(gr::fxpt::float_to_fixed(x))
-#elif FASTSINCOS == 2
-#define _GRFASTSIN(x) d_table.sin(x)
-#define _GRFASTCOS(x) d_table.cos(x)
-#else
-#define _GRFASTSIN(x) sin(x)
-#define _GRFASTCOS(x) cos(x)
-#endif
+static inline gr_complex phasor(float amp, float x)
+{
+    float s, c;
+    gr::sincosf(x, &s, &c);
+    return gr_complex(amp * c, amp * s);
+}
+
+/*
+ * Loads the lanes of one rotator, LANES real parts followed by LANES
+ * imaginary parts, with r * dw, r * dw^2, ... r * dw^LANES and
+ * returns dw^LANES, the step each lane then takes per LANES samples.
+ */
+static gr_complex start_tone(gr_complex r, gr_complex dw, float* lanes)
+{
+    float* re = lanes;
+    float* im = lanes + LANES;
+    for (int l = 0; l < LANES; l++) {
+        r = gr_complex(r.real() * dw.real() - r.imag() * dw.imag(),
+                       r.real() * dw.imag() + r.imag() * dw.real());
+        re[l] = r.real();
+        im[l] = r.imag();
+    }
+
+    gr_complex dl = dw;
+    for (int l = 1; l < LANES; l *= 2) {
+        dl *= dl;
+    }
+    return dl;
+}
+
+/*
+ * Writes the sum of the real parts of ntones rotators to acc for
+ * nsteps * LANES samples. The tones are independent of each other,
+ * so their updates overlap instead of waiting on one another.
+ */
+static void run_tones(
+    float* lanes, const gr_complex* dl, int ntones, int nsteps, float* acc)
+{
+    for (int s = 0; s < nsteps; s++) {
+        float sum[LANES] = { 0 };
+        for (int t = 0; t < ntones; t++) {
+            float* re = lanes + 2 * t * LANES;
+            float* im = re + LANES;
+            const float wr = dl[t].real(), wi = dl[t].imag();
+            for (int l = 0; l < LANES; l++) {
+                const float x = re[l], y = im[l];
+                sum[l] += x;
+                re[l] = x * wr - y * wi;
+                im[l] = x * wi + y * wr;
+            }
+        }
+        for (int l = 0; l < LANES; l++) {
+            acc[s * LANES + l] = sum[l];
+        }
+    }
+}
 
 void flat_fader_impl::next_samples(std::vector<gr_complex>& Hvec, int n_samples)
 {
     Hvec.resize(n_samples);
-    for (int i = 0; i < n_samples; i++) {
-        gr_complex H(0, 0);
+    if (n_samples > 0) {
+        next_samples(&Hvec[0], n_samples);
+    }
+}
+
+/*
+ * Writes the gains at stride, 2 * stride, ... n_samples * stride
+ * samples ahead to H and moves the fader n_samples * stride samples
+ * ahead. The sinusoid phases advance exactly; the random walk moves
+ * once per block with the mean and variance of the single steps it
+ * replaces.
+ */
+void flat_fader_impl::next_samples(gr_complex* H, int n_samples, int stride)
+{
+    const int ntones = d_N + (d_LOS ? 1 : 0);
+    float* acc_i = &d_acc[0];
+    float* acc_q = &d_acc[BLOCK];
+    float* lanes_i = &d_lanes[0];
+    float* lanes_q = &d_lanes[2 * LANES * (d_N + 1)];
+    const int per_block = std::max(1, BLOCK / stride);
+    const double step = 2 * GR_M_PI * d_fDTs * stride;
+    const float amp = d_LOS ? scale_sin * scale_nlos : scale_sin;
+
+    for (int done = 0; done < n_samples;) {
+        const int m = std::min(n_samples - done, per_block);
+        const int nsteps = (m + LANES - 1) / LANES;
+
+        // Rotators for the in-phase and quadrature sums; the
+        // quadrature part sin(x) is cos(x - pi/2).
         for (int n = 1; n < d_N + 1; n++) {
-            float alpha_n = (2 * GR_M_PI * n - GR_M_PI + d_theta) / (4 * d_N);
-            d_psi[n] =
-                fmod(d_psi[n] + 2 * GR_M_PI * d_fDTs * _GRFASTCOS(alpha_n), 2 * GR_M_PI);
-            d_phi[n] =
-                fmod(d_phi[n] + 2 * GR_M_PI * d_fDTs * _GRFASTCOS(alpha_n), 2 * GR_M_PI);
-            float s_i = scale_sin * _GRFASTCOS(d_psi[n]);
-            float s_q = scale_sin * _GRFASTSIN(d_phi[n]);
-            H += gr_complex(s_i, s_q);
+            const int t = n - 1;
+            double alpha_n = (2 * GR_M_PI * n - GR_M_PI + d_theta) / (4 * d_N);
+            double w = step * cos(alpha_n);
+            gr_complex dw = phasor(1.0f, w);
+            start_tone(phasor(amp, d_psi[n]), dw, lanes_i + 2 * t * LANES);
+            d_dl[t] = start_tone(
+                phasor(amp, d_phi[n] - GR_M_PI / 2), dw, lanes_q + 2 * t * LANES);
+            d_psi[n] = std::fmod(d_psi[n] + m * w, 2 * GR_M_PI);
+            d_phi[n] = std::fmod(d_phi[n] + m * w, 2 * GR_M_PI);
         }
 
         if (d_LOS) {
-            d_psi[0] = fmod(d_psi[0] + 2 * GR_M_PI * d_fDTs * _GRFASTCOS(d_theta_los),
-                            2 * GR_M_PI);
-            float los_i = scale_los * _GRFASTCOS(d_psi[0]);
-            float los_q = scale_los * _GRFASTSIN(d_psi[0]);
-            H = H * scale_nlos + gr_complex(los_i, los_q);
+            const int t = d_N;
+            double w = step * cos(d_theta_los);
+            gr_complex dw = phasor(1.0f, w);
+            gr_complex r = phasor(scale_los, d_psi[0]);
+            start_tone(r, dw, lanes_i + 2 * t * LANES);
+            d_dl[t] = start_tone(
+                gr_complex(r.imag(), -r.real()), dw, lanes_q + 2 * t * LANES);
+            d_psi[0] = std::fmod(d_psi[0] + m * w, 2 * GR_M_PI);
+        }
+
+        run_tones(lanes_i, &d_dl[0], ntones, nsteps, acc_i);
+        run_tones(lanes_q, &d_dl[0], ntones, nsteps, acc_q);
+
+        for (int i = 0; i < m; i++) {
+            H[done + i] = gr_complex(acc_i[i], acc_q[i]);
         }
 
-        update_theta();
-        Hvec[i] = H;
+        update_theta(m * stride);
+        done += m;
     }
 }
 
 gr_complex flat_fader_impl::next_sample()
 {
-    std::vector<gr_complex> v(1);
-    next_samples(v, 1);
-    return v[0];
+    gr_complex H;
+    next_samples(&H, 1);
+    return H;
 }
 
-void flat_fader_impl::update_theta()
+void flat_fader_impl::update_theta() { update_theta(1); }
+
+void flat_fader_impl::update_theta(int nsamples)
 {
-    d_theta += (d_step * rv_2());
+    if (nsamples == 1) {
+        d_theta += (d_step * rv_2());
+    } else {
+        // The sum of nsamples U(0,1) draws has mean nsamples/2 and
+        // variance nsamples/12; a sum of three draws, rescaled, has
+        // those moments and close to the same shape.
+        float u = rv_2() + rv_2() + rv_2() - 1.5f;
+        d_theta += d_step * (0.5f * nsamples + 2.0f * sqrtf(nsamples / 12.0f) * u);
+    }
+
     if (d_theta > GR_M_PI) {
         d_theta = GR_M_PI;
         d_step = -d_step;
@@ -30,11 +30,8 @@
 #include <boost/format.hpp>
 #include <boost/random.hpp>
 
-#include "sincostable.h"
-#include <gnuradio/fxpt.h>
-
-// FASTSINCOS:  0 = slow native,  1 = gr::fxpt impl,  2 = sincostable.h
-#define FASTSINCOS 2
+#include <gnuradio/gr_complex.h>
+#include <vector>
 
 namespace gr {
 namespace channels {
@@ -66,17 +63,19 @@ public:
     std::vector<float> d_psi; // in-phase initial phase
     std::vector<float> d_phi; // quadrature initial phase
 
-    std::vector<float> d_costable;
-
-    sincostable d_table;
+    std::vector<float> d_lanes;    // rotator states, in-phase then quadrature
+    std::vector<gr_complex> d_dl;  // rotator steps per LANES samples
+    std::vector<float> d_acc;      // in-phase and quadrature sums for one block
 
     float scale_sin, scale_los, scale_nlos;
 
     void update_theta();
+    void update_theta(int nsamples);
 
     flat_fader_impl(unsigned int N, float fDTs, bool LOS, float K, int seed);
     gr_complex next_sample();
     void next_samples(std::vector<gr_complex>& HVec, int n_samples);
+    void next_samples(gr_complex* H, int n_samples, int stride = 1);
 
 }; /* class flat_fader_impl */
 } /* namespace channels */
@@ -26,6 +26,7 @@
 #include <gnuradio/fxpt.h>
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
+#include <volk/volk.h>
 
 #include <boost/format.hpp>
 #include <boost/random.hpp>
@@ -40,6 +41,14 @@
 namespace gr {
 namespace channels {
 
+/*
+ * Path gains for knots after the first are generated a batch at a
+ * time, spanning at most KNOT_LOOKAHEAD samples so parameter changes
+ * still take effect soon.
+ */
+static const int KNOT_BATCH = 64;
+static const int KNOT_LOOKAHEAD = 4096;
+
 selective_fading_model::sptr selective_fading_model::make(unsigned int N,
                                                           float fDTs,
                                                           bool LOS,
@@ -67,7 +76,11 @@ selective_fading_model_impl::selective_fading_model_impl(unsigned int N,
                  io_signature::make(1, 1, sizeof(gr_complex))),
       d_delays(delays),
       d_mags(mags),
-      d_sintable(1024)
+      d_sintable(1024),
+      d_update_period(1),
+      d_cubic(false),
+      d_ahead_pos(0),
+      d_ahead_len(0)
 {
     if (mags.size() != delays.size())
         throw std::runtime_error("magnitude and delay vectors must be the same length!");
@@ -83,6 +96,25 @@ selective_fading_model_impl::selective_fading_model_impl(unsigned int N,
     }
     set_history(ntaps);
     d_taps.resize(ntaps, gr_complex(0, 0));
+
+    // Where each path lands on the taps does not change, only the
+    // path gains do; weights are stored in dot product order.
+    d_weights.resize(d_faders.size() * ntaps);
+    for (size_t j = 0; j < d_faders.size(); j++) {
+        for (int k = 0; k < ntaps; k++) {
+            float dist = k - d_delays[j];
+            float interpmag = d_sintable.sinc(GR_M_PI * dist);
+            d_weights[j * ntaps + (ntaps - 1 - k)] = interpmag * d_mags[j];
+        }
+    }
+
+    d_fading.resize(d_faders.size());
+    d_ahead.resize(d_faders.size() * KNOT_BATCH);
+    for (int i = 0; i < 4; i++) {
+        d_knots[i].resize(ntaps);
+        d_coeffs[i].resize(ntaps);
+    }
+    prime_knots();
 }
 
 selective_fading_model_impl::~selective_fading_model_impl()
@@ -92,50 +124,155 @@ selective_fading_model_impl::~selective_fading_model_impl()
     }
 }
 
+void selective_fading_model_impl::set_tap_update_period(int period)
+{
+    if (period < 1) {
+        throw std::invalid_argument("tap update period must be >= 1");
+    }
+    gr::thread::scoped_lock l(d_setlock);
+    d_update_period = period;
+    d_reset = true;
+    d_pos = 0;
+}
+
+void selective_fading_model_impl::set_tap_interp_cubic(bool cubic)
+{
+    gr::thread::scoped_lock l(d_setlock);
+    d_cubic = cubic;
+    d_reset = true;
+    d_pos = 0;
+}
+
+void selective_fading_model_impl::compute_knot(std::vector<gr_complex>& taps,
+                                               bool first)
+{
+    const size_t ntaps = taps.size();
+
+    if (first) {
+        for (size_t j = 0; j < d_faders.size(); j++) {
+            d_fading[j] = d_faders[j]->next_sample();
+        }
+        d_ahead_pos = d_ahead_len = 0;
+    } else {
+        if (d_ahead_pos == d_ahead_len) {
+            d_ahead_len = std::max(
+                1, std::min(KNOT_BATCH, KNOT_LOOKAHEAD / d_update_period));
+            for (size_t j = 0; j < d_faders.size(); j++) {
+                d_faders[j]->next_samples(
+                    &d_ahead[j * KNOT_BATCH], d_ahead_len, d_update_period);
+            }
+            d_ahead_pos = 0;
+        }
+        for (size_t j = 0; j < d_faders.size(); j++) {
+            d_fading[j] = d_ahead[j * KNOT_BATCH + d_ahead_pos];
+        }
+        d_ahead_pos++;
+    }
+
+    for (size_t k = 0; k < ntaps; k++) {
+        gr_complex tap(0, 0);
+        for (size_t j = 0; j < d_faders.size(); j++) {
+            tap += d_fading[j] * d_weights[j * ntaps + k];
+        }
+        taps[k] = tap;
+    }
+}
+
+/*
+ * Knot m holds the taps at the start of segment m. Segment 0 starts
+ * at the fader's next sample; knots further out are one update
+ * period apart. Cubic interpolation needs one knot behind and two
+ * ahead; the one behind starts out as a copy. When priming again
+ * after a reset the faders are not rewound: they already stand past
+ * the knots still held and those left in d_ahead, so the fading
+ * process jumps ahead by that much.
+ */
+void selective_fading_model_impl::prime_knots()
+{
+    compute_knot(d_knots[1], true);
+    d_knots[0] = d_knots[1];
+    compute_knot(d_knots[2], false);
+    compute_knot(d_knots[3], false);
+
+    d_pos = 0;
+    d_fresh = true;
+    d_reset = false;
+}
+
+void selective_fading_model_impl::start_segment()
+{
+    if (d_reset) {
+        prime_knots();
+    }
+
+    if (d_fresh) {
+        d_fresh = false;
+    } else {
+        std::swap(d_knots[0], d_knots[1]);
+        std::swap(d_knots[1], d_knots[2]);
+        std::swap(d_knots[2], d_knots[3]);
+        compute_knot(d_knots[3], false);
+    }
+
+    // Taps over the segment as a polynomial in f = pos / period
+    for (size_t k = 0; k < d_taps.size(); k++) {
+        const gr_complex p0 = d_knots[0][k];
+        const gr_complex p1 = d_knots[1][k];
+        const gr_complex p2 = d_knots[2][k];
+        const gr_complex p3 = d_knots[3][k];
+
+        d_coeffs[0][k] = p1;
+        if (d_cubic) {
+            d_coeffs[1][k] = 0.5f * (p2 - p0);
+            d_coeffs[2][k] = p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3;
+            d_coeffs[3][k] = 0.5f * (p3 - p0) + 1.5f * (p1 - p2);
+        } else {
+            d_coeffs[1][k] = p2 - p1;
+        }
+    }
+}
+
 int selective_fading_model_impl::work(int noutput_items,
                                       gr_vector_const_void_star& input_items,
                                       gr_vector_void_star& output_items)
 {
+    gr::thread::scoped_lock l(d_setlock);
+
     const gr_complex* in = (const gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
 
-    // pregenerate fading components
-    std::vector<std::vector<gr_complex>> fading_taps;
-    for (size_t j = 0; j < d_faders.size(); j++) {
-        fading_taps.push_back(std::vector<gr_complex>());
-        d_faders[j]->next_samples(fading_taps[j], noutput_items);
-    }
+    const unsigned int ntaps = d_taps.size();
+    const int order = d_cubic ? 3 : 1;
 
-    // loop over each output sample
+    // Within a segment the taps are a fixed polynomial in the
+    // position, so each output is a few fixed-tap dot products
+    // combined by Horner's rule.
     for (int i = 0; i < noutput_items; i++) {
-
-        // clear the current values in each tap
-        for (size_t j = 0; j < d_taps.size(); j++) {
-            d_taps[j] = gr_complex(0, 0);
+        if (d_pos == 0) {
+            start_segment();
         }
 
-        // add each flat fading component to the taps
-        for (size_t j = 0; j < d_faders.size(); j++) {
-            gr_complex ff_H(fading_taps[j][i]);
-            // gr_complex ff_H(d_faders[j]->next_sample());
-            for (size_t k = 0; k < d_taps.size(); k++) {
-                float dist = k - d_delays[j];
-                float interpmag = d_sintable.sinc(GR_M_PI * dist);
-                d_taps[k] += ff_H * interpmag * d_mags[j];
-            }
-        }
+        gr_complex sum;
+        volk_32fc_x2_dot_prod_32fc(&sum, &in[i], &d_coeffs[0][0], ntaps);
 
-        // apply the taps and generate output
-        gr_complex sum(0, 0);
-        for (size_t j = 0; j < d_taps.size(); j++) {
-            sum += in[i + j] * d_taps[d_taps.size() - j - 1];
+        if (d_pos) {
+            const float f = d_pos / (float)d_update_period;
+            gr_complex acc, dot;
+            volk_32fc_x2_dot_prod_32fc(&acc, &in[i], &d_coeffs[order][0], ntaps);
+            for (int o = order - 1; o > 0; o--) {
+                volk_32fc_x2_dot_prod_32fc(&dot, &in[i], &d_coeffs[o][0], ntaps);
+                acc = dot + f * acc;
+            }
+            sum += f * acc;
         }
 
-        // assign output
         out[i] = sum;
+
+        if (++d_pos == d_update_period) {
+            d_pos = 0;
+        }
     }
 
-    // return all outputs
     return noutput_items;
 }
 
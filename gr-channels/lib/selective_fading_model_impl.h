@@ -45,6 +45,25 @@ private:
     std::vector<float> d_mags;
     sincostable d_sintable;
 
+    // d_weights[j * ntaps + k]: gain of path j on tap ntaps - 1 - k
+    std::vector<float> d_weights;
+
+    int d_update_period;                 // samples between fader evaluations
+    bool d_cubic;                        // Catmull-Rom instead of linear
+    bool d_reset;                        // restart the knots at the next segment
+    bool d_fresh;                        // knots primed, no segment started yet
+    int d_pos;                           // position within the current segment
+    std::vector<gr_complex> d_fading;    // fader outputs for one knot
+    std::vector<gr_complex> d_ahead;     // fader outputs for the next knots
+    int d_ahead_pos;                     // next unused knot in d_ahead
+    int d_ahead_len;                     // knots per path in d_ahead
+    std::vector<gr_complex> d_knots[4];  // taps at knots m-1 .. m+2, reversed
+    std::vector<gr_complex> d_coeffs[4]; // tap polynomial in the segment
+
+    void compute_knot(std::vector<gr_complex>& taps, bool first);
+    void prime_knots();
+    void start_segment();
+
 public:
     selective_fading_model_impl(unsigned int N,
                                 float fDTs,
@@ -86,6 +105,11 @@ public:
             fader->d_step = step;
         }
     }
+
+    virtual int tap_update_period() { return d_update_period; }
+    virtual void set_tap_update_period(int period);
+    virtual bool tap_interp_cubic() { return d_cubic; }
+    virtual void set_tap_interp_cubic(bool cubic);
 };
 
 } /* namespace channels */
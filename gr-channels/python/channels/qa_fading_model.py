@@ -57,5 +57,18 @@ class test_fading_model(gr_unittest.TestCase):
         #exp_data = snk1.data()
         #self.assertComplexTuplesAlmostEqual(exp_data, dst_data, 5)
 
+    def test_001_mean_power(self):
+        # The fader has unit mean power, with and without a LOS path
+        N = 200000
+        for LOS in (False, True):
+            self.tb = gr.top_block()
+            src = blocks.vector_source_c([1.0, ] * N)
+            op = channels.fading_model(8, fDTs=0.01, LOS=LOS, K=4, seed=0)
+            snk = blocks.vector_sink_c()
+            self.tb.connect(src, op, snk)
+            self.tb.run()
+            power = sum(abs(h)**2 for h in snk.data()) / N
+            self.assertAlmostEqual(power, 1.0, delta=0.05)
+
 if __name__ == '__main__':
     gr_unittest.run(test_fading_model, "test_fading_model.xml")
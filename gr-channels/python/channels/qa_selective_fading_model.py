@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+#
+# Copyright 2019 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+from gnuradio import gr, gr_unittest, blocks, channels
+
+class test_selective_fading_model(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_model(self, period, cubic):
+        N = 20000
+        src = blocks.vector_source_c([1.0, ] * N)
+        op = channels.selective_fading_model(8, 0.001, False, 4.0, 0,
+                                             (0.0, 0.1, 1.3), (1, 0.99, 0.97), 8)
+        op.set_tap_update_period(period)
+        op.set_tap_interp_cubic(cubic)
+        self.assertEqual(period, op.tap_update_period())
+        self.assertEqual(cubic, op.tap_interp_cubic())
+        snk = blocks.vector_sink_c()
+        self.tb.connect(src, op, snk)
+        self.tb.run()
+        return snk.data()
+
+    def test_001_decimated_taps(self):
+        # Taps updated every 16 samples track the per-sample taps
+        # closely when the Doppler spread is slow
+        exp_data = self.run_model(1, False)
+        self.tb = gr.top_block()
+        dst_data = self.run_model(16, False)
+        self.assertComplexTuplesAlmostEqual(exp_data, dst_data, 2)
+
+        self.tb = gr.top_block()
+        dst_data = self.run_model(16, True)
+        self.assertComplexTuplesAlmostEqual(exp_data, dst_data, 2)
+
+    def test_002_strided_fader(self):
+        # With the random walk stopped the faders are deterministic, and
+        # the taps at the knots, computed with a stride of one update
+        # period, are every period-th per-sample tap
+        def run(period):
+            N = 4000
+            src = blocks.vector_source_c([1.0, ] * N)
+            op = channels.selective_fading_model(8, 0.01, False, 4.0, 0,
+                                                 (0.0, ), (1.0, ), 1)
+            op.set_step(0)
+            op.set_tap_update_period(period)
+            snk = blocks.vector_sink_c()
+            self.tb = gr.top_block()
+            self.tb.connect(src, op, snk)
+            self.tb.run()
+            return snk.data()
+
+        exp_data = run(1)
+        dst_data = run(16)
+        self.assertComplexTuplesAlmostEqual(exp_data[::16], dst_data[::16], 4)
+
+if __name__ == '__main__':
+    gr_unittest.run(test_selective_fading_model, "test_selective_fading_model.xml")
@@ -0,0 +1,81 @@
+#!/usr/bin/env python
+#
+# Copyright 2019 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+"""
+Measure the throughput of the adaptive equalizers for a range of
+equalizer lengths, with per-symbol and block tap updates.
+"""
+
+from __future__ import print_function
+from __future__ import unicode_literals
+import time
+import random
+from argparse import ArgumentParser
+from gnuradio import gr
+from gnuradio import blocks, digital
+from gnuradio.eng_arg import eng_float
+
+def make_qpsk_tuple(L):
+    points = digital.constellation_qpsk().points()
+    return tuple(random.choice(points) for x in range(L))
+
+def benchmark(name, creator, ntaps, sps, block_size, total_test_size):
+    tb = gr.top_block()
+    src = blocks.vector_source_c(make_qpsk_tuple(32768), True)
+    head = blocks.head(gr.sizeof_gr_complex, int(total_test_size))
+    op = creator(ntaps, sps)
+    op.set_block_size(block_size)
+    dst = blocks.null_sink(gr.sizeof_gr_complex)
+    tb.connect(src, head, op, dst)
+    start = time.time()
+    tb.run()
+    stop = time.time()
+    delta = stop - start
+    print("%16s: taps: %4d  block: %4d  time: %6.3f  samples/sec: %10.4g" % (
+        name, ntaps, block_size, delta, total_test_size / delta))
+
+def main():
+    parser = ArgumentParser()
+    parser.add_argument("-n", "--ntaps", type=int, nargs="+",
+                        default=[8, 32, 128, 512])
+    parser.add_argument("-b", "--block-size", type=int, nargs="+",
+                        default=[1, 64])
+    parser.add_argument("-t", "--total-input-size", type=eng_float, default=2e6)
+    parser.add_argument("-s", "--sps", type=int, default=1)
+    args = parser.parse_args()
+
+    cnst = digital.constellation_qpsk()
+    equalizers = (
+        ("lms_dd_equalizer", lambda n, sps:
+            digital.lms_dd_equalizer_cc(n, 0.001, sps, cnst.base())),
+        ("cma_equalizer", lambda n, sps:
+            digital.cma_equalizer_cc(n, 1.0, 0.001, sps)),
+    )
+
+    for name, creator in equalizers:
+        for ntaps in args.ntaps:
+            for block_size in args.block_size:
+                benchmark(name, creator, ntaps, args.sps, block_size,
+                          args.total_input_size)
+
+if __name__ == '__main__':
+    main()
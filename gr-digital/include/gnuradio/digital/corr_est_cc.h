@@ -44,6 +44,8 @@ namespace digital {
  * \li tag 'corr_est': the correlation value of the estimates
  * \li tag 'amp_est': 1 over the estimated amplitude
  * \li tag 'corr_start': the start sample of the correlation and the value
+ * \li tag 'pattern_id': index of the detected sequence, when
+ *     correlating against more than one (see set_patterns())
  *
  * \li Optional 2nd output stream providing the advanced correlator output
  *
@@ -115,6 +117,23 @@ public:
     virtual std::vector<gr_complex> symbols() const = 0;
     virtual void set_symbols(const std::vector<gr_complex>& symbols) = 0;
 
+    /*!
+     * \brief Correlate against several sequences at once.
+     *
+     * Replaces the symbols; patterns[0] takes their place. Every
+     * pattern is searched for with its own threshold, and all of them
+     * share one FFT of the input per block. Each detection gets the
+     * tags listed above plus a 'pattern_id' tag with the index of the
+     * pattern. Shorter patterns are padded at the end to the length of
+     * the longest, so the tags of every pattern are placed relative to
+     * the start of its sequence. The optional second output carries
+     * the correlation with patterns[0].
+     *
+     * \param patterns  Sets of symbols to correlate against.
+     */
+    virtual void set_patterns(const std::vector<std::vector<gr_complex>>& patterns) = 0;
+    virtual std::vector<std::vector<gr_complex>> patterns() const = 0;
+
     virtual unsigned int mark_delay() const = 0;
     virtual void set_mark_delay(unsigned int mark_delay) = 0;
 
@@ -26,6 +26,7 @@
 #include <gnuradio/digital/api.h>
 #include <gnuradio/sync_block.h>
 #include <string>
+#include <vector>
 
 namespace gr {
 namespace digital {
@@ -64,6 +65,21 @@ public:
     virtual bool set_access_code(const std::string& access_code) = 0;
     virtual void set_threshold(int threshold) = 0;
     virtual void set_tagname(const std::string& tagname) = 0;
+
+    /*!
+     * \brief Search for several access codes in one pass.
+     *
+     * Replaces the access code. A match of access_codes[i] is tagged
+     * with key tag_names[i]; codes matching at the same sample each
+     * get a tag. set_access_code() and set_tagname() act on the first
+     * code. Returns false, leaving the codes unchanged, if a code is
+     * longer than 64 bits, and throws if the vectors differ in size.
+     *
+     * \param access_codes codes represented with 1 byte per bit
+     * \param tag_names tag key for each code
+     */
+    virtual bool set_access_codes(const std::vector<std::string>& access_codes,
+                                  const std::vector<std::string>& tag_names) = 0;
 };
 
 } /* namespace digital */
@@ -90,6 +90,19 @@ public:
     virtual std::vector<gr_complex> taps() const = 0;
     virtual float gain() const = 0;
     virtual void set_gain(float mu) = 0;
+    /*!
+     * \brief Number of symbols the taps are held fixed for between
+     * updates.
+     *
+     * With the default of 1 the taps are updated after every output
+     * symbol. Larger values select block adaptation: the taps are
+     * updated once per block with the gradient summed over the block,
+     * which for long equalizers is computed with FFTs and is much
+     * cheaper than per-symbol updates. The gain should be scaled down
+     * by about the block size to keep the same convergence behavior.
+     */
+    virtual void set_block_size(int block_size) = 0;
+    virtual int block_size() const = 0;
 };
 
 } /* namespace digital */
@@ -193,8 +193,9 @@ public:
     virtual void update_taps(const std::vector<float>& taps) = 0;
 
     /*!
-     * Used to set the taps of the filters in the filterbank and
-     * differential filterbank.
+     * Partitions \p taps into \p ourtaps and loads the arms into
+     * \p ourfilter, then makes \p taps the new prototype filter as
+     * update_taps() does.
      *
      * WARNING: this should not be used externally and will be moved
      * to a private function in the next API.
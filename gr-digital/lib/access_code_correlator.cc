@@ -0,0 +1,152 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this file; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "access_code_correlator.h"
+
+namespace gr {
+namespace digital {
+
+// Shifts, masks and adds only, so a loop of these vectorizes on any
+// SIMD unit with 64-bit lanes; the popcount instruction does not.
+static inline uint64_t popcount64(uint64_t x)
+{
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    x = x + (x >> 8);
+    x = x + (x >> 16);
+    x = x + (x >> 32);
+    return x & 0x7f;
+}
+
+// The LSBs of in[0..7] as a byte, in[0] in the MSB. The byte loads
+// merge into one 64-bit load, and the multiply gathers the LSB of
+// byte j into bit 63 - j, the top byte of the product.
+static inline uint64_t pack8(const unsigned char in[])
+{
+    uint64_t x = 0;
+    for (int j = 0; j < 8; j++)
+        x |= (uint64_t)in[j] << (8 * j);
+    return ((x & 0x0101010101010101ULL) * 0x8040201008040201ULL) >> 56;
+}
+
+access_code_correlator::access_code_correlator() : d_reg(0), d_threshold(0) {}
+
+bool access_code_correlator::set_codes(const std::vector<std::string>& codes)
+{
+    std::vector<uint64_t> values, masks;
+    for (size_t c = 0; c < codes.size(); c++) {
+        const size_t len = codes[c].length();
+        if (len > 64)
+            return false;
+
+        // set len least significant bits to 1.
+        masks.push_back(len == 0 ? 0 : (~0ULL) >> (64 - len));
+
+        uint64_t value = 0;
+        for (size_t i = 0; i < len; i++)
+            value = (value << 1) | (codes[c][i] & 1);
+        values.push_back(value);
+    }
+
+    d_codes.swap(values);
+    d_masks.swap(masks);
+    return true;
+}
+
+bool access_code_correlator::any_match(const uint64_t windows[WORD_BITS]) const
+{
+    // threshold - nwrong wraps around to set the top bit exactly when
+    // nwrong exceeds the threshold; this avoids a 64-bit compare, which
+    // most SIMD units lack.
+    const uint64_t threshold = d_threshold;
+    uint64_t miss = 1;
+    for (size_t c = 0; c < d_codes.size(); c++) {
+        const uint64_t code = d_codes[c];
+        const uint64_t mask = d_masks[c];
+        for (size_t k = 0; k < WORD_BITS; k++)
+            miss &= (threshold - popcount64((windows[k] ^ code) & mask)) >> 63;
+    }
+    return miss == 0;
+}
+
+bool access_code_correlator::matches_at(uint64_t reg, std::vector<match>& matches) const
+{
+    for (unsigned int c = 0; c < d_codes.size(); c++) {
+        const unsigned int nwrong = popcount64((reg ^ d_codes[c]) & d_masks[c]);
+        if (nwrong <= d_threshold) {
+            match m = { c, nwrong };
+            matches.push_back(m);
+        }
+    }
+    return !matches.empty();
+}
+
+bool access_code_correlator::matches(std::vector<match>& matches) const
+{
+    matches.clear();
+    return matches_at(d_reg, matches);
+}
+
+int access_code_correlator::find(const unsigned char in[],
+                                 int n,
+                                 std::vector<match>& matches)
+{
+    matches.clear();
+
+    int i = 0;
+    while (i < n) {
+        // A word at a time while no code matches in it
+        if (n - i >= WORD_BITS) {
+            uint64_t word = 0;
+            for (int k = 0; k < WORD_BITS; k += 8)
+                word = (word << 8) | pack8(in + i + k);
+
+            // The register after shifting in bit k
+            uint64_t windows[WORD_BITS];
+            for (int k = 0; k < WORD_BITS; k++)
+                windows[k] = ((d_reg << k) << 1) | (word >> (WORD_BITS - 1 - k));
+
+            if (!any_match(windows)) {
+                d_reg = word; // the word fills the whole register
+                i += WORD_BITS;
+                continue;
+            }
+        }
+
+        // Bit by bit in the word with a match, and in the tail
+        const int end = (n - i >= WORD_BITS) ? i + WORD_BITS : n;
+        while (i < end) {
+            d_reg = (d_reg << 1) | (in[i++] & 1);
+            if (matches_at(d_reg, matches))
+                return i;
+        }
+    }
+    return n;
+}
+
+} /* namespace digital */
+} /* namespace gr */
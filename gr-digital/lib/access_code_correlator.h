@@ -0,0 +1,113 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this file; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DIGITAL_ACCESS_CODE_CORRELATOR_H
+#define INCLUDED_DIGITAL_ACCESS_CODE_CORRELATOR_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace digital {
+
+/*!
+ * \brief Searches a bit stream for one or more access codes.
+ * \ingroup internal
+ *
+ * \details
+ * Bits are shifted into a 64-bit register, most recent bit in the
+ * LSB, and a code of N bits matches when the last N bits differ from
+ * it in at most the threshold number of places.
+ *
+ * find() takes 64 bits per step: it packs them into a word, eight at
+ * a time with a multiply, and computes the Hamming distance of every
+ * code at each of the 64 bit positions in one pass over the codes,
+ * with a branch-free popcount the compiler vectorizes. Only a word in
+ * which some code matches is stepped through bit by bit, to locate
+ * the first match.
+ */
+class access_code_correlator
+{
+public:
+    //! A code matching at the current position
+    struct match {
+        unsigned int code;   //!< index of the code
+        unsigned int nwrong; //!< number of bits that differ
+    };
+
+    access_code_correlator();
+
+    /*!
+     * \brief Replace the codes.
+     *
+     * Each code is given as one byte per bit, e.g. "0101110"; only the
+     * LSB of each byte is used. Returns false, leaving the codes
+     * unchanged, if any code is longer than 64 bits.
+     */
+    bool set_codes(const std::vector<std::string>& codes);
+
+    void set_threshold(unsigned int threshold) { d_threshold = threshold; }
+    unsigned int threshold() const { return d_threshold; }
+
+    unsigned int ncodes() const { return d_codes.size(); }
+
+    //! Code \p i, right justified
+    uint64_t code(unsigned int i) const { return d_codes[i]; }
+
+    /*!
+     * \brief Shift bits in until a code matches.
+     *
+     * Shifts in the LSBs of in[0], in[1], ... and stops after the first
+     * bit at which any code matches, filling \p matches with every code
+     * that matches there, in code order. Returns the number of bits
+     * shifted in; \p matches is empty if it is \p n and no code matched
+     * at the last bit.
+     */
+    int find(const unsigned char in[], int n, std::vector<match>& matches);
+
+    //! Shift in the LSB of \p bit without searching
+    void shift(unsigned char bit) { d_reg = (d_reg << 1) | (bit & 1); }
+
+    /*!
+     * \brief Fill \p matches with the codes matching the bits shifted
+     * in so far. Returns false if there are none.
+     */
+    bool matches(std::vector<match>& matches) const;
+
+private:
+    //! Bits find() takes per step
+    static const int WORD_BITS = 64;
+
+    uint64_t d_reg;
+    unsigned int d_threshold;
+    std::vector<uint64_t> d_codes;
+    std::vector<uint64_t> d_masks;
+
+    bool any_match(const uint64_t windows[WORD_BITS]) const;
+    bool matches_at(uint64_t reg, std::vector<match>& matches) const;
+};
+
+} /* namespace digital */
+} /* namespace gr */
+
+#endif /* INCLUDED_DIGITAL_ACCESS_CODE_CORRELATOR_H */
@@ -0,0 +1,195 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this file; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "adaptive_fir.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <cstring>
+
+namespace gr {
+namespace digital {
+
+// Below this many taps the time domain block update is cheaper than
+// the five FFTs the frequency domain one needs.
+static const unsigned int FFT_MIN_TAPS = 32;
+
+adaptive_fir_ccc::adaptive_fir_ccc(const std::vector<gr_complex>& taps)
+    : d_taps(taps),
+      d_block_in(NULL),
+      d_block_nout(0),
+      d_block_decim(1),
+      d_fftsize(0),
+      d_fwdfft(NULL),
+      d_invfft(NULL)
+{
+}
+
+adaptive_fir_ccc::~adaptive_fir_ccc()
+{
+    delete d_fwdfft;
+    delete d_invfft;
+}
+
+void adaptive_fir_ccc::set_taps(const std::vector<gr_complex>& taps) { d_taps = taps; }
+
+gr_complex adaptive_fir_ccc::filter(const gr_complex input[]) const
+{
+    gr_complex out(0, 0);
+    volk_32fc_x2_dot_prod_32fc(&out, input, &d_taps[0], d_taps.size());
+    return out;
+}
+
+// The two update loops work on the interleaved floats so the compiler
+// can vectorize them; written with std::complex they stay scalar.
+
+void adaptive_fir_ccc::update_conj(const gr_complex input[], gr_complex coef)
+{
+    const float cr = coef.real(), ci = coef.imag();
+    const float* x = (const float*)input;
+    float* t = (float*)&d_taps[0];
+    const size_t n = 2 * d_taps.size();
+    for (size_t k = 0; k < n; k += 2) {
+        const float xr = x[k], xi = x[k + 1];
+        t[k] += cr * xr + ci * xi;
+        t[k + 1] += ci * xr - cr * xi;
+    }
+}
+
+void adaptive_fir_ccc::update(const gr_complex input[], gr_complex coef)
+{
+    const float cr = coef.real(), ci = coef.imag();
+    const float* x = (const float*)input;
+    float* t = (float*)&d_taps[0];
+    const size_t n = 2 * d_taps.size();
+    for (size_t k = 0; k < n; k += 2) {
+        const float xr = x[k], xi = x[k + 1];
+        t[k] += cr * xr - ci * xi;
+        t[k + 1] += ci * xr + cr * xi;
+    }
+}
+
+bool adaptive_fir_ccc::use_fft(int noutputs, int decimation) const
+{
+    // Worth it only for long filters and blocks at least that long
+    return d_taps.size() >= FFT_MIN_TAPS &&
+           (unsigned int)(noutputs * decimation) >= d_taps.size();
+}
+
+void adaptive_fir_ccc::resize_fft(int nsamples)
+{
+    if (nsamples <= d_fftsize)
+        return;
+
+    d_fftsize = 1;
+    while (d_fftsize < nsamples)
+        d_fftsize <<= 1;
+
+    delete d_fwdfft;
+    delete d_invfft;
+    d_fwdfft = new fft::fft_complex(d_fftsize, true);
+    d_invfft = new fft::fft_complex(d_fftsize, false);
+    d_xin.resize(d_fftsize);
+}
+
+/*
+ * Overlap-save: with the taps reversed into h, output i is sample
+ * i * decimation + ntaps - 1 of the linear convolution of the block
+ * input with h, and the FFT is long enough that the circular
+ * convolution does not wrap onto those samples.
+ */
+void adaptive_fir_ccc::filter_block(gr_complex output[],
+                                    const gr_complex input[],
+                                    int noutputs,
+                                    int decimation)
+{
+    d_block_in = input;
+    d_block_nout = noutputs;
+    d_block_decim = decimation;
+
+    if (!use_fft(noutputs, decimation)) {
+        for (int i = 0; i < noutputs; i++)
+            output[i] = filter(&input[i * decimation]);
+        return;
+    }
+
+    const int ntaps = d_taps.size();
+    const int nsamples = (noutputs - 1) * decimation + ntaps;
+    resize_fft(nsamples);
+
+    gr_complex* fin = d_fwdfft->get_inbuf();
+    gr_complex* fout = d_fwdfft->get_outbuf();
+
+    memcpy(fin, input, nsamples * sizeof(gr_complex));
+    std::fill(fin + nsamples, fin + d_fftsize, gr_complex(0, 0));
+    d_fwdfft->execute();
+    std::copy(fout, fout + d_fftsize, d_xin.begin());
+
+    std::reverse_copy(d_taps.begin(), d_taps.end(), fin);
+    std::fill(fin + ntaps, fin + d_fftsize, gr_complex(0, 0));
+    d_fwdfft->execute();
+
+    gr_complex* iin = d_invfft->get_inbuf();
+    volk_32fc_x2_multiply_32fc(iin, &d_xin[0], fout, d_fftsize);
+    d_invfft->execute();
+
+    const gr_complex* y = d_invfft->get_outbuf() + ntaps - 1;
+    const float scale = 1.0f / d_fftsize;
+    for (int i = 0; i < noutputs; i++)
+        output[i] = y[i * decimation] * scale;
+}
+
+/*
+ * The gradient for tap k is sum(coefs[i] * conj(x[i * decimation + k])),
+ * the conjugate of the cross-correlation of the block input with the
+ * coefficients placed at their output positions.
+ */
+void adaptive_fir_ccc::update_block_conj(const gr_complex coefs[])
+{
+    if (!use_fft(d_block_nout, d_block_decim)) {
+        for (int i = 0; i < d_block_nout; i++)
+            update_conj(&d_block_in[i * d_block_decim], coefs[i]);
+        return;
+    }
+
+    gr_complex* fin = d_fwdfft->get_inbuf();
+    std::fill(fin, fin + d_fftsize, gr_complex(0, 0));
+    for (int i = 0; i < d_block_nout; i++)
+        fin[i * d_block_decim] = coefs[i];
+    d_fwdfft->execute();
+
+    gr_complex* iin = d_invfft->get_inbuf();
+    volk_32fc_x2_multiply_conjugate_32fc(
+        iin, &d_xin[0], d_fwdfft->get_outbuf(), d_fftsize);
+    d_invfft->execute();
+
+    const gr_complex* corr = d_invfft->get_outbuf();
+    const float scale = 1.0f / d_fftsize;
+    for (unsigned int k = 0; k < d_taps.size(); k++)
+        d_taps[k] += std::conj(corr[k]) * scale;
+}
+
+} /* namespace digital */
+} /* namespace gr */
@@ -0,0 +1,108 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this file; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DIGITAL_ADAPTIVE_FIR_H
+#define INCLUDED_DIGITAL_ADAPTIVE_FIR_H
+
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/gr_complex.h>
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+namespace gr {
+namespace digital {
+
+/*!
+ * \brief Filter and tap update kernels shared by the adaptive
+ * equalizers.
+ * \ingroup internal
+ *
+ * \details
+ * The taps are kept in the order they are applied to the input:
+ * the output for the samples at x is sum(x[k] * taps[k]). This is the
+ * order filter::kernel::fir_filter_ccc keeps internally and the order
+ * the equalizers report from taps().
+ *
+ * Sample by sample adaptation alternates filter() with update() or
+ * update_conj(). Block adaptation holds the taps fixed for a block of
+ * outputs: filter_block() produces the outputs, the caller computes
+ * one update coefficient per output, and update_block_conj() applies
+ * the summed gradient. For long filters both steps run in the
+ * frequency domain (overlap-save fast block LMS), which costs a few
+ * FFTs per block instead of two passes over the taps per output.
+ */
+class adaptive_fir_ccc : boost::noncopyable
+{
+public:
+    adaptive_fir_ccc(const std::vector<gr_complex>& taps);
+    ~adaptive_fir_ccc();
+
+    void set_taps(const std::vector<gr_complex>& taps);
+    const std::vector<gr_complex>& taps() const { return d_taps; }
+    unsigned int ntaps() const { return d_taps.size(); }
+
+    //! Output for the ntaps() samples at \p input.
+    gr_complex filter(const gr_complex input[]) const;
+
+    //! taps[k] += coef * conj(input[k])
+    void update_conj(const gr_complex input[], gr_complex coef);
+
+    //! taps[k] += coef * input[k]
+    void update(const gr_complex input[], gr_complex coef);
+
+    /*!
+     * \brief Filter a block with the current taps.
+     *
+     * Output i is filter(&input[i * decimation]).
+     */
+    void filter_block(gr_complex output[],
+                      const gr_complex input[],
+                      int noutputs,
+                      int decimation);
+
+    /*!
+     * \brief Apply update_conj(&input[i * decimation], coefs[i]) for
+     * the block passed to the preceding filter_block().
+     */
+    void update_block_conj(const gr_complex coefs[]);
+
+private:
+    std::vector<gr_complex> d_taps;
+
+    // Block adaptation state
+    const gr_complex* d_block_in;
+    int d_block_nout;
+    int d_block_decim;
+
+    int d_fftsize;
+    fft::fft_complex* d_fwdfft;
+    fft::fft_complex* d_invfft;
+    std::vector<gr_complex> d_xin; // spectrum of the block input
+
+    bool use_fft(int noutputs, int decimation) const;
+    void resize_fft(int nsamples);
+};
+
+} /* namespace digital */
+} /* namespace gr */
+
+#endif /* INCLUDED_DIGITAL_ADAPTIVE_FIR_H */
@@ -23,20 +23,24 @@
 #ifndef INCLUDED_DIGITAL_CMA_EQUALIZER_CC_IMPL_H
 #define INCLUDED_DIGITAL_CMA_EQUALIZER_CC_IMPL_H
 
+#include "adaptive_fir.h"
 #include <gnuradio/digital/cma_equalizer_cc.h>
-#include <gnuradio/filter/fir_filter.h>
 #include <gnuradio/math.h>
 #include <stdexcept>
 
 namespace gr {
 namespace digital {
 
-class cma_equalizer_cc_impl : public cma_equalizer_cc, filter::kernel::fir_filter_ccc
+class cma_equalizer_cc_impl : public cma_equalizer_cc
 {
 private:
+    adaptive_fir_ccc d_fir;
     std::vector<gr_complex> d_new_taps;
     bool d_updated;
     gr_complex d_error;
+    int d_block_size;
+    int d_new_block_size;
+    std::vector<gr_complex> d_coefs;
 
     float d_modulus;
     float d_mu;
@@ -73,6 +77,9 @@ public:
         d_modulus = mod;
     }
 
+    int block_size() const { return d_new_block_size; }
+    void set_block_size(int block_size);
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items);
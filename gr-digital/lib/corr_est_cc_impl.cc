@@ -32,6 +32,8 @@
 #include <volk/volk.h>
 #include <boost/format.hpp>
 #include <boost/math/special_functions/round.hpp>
+#include <algorithm>
+#include <stdexcept>
 
 namespace gr {
 namespace digital {
@@ -54,7 +56,10 @@ corr_est_cc_impl::corr_est_cc_impl(const std::vector<gr_complex>& symbols,
     : sync_block("corr_est_cc",
                  io_signature::make(1, 1, sizeof(gr_complex)),
                  io_signature::make(1, 2, sizeof(gr_complex))),
-      d_src_id(pmt::intern(alias()))
+      d_src_id(pmt::intern(alias())),
+      d_stashed_mark_delay(mark_delay),
+      d_stashed_threshold(threshold),
+      d_corr(NULL)
 {
     d_sps = sps;
     d_threshold_method = threshold_method;
@@ -65,42 +70,8 @@ corr_est_cc_impl::corr_est_cc_impl(const std::vector<gr_complex>& symbols,
     // this ensures we optimally call the volk routines.
     const size_t nitems = 24 * 1024;
     set_max_noutput_items(nitems);
-    d_corr = (gr_complex*)volk_malloc(sizeof(gr_complex) * nitems, volk_get_alignment());
-    d_corr_mag = (float*)volk_malloc(sizeof(float) * nitems, volk_get_alignment());
 
-    // Create time-reversed conjugate of symbols
-    d_symbols = symbols;
-    for (size_t i = 0; i < d_symbols.size(); i++) {
-        d_symbols[i] = conj(d_symbols[i]);
-    }
-    std::reverse(d_symbols.begin(), d_symbols.end());
-
-    set_mark_delay(mark_delay);
-    set_threshold(threshold);
-
-    // Correlation filter
-    d_filter = new kernel::fft_filter_ccc(1, d_symbols);
-
-    // Per comments in gr-filter/include/gnuradio/filter/fft_filter.h,
-    // set the block output multiple to the FFT filter kernel's internal,
-    // assumed "nsamples", to ensure the scheduler always passes a
-    // proper number of samples.
-    int nsamples;
-    nsamples = d_filter->set_taps(d_symbols);
-    set_output_multiple(nsamples);
-
-    // It looks like the kernel::fft_filter_ccc stashes a tail between
-    // calls, so that contains our filtering history (I think).  The
-    // fft_filter_ccc block (which calls the kernel::fft_filter_ccc) sets
-    // the history to 1 (0 history items), so let's follow its lead.
-    // set_history(1);
-
-    // We'll (ab)use the history for our own purposes of tagging back in time.
-    // Keep a history of the length of the sync word to delay for tagging.
-    set_history(d_symbols.size() + 1);
-
-    declare_sample_delay(1, 0);
-    declare_sample_delay(0, d_symbols.size());
+    _set_patterns(std::vector<std::vector<gr_complex>>(1, symbols));
 
     // Setting the alignment multiple for volk causes problems with the
     // expected behavior of setting the output multiple for the FFT filter.
@@ -112,27 +83,63 @@ corr_est_cc_impl::corr_est_cc_impl(const std::vector<gr_complex>& symbols,
     d_scale = 1.0f;
 }
 
-corr_est_cc_impl::~corr_est_cc_impl()
-{
-    delete d_filter;
-    volk_free(d_corr);
-    volk_free(d_corr_mag);
-}
+corr_est_cc_impl::~corr_est_cc_impl() { volk_free(d_corr); }
 
 std::vector<gr_complex> corr_est_cc_impl::symbols() const { return d_symbols; }
 
 void corr_est_cc_impl::set_symbols(const std::vector<gr_complex>& symbols)
 {
     gr::thread::scoped_lock lock(d_setlock);
+    _set_patterns(std::vector<std::vector<gr_complex>>(1, symbols));
+}
 
-    d_symbols = symbols;
+std::vector<std::vector<gr_complex>> corr_est_cc_impl::patterns() const
+{
+    return d_patterns;
+}
+
+void corr_est_cc_impl::set_patterns(const std::vector<std::vector<gr_complex>>& patterns)
+{
+    gr::thread::scoped_lock lock(d_setlock);
+    _set_patterns(patterns);
+}
+
+void corr_est_cc_impl::_set_patterns(
+    const std::vector<std::vector<gr_complex>>& patterns)
+{
+    if (patterns.empty())
+        throw std::invalid_argument("corr_est_cc: no symbols to correlate against");
+
+    size_t len = 0;
+    for (size_t p = 0; p < patterns.size(); p++) {
+        if (patterns[p].empty())
+            throw std::invalid_argument("corr_est_cc: empty symbol pattern");
+        len = std::max(len, patterns[p].size());
+    }
+
+    d_patterns = patterns;
+
+    // Create time-reversed conjugate of symbols. Shorter patterns are
+    // padded at the end first, which puts their correlation peak where
+    // that of the longest pattern would be for a sync word starting at
+    // the same sample.
+    std::vector<std::vector<gr_complex>> taps(patterns.size());
+    for (size_t p = 0; p < patterns.size(); p++) {
+        taps[p] = patterns[p];
+        taps[p].resize(len, gr_complex(0, 0));
+        for (size_t i = 0; i < len; i++) {
+            taps[p][i] = conj(taps[p][i]);
+        }
+        std::reverse(taps[p].begin(), taps[p].end());
+    }
+    d_symbols = taps[0];
 
     // Per comments in gr-filter/include/gnuradio/filter/fft_filter.h,
     // set the block output multiple to the FFT filter kernel's internal,
     // assumed "nsamples", to ensure the scheduler always passes a
     // proper number of samples.
     int nsamples;
-    nsamples = d_filter->set_taps(d_symbols);
+    nsamples = d_filter.set_taps(taps);
     set_output_multiple(nsamples);
 
     // It looks like the kernel::fft_filter_ccc stashes a tail between
@@ -143,10 +150,20 @@ void corr_est_cc_impl::set_symbols(const std::vector<gr_complex>& symbols)
 
     // We'll (ab)use the history for our own purposes of tagging back in time.
     // Keep a history of the length of the sync word to delay for tagging.
-    set_history(d_symbols.size() + 1);
+    set_history(len + 1);
 
     declare_sample_delay(1, 0);
-    declare_sample_delay(0, d_symbols.size());
+    declare_sample_delay(0, len);
+
+    const size_t nitems = max_noutput_items();
+    volk_free(d_corr);
+    d_corr = (gr_complex*)volk_malloc(sizeof(gr_complex) * nitems * patterns.size(),
+                                      volk_get_alignment());
+    d_corrs.resize(patterns.size());
+    for (size_t p = 0; p < patterns.size(); p++)
+        d_corrs[p] = d_corr + p * nitems;
+    d_corr_mags.assign(patterns.size(), std::vector<float>(nitems + 2, 0));
+    d_level.resize(nitems);
 
     _set_mark_delay(d_stashed_mark_delay);
     _set_threshold(d_stashed_threshold);
@@ -189,13 +206,17 @@ void corr_est_cc_impl::_set_threshold(float threshold)
         break;
     case THRESHOLD_ABSOLUTE:
     default:
-        // Compute a correlation threshold.
+        // Compute a correlation threshold for each pattern.
         // Compute the value of the discrete autocorrelation of the matched
         // filter with offset 0 (aka the autocorrelation peak).
-        float corr = 0;
-        for (size_t i = 0; i < d_symbols.size(); i++)
-            corr += abs(d_symbols[i] * conj(d_symbols[i]));
-        d_thresh = threshold * corr * corr;
+        d_thresholds.resize(d_patterns.size());
+        for (size_t p = 0; p < d_patterns.size(); p++) {
+            float corr = 0;
+            for (size_t i = 0; i < d_patterns[p].size(); i++)
+                corr += abs(d_patterns[p][i] * conj(d_patterns[p][i]));
+            d_thresholds[p] = threshold * corr * corr;
+        }
+        d_thresh = d_thresholds[0];
         break;
     }
 }
@@ -206,180 +227,235 @@ void corr_est_cc_impl::set_threshold(float threshold)
     _set_threshold(threshold);
 }
 
-int corr_est_cc_impl::work(int noutput_items,
-                           gr_vector_const_void_star& input_items,
-                           gr_vector_void_star& output_items)
+/*
+ * Index of the first level[i] above thresh for from <= i < n, or n.
+ * Blocks of values are tested with a count the compiler vectorizes,
+ * and only a block with a crossing is searched value by value.
+ */
+static int find_crossing(const float level[], int from, int n, float thresh)
 {
-    gr::thread::scoped_lock lock(d_setlock);
-
-    const gr_complex* in = (gr_complex*)input_items[0];
-    gr_complex* out = (gr_complex*)output_items[0];
-    gr_complex* corr;
-    if (output_items.size() > 1)
-        corr = (gr_complex*)output_items[1];
-    else
-        corr = d_corr;
-
-    // Our correlation filter length
-    unsigned int hist_len = history() - 1;
-
-    // Calculate the correlation of the non-delayed input with the
-    // known symbols.
-    d_filter->filter(noutput_items, &in[hist_len], corr);
-
-    // Find the magnitude squared of the correlation
-    volk_32fc_magnitude_squared_32f(&d_corr_mag[0], corr, noutput_items);
-
-    float detection = 0;
-    if (d_threshold_method == THRESHOLD_DYNAMIC) {
-        for (int i = 0; i < noutput_items; i++) {
-            detection += d_corr_mag[i];
-        }
-        detection /= static_cast<float>(noutput_items);
-        detection *= d_pfa;
-    }
-
-    int isps = (int)(d_sps + 0.5f);
-    int i = 0;
-    while (i < noutput_items) {
-        float corr_mag;
-        switch (d_threshold_method) {
-        case THRESHOLD_DYNAMIC:
-            // Look for the correlator output to cross the threshold.
-            // Sum power over two consecutive symbols in case we're offset
-            // in time. If off by 1/2 a symbol, the peak of any one point
-            // is much lower.
-            corr_mag = (d_corr_mag[i] + d_corr_mag[i + 1]) * 0.5f;
-            d_thresh = 2 * detection;
+    const int block = 16;
+    int i = from;
+    for (; i + block <= n; i += block) {
+        int above = 0;
+        for (int k = 0; k < block; k++)
+            above += level[i + k] > thresh;
+        if (above)
             break;
-        case THRESHOLD_ABSOLUTE:
-        default:
-            corr_mag = d_corr_mag[i];
-            break;
-        }
-
-        if (corr_mag <= d_thresh) {
-            i++;
-            continue;
-        }
+    }
+    for (; i < n; i++) {
+        if (level[i] > thresh)
+            return i;
+    }
+    return n;
+}
 
-        // Go to (just past) the current correlator output peak
-        while ((i < (noutput_items - 1)) && (d_corr_mag[i] < d_corr_mag[i + 1])) {
-            i++;
-        }
-        // Delaying the primary signal output by the matched filter
-        // length using history(), means that the the peak output of
-        // the matched filter aligns with the start of the desired
-        // sync word in the primary signal output.  This corr_start
-        // tag is not offset to another sample, so that downstream
-        // data-aided blocks (like adaptive equalizers) know exactly
-        // where the start of the correlated symbols are.
-        add_item_tag(0,
-                     nitems_written(0) + i,
-                     pmt::intern("corr_start"),
-                     pmt::from_double(d_corr_mag[i]),
-                     d_src_id);
+void corr_est_cc_impl::add_detection_tags(unsigned int pattern,
+                                          int i,
+                                          const gr_complex corr[],
+                                          const float corr_mag[],
+                                          bool debug_output)
+{
+    // Delaying the primary signal output by the matched filter
+    // length using history(), means that the the peak output of
+    // the matched filter aligns with the start of the desired
+    // sync word in the primary signal output.  This corr_start
+    // tag is not offset to another sample, so that downstream
+    // data-aided blocks (like adaptive equalizers) know exactly
+    // where the start of the correlated symbols are.
+    add_item_tag(0,
+                 nitems_written(0) + i,
+                 pmt::intern("corr_start"),
+                 pmt::from_double(corr_mag[i]),
+                 d_src_id);
 
 #if 0
-        // Use Parabolic interpolation to estimate a fractional
-        // sample delay. There are more accurate methods as
-        // the sample delay estimate using this method is biased.
-        // But this method is simple and fast.
-        // center between [-0.5,0.5] units of samples
-        // Paper Reference: "Discrete Time Techniques for Time Delay
-        // Estimation" G. Jacovitti and G. Scarano
-        double center = 0.0;
-        if( i > 0 && i < (noutput_items - 1 )){
-          double nom = d_corr_mag[i-1]-d_corr_mag[i+1];
-          double denom = 2*(d_corr_mag[i-1]-2*d_corr_mag[i]+d_corr_mag[i+1]);
-          center = nom/denom;
-        }
+    // Use Parabolic interpolation to estimate a fractional
+    // sample delay. There are more accurate methods as
+    // the sample delay estimate using this method is biased.
+    // But this method is simple and fast.
+    // center between [-0.5,0.5] units of samples
+    // Paper Reference: "Discrete Time Techniques for Time Delay
+    // Estimation" G. Jacovitti and G. Scarano
+    double center = 0.0;
+    if( i > 0 && i < (noutput_items - 1 )){
+      double nom = corr_mag[i-1]-corr_mag[i+1];
+      double denom = 2*(corr_mag[i-1]-2*corr_mag[i]+corr_mag[i+1]);
+      center = nom/denom;
+    }
 #else
-        // Calculates the center of mass between the three points around the peak.
-        // Estimate is linear.
-        double nom = 0, den = 0;
-        nom = d_corr_mag[i - 1] + 2 * d_corr_mag[i] + 3 * d_corr_mag[i + 1];
-        den = d_corr_mag[i - 1] + d_corr_mag[i] + d_corr_mag[i + 1];
-        double center = nom / den;
-        center = (center - 2.0); // adjust for bias in center of mass calculation
+    // Calculates the center of mass between the three points around the peak.
+    // Estimate is linear.
+    double nom = 0, den = 0;
+    nom = corr_mag[i - 1] + 2 * corr_mag[i] + 3 * corr_mag[i + 1];
+    den = corr_mag[i - 1] + corr_mag[i] + corr_mag[i + 1];
+    double center = nom / den;
+    center = (center - 2.0); // adjust for bias in center of mass calculation
 #endif
 
-        // Estimated scaling factor for the input stream to normalize
-        // the output to +/-1.
-        uint32_t maxi;
-        volk_32fc_index_max_32u_manual(&maxi, (gr_complex*)in, noutput_items, "generic");
-        d_scale = 1 / std::abs(in[maxi]);
-
-        // Calculate the phase offset of the incoming signal.
-        //
-        // The analytic cross-correlation is:
-        //
-        // 2A*e_bb(t-t_d)*exp(-j*2*pi*f*(t-t_d) - j*phi_bb(t-t_d) - j*theta_c)
-        //
-
-        // The analytic auto-correlation's envelope, e_bb(), has its
-        // peak at the "group delay" time, t = t_d.  The analytic
-        // cross-correlation's center frequency phase shift, theta_c,
-        // is determined from the argument of the analytic
-        // cross-correlation at the "group delay" time, t = t_d.
-        //
-        // Taking the argument of the analytic cross-correlation at
-        // any other time will include the baseband auto-correlation's
-        // phase term, phi_bb(t-t_d), and a frequency dependent term
-        // of the cross-correlation, which I don't believe maps simply
-        // to expected symbol phase differences.
-        float phase = fast_atan2f(corr[i].imag(), corr[i].real());
-        int index = i + d_mark_delay;
-
+    // Calculate the phase offset of the incoming signal.
+    //
+    // The analytic cross-correlation is:
+    //
+    // 2A*e_bb(t-t_d)*exp(-j*2*pi*f*(t-t_d) - j*phi_bb(t-t_d) - j*theta_c)
+    //
+
+    // The analytic auto-correlation's envelope, e_bb(), has its
+    // peak at the "group delay" time, t = t_d.  The analytic
+    // cross-correlation's center frequency phase shift, theta_c,
+    // is determined from the argument of the analytic
+    // cross-correlation at the "group delay" time, t = t_d.
+    //
+    // Taking the argument of the analytic cross-correlation at
+    // any other time will include the baseband auto-correlation's
+    // phase term, phi_bb(t-t_d), and a frequency dependent term
+    // of the cross-correlation, which I don't believe maps simply
+    // to expected symbol phase differences.
+    float phase = fast_atan2f(corr[i].imag(), corr[i].real());
+    int index = i + d_mark_delay;
+
+    add_item_tag(0,
+                 nitems_written(0) + index,
+                 pmt::intern("phase_est"),
+                 pmt::from_double(phase),
+                 d_src_id);
+    add_item_tag(0,
+                 nitems_written(0) + index,
+                 pmt::intern("time_est"),
+                 pmt::from_double(center),
+                 d_src_id);
+    // N.B. the appropriate corr_mag[] index is "i", not "index".
+    add_item_tag(0,
+                 nitems_written(0) + index,
+                 pmt::intern("corr_est"),
+                 pmt::from_double(corr_mag[i]),
+                 d_src_id);
+    add_item_tag(0,
+                 nitems_written(0) + index,
+                 pmt::intern("amp_est"),
+                 pmt::from_double(d_scale),
+                 d_src_id);
+
+    if (d_patterns.size() > 1) {
         add_item_tag(0,
                      nitems_written(0) + index,
+                     pmt::intern("pattern_id"),
+                     pmt::from_long(pattern),
+                     d_src_id);
+    }
+
+    if (debug_output) {
+        // N.B. these debug tags are not offset to avoid walking off out buf
+        add_item_tag(1,
+                     nitems_written(0) + i,
                      pmt::intern("phase_est"),
                      pmt::from_double(phase),
                      d_src_id);
-        add_item_tag(0,
-                     nitems_written(0) + index,
+        add_item_tag(1,
+                     nitems_written(0) + i,
                      pmt::intern("time_est"),
                      pmt::from_double(center),
                      d_src_id);
-        // N.B. the appropriate d_corr_mag[] index is "i", not "index".
-        add_item_tag(0,
-                     nitems_written(0) + index,
+        add_item_tag(1,
+                     nitems_written(0) + i,
                      pmt::intern("corr_est"),
-                     pmt::from_double(d_corr_mag[i]),
+                     pmt::from_double(corr_mag[i]),
                      d_src_id);
-        add_item_tag(0,
-                     nitems_written(0) + index,
+        add_item_tag(1,
+                     nitems_written(0) + i,
                      pmt::intern("amp_est"),
                      pmt::from_double(d_scale),
                      d_src_id);
-
-        if (output_items.size() > 1) {
-            // N.B. these debug tags are not offset to avoid walking off out buf
+        if (d_patterns.size() > 1) {
             add_item_tag(1,
                          nitems_written(0) + i,
-                         pmt::intern("phase_est"),
-                         pmt::from_double(phase),
-                         d_src_id);
-            add_item_tag(1,
-                         nitems_written(0) + i,
-                         pmt::intern("time_est"),
-                         pmt::from_double(center),
-                         d_src_id);
-            add_item_tag(1,
-                         nitems_written(0) + i,
-                         pmt::intern("corr_est"),
-                         pmt::from_double(d_corr_mag[i]),
-                         d_src_id);
-            add_item_tag(1,
-                         nitems_written(0) + i,
-                         pmt::intern("amp_est"),
-                         pmt::from_double(d_scale),
+                         pmt::intern("pattern_id"),
+                         pmt::from_long(pattern),
                          d_src_id);
         }
+    }
+}
+
+int corr_est_cc_impl::work(int noutput_items,
+                           gr_vector_const_void_star& input_items,
+                           gr_vector_void_star& output_items)
+{
+    gr::thread::scoped_lock lock(d_setlock);
+
+    const gr_complex* in = (gr_complex*)input_items[0];
+    gr_complex* out = (gr_complex*)output_items[0];
+    const bool debug_output = output_items.size() > 1;
+    if (debug_output)
+        d_corrs[0] = (gr_complex*)output_items[1];
+    else
+        d_corrs[0] = d_corr;
+
+    // Our correlation filter length
+    unsigned int hist_len = history() - 1;
+
+    // Calculate the correlation of the non-delayed input with the
+    // known symbols, one forward FFT for all the patterns.
+    d_filter.filter(noutput_items, &in[hist_len], &d_corrs[0]);
+
+    bool have_scale = false;
+    int isps = (int)(d_sps + 0.5f);
+    for (unsigned int p = 0; p < d_patterns.size(); p++) {
+        const gr_complex* corr = d_corrs[p];
+        float* corr_mag = &d_corr_mags[p][1]; // corr_mag[-1] ends the last call
+
+        // Find the magnitude squared of the correlation
+        volk_32fc_magnitude_squared_32f(corr_mag, corr, noutput_items);
+        corr_mag[noutput_items] = 0;
+
+        const float* level = corr_mag;
+        float thresh;
+        if (d_threshold_method != THRESHOLD_DYNAMIC) {
+            thresh = d_thresholds[p];
+        } else {
+            float detection = 0;
+            for (int i = 0; i < noutput_items; i++) {
+                detection += corr_mag[i];
+            }
+            detection /= static_cast<float>(noutput_items);
+            detection *= d_pfa;
+            thresh = 2 * detection;
+            if (p == 0)
+                d_thresh = thresh;
+
+            // Look for the correlator output to cross the threshold.
+            // Sum power over two consecutive symbols in case we're offset
+            // in time. If off by 1/2 a symbol, the peak of any one point
+            // is much lower.
+            for (size_t i = 0; i < (size_t)noutput_items; i++)
+                d_level[i] = (corr_mag[i] + corr_mag[i + 1]) * 0.5f;
+            level = &d_level[0];
+        }
+
+        int i = 0;
+        while ((i = find_crossing(level, i, noutput_items, thresh)) < noutput_items) {
+            // Go to (just past) the current correlator output peak
+            while ((i < (noutput_items - 1)) && (corr_mag[i] < corr_mag[i + 1])) {
+                i++;
+            }
+
+            // Estimated scaling factor for the input stream to normalize
+            // the output to +/-1, the same for every peak in this call.
+            if (!have_scale) {
+                uint32_t maxi;
+                volk_32fc_index_max_32u_manual(
+                    &maxi, (gr_complex*)in, noutput_items, "generic");
+                d_scale = 1 / std::abs(in[maxi]);
+                have_scale = true;
+            }
+
+            add_detection_tags(p, i, corr, corr_mag, debug_output);
+
+            // Skip ahead to the next potential symbol peak
+            // (for non-offset/interleaved symbols)
+            i += isps;
+        }
 
-        // Skip ahead to the next potential symbol peak
-        // (for non-offset/interleaved symbols)
-        i += isps;
+        d_corr_mags[p][0] = corr_mag[noutput_items - 1];
     }
 
     // if (output_items.size() > 1)
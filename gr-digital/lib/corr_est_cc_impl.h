@@ -23,10 +23,8 @@
 #ifndef INCLUDED_DIGITAL_CORR_EST_CC_IMPL_H
 #define INCLUDED_DIGITAL_CORR_EST_CC_IMPL_H
 
+#include "fft_correlator_bank.h"
 #include <gnuradio/digital/corr_est_cc.h>
-#include <gnuradio/filter/fft_filter.h>
-
-using namespace gr::filter;
 
 namespace gr {
 namespace digital {
@@ -35,23 +33,35 @@ class corr_est_cc_impl : public corr_est_cc
 {
 private:
     pmt::pmt_t d_src_id;
-    std::vector<gr_complex> d_symbols;
+    std::vector<std::vector<gr_complex>> d_patterns;
+    std::vector<gr_complex> d_symbols; // matched filter for d_patterns[0]
     float d_sps;
     unsigned int d_mark_delay, d_stashed_mark_delay;
     float d_thresh, d_stashed_threshold;
-    kernel::fft_filter_ccc* d_filter;
+    std::vector<float> d_thresholds; // absolute threshold of each pattern
+    fft_correlator_bank d_filter;
 
-    gr_complex* d_corr;
-    float* d_corr_mag;
+    gr_complex* d_corr;                          // correlation with each pattern
+    std::vector<gr_complex*> d_corrs;            //   one max_noutput_items() run each
+    std::vector<std::vector<float>> d_corr_mags; // magnitude squared of d_corrs,
+                                                 //   after one sample of history
+    std::vector<float> d_level;                  // what the threshold applies to
 
     float d_scale;
     float d_pfa; // probability of false alarm
 
     tm_type d_threshold_method;
 
+    void _set_patterns(const std::vector<std::vector<gr_complex>>& patterns);
     void _set_mark_delay(unsigned int mark_delay);
     void _set_threshold(float threshold);
 
+    void add_detection_tags(unsigned int pattern,
+                            int i,
+                            const gr_complex corr[],
+                            const float corr_mag[],
+                            bool debug_output);
+
 public:
     corr_est_cc_impl(const std::vector<gr_complex>& symbols,
                      float sps,
@@ -63,6 +73,9 @@ public:
     std::vector<gr_complex> symbols() const;
     void set_symbols(const std::vector<gr_complex>& symbols);
 
+    std::vector<std::vector<gr_complex>> patterns() const;
+    void set_patterns(const std::vector<std::vector<gr_complex>>& patterns);
+
     unsigned int mark_delay() const;
     void set_mark_delay(unsigned int mark_delay);
 
@@ -27,7 +27,6 @@
 #include "correlate_access_code_ff_ts_impl.h"
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
-#include <volk/volk.h>
 #include <boost/format.hpp>
 #include <cstdio>
 #include <iostream>
@@ -47,11 +46,7 @@ correlate_access_code_ff_ts_impl::correlate_access_code_ff_ts_impl(
     const std::string& access_code, int threshold, const std::string& tag_name)
     : block("correlate_access_code_ff_ts",
             io_signature::make(1, 1, sizeof(float)),
-            io_signature::make(1, 1, sizeof(float))),
-      d_data_reg(0),
-      d_mask(0),
-      d_threshold(threshold),
-      d_len(0)
+            io_signature::make(1, 1, sizeof(float)))
 {
     set_tag_propagation_policy(TPP_DONT);
 
@@ -59,6 +54,7 @@ correlate_access_code_ff_ts_impl::correlate_access_code_ff_ts_impl(
         GR_LOG_ERROR(d_logger, "access_code is > 64 bits");
         throw std::out_of_range("access_code is > 64 bits");
     }
+    d_correlator.set_threshold(threshold);
 
     std::stringstream str;
     str << name() << unique_id();
@@ -76,27 +72,17 @@ correlate_access_code_ff_ts_impl::~correlate_access_code_ff_ts_impl() {}
 
 bool correlate_access_code_ff_ts_impl::set_access_code(const std::string& access_code)
 {
-    d_len = access_code.length(); // # of bytes in string
-    if (d_len > 64)
+    if (!d_correlator.set_codes(std::vector<std::string>(1, access_code)))
         return false;
 
-    // set len least significant bits to 1.
-    d_mask = ((~0ULL) >> (64 - d_len));
-
-    d_access_code = 0;
-    for (unsigned i = 0; i < d_len; i++) {
-        d_access_code = (d_access_code << 1) | (access_code[i] & 1);
-    }
-
-    GR_LOG_DEBUG(d_logger, boost::format("Access code: %llx") % d_access_code);
-    GR_LOG_DEBUG(d_logger, boost::format("Mask: %llx") % d_mask);
+    GR_LOG_DEBUG(d_logger, boost::format("Access code: %llx") % d_correlator.code(0));
 
     return true;
 }
 
 unsigned long long correlate_access_code_ff_ts_impl::access_code() const
 {
-    return d_access_code;
+    return d_correlator.code(0);
 }
 
 inline void correlate_access_code_ff_ts_impl::enter_search()
@@ -137,6 +123,11 @@ int correlate_access_code_ff_ts_impl::general_work(int noutput_items,
     const float* in = (const float*)input_items[0];
     float* out = (float*)output_items[0];
 
+    if (d_bits.size() < (size_t)noutput_items)
+        d_bits.resize(noutput_items);
+    for (int i = 0; i < noutput_items; i++)
+        d_bits[i] = gr::branchless_binary_slicer(in[i]);
+
     uint64_t abs_out_sample_cnt = nitems_written(0);
 
     int nprod = 0;
@@ -146,29 +137,14 @@ int correlate_access_code_ff_ts_impl::general_work(int noutput_items,
         switch (d_state) {
         case STATE_SYNC_SEARCH: // Look for the access code correlation
 
-            while (count < noutput_items) {
-                // shift in new data
-                d_data_reg =
-                    (d_data_reg << 1) | (gr::branchless_binary_slicer(in[count++]) & 0x1);
-
-                // compute hamming distance between desired access code and current data
-                uint64_t wrong_bits = 0;
-                uint64_t nwrong = d_threshold + 1;
-
-                wrong_bits = (d_data_reg ^ d_access_code) & d_mask;
-                volk_64u_popcnt(&nwrong, wrong_bits);
-
-                if (nwrong <= d_threshold) {
-                    enter_have_sync();
-                    break;
-                }
-            }
+            count += d_correlator.find(&d_bits[count], noutput_items - count, d_matches);
+            if (!d_matches.empty())
+                enter_have_sync();
             break;
 
         case STATE_HAVE_SYNC:
             while (count < noutput_items) { // Shift bits one at a time into header
-                d_hdr_reg =
-                    (d_hdr_reg << 1) | (gr::branchless_binary_slicer(in[count++]) & 0x1);
+                d_hdr_reg = (d_hdr_reg << 1) | d_bits[count++];
                 d_hdr_count++;
 
                 if (d_hdr_count == 32) {
@@ -23,6 +23,7 @@
 #ifndef INCLUDED_DIGITAL_CORRELATE_ACCESS_CODE_FF_TS_IMPL_H
 #define INCLUDED_DIGITAL_CORRELATE_ACCESS_CODE_FF_TS_IMPL_H
 
+#include "access_code_correlator.h"
 #include <gnuradio/digital/correlate_access_code_ff_ts.h>
 
 namespace gr {
@@ -35,13 +36,9 @@ private:
 
     state_t d_state;
 
-    unsigned long long d_access_code; // access code to locate start of packet
-                                      //   access code is left justified in the word
-    unsigned long long d_data_reg;    // used to look for access_code
-    unsigned long long d_mask;        // masks access_code bits (top N bits are set where
-                                      //   N is the number of bits in the access code)
-    unsigned int d_threshold;         // how many bits may be wrong in sync vector
-    unsigned int d_len;               // the length of the access code
+    access_code_correlator d_correlator;
+    std::vector<access_code_correlator::match> d_matches;
+    std::vector<unsigned char> d_bits; // the sliced input
 
     unsigned long long d_hdr_reg; // used to look for header
     int d_hdr_count;
@@ -26,9 +26,9 @@
 
 #include "correlate_access_code_tag_bb_impl.h"
 #include <gnuradio/io_signature.h>
-#include <volk/volk.h>
 #include <boost/format.hpp>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
@@ -47,21 +47,18 @@ correlate_access_code_tag_bb_impl::correlate_access_code_tag_bb_impl(
     const std::string& access_code, int threshold, const std::string& tag_name)
     : sync_block("correlate_access_code_tag_bb",
                  io_signature::make(1, 1, sizeof(char)),
-                 io_signature::make(1, 1, sizeof(char))),
-      d_data_reg(0),
-      d_mask(0),
-      d_threshold(threshold),
-      d_len(0)
+                 io_signature::make(1, 1, sizeof(char)))
 {
     if (!set_access_code(access_code)) {
         GR_LOG_ERROR(d_logger, "access_code is > 64 bits");
         throw std::out_of_range("access_code is > 64 bits");
     }
+    d_correlator.set_threshold(threshold);
 
     std::stringstream str;
     str << name() << unique_id();
     d_me = pmt::string_to_symbol(str.str());
-    d_key = pmt::string_to_symbol(tag_name);
+    d_keys[0] = pmt::string_to_symbol(tag_name);
 }
 
 correlate_access_code_tag_bb_impl::~correlate_access_code_tag_bb_impl() {}
@@ -70,24 +67,54 @@ bool correlate_access_code_tag_bb_impl::set_access_code(const std::string& acces
 {
     gr::thread::scoped_lock l(d_mutex_access_code);
 
-    d_len = access_code.length(); // # of bytes in string
-    if (d_len > 64)
+    if (!d_correlator.set_codes(std::vector<std::string>(1, access_code)))
         return false;
+    d_keys.resize(1);
 
-    // set len bottom bits to 1.
-    d_mask = ((~0ULL) >> (64 - d_len));
+    GR_LOG_DEBUG(d_logger, boost::format("Access code: %llx") % d_correlator.code(0));
 
-    d_access_code = 0;
-    for (unsigned i = 0; i < d_len; i++) {
-        d_access_code = (d_access_code << 1) | (access_code[i] & 1);
-    }
+    return true;
+}
+
+void correlate_access_code_tag_bb_impl::set_tagname(const std::string& tag_name)
+{
+    gr::thread::scoped_lock l(d_mutex_access_code);
+    d_keys[0] = pmt::string_to_symbol(tag_name);
+}
 
-    GR_LOG_DEBUG(d_logger, boost::format("Access code: %llx") % d_access_code);
-    GR_LOG_DEBUG(d_logger, boost::format("Mask: %llx") % d_mask);
+bool correlate_access_code_tag_bb_impl::set_access_codes(
+    const std::vector<std::string>& access_codes,
+    const std::vector<std::string>& tag_names)
+{
+    if (access_codes.empty() || access_codes.size() != tag_names.size())
+        throw std::invalid_argument(
+            "correlate_access_code_tag_bb: need one tag name per access code");
+
+    gr::thread::scoped_lock l(d_mutex_access_code);
+
+    if (!d_correlator.set_codes(access_codes))
+        return false;
+
+    d_keys.clear();
+    for (size_t i = 0; i < tag_names.size(); i++)
+        d_keys.push_back(pmt::string_to_symbol(tag_names[i]));
 
     return true;
 }
 
+void correlate_access_code_tag_bb_impl::tag_matches(uint64_t offset)
+{
+    for (size_t i = 0; i < d_matches.size(); i++) {
+        GR_LOG_DEBUG(d_logger, boost::format("writing tag at sample %llu") % offset);
+        add_item_tag(0,                                   // stream ID
+                     offset,                              // sample
+                     d_keys[d_matches[i].code],           // frame info
+                     pmt::from_long(d_matches[i].nwrong), // data (number wrong)
+                     d_me                                 // block src id
+        );
+    }
+}
+
 int correlate_access_code_tag_bb_impl::work(int noutput_items,
                                             gr_vector_const_void_star& input_items,
                                             gr_vector_void_star& output_items)
@@ -99,30 +126,20 @@ int correlate_access_code_tag_bb_impl::work(int noutput_items,
 
     uint64_t abs_out_sample_cnt = nitems_written(0);
 
-    for (int i = 0; i < noutput_items; i++) {
-        out[i] = in[i];
-
-        // compute hamming distance between desired access code and current data
-        uint64_t wrong_bits = 0;
-        uint64_t nwrong = d_threshold + 1;
-
-        wrong_bits = (d_data_reg ^ d_access_code) & d_mask;
-        volk_64u_popcnt(&nwrong, wrong_bits);
-
-        // shift in new data
-        d_data_reg = (d_data_reg << 1) | (in[i] & 0x1);
-        if (nwrong <= d_threshold) {
-            GR_LOG_DEBUG(d_logger,
-                         boost::format("writing tag at sample %llu") %
-                             (abs_out_sample_cnt + i));
-            add_item_tag(0,                      // stream ID
-                         abs_out_sample_cnt + i, // sample
-                         d_key,                  // frame info
-                         pmt::from_long(nwrong), // data (number wrong)
-                         d_me                    // block src id
-            );
-        }
+    memcpy(out, in, noutput_items);
+
+    // A match is tagged on the sample after its last bit, so one ending
+    // on the last bit of the previous call goes on our first sample.
+    if (d_correlator.matches(d_matches))
+        tag_matches(abs_out_sample_cnt);
+
+    int i = 0;
+    while (i < noutput_items - 1) {
+        i += d_correlator.find(&in[i], noutput_items - 1 - i, d_matches);
+        if (!d_matches.empty())
+            tag_matches(abs_out_sample_cnt + i);
     }
+    d_correlator.shift(in[noutput_items - 1]);
 
     return noutput_items;
 }
@@ -23,6 +23,7 @@
 #ifndef INCLUDED_DIGITAL_CORRELATE_ACCESS_CODE_TAG_FF_IMPL_H
 #define INCLUDED_DIGITAL_CORRELATE_ACCESS_CODE_TAG_FF_IMPL_H
 
+#include "access_code_correlator.h"
 #include <gnuradio/digital/correlate_access_code_tag_ff.h>
 
 namespace gr {
@@ -31,18 +32,17 @@ namespace digital {
 class correlate_access_code_tag_ff_impl : public correlate_access_code_tag_ff
 {
 private:
-    unsigned long long d_access_code; // access code to locate start of packet
-                                      //   access code is left justified in the word
-    unsigned long long d_data_reg;    // used to look for access_code
-    unsigned long long d_mask;        // masks access_code bits (top N bits are set where
-                                      //   N is the number of bits in the access code)
-    unsigned int d_threshold;         // how many bits may be wrong in sync vector
-    unsigned int d_len;               // the length of the access code
+    access_code_correlator d_correlator;
+    std::vector<access_code_correlator::match> d_matches;
+    std::vector<unsigned char> d_bits; // the sliced input
 
-    pmt::pmt_t d_key, d_me; // d_key is the tag name, d_me is the block name + unique ID
+    std::vector<pmt::pmt_t> d_keys; // tag name of each access code
+    pmt::pmt_t d_me;                // the block name + unique ID
 
     gr::thread::mutex d_mutex_access_code;
 
+    void tag_matches(uint64_t offset);
+
 public:
     correlate_access_code_tag_ff_impl(const std::string& access_code,
                                       int threshold,
@@ -54,11 +54,10 @@ public:
              gr_vector_void_star& output_items);
 
     bool set_access_code(const std::string& access_code);
-    void set_threshold(int threshold) { d_threshold = threshold; };
-    void set_tagname(const std::string& tag_name)
-    {
-        d_key = pmt::string_to_symbol(tag_name);
-    };
+    void set_threshold(int threshold) { d_correlator.set_threshold(threshold); };
+    void set_tagname(const std::string& tag_name);
+    bool set_access_codes(const std::vector<std::string>& access_codes,
+                          const std::vector<std::string>& tag_names);
 };
 
 } /* namespace digital */
@@ -30,6 +30,7 @@
 #include <gnuradio/math.h>
 #include <gnuradio/sincos.h>
 #include <boost/format.hpp>
+#include <algorithm>
 
 namespace gr {
 namespace digital {
@@ -170,8 +171,6 @@ int costas_loop_cc_impl::work(int noutput_items,
     float* phase_optr = output_items.size() >= 3 ? (float*)output_items[2] : NULL;
     float* error_optr = output_items.size() >= 4 ? (float*)output_items[3] : NULL;
 
-    gr_complex nco_out;
-
     std::vector<tag_t> tags;
     get_tags_in_range(tags,
                       0,
@@ -179,30 +178,36 @@ int costas_loop_cc_impl::work(int noutput_items,
                       nitems_read(0) + noutput_items,
                       pmt::intern("phase_est"));
 
-    for (int i = 0; i < noutput_items; i++) {
-        if (tags.size() > 0) {
-            if (tags[0].offset - nitems_read(0) == (size_t)i) {
-                d_phase = (float)pmt::to_double(tags[0].value);
-                tags.erase(tags.begin());
-            }
+    int i = 0;
+    while (i < noutput_items) {
+        while (tags.size() > 0 && tags[0].offset - nitems_read(0) == (size_t)i) {
+            d_phase = (float)pmt::to_double(tags[0].value);
+            tags.erase(tags.begin());
         }
 
-        nco_out = gr_expj(-d_phase);
-        optr[i] = iptr[i] * nco_out;
+        // A batch ends at the next phase estimate
+        int n = std::min(batch_size(), noutput_items - i);
+        if (tags.size() > 0)
+            n = std::min(n, (int)(tags[0].offset - nitems_read(0)) - i);
+
+        derotate(&optr[i], &iptr[i], n);
 
-        d_error = (*this.*d_phase_detector)(optr[i]);
-        d_error = gr::branchless_clip(d_error, 1.0);
+        for (int k = i; k < i + n; k++) {
+            d_error = (*this.*d_phase_detector)(optr[k]);
+            d_error = gr::branchless_clip(d_error, 1.0);
 
-        advance_loop(d_error);
-        phase_wrap();
-        frequency_limit();
+            advance_loop(d_error);
+            phase_wrap();
+            frequency_limit();
 
-        if (freq_optr != NULL)
-            freq_optr[i] = d_freq;
-        if (phase_optr != NULL)
-            phase_optr[i] = d_phase;
-        if (error_optr != NULL)
-            error_optr[i] = d_error;
+            if (freq_optr != NULL)
+                freq_optr[k] = d_freq;
+            if (phase_optr != NULL)
+                phase_optr[k] = d_phase;
+            if (error_optr != NULL)
+                error_optr[k] = d_error;
+        }
+        i += n;
     }
 
     return noutput_items;
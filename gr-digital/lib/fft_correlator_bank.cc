@@ -0,0 +1,141 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "fft_correlator_bank.h"
+#include <volk/volk.h>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace digital {
+
+fft_correlator_bank::fft_correlator_bank()
+    : d_ntaps(0), d_nsamples(0), d_fftsize(-1), d_fwdfft(NULL), d_invfft(NULL)
+{
+}
+
+fft_correlator_bank::~fft_correlator_bank()
+{
+    delete d_fwdfft;
+    delete d_invfft;
+    free_taps();
+}
+
+void fft_correlator_bank::free_taps()
+{
+    for (size_t f = 0; f < d_xformed_taps.size(); f++)
+        volk_free(d_xformed_taps[f]);
+    d_xformed_taps.clear();
+}
+
+int fft_correlator_bank::set_taps(const std::vector<std::vector<gr_complex>>& taps)
+{
+    if (taps.empty() || taps[0].empty())
+        throw std::invalid_argument("fft_correlator_bank: no taps");
+    for (size_t f = 1; f < taps.size(); f++) {
+        if (taps[f].size() != taps[0].size())
+            throw std::invalid_argument(
+                "fft_correlator_bank: filters differ in length");
+    }
+
+    // The sizes fft_filter_ccc picks for this many taps
+    const int old_fftsize = d_fftsize;
+    d_ntaps = taps[0].size();
+    d_fftsize = (int)(2 * pow(2.0, ceil(log(double(d_ntaps)) / log(2.0))));
+    d_nsamples = d_fftsize - d_ntaps + 1;
+
+    if (d_fftsize != old_fftsize) {
+        delete d_fwdfft;
+        delete d_invfft;
+        d_fwdfft = new fft::fft_complex(d_fftsize, true);
+        d_invfft = new fft::fft_complex(d_fftsize, false);
+    }
+
+    free_taps();
+    d_tails.assign(taps.size(), std::vector<gr_complex>(d_ntaps - 1, 0));
+
+    gr_complex* in = d_fwdfft->get_inbuf();
+    gr_complex* out = d_fwdfft->get_outbuf();
+    const float scale = 1.0 / d_fftsize;
+
+    for (size_t f = 0; f < taps.size(); f++) {
+        int i;
+        for (i = 0; i < d_ntaps; i++)
+            in[i] = taps[f][i] * scale;
+        for (; i < d_fftsize; i++)
+            in[i] = 0;
+
+        d_fwdfft->execute();
+
+        gr_complex* xformed = (gr_complex*)volk_malloc(sizeof(gr_complex) * d_fftsize,
+                                                       volk_get_alignment());
+        memcpy(xformed, out, sizeof(gr_complex) * d_fftsize);
+        d_xformed_taps.push_back(xformed);
+    }
+
+    return d_nsamples;
+}
+
+void fft_correlator_bank::filter(int nitems,
+                                 const gr_complex input[],
+                                 gr_complex* const outputs[])
+{
+    const int tailsize = d_ntaps - 1;
+
+    for (int i = 0; i < nitems; i += d_nsamples) {
+        gr_complex* fin = d_fwdfft->get_inbuf();
+        memcpy(fin, &input[i], d_nsamples * sizeof(gr_complex));
+        for (int j = d_nsamples; j < d_fftsize; j++)
+            fin[j] = 0;
+
+        d_fwdfft->execute(); // shared by all the filters
+
+        const gr_complex* a = d_fwdfft->get_outbuf();
+        gr_complex* c = d_invfft->get_inbuf();
+        gr_complex* y = d_invfft->get_outbuf();
+
+        for (size_t f = 0; f < d_xformed_taps.size(); f++) {
+            volk_32fc_x2_multiply_32fc_a(c, a, d_xformed_taps[f], d_fftsize);
+
+            d_invfft->execute();
+
+            // add in the overlapping tail
+            gr_complex* tail = d_tails[f].empty() ? NULL : &d_tails[f][0];
+            for (int j = 0; j < tailsize; j++)
+                y[j] += tail[j];
+
+            memcpy(&outputs[f][i], y, d_nsamples * sizeof(gr_complex));
+
+            // stash the tail
+            if (tailsize > 0)
+                memcpy(tail, y + d_nsamples, tailsize * sizeof(gr_complex));
+        }
+    }
+}
+
+} /* namespace digital */
+} /* namespace gr */
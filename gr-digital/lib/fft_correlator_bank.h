@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DIGITAL_FFT_CORRELATOR_BANK_H
+#define INCLUDED_DIGITAL_FFT_CORRELATOR_BANK_H
+
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/gr_complex.h>
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+namespace gr {
+namespace digital {
+
+/*!
+ * \brief A bank of FFT filters of equal length run on one input.
+ * \ingroup internal
+ *
+ * \details
+ * Overlap-add as in filter::kernel::fft_filter_ccc, with the forward
+ * transform of each input block computed once and shared by all
+ * filters, so N filters cost one forward and N inverse FFTs per block
+ * instead of N of each. With a single filter the outputs are those of
+ * fft_filter_ccc with decimation 1.
+ */
+class fft_correlator_bank : boost::noncopyable
+{
+public:
+    fft_correlator_bank();
+    ~fft_correlator_bank();
+
+    /*!
+     * \brief Replace the filters and clear their history.
+     *
+     * All filters must have the same number of taps. Returns the
+     * number of samples filter() processes per block; the number of
+     * items passed to it must be a multiple of this.
+     */
+    int set_taps(const std::vector<std::vector<gr_complex>>& taps);
+
+    unsigned int nfilters() const { return d_tails.size(); }
+    unsigned int ntaps() const { return d_ntaps; }
+
+    /*!
+     * \brief Filter \p nitems samples of \p input with every filter.
+     *
+     * outputs[f] receives the \p nitems outputs of filter f.
+     */
+    void filter(int nitems, const gr_complex input[], gr_complex* const outputs[]);
+
+private:
+    int d_ntaps;
+    int d_nsamples;
+    int d_fftsize;
+    fft::fft_complex* d_fwdfft;
+    fft::fft_complex* d_invfft;
+    std::vector<gr_complex*> d_xformed_taps;
+    std::vector<std::vector<gr_complex>> d_tails;
+
+    void free_taps();
+};
+
+} /* namespace digital */
+} /* namespace gr */
+
+#endif /* INCLUDED_DIGITAL_FFT_CORRELATOR_BANK_H */
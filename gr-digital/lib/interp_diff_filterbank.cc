@@ -0,0 +1,146 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this file; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "interp_diff_filterbank.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace digital {
+
+interp_diff_filterbank_ccf::interp_diff_filterbank_ccf()
+    : d_ntaps(0), d_narms(0), d_has_diff(false), d_padded(0)
+{
+    d_align = volk_get_alignment();
+    d_naligned = std::max((size_t)1, d_align / sizeof(gr_complex));
+}
+
+interp_diff_filterbank_ccf::~interp_diff_filterbank_ccf() { free_bank(); }
+
+void interp_diff_filterbank_ccf::free_bank()
+{
+    for (size_t i = 0; i < d_bank.size(); i++) {
+        volk_free(d_bank[i]);
+    }
+    d_bank.clear();
+}
+
+void interp_diff_filterbank_ccf::set_taps(
+    const std::vector<std::vector<float>>& taps,
+    const std::vector<std::vector<float>>& diff_taps)
+{
+    if (taps.empty() || taps[0].empty()) {
+        throw std::invalid_argument("interp_diff_filterbank_ccf: no taps");
+    }
+    if (!diff_taps.empty() && diff_taps.size() != taps.size()) {
+        throw std::invalid_argument(
+            "interp_diff_filterbank_ccf: derivative arms do not match filter arms");
+    }
+
+    const unsigned int ntaps = taps[0].size();
+    const bool has_diff = !diff_taps.empty();
+    for (unsigned int a = 0; a < taps.size(); a++) {
+        if (taps[a].size() != ntaps || (has_diff && diff_taps[a].size() != ntaps)) {
+            throw std::invalid_argument(
+                "interp_diff_filterbank_ccf: arms must all have the same length");
+        }
+    }
+
+    d_narms = taps.size();
+    d_ntaps = ntaps;
+    d_has_diff = has_diff;
+
+    // Room for the taps shifted by up to d_naligned - 1, rounded up so
+    // every tap set starts on an aligned address.
+    const unsigned int falign = std::max((size_t)1, d_align / sizeof(float));
+    d_padded = (d_ntaps + d_naligned - 1 + falign - 1) / falign * falign;
+    const size_t nfloats = (size_t)d_narms * 2 * d_padded;
+
+    // Make a set of taps at all possible input alignments
+    free_bank();
+    for (unsigned int i = 0; i < d_naligned; i++) {
+        float* bank = (float*)volk_malloc(nfloats * sizeof(float), d_align);
+        memset(bank, 0, nfloats * sizeof(float));
+        for (unsigned int a = 0; a < d_narms; a++) {
+            float* h = bank + a * 2 * d_padded + i;
+            float* d = h + d_padded;
+            for (unsigned int j = 0; j < d_ntaps; j++) {
+                h[j] = taps[a][d_ntaps - 1 - j];
+                if (d_has_diff) {
+                    d[j] = diff_taps[a][d_ntaps - 1 - j];
+                }
+            }
+        }
+        d_bank.push_back(bank);
+    }
+}
+
+/*
+ * Rounds input down to an aligned address and returns the arm's
+ * filter taps shifted to match, as fir_filter does.
+ */
+const float* interp_diff_filterbank_ccf::taps(const gr_complex* input,
+                                              int arm,
+                                              const gr_complex*& ar) const
+{
+    ar = (const gr_complex*)((size_t)input & ~(d_align - 1));
+    return d_bank[input - ar] + arm * 2 * d_padded;
+}
+
+gr_complex interp_diff_filterbank_ccf::filter(const gr_complex input[], int arm) const
+{
+    const gr_complex* ar;
+    const float* h = taps(input, arm, ar);
+    gr_complex out;
+    volk_32fc_32f_dot_prod_32fc_a(&out, ar, h, d_ntaps + (input - ar));
+    return out;
+}
+
+gr_complex interp_diff_filterbank_ccf::diff(const gr_complex input[], int arm) const
+{
+    const gr_complex* ar;
+    const float* h = taps(input, arm, ar);
+    gr_complex dout;
+    volk_32fc_32f_dot_prod_32fc_a(&dout, ar, h + d_padded, d_ntaps + (input - ar));
+    return dout;
+}
+
+void interp_diff_filterbank_ccf::filter_diff(const gr_complex input[],
+                                             int arm,
+                                             gr_complex& out,
+                                             gr_complex& dout) const
+{
+    const gr_complex* ar;
+    const float* h = taps(input, arm, ar);
+    const unsigned int n = d_ntaps + (input - ar);
+    volk_32fc_32f_dot_prod_32fc_a(&out, ar, h, n);
+    volk_32fc_32f_dot_prod_32fc_a(&dout, ar, h + d_padded, n);
+}
+
+} /* namespace digital */
+} /* namespace gr */
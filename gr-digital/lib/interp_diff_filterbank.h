@@ -0,0 +1,111 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this file; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DIGITAL_INTERP_DIFF_FILTERBANK_H
+#define INCLUDED_DIGITAL_INTERP_DIFF_FILTERBANK_H
+
+#include <gnuradio/digital/api.h>
+#include <gnuradio/gr_complex.h>
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+namespace gr {
+namespace digital {
+
+/*!
+ * \brief Polyphase interpolating filter arms together with their
+ * derivative filter arms, for symbol timing recovery.
+ * \ingroup internal
+ *
+ * \details
+ * All arms live in one aligned buffer, one arm after the other, with
+ * each arm's filter taps followed by its derivative taps, so the taps
+ * a symbol needs are adjacent in memory instead of spread over
+ * separately allocated filter objects. As in
+ * filter::kernel::fir_filter_ccf, the buffer is kept once for every
+ * input alignment, so the aligned VOLK dot product can always be
+ * used. filter_diff() returns the interpolated sample and its
+ * derivative together, which is what a timing error detector needs at
+ * each symbol.
+ *
+ * Arms are selected by index; callers map their fractional phase to
+ * an arm. Like filter::kernel::fir_filter_ccf, the output for input
+ * x is sum(x[j] * taps[ntaps - 1 - j]).
+ */
+class DIGITAL_API interp_diff_filterbank_ccf : boost::noncopyable
+{
+public:
+    interp_diff_filterbank_ccf();
+    ~interp_diff_filterbank_ccf();
+
+    /*!
+     * \brief Load the filter arms.
+     * \param taps Taps of each arm; all arms have the same length.
+     * \param diff_taps Derivative taps of each arm, the same shape as
+     *                  \p taps, or empty if no derivative is needed.
+     */
+    void set_taps(const std::vector<std::vector<float>>& taps,
+                  const std::vector<std::vector<float>>& diff_taps);
+
+    //! Number of taps in each arm
+    unsigned int ntaps() const { return d_ntaps; }
+
+    //! Number of arms
+    unsigned int narms() const { return d_narms; }
+
+    //! True if derivative taps are loaded
+    bool has_diff() const { return d_has_diff; }
+
+    //! Output of filter arm \p arm for the ntaps() samples at \p input.
+    gr_complex filter(const gr_complex input[], int arm) const;
+
+    //! Output of derivative arm \p arm for the samples at \p input.
+    gr_complex diff(const gr_complex input[], int arm) const;
+
+    /*!
+     * \brief Both filter() and diff() for one symbol.
+     *
+     * Two dot products over \p input; the two tap sets are adjacent
+     * and the input is still in cache for the second one.
+     */
+    void filter_diff(const gr_complex input[],
+                     int arm,
+                     gr_complex& out,
+                     gr_complex& dout) const;
+
+private:
+    unsigned int d_ntaps;
+    unsigned int d_narms;
+    bool d_has_diff;
+    size_t d_align;
+    unsigned int d_naligned;    // input alignments, as in fir_filter
+    unsigned int d_padded;      // floats per tap set, keeps each aligned
+    std::vector<float*> d_bank; // per alignment: per arm filter, then derivative
+
+    void free_bank();
+    const float* taps(const gr_complex* input, int arm, const gr_complex*& ar) const;
+};
+
+} /* namespace digital */
+} /* namespace gr */
+
+#endif /* INCLUDED_DIGITAL_INTERP_DIFF_FILTERBANK_H */
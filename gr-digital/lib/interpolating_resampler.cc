@@ -236,10 +236,7 @@ unsigned int interp_resampler_mmse_8tap_ff::ntaps() const { return d_interp->nta
 #include "gnuradio/filter/interpolator_taps.h"
 
 interp_resampler_pfb_no_mf_cc::interp_resampler_pfb_no_mf_cc(bool derivative, int nfilts)
-    : interpolating_resampler_ccf(IR_PFB_NO_MF, derivative),
-      d_nfilters(0),
-      d_filters(),
-      d_diff_filters()
+    : interpolating_resampler_ccf(IR_PFB_NO_MF, derivative), d_nfilters(0), d_bank()
 {
     if (nfilts <= 1)
         throw std::invalid_argument("interpolating_resampler_pfb_no_mf_cc: "
@@ -261,59 +258,48 @@ interp_resampler_pfb_no_mf_cc::interp_resampler_pfb_no_mf_cc(bool derivative, in
     // N.B. We create an extra final row for an offset of 1.0, because it's
     // easier than dealing with wrap around from 0.99... to 0.0 shifted
     // by 1 tap.
-    d_filters = std::vector<filter::kernel::fir_filter_ccf*>(d_nfilters + 1);
-    d_diff_filters = std::vector<filter::kernel::fir_filter_ccf*>(d_nfilters + 1);
-
-    std::vector<float> t(NTAPS, 0);
+    std::vector<std::vector<float>> arms;
+    std::vector<std::vector<float>> diff_arms;
     int incr = NSTEPS / d_nfilters;
-    int src, dst;
-    for (src = 0, dst = 0; src <= NSTEPS; src += incr, dst++) {
-
-        t.assign(&taps[src][0], &taps[src][NTAPS]);
-        d_filters[dst] = new filter::kernel::fir_filter_ccf(1, t);
-        if (d_filters[dst] == NULL)
-            throw std::runtime_error("unable to create fir_filter_ccf");
-
-        if (d_derivative) {
-            t.assign(&Dtaps[src][0], &Dtaps[src][DNTAPS]);
-            d_diff_filters[dst] = new filter::kernel::fir_filter_ccf(1, t);
-            if (d_diff_filters[dst] == NULL)
-                throw std::runtime_error("unable to create fir_filter_ccf");
-        }
-    }
-}
-
-interp_resampler_pfb_no_mf_cc::~interp_resampler_pfb_no_mf_cc()
-{
-    for (int i = 0; i <= d_nfilters; i++) {
-        delete d_filters[i];
+    int src;
+    for (src = 0; src <= NSTEPS; src += incr) {
+        arms.push_back(std::vector<float>(&taps[src][0], &taps[src][NTAPS]));
         if (d_derivative)
-            delete d_diff_filters[i];
+            diff_arms.push_back(std::vector<float>(&Dtaps[src][0], &Dtaps[src][DNTAPS]));
     }
+    d_bank.set_taps(arms, diff_arms);
 }
 
-gr_complex interp_resampler_pfb_no_mf_cc::interpolate(const gr_complex input[],
-                                                      float mu) const
+interp_resampler_pfb_no_mf_cc::~interp_resampler_pfb_no_mf_cc() {}
+
+int interp_resampler_pfb_no_mf_cc::arm(float mu) const
 {
     int arm = static_cast<int>(rint(mu * d_nfilters));
 
     if (arm < 0 || arm > d_nfilters)
         throw std::runtime_error("interp_resampler_pfb_no_mf_cc: mu is not "
                                  "in the range [0.0, 1.0]");
+    return arm;
+}
 
-    return d_filters[arm]->filter(input);
+gr_complex interp_resampler_pfb_no_mf_cc::interpolate(const gr_complex input[],
+                                                      float mu) const
+{
+    return d_bank.filter(input, arm(mu));
 }
 
 gr_complex interp_resampler_pfb_no_mf_cc::differentiate(const gr_complex input[],
                                                         float mu) const
 {
-    int arm = static_cast<int>(rint(mu * d_nfilters));
-
-    if (arm < 0 || arm > d_nfilters)
-        throw std::runtime_error("interp_resampler_pfb_no_mf_cc: mu is not "
-                                 "in the range [0.0, 1.0]");
+    return d_bank.diff(input, arm(mu));
+}
 
-    return d_diff_filters[arm]->filter(input);
+void interp_resampler_pfb_no_mf_cc::interpolate_differentiate(const gr_complex input[],
+                                                              float mu,
+                                                              gr_complex& out,
+                                                              gr_complex& dout) const
+{
+    d_bank.filter_diff(input, arm(mu), out, dout);
 }
 
 unsigned int interp_resampler_pfb_no_mf_cc::ntaps() const { return NTAPS; }
@@ -410,8 +396,7 @@ interp_resampler_pfb_mf_ccf::interp_resampler_pfb_mf_ccf(const std::vector<float
       d_nfilters(nfilts),
       d_taps_per_filter(static_cast<unsigned int>(
           ceil(static_cast<double>(taps.size()) / static_cast<double>(nfilts)))),
-      d_filters(),
-      d_diff_filters(),
+      d_bank(),
       d_taps(),
       d_diff_taps()
 {
@@ -485,13 +470,11 @@ interp_resampler_pfb_mf_ccf::interp_resampler_pfb_mf_ccf(const std::vector<float
     // N.B. We create an extra final row for an offset of 1.0, because it's
     // easier than dealing with wrap around from 0.99... to 0.0 shifted
     // by 1 tap.
-    d_filters = std::vector<filter::kernel::fir_filter_ccf*>(d_nfilters + 1);
-    d_diff_filters = std::vector<filter::kernel::fir_filter_ccf*>(d_nfilters + 1);
-
     m = taps.size();
     n = diff_taps.size();
     d_taps.resize(d_nfilters + 1);
-    d_diff_taps.resize(d_nfilters + 1);
+    if (d_derivative)
+        d_diff_taps.resize(d_nfilters + 1);
     signed int taps_per_filter = static_cast<signed int>(d_taps_per_filter);
 
     for (i = 0; i <= d_nfilters; i++) {
@@ -501,9 +484,6 @@ interp_resampler_pfb_mf_ccf::interp_resampler_pfb_mf_ccf(const std::vector<float
             if (k < m)
                 d_taps[i][j] = taps[k];
         }
-        d_filters[i] = new filter::kernel::fir_filter_ccf(1, d_taps[i]);
-        if (d_filters[i] == NULL)
-            throw std::runtime_error("unable to create fir_filter_ccf");
 
         if (!d_derivative)
             continue;
@@ -514,43 +494,40 @@ interp_resampler_pfb_mf_ccf::interp_resampler_pfb_mf_ccf(const std::vector<float
             if (k < n)
                 d_diff_taps[i][j] = diff_taps[k];
         }
-        d_diff_filters[i] = new filter::kernel::fir_filter_ccf(1, d_diff_taps[i]);
-        if (d_diff_filters[i] == NULL)
-            throw std::runtime_error("unable to create fir_filter_ccf");
     }
+    d_bank.set_taps(d_taps, d_diff_taps);
 }
 
-interp_resampler_pfb_mf_ccf::~interp_resampler_pfb_mf_ccf()
-{
-    for (int i = 0; i <= d_nfilters; i++) {
-        delete d_filters[i];
-        if (d_derivative)
-            delete d_diff_filters[i];
-    }
-}
+interp_resampler_pfb_mf_ccf::~interp_resampler_pfb_mf_ccf() {}
 
-gr_complex interp_resampler_pfb_mf_ccf::interpolate(const gr_complex input[],
-                                                    float mu) const
+int interp_resampler_pfb_mf_ccf::arm(float mu) const
 {
     int arm = static_cast<int>(rint(mu * d_nfilters));
 
     if (arm < 0 || arm > d_nfilters)
         throw std::runtime_error("interp_resampler_pfb_mf_ccf: mu is not "
                                  "in the range [0.0, 1.0]");
+    return arm;
+}
 
-    return d_filters[arm]->filter(input);
+gr_complex interp_resampler_pfb_mf_ccf::interpolate(const gr_complex input[],
+                                                    float mu) const
+{
+    return d_bank.filter(input, arm(mu));
 }
 
 gr_complex interp_resampler_pfb_mf_ccf::differentiate(const gr_complex input[],
                                                       float mu) const
 {
-    int arm = static_cast<int>(rint(mu * d_nfilters));
-
-    if (arm < 0 || arm > d_nfilters)
-        throw std::runtime_error("interp_resampler_pfb_mf_ccf: mu is not "
-                                 "in the range [0.0, 1.0]");
+    return d_bank.diff(input, arm(mu));
+}
 
-    return d_diff_filters[arm]->filter(input);
+void interp_resampler_pfb_mf_ccf::interpolate_differentiate(const gr_complex input[],
+                                                            float mu,
+                                                            gr_complex& out,
+                                                            gr_complex& dout) const
+{
+    d_bank.filter_diff(input, arm(mu), out, dout);
 }
 
 unsigned int interp_resampler_pfb_mf_ccf::ntaps() const { return d_taps_per_filter; }
@@ -23,6 +23,7 @@
 #ifndef INCLUDED_DIGITAL_INTERPOLATING_RESAMPLER_H
 #define INCLUDED_DIGITAL_INTERPOLATING_RESAMPLER_H
 
+#include "interp_diff_filterbank.h"
 #include <gnuradio/digital/interpolating_resampler_type.h>
 #include <gnuradio/filter/mmse_fir_interpolator_cc.h>
 #include <gnuradio/filter/mmse_fir_interpolator_ff.h>
@@ -193,6 +194,23 @@ public:
      */
     virtual gr_complex differentiate(const gr_complex input[], float mu) const = 0;
 
+    /*!
+     * \brief Return an interpolated sample and the interpolated
+     * derivative sample at the same phase.
+     * \param input Array of input samples of length ntaps().
+     * \param mu Intersample phase in the range [0.0, 1.0] samples.
+     * \param out The interpolated sample.
+     * \param dout The interpolated derivative sample.
+     */
+    virtual void interpolate_differentiate(const gr_complex input[],
+                                           float mu,
+                                           gr_complex& out,
+                                           gr_complex& dout) const
+    {
+        out = interpolate(input, mu);
+        dout = differentiate(input, mu);
+    }
+
 protected:
     interpolating_resampler_ccf(enum ir_type type, bool derivative = false)
         : interpolating_resampler(type, derivative)
@@ -409,10 +427,20 @@ public:
      */
     gr_complex differentiate(const gr_complex input[], float mu) const;
 
+    /*!
+     * \brief Return an interpolated sample and derivative sample from
+     * one filter arm lookup.
+     */
+    void interpolate_differentiate(const gr_complex input[],
+                                   float mu,
+                                   gr_complex& out,
+                                   gr_complex& dout) const;
+
 private:
+    int arm(float mu) const;
+
     int d_nfilters;
-    std::vector<filter::kernel::fir_filter_ccf*> d_filters;
-    std::vector<filter::kernel::fir_filter_ccf*> d_diff_filters;
+    interp_diff_filterbank_ccf d_bank;
 };
 
 /*!
@@ -519,11 +547,21 @@ public:
      */
     gr_complex differentiate(const gr_complex input[], float mu) const;
 
+    /*!
+     * \brief Return an interpolated sample and derivative sample from
+     * one filter arm lookup.
+     */
+    void interpolate_differentiate(const gr_complex input[],
+                                   float mu,
+                                   gr_complex& out,
+                                   gr_complex& dout) const;
+
 private:
+    int arm(float mu) const;
+
     int d_nfilters;
     const unsigned int d_taps_per_filter;
-    std::vector<filter::kernel::fir_filter_ccf*> d_filters;
-    std::vector<filter::kernel::fir_filter_ccf*> d_diff_filters;
+    interp_diff_filterbank_ccf d_bank;
 
     std::vector<std::vector<float>> d_taps;
     std::vector<std::vector<float>> d_diff_taps;
@@ -28,12 +28,11 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/misc.h>
 #include <volk/volk.h>
+#include <algorithm>
 
 namespace gr {
 namespace digital {
 
-using namespace filter::kernel;
-
 lms_dd_equalizer_cc::sptr
 lms_dd_equalizer_cc::make(int num_taps, float mu, int sps, constellation_sptr cnst)
 {
@@ -49,15 +48,19 @@ lms_dd_equalizer_cc_impl::lms_dd_equalizer_cc_impl(int num_taps,
                      io_signature::make(1, 1, sizeof(gr_complex)),
                      io_signature::make(1, 1, sizeof(gr_complex)),
                      sps),
-      fir_filter_ccc(sps, std::vector<gr_complex>(num_taps, gr_complex(0, 0))),
+      d_fir(std::vector<gr_complex>(num_taps, gr_complex(0, 0))),
       d_new_taps(num_taps, gr_complex(0, 0)),
       d_updated(false),
+      d_block_size(1),
+      d_new_block_size(1),
       d_cnst(cnst)
 {
     set_gain(mu);
+
+    // Start out passing the newest sample straight through
     if (num_taps > 0)
-        d_new_taps[0] = 1.0;
-    fir_filter_ccc::set_taps(d_new_taps);
+        d_new_taps[num_taps - 1] = 1.0;
+    d_fir.set_taps(d_new_taps);
 
     const int alignment_multiple = volk_get_alignment() / sizeof(gr_complex);
     set_alignment(std::max(1, alignment_multiple));
@@ -69,11 +72,23 @@ lms_dd_equalizer_cc_impl::~lms_dd_equalizer_cc_impl() {}
 
 void lms_dd_equalizer_cc_impl::set_taps(const std::vector<gr_complex>& taps)
 {
+    gr::thread::scoped_lock guard(d_setlock);
     d_new_taps = taps;
     d_updated = true;
 }
 
-std::vector<gr_complex> lms_dd_equalizer_cc_impl::taps() const { return d_taps; }
+std::vector<gr_complex> lms_dd_equalizer_cc_impl::taps() const { return d_fir.taps(); }
+
+void lms_dd_equalizer_cc_impl::set_block_size(int block_size)
+{
+    if (block_size < 1)
+        throw std::out_of_range(
+            "lms_dd_equalizer_impl::set_block_size: Block size must be >= 1");
+
+    // work() switches over between calls
+    gr::thread::scoped_lock guard(d_setlock);
+    d_new_block_size = block_size;
+}
 
 gr_complex lms_dd_equalizer_cc_impl::error(const gr_complex& out)
 {
@@ -101,29 +116,48 @@ int lms_dd_equalizer_cc_impl::work(int noutput_items,
     const gr_complex* in = (const gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
 
+    gr::thread::scoped_lock guard(d_setlock);
+
     if (d_updated) {
-        d_taps = d_new_taps;
-        set_history(d_taps.size());
+        d_fir.set_taps(d_new_taps);
+        set_history(d_new_taps.size());
         d_updated = false;
         return 0; // history requirements may have changed.
     }
 
+    if (d_new_block_size != d_block_size) {
+        d_block_size = d_new_block_size;
+        d_coefs.resize(d_block_size);
+        set_output_multiple(d_block_size);
+        return 0; // blocks start with the next, suitably sized, call
+    }
+
+    const int decim = decimation();
+
+    if (d_block_size > 1) {
+        // Hold the taps over each block and apply the summed update
+        // at its end.
+        for (int i = 0; i < noutput_items; i += d_block_size) {
+            const int n = std::min(d_block_size, noutput_items - i);
+            d_fir.filter_block(&out[i], &in[i * decim], n, decim);
+            for (int b = 0; b < n; b++) {
+                d_error = error(out[i + b]);
+                d_coefs[b] = d_mu * d_error;
+            }
+            d_fir.update_block_conj(&d_coefs[0]);
+        }
+        return noutput_items;
+    }
+
     int j = 0;
-    size_t k, l = d_taps.size();
     for (int i = 0; i < noutput_items; i++) {
-        out[i] = filter(&in[j]);
+        out[i] = d_fir.filter(&in[j]);
 
         // Adjust taps
         d_error = error(out[i]);
-        for (k = 0; k < l; k++) {
-            // Update tap locally from error.
-            update_tap(d_taps[k], in[j + k]);
-
-            // Update aligned taps in filter object.
-            fir_filter_ccc::update_tap(d_taps[k], k);
-        }
+        d_fir.update_conj(&in[j], d_mu * d_error);
 
-        j += decimation();
+        j += decim;
     }
 
     return noutput_items;
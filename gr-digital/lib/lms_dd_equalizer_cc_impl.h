@@ -23,20 +23,23 @@
 #ifndef INCLUDED_DIGITAL_LMS_DD_EQUALIZER_CC_IMPL_H
 #define INCLUDED_DIGITAL_LMS_DD_EQUALIZER_CC_IMPL_H
 
+#include "adaptive_fir.h"
 #include <gnuradio/digital/lms_dd_equalizer_cc.h>
-#include <gnuradio/filter/fir_filter.h>
 #include <stdexcept>
 
 namespace gr {
 namespace digital {
 
-class lms_dd_equalizer_cc_impl : public lms_dd_equalizer_cc,
-                                 filter::kernel::fir_filter_ccc
+class lms_dd_equalizer_cc_impl : public lms_dd_equalizer_cc
 {
 private:
+    adaptive_fir_ccc d_fir;
     std::vector<gr_complex> d_new_taps;
     bool d_updated;
     gr_complex d_error;
+    int d_block_size;
+    int d_new_block_size;
+    std::vector<gr_complex> d_coefs;
 
     float d_mu;
     constellation_sptr d_cnst;
@@ -64,6 +67,9 @@ public:
         }
     }
 
+    int block_size() const { return d_new_block_size; }
+    void set_block_size(int block_size);
+
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items);
@@ -93,21 +93,8 @@ pfb_clock_sync_ccf_impl::pfb_clock_sync_ccf_impl(double sps,
     d_rate_f = d_rate - (float)d_rate_i;
     d_filtnum = (int)floor(d_k);
 
-    d_filters = std::vector<kernel::fir_filter_ccf*>(d_nfilters);
-    d_diff_filters = std::vector<kernel::fir_filter_ccf*>(d_nfilters);
-
-    // Create an FIR filter for each channel and zero out the taps
-    std::vector<float> vtaps(1, 0);
-    for (int i = 0; i < d_nfilters; i++) {
-        d_filters[i] = new kernel::fir_filter_ccf(1, vtaps);
-        d_diff_filters[i] = new kernel::fir_filter_ccf(1, vtaps);
-    }
-
     // Now, actually set the filters' taps
-    std::vector<float> dtaps;
-    create_diff_taps(taps, dtaps);
-    set_taps(taps, d_taps, d_filters);
-    set_taps(dtaps, d_dtaps, d_diff_filters);
+    load_taps(taps);
 
     d_old_in = 0;
     d_new_in = 0;
@@ -116,13 +103,7 @@ pfb_clock_sync_ccf_impl::pfb_clock_sync_ccf_impl(double sps,
     set_relative_rate((uint64_t)d_osps, (uint64_t)d_sps);
 }
 
-pfb_clock_sync_ccf_impl::~pfb_clock_sync_ccf_impl()
-{
-    for (int i = 0; i < d_nfilters; i++) {
-        delete d_filters[i];
-        delete d_diff_filters[i];
-    }
-}
+pfb_clock_sync_ccf_impl::~pfb_clock_sync_ccf_impl() {}
 
 bool pfb_clock_sync_ccf_impl::check_topology(int ninputs, int noutputs)
 {
@@ -139,6 +120,7 @@ void pfb_clock_sync_ccf_impl::forecast(int noutput_items,
 
 void pfb_clock_sync_ccf_impl::update_taps(const std::vector<float>& taps)
 {
+    gr::thread::scoped_lock guard(d_setlock);
     d_updated_taps = taps;
     d_updated = true;
 }
@@ -215,37 +197,69 @@ void pfb_clock_sync_ccf_impl::update_gains()
     d_beta = (4 * d_loop_bw * d_loop_bw) / denom;
 }
 
+/*
+ * general_work() filters with d_bank, not with filters passed in here,
+ * so the taps are loaded as a new prototype filter the way
+ * update_taps() does it, once the scheduler can change the history.
+ */
 void pfb_clock_sync_ccf_impl::set_taps(const std::vector<float>& newtaps,
                                        std::vector<std::vector<float>>& ourtaps,
                                        std::vector<kernel::fir_filter_ccf*>& ourfilter)
+{
+    gr::thread::scoped_lock guard(d_setlock);
+
+    partition_taps(newtaps, ourtaps);
+
+    // Build a filter for each channel and add it's taps to it
+    for (int i = 0; i < d_nfilters; i++) {
+        ourfilter[i]->set_taps(ourtaps[i]);
+    }
+
+    d_updated_taps = newtaps;
+    d_updated = true;
+}
+
+void pfb_clock_sync_ccf_impl::partition_taps(
+    const std::vector<float>& newtaps, std::vector<std::vector<float>>& ourtaps) const
 {
     int i, j;
 
     unsigned int ntaps = newtaps.size();
-    d_taps_per_filter = (unsigned int)ceil((double)ntaps / (double)d_nfilters);
+    const int taps_per_filter = (int)ceil((double)ntaps / (double)d_nfilters);
 
     // Create d_numchan vectors to store each channel's taps
     ourtaps.resize(d_nfilters);
 
     // Make a vector of the taps plus fill it out with 0's to fill
-    // each polyphase filter with exactly d_taps_per_filter
+    // each polyphase filter with exactly taps_per_filter
     std::vector<float> tmp_taps;
     tmp_taps = newtaps;
-    while ((float)(tmp_taps.size()) < d_nfilters * d_taps_per_filter) {
+    while ((float)(tmp_taps.size()) < d_nfilters * taps_per_filter) {
         tmp_taps.push_back(0.0);
     }
 
     // Partition the filter
     for (i = 0; i < d_nfilters; i++) {
-        // Each channel uses all d_taps_per_filter with 0's if not enough taps to fill out
-        ourtaps[i] = std::vector<float>(d_taps_per_filter, 0);
-        for (j = 0; j < d_taps_per_filter; j++) {
+        // Each channel uses all taps_per_filter with 0's if not enough taps to fill out
+        ourtaps[i] = std::vector<float>(taps_per_filter, 0);
+        for (j = 0; j < taps_per_filter; j++) {
             ourtaps[i][j] = tmp_taps[i + j * d_nfilters];
         }
-
-        // Build a filter for each channel and add it's taps to it
-        ourfilter[i]->set_taps(ourtaps[i]);
     }
+}
+
+/*
+ * Partitions the matched filter and its derivative into arms and
+ * loads both into the filter bank used by general_work().
+ */
+void pfb_clock_sync_ccf_impl::load_taps(const std::vector<float>& taps)
+{
+    std::vector<float> dtaps;
+    create_diff_taps(taps, dtaps);
+    partition_taps(taps, d_taps);
+    partition_taps(dtaps, d_dtaps);
+    d_bank.set_taps(d_taps, d_dtaps);
+    d_taps_per_filter = d_bank.ntaps();
 
     // Set the history to ensure enough input items for each filter
     set_history(d_taps_per_filter + d_sps + d_sps);
@@ -358,11 +372,10 @@ int pfb_clock_sync_ccf_impl::general_work(int noutput_items,
     gr_complex* in = (gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
 
+    gr::thread::scoped_lock guard(d_setlock);
+
     if (d_updated) {
-        std::vector<float> dtaps;
-        create_diff_taps(d_updated_taps, dtaps);
-        set_taps(d_updated_taps, d_taps, d_filters);
-        set_taps(dtaps, d_dtaps, d_diff_filters);
+        load_taps(d_updated_taps);
         d_updated = false;
         return 0; // history requirements may have changed.
     }
@@ -377,8 +390,16 @@ int pfb_clock_sync_ccf_impl::general_work(int noutput_items,
     std::vector<tag_t> tags;
     get_tags_in_window(tags, 0, 0, d_sps * noutput_items, pmt::intern("time_est"));
 
+    // Fetch the tags to pass through once; each output then picks
+    // out the ones in its own range.
+    const uint64_t nread = nitems_read(0);
+    get_tags_in_range(
+        d_in_tags, 0, std::min(d_old_in, nread), nread + ninput_items[0]);
+
     int i = 0, count = 0;
     float error_r, error_i;
+    gr_complex diff;
+    bool have_diff;
 
     // produce output as long as we can and there are enough input samples
     while (i < noutput_items) {
@@ -392,6 +413,7 @@ int pfb_clock_sync_ccf_impl::general_work(int noutput_items,
             }
         }
 
+        have_diff = false;
         while (d_out_idx < d_osps) {
 
             d_filtnum = (int)floor(d_k);
@@ -410,17 +432,23 @@ int pfb_clock_sync_ccf_impl::general_work(int noutput_items,
                 count -= 1;
             }
 
-            out[i + d_out_idx] = d_filters[d_filtnum]->filter(&in[count + d_out_idx]);
+            // With one output per symbol the error below uses the same
+            // arm and input, so get the derivative in the same call.
+            if (d_osps == 1) {
+                d_bank.filter_diff(&in[count], d_filtnum, out[i], diff);
+                have_diff = true;
+            } else {
+                out[i + d_out_idx] = d_bank.filter(&in[count + d_out_idx], d_filtnum);
+            }
             d_k = d_k + d_rate_i + d_rate_f; // update phase
 
 
             // Manage Tags
-            std::vector<tag_t> xtags;
-            std::vector<tag_t>::iterator itags;
-            d_new_in = nitems_read(0) + count + d_out_idx + d_sps;
-            get_tags_in_range(xtags, 0, d_old_in, d_new_in);
-            for (itags = xtags.begin(); itags != xtags.end(); itags++) {
-                tag_t new_tag = *itags;
+            d_new_in = nread + count + d_out_idx + d_sps;
+            for (size_t t = 0; t < d_in_tags.size(); t++) {
+                if (d_in_tags[t].offset < d_old_in || d_in_tags[t].offset >= d_new_in)
+                    continue;
+                tag_t new_tag = d_in_tags[t];
                 // new_tag.offset = d_last_out + d_taps_per_filter/(2*d_sps) - 2;
                 new_tag.offset = d_last_out + d_taps_per_filter / 4 - 2;
                 add_item_tag(0, new_tag);
@@ -448,7 +476,8 @@ int pfb_clock_sync_ccf_impl::general_work(int noutput_items,
         d_out_idx = 0;
 
         // Update the phase and rate estimates for this symbol
-        gr_complex diff = d_diff_filters[d_filtnum]->filter(&in[count]);
+        if (!have_diff)
+            diff = d_bank.diff(&in[count], d_filtnum);
         error_r = out[i].real() * diff.real();
         error_i = out[i].imag() * diff.imag();
         d_error = (error_i + error_r) / 2.0; // average error from I&Q channel
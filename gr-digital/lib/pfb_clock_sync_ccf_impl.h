@@ -23,6 +23,7 @@
 #ifndef INCLUDED_DIGITAL_PFB_CLOCK_SYNC_CCF_IMPL_H
 #define INCLUDED_DIGITAL_PFB_CLOCK_SYNC_CCF_IMPL_H
 
+#include "interp_diff_filterbank.h"
 #include <gnuradio/digital/pfb_clock_sync_ccf.h>
 
 using namespace gr::filter;
@@ -42,8 +43,7 @@ private:
 
     int d_nfilters;
     int d_taps_per_filter;
-    std::vector<kernel::fir_filter_ccf*> d_filters;
-    std::vector<kernel::fir_filter_ccf*> d_diff_filters;
+    interp_diff_filterbank_ccf d_bank;
     std::vector<std::vector<float>> d_taps;
     std::vector<std::vector<float>> d_dtaps;
     std::vector<float> d_updated_taps;
@@ -59,6 +59,13 @@ private:
     int d_out_idx;
 
     uint64_t d_old_in, d_new_in, d_last_out;
+    std::vector<tag_t> d_in_tags;
+
+    void load_taps(const std::vector<float>& taps);
+
+    //! Split \p newtaps into d_nfilters arms
+    void partition_taps(const std::vector<float>& newtaps,
+                        std::vector<std::vector<float>>& ourtaps) const;
 
     void create_diff_taps(const std::vector<float>& newtaps,
                           std::vector<float>& difftaps);
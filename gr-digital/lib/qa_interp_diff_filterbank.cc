@@ -0,0 +1,140 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "interp_diff_filterbank.h"
+#include <gnuradio/filter/fir_filter.h>
+#include <gnuradio/random.h>
+#include <volk/volk.h>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+namespace gr {
+namespace digital {
+
+static gr::random rndm;
+
+static float uniform()
+{
+    return 2.0 * (rndm.ran1() - 0.5); // uniformly (-1, 1)
+}
+
+static void random_arms(std::vector<std::vector<float>>& arms,
+                        unsigned int narms,
+                        unsigned int ntaps)
+{
+    arms.assign(narms, std::vector<float>(ntaps));
+    for (unsigned int a = 0; a < narms; a++) {
+        for (unsigned int j = 0; j < ntaps; j++) {
+            arms[a][j] = uniform();
+        }
+    }
+}
+
+static void check_close(gr_complex expected, gr_complex actual, unsigned int ntaps)
+{
+    // tolerance grows with the number of products summed
+    const float tol = 1e-5 * ntaps;
+    BOOST_CHECK(std::abs(expected.real() - actual.real()) <= tol);
+    BOOST_CHECK(std::abs(expected.imag() - actual.imag()) <= tol);
+}
+
+BOOST_AUTO_TEST_CASE(t1_against_fir_filter)
+{
+    const unsigned int NARMS = 5;
+    const unsigned int NINPUT = 64;
+
+    for (unsigned int ntaps = 1; ntaps <= 33; ntaps += 4) {
+        std::vector<std::vector<float>> taps, dtaps;
+        random_arms(taps, NARMS, ntaps);
+        random_arms(dtaps, NARMS, ntaps);
+
+        interp_diff_filterbank_ccf bank;
+        bank.set_taps(taps, dtaps);
+        BOOST_CHECK_EQUAL(bank.ntaps(), ntaps);
+        BOOST_CHECK_EQUAL(bank.narms(), NARMS);
+        BOOST_CHECK(bank.has_diff());
+
+        // aligned buffer, so every input alignment below is exercised
+        const unsigned int n = NINPUT + ntaps;
+        gr_complex* input =
+            (gr_complex*)volk_malloc(n * sizeof(gr_complex), volk_get_alignment());
+        for (unsigned int i = 0; i < n; i++) {
+            input[i] = gr_complex(uniform(), uniform());
+        }
+
+        for (unsigned int a = 0; a < NARMS; a++) {
+            filter::kernel::fir_filter_ccf fir(1, taps[a]);
+            filter::kernel::fir_filter_ccf dfir(1, dtaps[a]);
+
+            for (unsigned int i = 0; i < NINPUT; i++) {
+                const gr_complex expected = fir.filter(&input[i]);
+                const gr_complex dexpected = dfir.filter(&input[i]);
+
+                check_close(expected, bank.filter(&input[i], a), ntaps);
+                check_close(dexpected, bank.diff(&input[i], a), ntaps);
+
+                gr_complex out, dout;
+                bank.filter_diff(&input[i], a, out, dout);
+                check_close(expected, out, ntaps);
+                check_close(dexpected, dout, ntaps);
+            }
+        }
+        volk_free(input);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(t2_reload_without_diff)
+{
+    std::vector<std::vector<float>> taps, dtaps, none;
+    random_arms(taps, 3, 7);
+    random_arms(dtaps, 3, 7);
+
+    interp_diff_filterbank_ccf bank;
+    bank.set_taps(taps, dtaps);
+
+    // a smaller bank without derivative arms replaces the first one
+    random_arms(taps, 2, 4);
+    bank.set_taps(taps, none);
+    BOOST_CHECK_EQUAL(bank.ntaps(), 4U);
+    BOOST_CHECK_EQUAL(bank.narms(), 2U);
+    BOOST_CHECK(!bank.has_diff());
+
+    std::vector<gr_complex> input(8);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = gr_complex(uniform(), uniform());
+    }
+    for (unsigned int a = 0; a < 2; a++) {
+        filter::kernel::fir_filter_ccf fir(1, taps[a]);
+        for (unsigned int i = 0; i < 4; i++) {
+            check_close(fir.filter(&input[i]), bank.filter(&input[i], a), 4);
+            check_close(0, bank.diff(&input[i], a), 4);
+        }
+    }
+}
+
+} /* namespace digital */
+} /* namespace gr */
@@ -448,17 +448,19 @@ int symbol_sync_cc_impl::general_work(int noutput_items,
         advance_internal_clocks();
 
         // Symbol Clock and Interpolator Positioning & Alignment
-        interp_output = d_interp->interpolate(&in[ii], d_interp->phase_wrapped());
+        // The derivative uses the same filter arm, so get both at once
+        // when the TED is going to need it.
+        if (ted_input_clock() && d_ted->needs_derivative())
+            d_interp->interpolate_differentiate(
+                &in[ii], d_interp->phase_wrapped(), interp_output, interp_derivative);
+        else
+            interp_output = d_interp->interpolate(&in[ii], d_interp->phase_wrapped());
         if (output_sample_clock())
             out[oo] = interp_output;
 
         // Timing Error Detector
-        if (ted_input_clock()) {
-            if (d_ted->needs_derivative())
-                interp_derivative =
-                    d_interp->differentiate(&in[ii], d_interp->phase_wrapped());
+        if (ted_input_clock())
             d_ted->input(interp_output, interp_derivative);
-        }
         if (symbol_clock() && d_ted->needs_lookahead()) {
             // N.B. symbol_clock() == true implies ted_input_clock() == true
             // N.B. symbol_clock() == true implies output_sample_clock() == true
@@ -491,11 +493,14 @@ int symbol_sync_cc_impl::general_work(int noutput_items,
             }
             // Give the ted the look ahead input that it needs to compute
             // the error for *this* symbol.
-            interp_output = d_interp->interpolate(&in[ii + look_ahead_phase_n],
-                                                  look_ahead_phase_wrapped);
             if (d_ted->needs_derivative())
-                interp_derivative = d_interp->differentiate(&in[ii + look_ahead_phase_n],
-                                                            look_ahead_phase_wrapped);
+                d_interp->interpolate_differentiate(&in[ii + look_ahead_phase_n],
+                                                    look_ahead_phase_wrapped,
+                                                    interp_output,
+                                                    interp_derivative);
+            else
+                interp_output = d_interp->interpolate(&in[ii + look_ahead_phase_n],
+                                                      look_ahead_phase_wrapped);
             d_ted->input_lookahead(interp_output, interp_derivative);
         }
         error = d_ted->error();
@@ -22,6 +22,12 @@
 
 
 from gnuradio import gr, gr_unittest, digital, blocks
+import random
+
+def isi_channel(symbols, h):
+    # Causal FIR channel applied to the transmitted symbols
+    return [sum(h[k] * symbols[n - k] for k in range(len(h)) if n >= k)
+            for n in range(len(symbols))]
 
 class test_cma_equalizer_fir(gr_unittest.TestCase):
 
@@ -31,9 +37,10 @@ class test_cma_equalizer_fir(gr_unittest.TestCase):
     def tearDown(self):
         self.tb = None
 
-    def transform(self, src_data):
+    def transform(self, src_data, ntaps=4, block_size=1, mu=.001):
         SRC = blocks.vector_source_c(src_data, False)
-        EQU = digital.cma_equalizer_cc(4, 1.0, .001, 1)
+        EQU = digital.cma_equalizer_cc(ntaps, 1.0, mu, 1)
+        EQU.set_block_size(block_size)
         DST = blocks.vector_sink_c()
         self.tb.connect(SRC, EQU, DST)
         self.tb.run()
@@ -48,5 +55,31 @@ class test_cma_equalizer_fir(gr_unittest.TestCase):
         N = -500
         self.assertComplexTuplesAlmostEqual(expected_data[N:], result[N:])
 
+    def test_002_block_identity(self):
+        # Long enough for the frequency domain block update
+        src_data      = (1+0j, 0+1j, -1+0j, 0-1j)*1000
+        expected_data = src_data
+        result = self.transform(src_data, 64, 32)
+
+        N = -500
+        self.assertComplexTuplesAlmostEqual(expected_data[N:], result[N:])
+
+    def test_003_block_isi(self):
+        # A minimum phase ISI channel, with taps and block long enough
+        # for the frequency domain gradient. CMA leaves the phase free,
+        # so only the modulus is checked.
+        rnd = random.Random(0)
+        src_data = [rnd.choice((1+0j, 0+1j, -1+0j, 0-1j)) for i in range(8000)]
+        rx_data = isi_channel(src_data, (1.0, 0.3+0.3j))
+
+        result = self.transform(rx_data, 32, 32, .004)
+
+        # Off the unit circle at first, on it once converged
+        N = 500
+        self.assertGreater(max(abs(abs(y) - 1) for y in result[:N]), 0.2)
+        N = -500
+        for y in result[N:]:
+            self.assertAlmostEqual(abs(y), 1.0, 3)
+
 if __name__ == "__main__":
     gr_unittest.run(test_cma_equalizer_fir, "test_cma_equalizer_fir.xml")
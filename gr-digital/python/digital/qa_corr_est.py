@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+#
+# Copyright 2019 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+from gnuradio import gr, gr_unittest, digital, blocks
+import pmt
+
+# Two BPSK sync words of different lengths with low cross-correlation
+pattern_a = [1, 1, 1, -1, -1, 1, -1, 1, 1, -1, -1, -1, 1, -1, -1, -1]
+pattern_b = [1, -1, 1, 1, 1, -1, -1, -1]
+
+class test_corr_est(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_corr_est(self, src_data, op):
+        src = blocks.vector_source_c(src_data)
+        dst = blocks.tag_debug(gr.sizeof_gr_complex, "")
+        dst.set_display(False)
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        return dst.current_tags()
+
+    def test_001_single_pattern(self):
+        # Without extra patterns there are no pattern_id tags
+        src_data = [0] * 600
+        src_data[100:100 + len(pattern_a)] = pattern_a
+        op = digital.corr_est_cc(pattern_a, 1, 0)
+        tags = self.run_corr_est(src_data, op)
+        corr_est = [t.offset for t in tags
+                    if pmt.symbol_to_string(t.key) == "corr_est"]
+        pattern_id = [t for t in tags
+                      if pmt.symbol_to_string(t.key) == "pattern_id"]
+        self.assertEqual(corr_est, [100 + len(pattern_a) - 1])
+        self.assertEqual(pattern_id, [])
+
+    def test_002_multi_pattern(self):
+        # Each pattern is detected with its own ID; the shorter one is
+        # tagged relative to its start like the longer one.
+        src_data = [0] * 600
+        src_data[100:100 + len(pattern_a)] = pattern_a
+        src_data[400:400 + len(pattern_b)] = pattern_b
+        op = digital.corr_est_cc(pattern_a, 1, 0)
+        op.set_patterns([pattern_a, pattern_b])
+        self.assertEqual(len(op.patterns()), 2)
+        tags = self.run_corr_est(src_data, op)
+        corr_est = sorted(t.offset for t in tags
+                          if pmt.symbol_to_string(t.key) == "corr_est")
+        pattern_id = sorted((t.offset, pmt.to_long(t.value)) for t in tags
+                            if pmt.symbol_to_string(t.key) == "pattern_id")
+        peak_a = 100 + len(pattern_a) - 1
+        peak_b = 400 + len(pattern_a) - 1
+        self.assertEqual(corr_est, [peak_a, peak_b])
+        self.assertEqual(pattern_id, [(peak_a, 0), (peak_b, 1)])
+
+if __name__ == '__main__':
+    gr_unittest.run(test_corr_est, "test_corr_est.xml")
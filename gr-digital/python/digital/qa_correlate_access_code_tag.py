@@ -22,6 +22,7 @@
 
 
 from gnuradio import gr, gr_unittest, digital, blocks
+import pmt
 
 default_access_code = '\xAC\xDD\xA4\xE2\xF2\x8C\x20\xFC'
 
@@ -106,6 +107,35 @@ class test_correlate_access_code(gr_unittest.TestCase):
         self.assertEqual(len(result_data), 1)
         self.assertEqual(result_data[0].offset, len(code))
 
+    def test_005(self):
+        pad = (0,) * 64
+        src_data = (1, 0, 1, 1, 1, 1, 0, 1, 1) + pad + (0,) * 7
+        src = blocks.vector_source_b(src_data)
+        op = digital.correlate_access_code_tag_bb("1011", 0, "sync")
+        self.assertFalse(op.set_access_codes(("1011", "0" * 65), ("a", "b")))
+        self.assertTrue(op.set_access_codes(("1011", "0111"), ("a", "b")))
+        dst = blocks.tag_debug(gr.sizeof_char, "")
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        result_data = [(t.offset, pmt.symbol_to_string(t.key))
+                       for t in dst.current_tags()]
+        self.assertEqual(sorted(result_data), [(4, "a"), (5, "b"), (9, "a")])
+
+    def test_006(self):
+        pad = (0,) * 64
+        src_bits = (1, 0, 1, 1, 1, 1, 0, 1, 1) + pad + (0,) * 7
+        src_data = [2.0*x - 1.0 for x in src_bits]
+        src = blocks.vector_source_f(src_data)
+        op = digital.correlate_access_code_tag_ff("1011", 0, "sync")
+        op.set_access_codes(("1011", "0111"), ("a", "b"))
+        op.set_threshold(1)
+        dst = blocks.tag_debug(gr.sizeof_float, "b")
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        result_data = [(t.offset, pmt.to_long(t.value))
+                       for t in dst.current_tags()]
+        self.assertEqual(sorted(result_data), [(3, 1), (5, 0), (6, 1), (10, 1)])
+
 if __name__ == '__main__':
     gr_unittest.run(test_correlate_access_code, "test_correlate_access_code_tag.xml")
 
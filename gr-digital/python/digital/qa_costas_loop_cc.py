@@ -152,5 +152,55 @@ class test_costas_loop_cc(gr_unittest.TestCase):
         # not exactly on, the target data
         self.assertComplexTuplesAlmostEqual(expected_result, dst_data, 2)
 
+    def test06(self):
+        # A wide loop falls back to the per-sample loop in block mode
+        natfreq = 0.25
+        order = 4
+        self.test = digital.costas_loop_cc(natfreq, order)
+        self.test.set_block_size(64)
+        self.assertEqual(self.test.batch_size(), 1)
+
+        rot = cmath.exp(0.2j) # some small rotation
+        data = [complex(2*random.randint(0,1)-1, 2*random.randint(0,1)-1)
+                for i in range(100)]
+
+        N = 40 # settling time
+        expected_result = data[N:]
+        data = [rot*d for d in data]
+
+        self.src = blocks.vector_source_c(data, False)
+        self.snk = blocks.vector_sink_c()
+
+        self.tb.connect(self.src, self.test, self.snk)
+        self.tb.run()
+
+        dst_data = self.snk.data()[N:]
+        self.assertComplexTuplesAlmostEqual(expected_result, dst_data, 2)
+
+    def test07(self):
+        # QPSK convergence in block mode with a narrow loop
+        natfreq = 0.01
+        order = 4
+        self.test = digital.costas_loop_cc(natfreq, order)
+        self.test.set_block_size(64)
+        self.assertGreater(self.test.batch_size(), 1)
+
+        rot = cmath.exp(0.2j) # some small rotation
+        data = [complex(2*random.randint(0,1)-1, 2*random.randint(0,1)-1)
+                for i in range(2000)]
+
+        N = 1000 # settling time
+        expected_result = data[N:]
+        data = [rot*d for d in data]
+
+        self.src = blocks.vector_source_c(data, False)
+        self.snk = blocks.vector_sink_c()
+
+        self.tb.connect(self.src, self.test, self.snk)
+        self.tb.run()
+
+        dst_data = self.snk.data()[N:]
+        self.assertComplexTuplesAlmostEqual(expected_result, dst_data, 2)
+
 if __name__ == '__main__':
     gr_unittest.run(test_costas_loop_cc, "test_costas_loop_cc.xml")
@@ -22,6 +22,12 @@
 
 
 from gnuradio import gr, gr_unittest, digital, blocks
+import random
+
+def isi_channel(symbols, h):
+    # Causal FIR channel applied to the transmitted symbols
+    return [sum(h[k] * symbols[n - k] for k in range(len(h)) if n >= k)
+            for n in range(len(symbols))]
 
 class test_lms_dd_equalizer(gr_unittest.TestCase):
 
@@ -31,9 +37,10 @@ class test_lms_dd_equalizer(gr_unittest.TestCase):
     def tearDown(self):
         self.tb = None
 
-    def transform(self, src_data, gain, const):
+    def transform(self, src_data, gain, const, ntaps=4, block_size=1):
         SRC = blocks.vector_source_c(src_data, False)
-        EQU = digital.lms_dd_equalizer_cc(4, gain, 1, const.base())
+        EQU = digital.lms_dd_equalizer_cc(ntaps, gain, 1, const.base())
+        EQU.set_block_size(block_size)
         DST = blocks.vector_sink_c()
         self.tb.connect(SRC, EQU, DST)
         self.tb.run()
@@ -51,5 +58,35 @@ class test_lms_dd_equalizer(gr_unittest.TestCase):
         N = -500
         self.assertComplexTuplesAlmostEqual(expected_data[N:], result[N:], 5)
 
+    def test_002_block_identity(self):
+        # Long enough for the frequency domain block update
+        const = digital.constellation_qpsk()
+        src_data = const.points()*1000
+
+        N = 100 # settling time
+        expected_data = src_data[N:]
+        result = self.transform(src_data, 0.001, const, 64, 32)[N:]
+
+        N = -500
+        self.assertComplexTuplesAlmostEqual(expected_data[N:], result[N:], 5)
+
+    def test_003_block_isi(self):
+        # A minimum phase ISI channel the causal equalizer can invert,
+        # with taps and block long enough for the frequency domain
+        # gradient; the eye is open, so decisions start out right.
+        const = digital.constellation_qpsk()
+        rnd = random.Random(0)
+        src_data = [rnd.choice(const.points()) for i in range(4000)]
+        rx_data = isi_channel(src_data, (1.0, 0.3+0.3j))
+
+        result = self.transform(rx_data, 0.002, const, 32, 32)
+
+        # Unequalized at first, the transmitted symbols once converged
+        N = 100
+        self.assertGreater(max(abs(x - y) for x, y in
+                               zip(src_data[:N], result[:N])), 0.5)
+        N = -500
+        self.assertComplexTuplesAlmostEqual(src_data[N:], result[N:], 3)
+
 if __name__ == "__main__":
     gr_unittest.run(test_lms_dd_equalizer, "test_lms_dd_equalizer.xml")
@@ -30,6 +30,7 @@
 #include <gnuradio/fft/api.h>
 #include <gnuradio/gr_complex.h>
 #include <boost/thread.hpp>
+#include <vector>
 
 namespace gr {
 namespace fft {
@@ -63,6 +64,46 @@ public:
      * Return reference to planner mutex
      */
     static boost::mutex& mutex();
+
+    /*!
+     * \brief Create and cache plans for complex FFTs of the given sizes.
+     *
+     * Plans are kept in a process-wide cache keyed by size, direction
+     * and number of threads, and are shared by every fft_complex of
+     * the same shape. Calling this before building a flowgraph moves
+     * all FFTW planning out of the block constructors.
+     */
+    static void preplan_complex(const std::vector<int>& sizes,
+                                bool forward = true,
+                                int nthreads = 1);
+
+    /*!
+     * \brief Create and cache plans for real forward FFTs of the given sizes.
+     */
+    static void preplan_real_fwd(const std::vector<int>& sizes, int nthreads = 1);
+
+    /*!
+     * \brief Create and cache plans for real reverse FFTs of the given sizes.
+     */
+    static void preplan_real_rev(const std::vector<int>& sizes, int nthreads = 1);
+
+    /*!
+     * \brief Write newly gathered FFTW wisdom to disk.
+     *
+     * Wisdom is read from disk once per process and written back when
+     * the process exits; this forces the write to happen now.
+     */
+    static void flush_wisdom();
+
+    /*!
+     * \brief Destroy all cached plans not used by any FFT object.
+     */
+    static void clear_cache();
+
+    /*!
+     * \brief Number of plans currently held in the plan cache.
+     */
+    static size_t cache_size();
 };
 
 /*!
@@ -73,6 +114,7 @@ class FFT_API fft_complex
 {
     int d_fft_size;
     int d_nthreads;
+    bool d_forward;
     gr_complex* d_inbuf;
     gr_complex* d_outbuf;
     void* d_plan;
@@ -93,7 +135,8 @@ public:
     int outbuf_length() const { return d_fft_size; }
 
     /*!
-     *  Set the number of threads to use for caclulation.
+     *  Set the number of threads to use for caclulation. The object
+     *  switches to the shared plan for the new thread count.
      */
     void set_nthreads(int n);
 
@@ -137,7 +180,8 @@ public:
     int outbuf_length() const { return d_fft_size / 2 + 1; }
 
     /*!
-     *  Set the number of threads to use for caclulation.
+     *  Set the number of threads to use for caclulation. The object
+     *  switches to the shared plan for the new thread count.
      */
     void set_nthreads(int n);
 
@@ -181,7 +225,8 @@ public:
     int outbuf_length() const { return d_fft_size; }
 
     /*!
-     *  Set the number of threads to use for caclulation.
+     *  Set the number of threads to use for caclulation. The object
+     *  switches to the shared plan for the new thread count.
      */
     void set_nthreads(int n);
 
@@ -48,7 +48,9 @@ static int my_fftw_read_char(void* f) { return fgetc((FILE*)f); }
 #include <stdlib.h>
 #include <string.h>
 #include <cassert>
+#include <map>
 #include <stdexcept>
+#include <tuple>
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
@@ -87,8 +89,8 @@ boost::mutex& planner::mutex()
 
 static std::string wisdom_filename()
 {
-    static fs::path path;
-    path = fs::path(gr::appdata_path()) / ".gr_fftw_wisdom";
+    // no function-local static here: this is also called at exit
+    fs::path path = fs::path(gr::appdata_path()) / ".gr_fftw_wisdom";
     return path.string();
 }
 
@@ -164,6 +166,268 @@ static void export_wisdom()
     }
 }
 
+// ----------------------------------------------------------------
+// Process-wide plan cache
+//
+// Plans are created once per (kind, size, nthreads) on private scratch
+// buffers and executed with the new-array interface, so any number of
+// FFT objects of the same shape share a single plan. Wisdom is read
+// from disk before the first plan is made and written back at exit.
+// All functions below expect the planner mutex to be held.
+
+enum plan_kind { COMPLEX_FORWARD, COMPLEX_REVERSE, REAL_FORWARD, REAL_REVERSE };
+
+typedef std::tuple<int, int, int> plan_key; // kind, size, nthreads
+
+struct cached_plan {
+    fftwf_plan plan;
+    int in_alignment;
+    int out_alignment;
+    int users;
+};
+
+struct plan_cache {
+    std::map<plan_key, cached_plan> plans;
+    bool wisdom_loaded;
+    bool wisdom_dirty;
+
+    plan_cache() : wisdom_loaded(false), wisdom_dirty(false)
+    {
+        // make sure the planner mutex outlives us
+        planner::mutex();
+    }
+
+    ~plan_cache()
+    {
+        // Plans are left to the OS here: FFT objects owned by other
+        // static objects may still be using them.
+        if (!wisdom_dirty)
+            return;
+        try {
+            planner::scoped_lock lock(planner::mutex());
+            lock_wisdom();
+            import_wisdom(); // merge with what other processes stored meanwhile
+            export_wisdom();
+            unlock_wisdom();
+        } catch (std::exception& e) {
+            fprintf(stderr, "gr::fft: can't store wisdom: %s\n", e.what());
+        }
+    }
+};
+
+static plan_cache& cache()
+{
+    static plan_cache s_cache;
+    return s_cache;
+}
+
+static size_t in_bytes(plan_kind kind, int size)
+{
+    switch (kind) {
+    case REAL_FORWARD:
+        return sizeof(float) * size;
+    case REAL_REVERSE:
+        return sizeof(gr_complex) * (size / 2 + 1);
+    default:
+        return sizeof(gr_complex) * size;
+    }
+}
+
+static size_t out_bytes(plan_kind kind, int size)
+{
+    switch (kind) {
+    case REAL_FORWARD:
+        return sizeof(gr_complex) * (size / 2 + 1);
+    case REAL_REVERSE:
+        return sizeof(float) * size;
+    default:
+        return sizeof(gr_complex) * size;
+    }
+}
+
+static fftwf_plan create_plan(plan_kind kind, int size, int nthreads, void* in, void* out)
+{
+    plan_cache& c = cache();
+    if (!c.wisdom_loaded) {
+        lock_wisdom();
+        import_wisdom(); // load prior wisdom from disk
+        unlock_wisdom();
+        c.wisdom_loaded = true;
+    }
+    config_threading(nthreads);
+
+    fftwf_plan plan = NULL;
+    switch (kind) {
+    case COMPLEX_FORWARD:
+    case COMPLEX_REVERSE:
+        plan = fftwf_plan_dft_1d(size,
+                                 reinterpret_cast<fftwf_complex*>(in),
+                                 reinterpret_cast<fftwf_complex*>(out),
+                                 kind == COMPLEX_FORWARD ? FFTW_FORWARD : FFTW_BACKWARD,
+                                 FFTW_MEASURE);
+        break;
+    case REAL_FORWARD:
+        plan = fftwf_plan_dft_r2c_1d(size,
+                                     reinterpret_cast<float*>(in),
+                                     reinterpret_cast<fftwf_complex*>(out),
+                                     FFTW_MEASURE);
+        break;
+    case REAL_REVERSE:
+        plan = fftwf_plan_dft_c2r_1d(size,
+                                     reinterpret_cast<fftwf_complex*>(in),
+                                     reinterpret_cast<float*>(out),
+                                     FFTW_MEASURE);
+        break;
+    }
+
+    if (plan == NULL) {
+        fprintf(stderr, "gr::fft: error creating plan\n");
+        throw std::runtime_error("gr::fft: FFTW planning failed");
+    }
+    c.wisdom_dirty = true;
+    return plan;
+}
+
+static cached_plan& lookup_plan(plan_kind kind, int size, int nthreads)
+{
+    if (size <= 0) {
+        throw std::out_of_range("gr::fft: invalid fft_size");
+    }
+
+    std::map<plan_key, cached_plan>& plans = cache().plans;
+    const plan_key key(kind, size, nthreads);
+    std::map<plan_key, cached_plan>::iterator it = plans.find(key);
+    if (it != plans.end()) {
+        return it->second;
+    }
+
+    // Plan on scratch buffers so that FFTW_MEASURE never touches the
+    // buffers of an FFT object that may already be in use.
+    float* in = (float*)volk_malloc(in_bytes(kind, size), volk_get_alignment());
+    float* out = (float*)volk_malloc(out_bytes(kind, size), volk_get_alignment());
+    if (in == 0 || out == 0) {
+        volk_free(in);
+        volk_free(out);
+        throw std::runtime_error("volk_malloc");
+    }
+
+    cached_plan p;
+    p.in_alignment = fftwf_alignment_of(in);
+    p.out_alignment = fftwf_alignment_of(out);
+    p.users = 0;
+    try {
+        p.plan = create_plan(kind, size, nthreads, in, out);
+    } catch (...) {
+        volk_free(in);
+        volk_free(out);
+        throw;
+    }
+    volk_free(in);
+    volk_free(out);
+
+    return plans.insert(std::make_pair(key, p)).first->second;
+}
+
+static void* acquire_plan(plan_kind kind, int size, int nthreads, void* in, void* out)
+{
+    cached_plan& p = lookup_plan(kind, size, nthreads);
+
+    // The new-array execute functions require the same alignment the
+    // plan was made with; fall back to a private plan otherwise.
+    if (fftwf_alignment_of(reinterpret_cast<float*>(in)) != p.in_alignment ||
+        fftwf_alignment_of(reinterpret_cast<float*>(out)) != p.out_alignment) {
+        return create_plan(kind, size, nthreads, in, out);
+    }
+
+    p.users++;
+    return p.plan;
+}
+
+static void release_plan(void* plan)
+{
+    std::map<plan_key, cached_plan>& plans = cache().plans;
+    for (std::map<plan_key, cached_plan>::iterator it = plans.begin(); it != plans.end();
+         ++it) {
+        if (it->second.plan == plan) {
+            it->second.users--;
+            return;
+        }
+    }
+
+    // not from the cache; private plan
+    fftwf_destroy_plan((fftwf_plan)plan);
+}
+
+// Swap the plan of an FFT object for one made for another thread count
+static void*
+replan(void* plan, plan_kind kind, int size, int nthreads, void* in, void* out)
+{
+    void* new_plan = acquire_plan(kind, size, nthreads, in, out);
+    release_plan(plan);
+    return new_plan;
+}
+
+static void preplan(plan_kind kind, const std::vector<int>& sizes, int nthreads)
+{
+    planner::scoped_lock lock(planner::mutex());
+
+    for (size_t i = 0; i < sizes.size(); i++) {
+        lookup_plan(kind, sizes[i], nthreads);
+    }
+}
+
+void planner::preplan_complex(const std::vector<int>& sizes, bool forward, int nthreads)
+{
+    preplan(forward ? COMPLEX_FORWARD : COMPLEX_REVERSE, sizes, nthreads);
+}
+
+void planner::preplan_real_fwd(const std::vector<int>& sizes, int nthreads)
+{
+    preplan(REAL_FORWARD, sizes, nthreads);
+}
+
+void planner::preplan_real_rev(const std::vector<int>& sizes, int nthreads)
+{
+    preplan(REAL_REVERSE, sizes, nthreads);
+}
+
+void planner::flush_wisdom()
+{
+    scoped_lock lock(mutex());
+
+    plan_cache& c = cache();
+    if (!c.wisdom_dirty)
+        return;
+
+    lock_wisdom();
+    import_wisdom();
+    export_wisdom();
+    unlock_wisdom();
+    c.wisdom_dirty = false;
+}
+
+void planner::clear_cache()
+{
+    scoped_lock lock(mutex());
+
+    std::map<plan_key, cached_plan>& plans = cache().plans;
+    std::map<plan_key, cached_plan>::iterator it = plans.begin();
+    while (it != plans.end()) {
+        if (it->second.users == 0) {
+            fftwf_destroy_plan(it->second.plan);
+            plans.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t planner::cache_size()
+{
+    scoped_lock lock(mutex());
+    return cache().plans.size();
+}
+
 // ----------------------------------------------------------------
 
 fft_complex::fft_complex(int fft_size, bool forward, int nthreads)
@@ -190,23 +454,13 @@ fft_complex::fft_complex(int fft_size, bool forward, int nthreads)
         throw std::runtime_error("volk_malloc");
     }
 
+    d_forward = forward;
     d_nthreads = nthreads;
-    config_threading(nthreads);
-    lock_wisdom();
-    import_wisdom(); // load prior wisdom from disk
-
-    d_plan = fftwf_plan_dft_1d(fft_size,
-                               reinterpret_cast<fftwf_complex*>(d_inbuf),
-                               reinterpret_cast<fftwf_complex*>(d_outbuf),
-                               forward ? FFTW_FORWARD : FFTW_BACKWARD,
-                               FFTW_MEASURE);
-
-    if (d_plan == NULL) {
-        fprintf(stderr, "gr::fft: error creating plan\n");
-        throw std::runtime_error("fftwf_plan_dft_1d failed");
-    }
-    export_wisdom(); // store new wisdom to disk
-    unlock_wisdom();
+    d_plan = acquire_plan(forward ? COMPLEX_FORWARD : COMPLEX_REVERSE,
+                          fft_size,
+                          nthreads,
+                          d_inbuf,
+                          d_outbuf);
 }
 
 fft_complex::~fft_complex()
@@ -214,7 +468,7 @@ fft_complex::~fft_complex()
     // Hold global mutex during plan construction and destruction.
     planner::scoped_lock lock(planner::mutex());
 
-    fftwf_destroy_plan((fftwf_plan)d_plan);
+    release_plan(d_plan);
     volk_free(d_inbuf);
     volk_free(d_outbuf);
 }
@@ -224,14 +478,25 @@ void fft_complex::set_nthreads(int n)
     if (n <= 0) {
         throw std::out_of_range("gr::fft: invalid number of threads");
     }
-    d_nthreads = n;
 
-#ifdef FFTW3F_THREADS
-    fftwf_plan_with_nthreads(d_nthreads);
-#endif
+    planner::scoped_lock lock(planner::mutex());
+    if (n != d_nthreads) {
+        d_plan = replan(d_plan,
+                        d_forward ? COMPLEX_FORWARD : COMPLEX_REVERSE,
+                        d_fft_size,
+                        n,
+                        d_inbuf,
+                        d_outbuf);
+        d_nthreads = n;
+    }
 }
 
-void fft_complex::execute() { fftwf_execute((fftwf_plan)d_plan); }
+void fft_complex::execute()
+{
+    fftwf_execute_dft((fftwf_plan)d_plan,
+                      reinterpret_cast<fftwf_complex*>(d_inbuf),
+                      reinterpret_cast<fftwf_complex*>(d_outbuf));
+}
 
 // ----------------------------------------------------------------
 
@@ -260,19 +525,7 @@ fft_real_fwd::fft_real_fwd(int fft_size, int nthreads)
     }
 
     d_nthreads = nthreads;
-    config_threading(nthreads);
-    lock_wisdom();
-    import_wisdom(); // load prior wisdom from disk
-
-    d_plan = fftwf_plan_dft_r2c_1d(
-        fft_size, d_inbuf, reinterpret_cast<fftwf_complex*>(d_outbuf), FFTW_MEASURE);
-
-    if (d_plan == NULL) {
-        fprintf(stderr, "gr::fft::fft_real_fwd: error creating plan\n");
-        throw std::runtime_error("fftwf_plan_dft_r2c_1d failed");
-    }
-    export_wisdom(); // store new wisdom to disk
-    unlock_wisdom();
+    d_plan = acquire_plan(REAL_FORWARD, fft_size, nthreads, d_inbuf, d_outbuf);
 }
 
 fft_real_fwd::~fft_real_fwd()
@@ -280,7 +533,7 @@ fft_real_fwd::~fft_real_fwd()
     // Hold global mutex during plan construction and destruction.
     planner::scoped_lock lock(planner::mutex());
 
-    fftwf_destroy_plan((fftwf_plan)d_plan);
+    release_plan(d_plan);
     volk_free(d_inbuf);
     volk_free(d_outbuf);
 }
@@ -291,14 +544,19 @@ void fft_real_fwd::set_nthreads(int n)
         throw std::out_of_range(
             "gr::fft::fft_real_fwd::set_nthreads: invalid number of threads");
     }
-    d_nthreads = n;
 
-#ifdef FFTW3F_THREADS
-    fftwf_plan_with_nthreads(d_nthreads);
-#endif
+    planner::scoped_lock lock(planner::mutex());
+    if (n != d_nthreads) {
+        d_plan = replan(d_plan, REAL_FORWARD, d_fft_size, n, d_inbuf, d_outbuf);
+        d_nthreads = n;
+    }
 }
 
-void fft_real_fwd::execute() { fftwf_execute((fftwf_plan)d_plan); }
+void fft_real_fwd::execute()
+{
+    fftwf_execute_dft_r2c(
+        (fftwf_plan)d_plan, d_inbuf, reinterpret_cast<fftwf_complex*>(d_outbuf));
+}
 
 // ----------------------------------------------------------------
 
@@ -327,22 +585,7 @@ fft_real_rev::fft_real_rev(int fft_size, int nthreads)
     }
 
     d_nthreads = nthreads;
-    config_threading(nthreads);
-    lock_wisdom();
-    import_wisdom(); // load prior wisdom from disk
-
-    // FIXME If there's ever a chance that the planning functions
-    // will be called in multiple threads, we've got to ensure single
-    // threaded access.  They are not thread-safe.
-    d_plan = fftwf_plan_dft_c2r_1d(
-        fft_size, reinterpret_cast<fftwf_complex*>(d_inbuf), d_outbuf, FFTW_MEASURE);
-
-    if (d_plan == NULL) {
-        fprintf(stderr, "gr::fft::fft_real_rev: error creating plan\n");
-        throw std::runtime_error("fftwf_plan_dft_c2r_1d failed");
-    }
-    export_wisdom(); // store new wisdom to disk
-    unlock_wisdom();
+    d_plan = acquire_plan(REAL_REVERSE, fft_size, nthreads, d_inbuf, d_outbuf);
 }
 
 fft_real_rev::~fft_real_rev()
@@ -350,7 +593,7 @@ fft_real_rev::~fft_real_rev()
     // Hold global mutex during plan construction and destruction.
     planner::scoped_lock lock(planner::mutex());
 
-    fftwf_destroy_plan((fftwf_plan)d_plan);
+    release_plan(d_plan);
     volk_free(d_inbuf);
     volk_free(d_outbuf);
 }
@@ -361,14 +604,19 @@ void fft_real_rev::set_nthreads(int n)
         throw std::out_of_range(
             "gr::fft::fft_real_rev::set_nthreads: invalid number of threads");
     }
-    d_nthreads = n;
 
-#ifdef FFTW3F_THREADS
-    fftwf_plan_with_nthreads(d_nthreads);
-#endif
+    planner::scoped_lock lock(planner::mutex());
+    if (n != d_nthreads) {
+        d_plan = replan(d_plan, REAL_REVERSE, d_fft_size, n, d_inbuf, d_outbuf);
+        d_nthreads = n;
+    }
 }
 
-void fft_real_rev::execute() { fftwf_execute((fftwf_plan)d_plan); }
+void fft_real_rev::execute()
+{
+    fftwf_execute_dft_c2r(
+        (fftwf_plan)d_plan, reinterpret_cast<fftwf_complex*>(d_inbuf), d_outbuf);
+}
 
 } /* namespace fft */
 } /* namespace gr */
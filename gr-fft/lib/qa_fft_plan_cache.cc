@@ -0,0 +1,106 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/fft/fft.h>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+namespace gr {
+namespace fft {
+
+BOOST_AUTO_TEST_CASE(t1_shared_plan)
+{
+    planner::clear_cache();
+    const size_t before = planner::cache_size();
+
+    fft_complex a(64, true);
+    fft_complex b(64, true);
+    BOOST_CHECK_EQUAL(planner::cache_size(), before + 1);
+
+    // both objects run the shared plan on their own buffers
+    for (int i = 0; i < 64; i++) {
+        a.get_inbuf()[i] = gr_complex(i == 0 ? 1.0f : 0.0f, 0.0f);
+        b.get_inbuf()[i] = gr_complex(i == 1 ? 1.0f : 0.0f, 0.0f);
+    }
+    a.execute();
+    b.execute();
+
+    for (int k = 0; k < 64; k++) {
+        const float w = -2.0f * M_PI * k / 64.0f;
+        BOOST_CHECK_SMALL(std::abs(a.get_outbuf()[k] - gr_complex(1.0f, 0.0f)), 1e-5f);
+        BOOST_CHECK_SMALL(
+            std::abs(b.get_outbuf()[k] - gr_complex(std::cos(w), std::sin(w))), 1e-5f);
+    }
+
+    // a different direction or thread count is a different plan
+    fft_complex c(64, false);
+    BOOST_CHECK_EQUAL(planner::cache_size(), before + 2);
+}
+
+BOOST_AUTO_TEST_CASE(t2_preplan)
+{
+    planner::clear_cache();
+    BOOST_CHECK_EQUAL(planner::cache_size(), 0);
+
+    std::vector<int> sizes{ 128, 256, 1024 };
+    planner::preplan_complex(sizes);
+    planner::preplan_real_fwd(sizes);
+    planner::preplan_real_rev(sizes);
+    BOOST_CHECK_EQUAL(planner::cache_size(), 9);
+
+    // constructing objects of a pre-planned shape adds nothing
+    fft_real_fwd f(256);
+    fft_real_rev r(256);
+    BOOST_CHECK_EQUAL(planner::cache_size(), 9);
+
+    for (int i = 0; i < 256; i++) {
+        f.get_inbuf()[i] = std::sin(2.0f * float(M_PI) * 5 * i / 256.0f);
+    }
+    f.execute();
+    for (int k = 0; k < f.outbuf_length(); k++) {
+        r.get_inbuf()[k] = f.get_outbuf()[k];
+    }
+    r.execute();
+    for (int i = 0; i < 256; i++) {
+        BOOST_CHECK_SMALL(r.get_outbuf()[i] / 256.0f -
+                              std::sin(2.0f * float(M_PI) * 5 * i / 256.0f),
+                          1e-4f);
+    }
+
+    // plans still in use survive clearing the cache
+    planner::clear_cache();
+    BOOST_CHECK_EQUAL(planner::cache_size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(t3_invalid_size)
+{
+    std::vector<int> sizes{ 0 };
+    BOOST_CHECK_THROW(planner::preplan_complex(sizes), std::out_of_range);
+}
+
+} /* namespace fft */
+} /* namespace gr */
@@ -0,0 +1,123 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_FILTER_FIR_FILTER_BATCH_H
+#define INCLUDED_FILTER_FIR_FILTER_BATCH_H
+
+#include <gnuradio/filter/api.h>
+#include <gnuradio/gr_complex.h>
+#include <vector>
+
+namespace gr {
+namespace filter {
+namespace kernel {
+
+/*!
+ * \brief Bank of FIR filters for gr_complex input, gr_complex output
+ * and float taps that computes one output of every filter in a single
+ * pass.
+ * \ingroup filter
+ *
+ * \details
+ * Each filter in the bank is a lane. Input samples are stored
+ * interleaved (lane-major): input[k * nlanes() + l] is the k-th
+ * sample of lane l. The taps of all lanes are stored the same way,
+ * so one output of every lane is an element-wise multiply-accumulate
+ * over ntaps() contiguous rows, which the compiler turns into SIMD
+ * code. This replaces nlanes() separate fir_filter_ccf dot products
+ * in the polyphase filterbanks.
+ *
+ * Lanes with fewer taps than the longest lane are padded with zeros
+ * at the end of their tap vector.
+ */
+class FILTER_API fir_filter_batch_ccf
+{
+private:
+    std::vector<std::vector<float>> d_taps;
+    unsigned int d_nlanes;
+    unsigned int d_ntaps;
+    float* d_interleaved_taps;
+
+public:
+    /*!
+     * \brief construct a bank with one lane per entry of \p taps.
+     *
+     * Note that taps must be in forward order, e.g., coefficient 0 of
+     * lane l is stored in taps[l][0], coefficient 1 in taps[l][1], etc.
+     */
+    fir_filter_batch_ccf(const std::vector<std::vector<float>>& taps);
+
+    ~fir_filter_batch_ccf();
+
+    /*!
+     * \brief compute one output value for every lane.
+     *
+     * \p input must hold ntaps() rows of nlanes() interleaved samples,
+     * oldest row first. \p output receives nlanes() values.
+     */
+    void filter(gr_complex output[], const gr_complex input[]);
+
+    /*!
+     * \brief compute n output rows; each output row advances the input
+     * by one row.
+     *
+     * \p input must hold (n - 1 + ntaps()) rows; \p output receives
+     * n * nlanes() values.
+     */
+    void filterN(gr_complex output[], const gr_complex input[], unsigned long n);
+
+    /*!
+     * \brief Interleave separate streams into the lane-major layout.
+     *
+     * streams[l] provides the samples of lane l; \p n samples are
+     * copied from each stream into \p output.
+     */
+    static void interleave(gr_complex output[],
+                           const std::vector<const gr_complex*>& streams,
+                           unsigned long n);
+
+    /*!
+     * \return number of lanes in the bank.
+     */
+    unsigned int nlanes() const { return d_nlanes; }
+
+    /*!
+     * \return number of taps of each lane.
+     */
+    unsigned int ntaps() const { return d_ntaps; }
+
+    /*!
+     * \brief install \p taps as the current taps of all lanes.
+     */
+    void set_taps(const std::vector<std::vector<float>>& taps);
+
+    /*!
+     * \return current taps of all lanes.
+     */
+    std::vector<std::vector<float>> taps() const;
+};
+
+} /* namespace kernel */
+} /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_FIR_FILTER_BATCH_H */
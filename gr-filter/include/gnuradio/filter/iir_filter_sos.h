@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_FILTER_IIR_FILTER_SOS_H
+#define INCLUDED_FILTER_IIR_FILTER_SOS_H
+
+#include <gnuradio/filter/api.h>
+#include <vector>
+
+namespace gr {
+namespace filter {
+namespace kernel {
+
+/*!
+ * \brief IIR filter built from a cascade of second-order sections
+ *
+ * \details
+ * Each section is a biquad run in transposed Direct Form II:
+
+ \f[
+ y[n] = b_0 x[n] + z_1[n-1] \\
+ z_1[n] = b_1 x[n] - a_1 y[n] + z_2[n-1] \\
+ z_2[n] = b_2 x[n] - a_2 y[n]
+ \f]
+
+ * Splitting a high-order design into sections keeps the poles well
+ * conditioned, so the cascade is stable in single precision where
+ * the equivalent Direct Form I iir_filter needs double taps.
+ *
+ * The taps are given in the layout used by scipy.signal (the \p sos
+ * output of iirfilter, butter, etc.) flattened row by row: six
+ * values [b0, b1, b2, a0, a1, a2] per section. Each section is
+ * normalized by its a0.
+ *
+ * The filter runs \p nlanes independent channels with the same
+ * taps. Samples are interleaved, input[t * nlanes + l] being sample
+ * t of channel l, and the per-channel recursion is evaluated across
+ * all lanes in one contiguous loop so it vectorizes. A vector stream
+ * of vlen floats is vlen lanes; complex samples are two lanes each.
+ */
+class FILTER_API iir_filter_sos
+{
+public:
+    /*!
+     * \brief Construct a cascade of sections filtering \p nlanes channels.
+     *
+     * \param sos flattened [b0, b1, b2, a0, a1, a2] rows, one per section.
+     * \param nlanes number of independent channels.
+     */
+    iir_filter_sos(const std::vector<float>& sos, unsigned int nlanes = 1);
+
+    ~iir_filter_sos();
+
+    /*!
+     * \brief compute n output rows of nlanes() values each.
+     *
+     * \p input and \p output hold n * nlanes() interleaved samples and
+     * may point to the same buffer.
+     */
+    void filter_n(float output[], const float input[], unsigned long n);
+
+    /*!
+     * \brief install new sections and clear the filter state.
+     */
+    void set_taps(const std::vector<float>& sos);
+
+    /*!
+     * \return the current sections in the layout passed to set_taps.
+     */
+    std::vector<float> taps() const { return d_sos; }
+
+    /*!
+     * \brief clear the filter state of all lanes.
+     */
+    void reset();
+
+    unsigned int nsections() const { return d_nsections; }
+    unsigned int nlanes() const { return d_nlanes; }
+
+private:
+    struct section {
+        float b0, b1, b2, a1, a2;
+    };
+
+    std::vector<float> d_sos;
+    std::vector<section> d_sections;
+    unsigned int d_nsections;
+    unsigned int d_nlanes;
+    float* d_state; // z1 then z2 of each section, nlanes values each
+};
+
+} /* namespace kernel */
+} /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_IIR_FILTER_SOS_H */
@@ -0,0 +1,76 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_IIR_FILTER_SOS_FFF_H
+#define INCLUDED_IIR_FILTER_SOS_FFF_H
+
+#include <gnuradio/filter/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+namespace filter {
+
+/*!
+ * \brief IIR filter as a cascade of second-order sections with
+ * float input, float output and float taps
+ * \ingroup filter_blk
+ *
+ * \details
+ * The filter is given as second-order sections (biquads) in the
+ * layout produced by scipy.signal with output='sos', flattened row
+ * by row: [b0, b1, b2, a0, a1, a2] for each section. Each section
+ * implements
+
+ \f[
+ H_s(z) = \frac{b_0 + b_1 z^{-1} + b_2 z^{-2}}{a_0 + a_1 z^{-1} + a_2 z^{-2}}
+ \f]
+
+ \xmlonly
+ H_s(z) = \ frac{b_0 + b_1 z^{-1} + b_2 z^{-2}}{a_0 + a_1 z^{-1} + a_2 z^{-2}}
+ \endxmlonly
+
+ * and runs in transposed Direct Form II, which is numerically well
+ * behaved for high-order designs even with single precision taps.
+ *
+ * Each of the \p vlen elements of a vector is filtered as an
+ * independent channel.
+ */
+class FILTER_API iir_filter_sos_fff : virtual public sync_block
+{
+public:
+    // gr::filter::iir_filter_sos_fff::sptr
+    typedef boost::shared_ptr<iir_filter_sos_fff> sptr;
+
+    /*!
+     * \param sos flattened second-order sections, 6 values per section.
+     * \param vlen number of items per vector.
+     */
+    static sptr make(const std::vector<float>& sos, unsigned int vlen = 1);
+
+    virtual void set_taps(const std::vector<float>& sos) = 0;
+    virtual std::vector<float> taps() const = 0;
+};
+
+} /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_IIR_FILTER_SOS_FFF_H */
@@ -94,8 +94,6 @@ namespace kernel {
 class FILTER_API pfb_arb_resampler_ccf
 {
 private:
-    std::vector<fir_filter_ccf*> d_filters;
-    std::vector<fir_filter_ccf*> d_diff_filters;
     std::vector<std::vector<float>> d_taps;
     std::vector<std::vector<float>> d_dtaps;
     unsigned int d_int_rate;        // the number of filters (interpolation rate)
@@ -107,6 +105,17 @@ private:
     int d_delay;                    // filter's group delay
     float d_est_phase_change;       // est. of phase change of a sine wave through filt.
 
+    // Filter and derivative taps of every arm, reversed and with each
+    // tap duplicated to line up with the real and imaginary parts of
+    // the input; arm j starts at d_fused_taps[4 * j * d_taps_per_filter].
+    float* d_fused_taps;
+
+    // Input index, filter arm and interpolation point of each output
+    // of the current call to filter().
+    std::vector<int> d_run_input;
+    std::vector<unsigned int> d_run_filter;
+    std::vector<float> d_run_acc;
+
     /*!
      * Takes in the taps and convolves them with [-1,0,1], which
      * creates a differential set of taps that are used in the
@@ -122,12 +131,14 @@ private:
      * \param newtaps    (vector of floats) The prototype filter to populate the
      * filterbank. The taps should be generated at the interpolated sampling rate. \param
      * ourtaps    (vector of floats) Reference to our internal member of holding the taps.
-     * \param ourfilter  (vector of filters) Reference to our internal filter to set the
-     * taps for.
      */
     void create_taps(const std::vector<float>& newtaps,
-                     std::vector<std::vector<float>>& ourtaps,
-                     std::vector<kernel::fir_filter_ccf*>& ourfilter);
+                     std::vector<std::vector<float>>& ourtaps);
+
+    /*!
+     * Builds d_fused_taps from d_taps and d_dtaps.
+     */
+    void create_fused_taps();
 
 public:
     /*!
@@ -116,10 +116,14 @@ public:
      * \param taps (vector/list of floats) The prototype filter to
      *             populate the filterbank.
      * \param fft_forward (bool) use a forward or inverse FFT (default=false).
+     * \param fir_filters (bool) build the per-filter d_fir_filters;
+     *                    subclasses that filter with their own kernel
+     *                    can skip them (default=true).
      */
     polyphase_filterbank(unsigned int nfilts,
                          const std::vector<float>& taps,
-                         bool fft_forward = false);
+                         bool fft_forward = false,
+                         bool fir_filters = true);
 
     ~polyphase_filterbank();
 
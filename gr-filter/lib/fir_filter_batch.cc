@@ -0,0 +1,124 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/filter/fir_filter_batch.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cstring>
+
+namespace gr {
+namespace filter {
+namespace kernel {
+
+fir_filter_batch_ccf::fir_filter_batch_ccf(const std::vector<std::vector<float>>& taps)
+    : d_nlanes(0), d_ntaps(0), d_interleaved_taps(NULL)
+{
+    set_taps(taps);
+}
+
+fir_filter_batch_ccf::~fir_filter_batch_ccf()
+{
+    if (d_interleaved_taps != NULL) {
+        volk_free(d_interleaved_taps);
+        d_interleaved_taps = NULL;
+    }
+}
+
+void fir_filter_batch_ccf::set_taps(const std::vector<std::vector<float>>& taps)
+{
+    if (d_interleaved_taps != NULL) {
+        volk_free(d_interleaved_taps);
+        d_interleaved_taps = NULL;
+    }
+
+    d_taps = taps;
+    d_nlanes = taps.size();
+    d_ntaps = 0;
+    for (unsigned int l = 0; l < d_nlanes; l++) {
+        d_ntaps = std::max(d_ntaps, (unsigned int)taps[l].size());
+    }
+
+    // Row k holds the reversed tap k of every lane, twice, so that it
+    // lines up with the real and imaginary parts of an input row.
+    const unsigned int width = 2 * d_nlanes;
+    d_interleaved_taps = (float*)volk_malloc(
+        std::max(1u, d_ntaps * width) * sizeof(float), volk_get_alignment());
+    memset(d_interleaved_taps, 0, d_ntaps * width * sizeof(float));
+    for (unsigned int l = 0; l < d_nlanes; l++) {
+        for (unsigned int j = 0; j < taps[l].size(); j++) {
+            float* t = &d_interleaved_taps[(d_ntaps - 1 - j) * width + 2 * l];
+            t[0] = taps[l][j];
+            t[1] = taps[l][j];
+        }
+    }
+}
+
+std::vector<std::vector<float>> fir_filter_batch_ccf::taps() const { return d_taps; }
+
+void fir_filter_batch_ccf::filter(gr_complex output[], const gr_complex input[])
+{
+    const unsigned int width = 2 * d_nlanes;
+    const float* in = (const float*)input;
+    const float* taps = d_interleaved_taps;
+    float* out = (float*)output;
+
+    std::fill(out, out + width, 0.0f);
+    for (unsigned int k = 0; k < d_ntaps; k++) {
+        for (unsigned int l = 0; l < width; l++) {
+            out[l] += in[l] * taps[l];
+        }
+        in += width;
+        taps += width;
+    }
+}
+
+void fir_filter_batch_ccf::filterN(gr_complex output[],
+                                   const gr_complex input[],
+                                   unsigned long n)
+{
+    for (unsigned long i = 0; i < n; i++) {
+        filter(&output[i * d_nlanes], &input[i * d_nlanes]);
+    }
+}
+
+void fir_filter_batch_ccf::interleave(gr_complex output[],
+                                      const std::vector<const gr_complex*>& streams,
+                                      unsigned long n)
+{
+    const size_t nlanes = streams.size();
+    for (size_t l = 0; l < nlanes; l++) {
+        const gr_complex* in = streams[l];
+        gr_complex* out = &output[l];
+        for (unsigned long i = 0; i < n; i++) {
+            *out = in[i];
+            out += nlanes;
+        }
+    }
+}
+
+} /* namespace kernel */
+} /* namespace filter */
+} /* namespace gr */
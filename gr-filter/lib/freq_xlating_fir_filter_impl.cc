@@ -175,10 +175,13 @@ int freq_xlating_fir_filter_impl<IN_T, OUT_T, TAP_T>::work(
 
     unsigned j = 0;
     for (int i = 0; i < noutput_items; i++) {
-        out[i] = d_r.rotate(d_composite_fir->filter(&in[j]));
+        out[i] = d_composite_fir->filter(&in[j]);
         j += this->decimation();
     }
 
+    // Derotate the whole block at once
+    d_r.rotateN(out, out, noutput_items);
+
     return noutput_items;
 }
 
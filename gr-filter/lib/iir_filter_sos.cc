@@ -0,0 +1,119 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/filter/iir_filter_sos.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace filter {
+namespace kernel {
+
+iir_filter_sos::iir_filter_sos(const std::vector<float>& sos, unsigned int nlanes)
+    : d_nsections(0), d_nlanes(nlanes), d_state(NULL)
+{
+    if (nlanes == 0) {
+        throw std::invalid_argument("iir_filter_sos: nlanes must be > 0");
+    }
+    set_taps(sos);
+}
+
+iir_filter_sos::~iir_filter_sos() { volk_free(d_state); }
+
+void iir_filter_sos::set_taps(const std::vector<float>& sos)
+{
+    if (sos.size() % 6 != 0) {
+        throw std::invalid_argument(
+            "iir_filter_sos: taps must hold 6 values [b0 b1 b2 a0 a1 a2] per section");
+    }
+
+    std::vector<section> sections(sos.size() / 6);
+    for (size_t s = 0; s < sections.size(); s++) {
+        const float* c = &sos[6 * s];
+        if (c[3] == 0) {
+            throw std::invalid_argument("iir_filter_sos: a0 of a section is zero");
+        }
+        sections[s].b0 = c[0] / c[3];
+        sections[s].b1 = c[1] / c[3];
+        sections[s].b2 = c[2] / c[3];
+        sections[s].a1 = c[4] / c[3];
+        sections[s].a2 = c[5] / c[3];
+    }
+
+    d_sos = sos;
+    d_sections = sections;
+    d_nsections = sections.size();
+
+    volk_free(d_state);
+    const unsigned int nstate = std::max(1u, 2 * d_nsections * d_nlanes);
+    d_state = (float*)volk_malloc(nstate * sizeof(float), volk_get_alignment());
+    reset();
+}
+
+void iir_filter_sos::reset()
+{
+    memset(d_state, 0, 2 * d_nsections * d_nlanes * sizeof(float));
+}
+
+void iir_filter_sos::filter_n(float output[], const float input[], unsigned long n)
+{
+    const unsigned int L = d_nlanes;
+
+    if (d_nsections == 0) {
+        if (output != input) {
+            memcpy(output, input, n * L * sizeof(float));
+        }
+        return;
+    }
+
+    for (unsigned long t = 0; t < n; t++) {
+        // The first section reads the input row, the following ones
+        // work in place on the output row.
+        const float* x = &input[t * L];
+        float* y = &output[t * L];
+
+        for (unsigned int s = 0; s < d_nsections; s++) {
+            const section c = d_sections[s];
+            float* z1 = &d_state[2 * s * L];
+            float* z2 = z1 + L;
+
+            for (unsigned int l = 0; l < L; l++) {
+                const float in = x[l];
+                const float out = c.b0 * in + z1[l];
+                z1[l] = c.b1 * in - c.a1 * out + z2[l];
+                z2[l] = c.b2 * in - c.a2 * out;
+                y[l] = out;
+            }
+            x = y;
+        }
+    }
+}
+
+} /* namespace kernel */
+} /* namespace filter */
+} /* namespace gr */
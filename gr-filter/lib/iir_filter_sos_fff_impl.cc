@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "iir_filter_sos_fff_impl.h"
+#include <gnuradio/io_signature.h>
+
+namespace gr {
+namespace filter {
+
+iir_filter_sos_fff::sptr iir_filter_sos_fff::make(const std::vector<float>& sos,
+                                                  unsigned int vlen)
+{
+    return gnuradio::get_initial_sptr(new iir_filter_sos_fff_impl(sos, vlen));
+}
+
+iir_filter_sos_fff_impl::iir_filter_sos_fff_impl(const std::vector<float>& sos,
+                                                 unsigned int vlen)
+    : sync_block("iir_filter_sos_fff",
+                 io_signature::make(1, 1, sizeof(float) * vlen),
+                 io_signature::make(1, 1, sizeof(float) * vlen)),
+      d_updated(false)
+{
+    d_iir = new kernel::iir_filter_sos(sos, vlen);
+}
+
+iir_filter_sos_fff_impl::~iir_filter_sos_fff_impl() { delete d_iir; }
+
+void iir_filter_sos_fff_impl::set_taps(const std::vector<float>& sos)
+{
+    // validate now, apply in the work thread
+    kernel::iir_filter_sos check(sos);
+    d_new_sos = sos;
+    d_updated = true;
+}
+
+std::vector<float> iir_filter_sos_fff_impl::taps() const { return d_iir->taps(); }
+
+int iir_filter_sos_fff_impl::work(int noutput_items,
+                                  gr_vector_const_void_star& input_items,
+                                  gr_vector_void_star& output_items)
+{
+    const float* in = (const float*)input_items[0];
+    float* out = (float*)output_items[0];
+
+    if (d_updated) {
+        d_iir->set_taps(d_new_sos);
+        d_updated = false;
+    }
+
+    d_iir->filter_n(out, in, noutput_items);
+    return noutput_items;
+}
+
+} /* namespace filter */
+} /* namespace gr */
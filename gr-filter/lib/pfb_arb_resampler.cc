@@ -27,7 +27,9 @@
 #include <gnuradio/filter/pfb_arb_resampler.h>
 #include <gnuradio/logger.h>
 #include <gnuradio/math.h>
+#include <volk/volk.h>
 #include <boost/math/special_functions/round.hpp>
+#include <algorithm>
 #include <cstdio>
 #include <stdexcept>
 
@@ -55,17 +57,8 @@ pfb_arb_resampler_ccf::pfb_arb_resampler_ccf(float rate,
 
     d_last_filter = (taps.size() / 2) % filter_size;
 
-    d_filters = std::vector<fir_filter_ccf*>(d_int_rate);
-    d_diff_filters = std::vector<fir_filter_ccf*>(d_int_rate);
-
-    // Create an FIR filter for each channel and zero out the taps
-    std::vector<float> vtaps(0, d_int_rate);
-    for (unsigned int i = 0; i < d_int_rate; i++) {
-        d_filters[i] = new fir_filter_ccf(1, vtaps);
-        d_diff_filters[i] = new fir_filter_ccf(1, vtaps);
-    }
-
     // Now, actually set the filters' taps
+    d_fused_taps = NULL;
     set_taps(taps);
 
     // Delay is based on number of taps per filter arm. Round to
@@ -88,17 +81,10 @@ pfb_arb_resampler_ccf::pfb_arb_resampler_ccf(float rate,
     d_est_phase_change = d_last_filter - (end_filter + accum_frac);
 }
 
-pfb_arb_resampler_ccf::~pfb_arb_resampler_ccf()
-{
-    for (unsigned int i = 0; i < d_int_rate; i++) {
-        delete d_filters[i];
-        delete d_diff_filters[i];
-    }
-}
+pfb_arb_resampler_ccf::~pfb_arb_resampler_ccf() { volk_free(d_fused_taps); }
 
 void pfb_arb_resampler_ccf::create_taps(const std::vector<float>& newtaps,
-                                        std::vector<std::vector<float>>& ourtaps,
-                                        std::vector<fir_filter_ccf*>& ourfilter)
+                                        std::vector<std::vector<float>>& ourtaps)
 {
     unsigned int ntaps = newtaps.size();
     d_taps_per_filter = (unsigned int)ceil((double)ntaps / (double)d_int_rate);
@@ -120,9 +106,25 @@ void pfb_arb_resampler_ccf::create_taps(const std::vector<float>& newtaps,
         for (unsigned int j = 0; j < d_taps_per_filter; j++) {
             ourtaps[i][j] = tmp_taps[i + j * d_int_rate];
         }
+    }
+}
 
-        // Build a filter for each channel and add it's taps to it
-        ourfilter[i]->set_taps(ourtaps[i]);
+void pfb_arb_resampler_ccf::create_fused_taps()
+{
+    volk_free(d_fused_taps);
+
+    // For each arm: 2*K filter taps followed by 2*K derivative taps,
+    // in the reversed order the input is walked through.
+    const unsigned int K = d_taps_per_filter;
+    d_fused_taps = (float*)volk_malloc(std::max(1u, 4 * K * d_int_rate) * sizeof(float),
+                                       volk_get_alignment());
+    for (unsigned int i = 0; i < d_int_rate; i++) {
+        float* taps = &d_fused_taps[4 * K * i];
+        float* dtaps = taps + 2 * K;
+        for (unsigned int k = 0; k < K; k++) {
+            taps[2 * k] = taps[2 * k + 1] = d_taps[i][K - 1 - k];
+            dtaps[2 * k] = dtaps[2 * k + 1] = d_dtaps[i][K - 1 - k];
+        }
     }
 }
 
@@ -148,8 +150,9 @@ void pfb_arb_resampler_ccf::set_taps(const std::vector<float>& taps)
 {
     std::vector<float> dtaps;
     create_diff_taps(taps, dtaps);
-    create_taps(taps, d_taps, d_filters);
-    create_taps(dtaps, d_dtaps, d_diff_filters);
+    create_taps(taps, d_taps);
+    create_taps(dtaps, d_dtaps);
+    create_fused_taps();
 }
 
 std::vector<std::vector<float>> pfb_arb_resampler_ccf::taps() const { return d_taps; }
@@ -179,13 +182,13 @@ void pfb_arb_resampler_ccf::set_phase(float ph)
             "pfb_arb_resampler_ccf: set_phase value out of bounds [0, 2pi).\n");
     }
 
-    float ph_diff = 2.0 * GR_M_PI / (float)d_filters.size();
+    float ph_diff = 2.0 * GR_M_PI / (float)d_int_rate;
     d_last_filter = static_cast<int>(ph / ph_diff);
 }
 
 float pfb_arb_resampler_ccf::phase() const
 {
-    float ph_diff = 2.0 * GR_M_PI / static_cast<float>(d_filters.size());
+    float ph_diff = 2.0 * GR_M_PI / static_cast<float>(d_int_rate);
     return d_last_filter * ph_diff;
 }
 
@@ -197,25 +200,66 @@ float pfb_arb_resampler_ccf::phase_offset(float freq, float fs)
     return -adj * d_est_phase_change;
 }
 
+/*!
+ * Computes the filter output and the derivative filter output of one
+ * arm in a single pass over the input. The products are accumulated
+ * in 8 independent lanes (4 complex samples), which maps directly to
+ * SIMD registers without reordering the floating point sums within a
+ * lane.
+ */
+static inline gr_complex fused_filter(const gr_complex* input,
+                                      const float* taps,
+                                      unsigned int ntaps,
+                                      float mu)
+{
+    const float* in = (const float*)input;
+    const float* dtaps = taps + 2 * ntaps;
+    const unsigned int n = 2 * ntaps;
+
+    float acc0[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    float acc1[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (unsigned int l = 0; l < 8; l++) {
+            acc0[l] += in[i + l] * taps[i + l];
+            acc1[l] += in[i + l] * dtaps[i + l];
+        }
+    }
+    for (; i < n; i++) {
+        acc0[i & 7] += in[i] * taps[i];
+        acc1[i & 7] += in[i] * dtaps[i];
+    }
+
+    // linearly interpolate between the two filter outputs
+    float re = 0, im = 0;
+    for (unsigned int l = 0; l < 8; l += 2) {
+        re += acc0[l] + acc1[l] * mu;
+        im += acc0[l + 1] + acc1[l + 1] * mu;
+    }
+    return gr_complex(re, im);
+}
+
 int pfb_arb_resampler_ccf::filter(gr_complex* output,
                                   gr_complex* input,
                                   int n_to_read,
                                   int& n_read)
 {
-    int i_out = 0, i_in = 0;
+    int i_in = 0;
     unsigned int j = d_last_filter;
-    ;
-    gr_complex o0, o1;
 
+    // Step through the filterbank first and record which arm and
+    // interpolation point every output uses. This keeps the scalar
+    // accumulator arithmetic out of the filtering loop below.
+    d_run_input.clear();
+    d_run_filter.clear();
+    d_run_acc.clear();
     while (i_in < n_to_read) {
         // start j by wrapping around mod the number of channels
         while (j < d_int_rate) {
-            // Take the current filter and derivative filter output
-            o0 = d_filters[j]->filter(&input[i_in]);
-            o1 = d_diff_filters[j]->filter(&input[i_in]);
-
-            output[i_out] = o0 + o1 * d_acc; // linearly interpolate between samples
-            i_out++;
+            d_run_input.push_back(i_in);
+            d_run_filter.push_back(j);
+            d_run_acc.push_back(d_acc);
 
             // Adjust accumulator and index into filterbank
             d_acc += d_flt_rate;
@@ -227,8 +271,18 @@ int pfb_arb_resampler_ccf::filter(gr_complex* output,
     }
     d_last_filter = j; // save last filter state for re-entry
 
+    // Take the current filter and derivative filter output
+    const int n_out = d_run_input.size();
+    const unsigned int stride = 4 * d_taps_per_filter;
+    for (int i_out = 0; i_out < n_out; i_out++) {
+        output[i_out] = fused_filter(&input[d_run_input[i_out]],
+                                     &d_fused_taps[stride * d_run_filter[i_out]],
+                                     d_taps_per_filter,
+                                     d_run_acc[i_out]);
+    }
+
     n_read = i_in; // return how much we've actually read
-    return i_out;  // return how much we've produced
+    return n_out;  // return how much we've produced
 }
 
 /****************************************************************/
@@ -49,7 +49,7 @@ pfb_channelizer_ccf_impl::pfb_channelizer_ccf_impl(unsigned int nfilts,
     : block("pfb_channelizer_ccf",
             io_signature::make(nfilts, nfilts, sizeof(gr_complex)),
             io_signature::make(1, nfilts, sizeof(gr_complex))),
-      polyphase_filterbank(nfilts, taps, false),
+      polyphase_filterbank(nfilts, taps, false, false),
       d_updated(false),
       d_oversample_rate(oversample_rate)
 {
@@ -103,17 +103,55 @@ pfb_channelizer_ccf_impl::pfb_channelizer_ccf_impl(unsigned int nfilts,
     set_tag_propagation_policy(TPP_ONE_TO_ONE);
 }
 
-pfb_channelizer_ccf_impl::~pfb_channelizer_ccf_impl() { delete[] d_idxlut; }
+pfb_channelizer_ccf_impl::~pfb_channelizer_ccf_impl()
+{
+    delete[] d_idxlut;
+    for (unsigned int i = 0; i < d_batch_filters.size(); i++) {
+        delete d_batch_filters[i];
+    }
+}
 
 void pfb_channelizer_ccf_impl::set_taps(const std::vector<float>& taps)
 {
     gr::thread::scoped_lock guard(d_mutex);
 
     polyphase_filterbank::set_taps(taps);
+    build_batch_filters();
     set_history(d_taps_per_filter + 1);
     d_updated = true;
 }
 
+void pfb_channelizer_ccf_impl::build_batch_filters()
+{
+    for (unsigned int i = 0; i < d_batch_filters.size(); i++) {
+        delete d_batch_filters[i];
+    }
+    d_batch_filters = std::vector<kernel::fir_filter_batch_ccf*>(d_nfilts, NULL);
+
+    // Each rotation in general_work feeds input j into filter
+    // (last - j) mod nfilts; inputs past 'last' are read one sample
+    // earlier. All lanes are filtered over the same ntaps+1 rows
+    // starting at n-1, so the lanes reading in[n] get a trailing zero
+    // tap and the ones reading in[n-1] a leading zero tap.
+    int last = -1;
+    for (int r = 0; r < d_output_multiple; r++) {
+        last = (last + d_rate_ratio) % d_nfilts;
+
+        std::vector<std::vector<float>> lanes(d_nfilts);
+        for (int j = 0; j < (int)d_nfilts; j++) {
+            std::vector<float>& lane = lanes[d_idxlut[j]];
+            if (j <= last) {
+                lane = d_taps[last - j];
+                lane.push_back(0.0f);
+            } else {
+                lane = d_taps[last - j + d_nfilts];
+                lane.insert(lane.begin(), 0.0f);
+            }
+        }
+        d_batch_filters[last] = new kernel::fir_filter_batch_ccf(lanes);
+    }
+}
+
 void pfb_channelizer_ccf_impl::print_taps() { polyphase_filterbank::print_taps(); }
 
 std::vector<std::vector<float>> pfb_channelizer_ccf_impl::taps() const
@@ -144,7 +182,6 @@ int pfb_channelizer_ccf_impl::general_work(int noutput_items,
 {
     gr::thread::scoped_lock guard(d_mutex);
 
-    gr_complex* in = (gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
 
     if (d_updated) {
@@ -166,26 +203,25 @@ int pfb_channelizer_ccf_impl::general_work(int noutput_items,
     // fred harris, Multirate Signal Processing For Communication
     // Systems. Upper Saddle River, NJ: Prentice Hall, 2004.
 
-    int n = 1, i = -1, j = 0, oo = 0, last;
+    // The filters of one rotation are run together by a batch
+    // filter over the inputs interleaved in FFT input order; see
+    // build_batch_filters() for how the rotation is folded into the
+    // taps.
+    int n = 1, i = -1, oo = 0;
     int toconsume = (int)rintf(noutput_items / d_oversample_rate);
+    const unsigned long nrows = toconsume + d_taps_per_filter;
+
+    d_lane_inputs.resize(d_nfilts);
+    for (unsigned int j = 0; j < d_nfilts; j++) {
+        d_lane_inputs[d_idxlut[j]] = (const gr_complex*)input_items[j];
+    }
+    d_interleaved.resize(nrows * d_nfilts);
+    kernel::fir_filter_batch_ccf::interleave(&d_interleaved[0], d_lane_inputs, nrows);
+
     while (n <= toconsume) {
-        j = 0;
         i = (i + d_rate_ratio) % d_nfilts;
-        last = i;
-        while (i >= 0) {
-            in = (gr_complex*)input_items[j];
-            d_fft->get_inbuf()[d_idxlut[j]] = d_fir_filters[i]->filter(&in[n]);
-            j++;
-            i--;
-        }
-
-        i = d_nfilts - 1;
-        while (i > last) {
-            in = (gr_complex*)input_items[j];
-            d_fft->get_inbuf()[d_idxlut[j]] = d_fir_filters[i]->filter(&in[n - 1]);
-            j++;
-            i--;
-        }
+        d_batch_filters[i]->filter(d_fft->get_inbuf(),
+                                   &d_interleaved[(n - 1) * d_nfilts]);
 
         n += (i + d_rate_ratio) >= (int)d_nfilts;
 
@@ -25,6 +25,7 @@
 
 #include <gnuradio/fft/fft.h>
 #include <gnuradio/filter/fir_filter.h>
+#include <gnuradio/filter/fir_filter_batch.h>
 #include <gnuradio/filter/pfb_channelizer_ccf.h>
 #include <gnuradio/filter/polyphase_filterbank.h>
 #include <gnuradio/thread/thread.h>
@@ -44,6 +45,14 @@ private:
     std::vector<int> d_channel_map;
     gr::thread::mutex d_mutex; // mutex to protect set/work access
 
+    // One filter bank per filter rotation, indexed by the last filter
+    // of that rotation; lanes are in FFT input order.
+    std::vector<kernel::fir_filter_batch_ccf*> d_batch_filters;
+    std::vector<gr_complex> d_interleaved;
+    std::vector<const gr_complex*> d_lane_inputs;
+
+    void build_batch_filters();
+
 public:
     pfb_channelizer_ccf_impl(unsigned int nfilts,
                              const std::vector<float>& taps,
@@ -29,6 +29,7 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
 #include <volk/volk.h>
+#include <cstring>
 
 namespace gr {
 namespace filter {
@@ -51,11 +52,12 @@ pfb_decimator_ccf_impl::pfb_decimator_ccf_impl(unsigned int decim,
     : sync_block("pfb_decimator_ccf",
                  io_signature::make(decim, decim, sizeof(gr_complex)),
                  io_signature::make(1, 1, sizeof(gr_complex))),
-      polyphase_filterbank(decim, taps),
+      polyphase_filterbank(decim, taps, false, false),
       d_updated(false),
       d_chan(channel),
       d_use_fft_rotator(use_fft_rotator),
-      d_use_fft_filters(use_fft_filters)
+      d_use_fft_filters(use_fft_filters),
+      d_batch_filter(new kernel::fir_filter_batch_ccf(d_taps))
 {
     d_rate = decim;
     d_rotator = new gr_complex[d_rate];
@@ -94,13 +96,18 @@ bool pfb_decimator_ccf_impl::stop()
     return block::stop();
 }
 
-pfb_decimator_ccf_impl::~pfb_decimator_ccf_impl() { delete[] d_rotator; }
+pfb_decimator_ccf_impl::~pfb_decimator_ccf_impl()
+{
+    delete[] d_rotator;
+    delete d_batch_filter;
+}
 
 void pfb_decimator_ccf_impl::set_taps(const std::vector<float>& taps)
 {
     gr::thread::scoped_lock guard(d_mutex);
 
     polyphase_filterbank::set_taps(taps);
+    d_batch_filter->set_taps(d_taps);
     set_history(d_taps_per_filter);
     d_updated = true;
 }
@@ -144,22 +151,36 @@ int pfb_decimator_ccf_impl::work(int noutput_items,
     }
 }
 
+void pfb_decimator_ccf_impl::filter_branches(int noutput_items,
+                                             gr_vector_const_void_star& input_items)
+{
+    // Interleave the inputs, last input first, and run all filters of
+    // the bank for every output in one pass: d_branch_out[i*d_rate + j]
+    // is the output of filter j for output item i.
+    const unsigned long nrows = noutput_items + d_taps_per_filter - 1;
+
+    d_lane_inputs.resize(d_rate);
+    for (unsigned int j = 0; j < d_rate; j++) {
+        d_lane_inputs[j] = (const gr_complex*)input_items[d_rate - 1 - j];
+    }
+    d_interleaved.resize(nrows * d_rate);
+    kernel::fir_filter_batch_ccf::interleave(&d_interleaved[0], d_lane_inputs, nrows);
+
+    d_branch_out.resize(noutput_items * d_rate);
+    d_batch_filter->filterN(&d_branch_out[0], &d_interleaved[0], noutput_items);
+}
+
 int pfb_decimator_ccf_impl::work_fir_exp(int noutput_items,
                                          gr_vector_const_void_star& input_items,
                                          gr_vector_void_star& output_items)
 {
-    gr_complex* in;
     gr_complex* out = (gr_complex*)output_items[0];
 
-    int i;
-    for (i = 0; i < noutput_items; i++) {
-        // Move through filters from bottom to top
-        out[i] = 0;
-        for (int j = d_rate - 1; j >= 0; j--) {
-            // Take items from M-1 to 0; filter and rotate
-            in = (gr_complex*)input_items[d_rate - 1 - j];
-            out[i] += d_fir_filters[j]->filter(&in[i]) * d_rotator[j];
-        }
+    filter_branches(noutput_items, input_items);
+
+    // Rotate and add filter outputs
+    for (int i = 0; i < noutput_items; i++) {
+        volk_32fc_x2_dot_prod_32fc(&out[i], &d_branch_out[i * d_rate], d_rotator, d_rate);
     }
 
     return noutput_items;
@@ -169,18 +190,14 @@ int pfb_decimator_ccf_impl::work_fir_fft(int noutput_items,
                                          gr_vector_const_void_star& input_items,
                                          gr_vector_void_star& output_items)
 {
-    gr_complex* in;
     gr_complex* out = (gr_complex*)output_items[0];
 
+    filter_branches(noutput_items, input_items);
+
     int i;
     for (i = 0; i < noutput_items; i++) {
-        // Move through filters from bottom to top
-        out[i] = 0;
-        for (unsigned int j = 0; j < d_rate; j++) {
-            // Take in the items from the first input stream to d_rate
-            in = (gr_complex*)input_items[d_rate - 1 - j];
-            d_fft->get_inbuf()[j] = d_fir_filters[j]->filter(&in[i]);
-        }
+        memcpy(
+            d_fft->get_inbuf(), &d_branch_out[i * d_rate], d_rate * sizeof(gr_complex));
 
         // Perform the FFT to do the complex multiply despinning for all channels
         d_fft->execute();
@@ -24,6 +24,7 @@
 #ifndef INCLUDED_PFB_DECIMATOR_CCF_IMPL_H
 #define INCLUDED_PFB_DECIMATOR_CCF_IMPL_H
 
+#include <gnuradio/filter/fir_filter_batch.h>
 #include <gnuradio/filter/pfb_decimator_ccf.h>
 #include <gnuradio/filter/polyphase_filterbank.h>
 #include <gnuradio/thread/thread.h>
@@ -44,6 +45,15 @@ private:
     gr_complex* d_tmp;         // used for fft filters
     gr::thread::mutex d_mutex; // mutex to protect set/work access
 
+    // used for fir filters; lane j is filter j, fed from input d_rate-1-j
+    kernel::fir_filter_batch_ccf* d_batch_filter;
+    std::vector<gr_complex> d_interleaved;
+    std::vector<gr_complex> d_branch_out;
+    std::vector<const gr_complex*> d_lane_inputs;
+
+    inline void filter_branches(int noutput_items,
+                                gr_vector_const_void_star& input_items);
+
     inline int work_fir_exp(int noutput_items,
                             gr_vector_const_void_star& input_items,
                             gr_vector_void_star& output_items);
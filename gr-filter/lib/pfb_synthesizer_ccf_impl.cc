@@ -27,6 +27,7 @@
 #include "pfb_synthesizer_ccf_impl.h"
 #include <gnuradio/io_signature.h>
 #include <cstdio>
+#include <cstring>
 
 namespace gr {
 namespace filter {
@@ -56,14 +57,14 @@ pfb_synthesizer_ccf_impl::pfb_synthesizer_ccf_impl(unsigned int numchans,
                                     "be even for 2x oversampling.\n");
     }
 
-    d_filters = std::vector<kernel::fir_filter_with_buffer_ccf*>(d_twox * d_numchans);
     d_channel_map.resize(d_twox * d_numchans);
 
-    // Create an FIR filter for each channel and zero out the taps
-    // and set the default channel map
-    std::vector<float> vtaps(0, d_twox * d_numchans);
+    // Create the filter bank with one lane for each filter and set
+    // the default channel map
+    d_filters = new kernel::fir_filter_batch_ccf(
+        std::vector<std::vector<float>>(d_twox * d_numchans));
+    d_filter_out.resize(d_twox * d_numchans);
     for (unsigned int i = 0; i < d_twox * d_numchans; i++) {
-        d_filters[i] = new kernel::fir_filter_with_buffer_ccf(vtaps);
         d_channel_map[i] = i;
     }
 
@@ -80,9 +81,7 @@ pfb_synthesizer_ccf_impl::pfb_synthesizer_ccf_impl(unsigned int numchans,
 pfb_synthesizer_ccf_impl::~pfb_synthesizer_ccf_impl()
 {
     delete d_fft;
-    for (unsigned int i = 0; i < d_twox * d_numchans; i++) {
-        delete d_filters[i];
-    }
+    delete d_filters;
 }
 
 void pfb_synthesizer_ccf_impl::set_taps(const std::vector<float>& taps)
@@ -96,7 +95,11 @@ void pfb_synthesizer_ccf_impl::set_taps(const std::vector<float>& taps)
     else
         set_taps2(taps);
 
-    // Because we keep our own buffers inside the filters, we don't
+    d_filters->set_taps(d_taps);
+    d_history.assign(2 * d_taps_per_filter * d_twox * d_numchans, 0);
+    d_history_idx = 0;
+
+    // Because we keep our own buffer of the filter inputs, we don't
     // need history.
     set_history(1);
     d_updated = true;
@@ -134,9 +137,6 @@ void pfb_synthesizer_ccf_impl::set_taps1(const std::vector<float>& taps)
             d_taps[i][j] =
                 tmp_taps[i + j * d_numchans]; // add taps to channels in reverse order
         }
-
-        // Set the filter taps for each channel
-        d_filters[i]->set_taps(d_taps[i]);
     }
 }
 
@@ -187,10 +187,6 @@ void pfb_synthesizer_ccf_impl::set_taps2(const std::vector<float>& taps)
                 state = 0;
             }
         }
-
-        // Set the filter taps for each channel
-        d_filters[i]->set_taps(d_taps[i]);
-        d_filters[d_numchans + i]->set_taps(d_taps[d_numchans + i]);
     }
 }
 
@@ -245,50 +241,53 @@ int pfb_synthesizer_ccf_impl::work(int noutput_items,
 
     unsigned int n, i;
     size_t ninputs = input_items.size();
+    const unsigned int nlanes = d_twox * d_numchans;
+    const size_t rowsize = nlanes * sizeof(gr_complex);
 
-    // Algorithm for critically sampled channels
-    if (d_twox == 1) {
-        for (n = 0; n < noutput_items / d_numchans; n++) {
-            for (i = 0; i < ninputs; i++) {
-                in = (gr_complex*)input_items[i];
-                d_fft->get_inbuf()[d_channel_map[i]] = in[n];
-            }
-
-            // spin through IFFT
-            d_fft->execute();
+    for (n = 0; n < noutput_items / d_numchans; n++) {
+        for (i = 0; i < ninputs; i++) {
+            in = (gr_complex*)input_items[i];
+            d_fft->get_inbuf()[d_channel_map[i]] = in[n];
+        }
 
-            for (i = 0; i < d_numchans; i++) {
-                out[i] = d_filters[i]->filter(d_fft->get_outbuf()[i]);
-            }
-            out += d_numchans;
+        // spin through IFFT
+        d_fft->execute();
+
+        // Push the IFFT output onto the filter history; lane i of the
+        // filter bank sees IFFT output i.
+        gr_complex* row = &d_history[d_history_idx * nlanes];
+        if (d_twox == 1) {
+            memcpy(row, d_fft->get_outbuf(), rowsize);
+        } else {
+            // For oversampling by 2x, the input buffer to the filters
+            // must be circularly shifted by numchans every time
+            // through, done by using d_state to determine which IFFT
+            // buffer position to pull from.
+            memcpy(row,
+                   d_fft->get_outbuf() + d_state * d_numchans,
+                   d_numchans * sizeof(gr_complex));
+            memcpy(row + d_numchans,
+                   d_fft->get_outbuf() + (d_state ^ 1) * d_numchans,
+                   d_numchans * sizeof(gr_complex));
+            d_state ^= 1;
         }
-    }
+        memcpy(row + d_taps_per_filter * nlanes, row, rowsize);
 
-    // Algorithm for oversampling by 2x
-    else {
-        for (n = 0; n < noutput_items / d_numchans; n++) {
-            for (i = 0; i < ninputs; i++) {
-                // in = (gr_complex*)input_items[ninputs-i-1];
-                in = (gr_complex*)input_items[i];
-                d_fft->get_inbuf()[d_channel_map[i]] = in[n];
-            }
+        d_history_idx++;
+        if (d_history_idx >= d_taps_per_filter)
+            d_history_idx = 0;
 
-            // spin through IFFT
-            d_fft->execute();
+        d_filters->filter(&d_filter_out[0], &d_history[d_history_idx * nlanes]);
 
-            // Output is sum of two filters, but the input buffer to the filters must be
-            // circularly shifted by numchans every time through, done by using d_state to
-            // determine which IFFT buffer position to pull from.
+        if (d_twox == 1) {
+            memcpy(out, &d_filter_out[0], d_numchans * sizeof(gr_complex));
+        } else {
+            // Output is sum of two filters
             for (i = 0; i < d_numchans; i++) {
-                out[i] =
-                    d_filters[i]->filter(d_fft->get_outbuf()[d_state * d_numchans + i]);
-                out[i] += d_filters[d_numchans + i]->filter(
-                    d_fft->get_outbuf()[(d_state ^ 1) * d_numchans + i]);
+                out[i] = d_filter_out[i] + d_filter_out[d_numchans + i];
             }
-            d_state ^= 1;
-
-            out += d_numchans;
         }
+        out += d_numchans;
     }
 
     return noutput_items;
@@ -25,7 +25,7 @@
 #define INCLUDED_PFB_SYNTHESIZER_CCF_IMPL_H
 
 #include <gnuradio/fft/fft.h>
-#include <gnuradio/filter/fir_filter_with_buffer.h>
+#include <gnuradio/filter/fir_filter_batch.h>
 #include <gnuradio/filter/pfb_synthesizer_ccf.h>
 #include <gnuradio/thread/thread.h>
 
@@ -33,8 +33,8 @@ namespace gr {
 namespace filter {
 
 // While this is a polyphase_filterbank, we don't use the normal
-// parent class because we have to use the fir_filter_with_buffer
-// objects instead of normal filters.
+// parent class because the filters run on a history of the IFFT
+// outputs kept here instead of on the input streams.
 
 class FILTER_API pfb_synthesizer_ccf_impl : public pfb_synthesizer_ccf
 {
@@ -43,8 +43,14 @@ private:
     unsigned int d_numchans;
     unsigned int d_taps_per_filter;
     fft::fft_complex* d_fft;
-    std::vector<kernel::fir_filter_with_buffer_ccf*> d_filters;
+    kernel::fir_filter_batch_ccf* d_filters;
     std::vector<std::vector<float>> d_taps;
+
+    // Last d_taps_per_filter IFFT outputs, one row per IFFT and
+    // stored twice so that a contiguous window always exists.
+    std::vector<gr_complex> d_history;
+    unsigned int d_history_idx;
+    std::vector<gr_complex> d_filter_out;
     int d_state;
     std::vector<int> d_channel_map;
     unsigned int d_twox;
@@ -33,16 +33,20 @@ namespace kernel {
 
 polyphase_filterbank::polyphase_filterbank(unsigned int nfilts,
                                            const std::vector<float>& taps,
-                                           bool fft_forward)
+                                           bool fft_forward,
+                                           bool fir_filters)
     : d_nfilts(nfilts)
 {
-    d_fir_filters = std::vector<kernel::fir_filter_ccf*>(d_nfilts);
+    if (fir_filters)
+        d_fir_filters = std::vector<kernel::fir_filter_ccf*>(d_nfilts);
     d_fft_filters = std::vector<kernel::fft_filter_ccf*>(d_nfilts);
 
     // Create an FIR filter for each channel and zero out the taps
     std::vector<float> vtaps(1, 0.0f);
-    for (unsigned int i = 0; i < d_nfilts; i++) {
+    for (unsigned int i = 0; i < d_fir_filters.size(); i++) {
         d_fir_filters[i] = new kernel::fir_filter_ccf(1, vtaps);
+    }
+    for (unsigned int i = 0; i < d_nfilts; i++) {
         d_fft_filters[i] = new kernel::fft_filter_ccf(1, vtaps);
     }
 
@@ -56,8 +60,10 @@ polyphase_filterbank::polyphase_filterbank(unsigned int nfilts,
 polyphase_filterbank::~polyphase_filterbank()
 {
     delete d_fft;
-    for (unsigned int i = 0; i < d_nfilts; i++) {
+    for (unsigned int i = 0; i < d_fir_filters.size(); i++) {
         delete d_fir_filters[i];
+    }
+    for (unsigned int i = 0; i < d_nfilts; i++) {
         delete d_fft_filters[i];
     }
 }
@@ -87,7 +93,8 @@ void polyphase_filterbank::set_taps(const std::vector<float>& taps)
         }
 
         // Set the filter taps for each channel
-        d_fir_filters[i]->set_taps(d_taps[i]);
+        if (!d_fir_filters.empty())
+            d_fir_filters[i]->set_taps(d_taps[i]);
         d_fft_filters[i]->set_taps(d_taps[i]);
     }
 }
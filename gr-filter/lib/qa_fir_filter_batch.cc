@@ -0,0 +1,102 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/filter/fir_filter_batch.h>
+#include <gnuradio/random.h>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+namespace gr {
+namespace filter {
+
+static gr::random rndm;
+
+static float uniform()
+{
+    return 2.0 * (rndm.ran1() - 0.5); // uniformly (-1, 1)
+}
+
+static gr_complex ref_filter(const std::vector<float>& taps, const gr_complex input[])
+{
+    // same convention as kernel::fir_filter: taps applied in reverse
+    gr_complex sum = 0;
+    for (size_t k = 0; k < taps.size(); k++) {
+        sum += input[k] * taps[taps.size() - 1 - k];
+    }
+    return sum;
+}
+
+BOOST_AUTO_TEST_CASE(t1_lanes)
+{
+    const unsigned int NOUTPUT = 23;
+
+    for (unsigned int nlanes = 1; nlanes <= 17; nlanes += 4) {
+        for (unsigned int ntaps = 1; ntaps <= 13; ntaps += 3) {
+            // lanes of unequal length are zero-padded at the end
+            std::vector<std::vector<float>> taps(nlanes);
+            for (unsigned int l = 0; l < nlanes; l++) {
+                taps[l].resize(ntaps - (l % ntaps));
+                for (unsigned int k = 0; k < taps[l].size(); k++) {
+                    taps[l][k] = uniform();
+                }
+            }
+
+            const unsigned int nrows = NOUTPUT + ntaps - 1;
+            std::vector<std::vector<gr_complex>> streams(nlanes);
+            std::vector<const gr_complex*> ptrs(nlanes);
+            for (unsigned int l = 0; l < nlanes; l++) {
+                streams[l].resize(nrows);
+                for (unsigned int i = 0; i < nrows; i++) {
+                    streams[l][i] = gr_complex(uniform(), uniform());
+                }
+                ptrs[l] = &streams[l][0];
+            }
+
+            kernel::fir_filter_batch_ccf f(taps);
+            BOOST_CHECK_EQUAL(f.nlanes(), nlanes);
+            BOOST_CHECK_EQUAL(f.ntaps(), ntaps);
+
+            std::vector<gr_complex> interleaved(nrows * nlanes);
+            kernel::fir_filter_batch_ccf::interleave(&interleaved[0], ptrs, nrows);
+
+            std::vector<gr_complex> output(NOUTPUT * nlanes);
+            f.filterN(&output[0], &interleaved[0], NOUTPUT);
+
+            for (unsigned int l = 0; l < nlanes; l++) {
+                std::vector<float> padded = taps[l];
+                padded.resize(ntaps, 0.0f);
+                for (unsigned int i = 0; i < NOUTPUT; i++) {
+                    gr_complex expected = ref_filter(padded, &streams[l][i]);
+                    BOOST_CHECK_SMALL(std::abs(output[i * nlanes + l] - expected), 1e-5f);
+                }
+            }
+        }
+    }
+}
+
+} /* namespace filter */
+} /* namespace gr */
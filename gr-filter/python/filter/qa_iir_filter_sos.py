@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+#
+# Copyright 2020 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+from gnuradio import gr, gr_unittest, filter, blocks
+
+# two sections of a 4th order lowpass, [b0 b1 b2 a0 a1 a2] each
+sos = (0.0048243, 0.0096486, 0.0048243, 1.0, -1.0485995, 0.2961403,
+       1.0, 2.0, 1.0, 1.0, -1.3209134, 0.6327387)
+
+def reference(data, sos):
+    # Direct Form I, one section after the other
+    y = list(data)
+    for s in range(len(sos) // 6):
+        b0, b1, b2, a0, a1, a2 = sos[6*s:6*s+6]
+        x1 = x2 = y1 = y2 = 0
+        out = []
+        for x in y:
+            v = (b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2) / a0
+            x2, x1 = x1, x
+            y2, y1 = y1, v
+            out.append(v)
+        y = out
+    return y
+
+class test_iir_filter_sos(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_sos_fff_001(self):
+        src_data = [1.0] + [0.0]*63
+        expected_result = reference(src_data, sos)
+        src = blocks.vector_source_f(src_data)
+        op = filter.iir_filter_sos_fff(sos)
+        dst = blocks.vector_sink_f()
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        result_data = dst.data()
+        self.assertFloatTuplesAlmostEqual(expected_result, result_data, 5)
+
+    def test_sos_fff_002(self):
+        # vector elements are independent channels
+        ch0 = [float(i % 7) for i in range(50)]
+        ch1 = [float((3*i) % 5) - 2 for i in range(50)]
+        src_data = [v for pair in zip(ch0, ch1) for v in pair]
+        ref0 = reference(ch0, sos)
+        ref1 = reference(ch1, sos)
+        expected_result = [v for pair in zip(ref0, ref1) for v in pair]
+        src = blocks.vector_source_f(src_data, False, 2)
+        op = filter.iir_filter_sos_fff(sos, 2)
+        dst = blocks.vector_sink_f(2)
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        result_data = dst.data()
+        self.assertFloatTuplesAlmostEqual(expected_result, result_data, 4)
+
+    def test_sos_ccf_001(self):
+        re = [float(i % 9) for i in range(40)]
+        im = [float(-(i % 4)) for i in range(40)]
+        src_data = [complex(r, i) for r, i in zip(re, im)]
+        expected_result = [complex(r, i) for r, i in
+                           zip(reference(re, sos), reference(im, sos))]
+        src = blocks.vector_source_c(src_data)
+        op = filter.iir_filter_sos_ccf(sos)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        result_data = dst.data()
+        self.assertComplexTuplesAlmostEqual(expected_result, result_data, 4)
+
+    def test_sos_set_taps_001(self):
+        op = filter.iir_filter_sos_fff(sos)
+        self.assertRaises(RuntimeError, op.set_taps, (1.0, 2.0, 3.0))
+
+if __name__ == '__main__':
+    gr_unittest.run(test_iir_filter_sos, "test_iir_filter_sos.xml")
@@ -49,6 +49,8 @@
 #include "gnuradio/filter/iir_filter_ccf.h"
 #include "gnuradio/filter/iir_filter_ccd.h"
 #include "gnuradio/filter/iir_filter_ccz.h"
+#include "gnuradio/filter/iir_filter_sos_fff.h"
+#include "gnuradio/filter/iir_filter_sos_ccf.h"
 #include "gnuradio/filter/interp_fir_filter.h"
 #include "gnuradio/filter/pfb_arb_resampler_ccf.h"
 #include "gnuradio/filter/pfb_arb_resampler_ccc.h"
@@ -83,6 +85,8 @@
 %include "gnuradio/filter/iir_filter_ccf.h"
 %include "gnuradio/filter/iir_filter_ccd.h"
 %include "gnuradio/filter/iir_filter_ccz.h"
+%include "gnuradio/filter/iir_filter_sos_fff.h"
+%include "gnuradio/filter/iir_filter_sos_ccf.h"
 %include "gnuradio/filter/interp_fir_filter.h"
 %include "gnuradio/filter/pfb_arb_resampler_ccf.h"
 %include "gnuradio/filter/pfb_arb_resampler_ccc.h"
@@ -124,6 +128,8 @@ GR_SWIG_BLOCK_MAGIC2(filter, iir_filter_ccc);
 GR_SWIG_BLOCK_MAGIC2(filter, iir_filter_ccf);
 GR_SWIG_BLOCK_MAGIC2(filter, iir_filter_ccd);
 GR_SWIG_BLOCK_MAGIC2(filter, iir_filter_ccz);
+GR_SWIG_BLOCK_MAGIC2(filter, iir_filter_sos_fff);
+GR_SWIG_BLOCK_MAGIC2(filter, iir_filter_sos_ccf);
 GR_SWIG_BLOCK_MAGIC2_TMPL(filter, interp_fir_filter_ccc, interp_fir_filter<gr_complex, gr_complex, gr_complex>);
 GR_SWIG_BLOCK_MAGIC2_TMPL(filter, interp_fir_filter_ccf, interp_fir_filter<gr_complex, gr_complex, float>);
 GR_SWIG_BLOCK_MAGIC2_TMPL(filter, interp_fir_filter_fcc, interp_fir_filter<float, gr_complex, gr_complex>);
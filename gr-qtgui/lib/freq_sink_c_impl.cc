@@ -124,6 +124,12 @@ freq_sink_c_impl::freq_sink_c_impl(int fftsize,
 
     buildwindow();
 
+    d_worker = new spectrum_worker(
+        d_nconnections, boost::bind(&freq_sink_c_impl::display_frame, this, _1, _2, _3));
+    d_worker->set_fft_size(d_fftsize);
+    d_worker->set_window(d_wintype);
+    d_worker->set_average(d_fftavg);
+
     initialize();
 
     set_trigger_mode(TRIG_MODE_FREE, 0, 0);
@@ -131,6 +137,9 @@ freq_sink_c_impl::freq_sink_c_impl(int fftsize,
 
 freq_sink_c_impl::~freq_sink_c_impl()
 {
+    // Stop the worker first; it posts to the GUI
+    delete d_worker;
+
     if (!d_main_gui->isClosed())
         d_main_gui->close();
 
@@ -244,6 +253,7 @@ void freq_sink_c_impl::set_update_time(double t)
     d_update_time = t * tps;
     d_main_gui->setUpdateTime(t);
     d_last_time = 0;
+    d_worker->set_update_time(d_update_time);
 }
 
 void freq_sink_c_impl::set_title(const std::string& title)
@@ -410,6 +420,7 @@ bool freq_sink_c_impl::windowreset()
     if (d_wintype != newwintype) {
         d_wintype = newwintype;
         buildwindow();
+        d_worker->set_window(d_wintype);
         return true;
     }
     return false;
@@ -429,6 +440,7 @@ bool freq_sink_c_impl::fftresize()
 
     int newfftsize = d_main_gui->getFFTSize();
     d_fftavg = d_main_gui->getFFTAverage();
+    d_worker->set_average(d_fftavg);
 
     if (newfftsize != d_fftsize) {
         // Resize residbuf and replace data
@@ -453,6 +465,7 @@ bool freq_sink_c_impl::fftresize()
         // (throws away any currently held data, but who cares?)
         d_fftsize = newfftsize;
         d_index = 0;
+        d_worker->set_fft_size(d_fftsize);
 
         // Reset window to reflect new size
         buildwindow();
@@ -578,50 +591,61 @@ int freq_sink_c_impl::work(int noutput_items,
     gr::thread::scoped_lock lock(d_setlock);
     for (d_index = 0; d_index < noutput_items; d_index += d_fftsize) {
 
-        if ((gr::high_res_timer_now() - d_last_time) > d_update_time) {
+        // Skip chunks the display has no use for
+        if (!d_worker->wants_input())
+            continue;
 
-            // Trigger off tag, if active
-            if ((d_trigger_mode == TRIG_MODE_TAG) && !d_triggered) {
-                _test_trigger_tags(d_index, d_fftsize);
-                if (d_triggered) {
-                    // If not enough from tag position, early exit
-                    if ((d_index + d_fftsize) >= noutput_items)
-                        return d_index;
-                }
-            }
-
-            // Perform FFT and shift operations into d_magbufs
-            for (int n = 0; n < d_nconnections; n++) {
-                in = (const gr_complex*)input_items[n];
-                memcpy(d_residbufs[n], &in[d_index], sizeof(gr_complex) * d_fftsize);
-
-                fft(d_fbuf, d_residbufs[n], d_fftsize);
-                for (int x = 0; x < d_fftsize; x++) {
-                    d_magbufs[n][x] = (double)((1.0 - d_fftavg) * d_magbufs[n][x] +
-                                               (d_fftavg)*d_fbuf[x]);
-                }
-                // volk_32f_convert_64f(d_magbufs[n], d_fbuf, d_fftsize);
-            }
+        // Trigger off tag, if active
+        if ((d_trigger_mode == TRIG_MODE_TAG) && !d_triggered) {
+            _test_trigger_tags(d_index, d_fftsize);
+            if (!d_triggered)
+                continue;
 
-            // Test trigger off signal power in d_magbufs
-            if ((d_trigger_mode == TRIG_MODE_NORM) ||
-                (d_trigger_mode == TRIG_MODE_AUTO)) {
-                _test_trigger_norm(d_fftsize, d_magbufs);
-            }
+            // If not enough from tag position, early exit
+            if ((d_index + d_fftsize) >= noutput_items)
+                return d_index;
+        }
 
-            // If a trigger (FREE always triggers), plot and reset state
-            if (d_triggered) {
-                d_last_time = gr::high_res_timer_now();
-                d_qApplication->postEvent(d_main_gui,
-                                          new FreqUpdateEvent(d_magbufs, d_fftsize));
-                _reset();
-            }
+        // The FFT, averaging and plotting happen on the worker thread
+        for (int n = 0; n < d_nconnections; n++) {
+            in = (const gr_complex*)input_items[n];
+            memcpy(d_worker->input(n), &in[d_index], sizeof(gr_complex) * d_fftsize);
         }
+        d_worker->publish(gr::high_res_timer_now());
     }
 
     return noutput_items;
 }
 
+bool freq_sink_c_impl::display_frame(const std::vector<double*>& points,
+                                     int fftsize,
+                                     gr::high_res_timer_type t)
+{
+    gr::thread::scoped_lock lock(d_setlock);
+
+    // Drop frames computed before an FFT size change
+    if (fftsize != d_fftsize)
+        return false;
+
+    for (int n = 0; n < d_nconnections; n++)
+        memcpy(d_magbufs[n], points[n], sizeof(double) * fftsize);
+
+    // Test trigger off signal power in d_magbufs
+    if ((d_trigger_mode == TRIG_MODE_NORM) || (d_trigger_mode == TRIG_MODE_AUTO)) {
+        _test_trigger_norm(d_fftsize, d_magbufs);
+    }
+
+    // If a trigger (FREE always triggers), plot and reset state
+    if (!d_triggered)
+        return false;
+
+    d_last_time = gr::high_res_timer_now();
+    d_qApplication->postEvent(
+        d_main_gui, new FreqFrameEvent(d_magbufs, d_fftsize, d_worker->display_token()));
+    _reset();
+    return true;
+}
+
 
 void freq_sink_c_impl::handle_pdus(pmt::pmt_t msg)
 {
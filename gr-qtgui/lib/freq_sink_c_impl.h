@@ -31,6 +31,8 @@
 #include <gnuradio/high_res_timer.h>
 #include <gnuradio/qtgui/freqdisplayform.h>
 
+#include "spectrum_worker.h"
+
 namespace gr {
 namespace qtgui {
 
@@ -69,6 +71,11 @@ private:
     gr::high_res_timer_type d_update_time;
     gr::high_res_timer_type d_last_time;
 
+    spectrum_worker* d_worker;
+    bool display_frame(const std::vector<double*>& points,
+                       int fftsize,
+                       gr::high_res_timer_type t);
+
     bool windowreset();
     void buildwindow();
     bool fftresize();
@@ -125,6 +125,12 @@ freq_sink_f_impl::freq_sink_f_impl(int fftsize,
 
     buildwindow();
 
+    d_worker = new spectrum_worker(
+        d_nconnections, boost::bind(&freq_sink_f_impl::display_frame, this, _1, _2, _3));
+    d_worker->set_fft_size(d_fftsize);
+    d_worker->set_window(d_wintype);
+    d_worker->set_average(d_fftavg);
+
     initialize();
 
     set_trigger_mode(TRIG_MODE_FREE, 0, 0);
@@ -132,6 +138,9 @@ freq_sink_f_impl::freq_sink_f_impl(int fftsize,
 
 freq_sink_f_impl::~freq_sink_f_impl()
 {
+    // Stop the worker first; it posts to the GUI
+    delete d_worker;
+
     if (!d_main_gui->isClosed())
         d_main_gui->close();
 
@@ -245,6 +254,7 @@ void freq_sink_f_impl::set_update_time(double t)
     d_update_time = t * tps;
     d_main_gui->setUpdateTime(t);
     d_last_time = 0;
+    d_worker->set_update_time(d_update_time);
 }
 
 void freq_sink_f_impl::set_title(const std::string& title)
@@ -414,6 +424,7 @@ bool freq_sink_f_impl::windowreset()
     if (d_wintype != newwintype) {
         d_wintype = newwintype;
         buildwindow();
+        d_worker->set_window(d_wintype);
         return true;
     }
     return false;
@@ -433,6 +444,7 @@ bool freq_sink_f_impl::fftresize()
 
     int newfftsize = d_main_gui->getFFTSize();
     d_fftavg = d_main_gui->getFFTAverage();
+    d_worker->set_average(d_fftavg);
 
     if (newfftsize != d_fftsize) {
         // Resize residbuf and replace data
@@ -457,6 +469,7 @@ bool freq_sink_f_impl::fftresize()
         // (throws away any currently held data, but who cares?)
         d_fftsize = newfftsize;
         d_index = 0;
+        d_worker->set_fft_size(d_fftsize);
 
         // Reset window to reflect new size
         buildwindow();
@@ -582,50 +595,64 @@ int freq_sink_f_impl::work(int noutput_items,
     gr::thread::scoped_lock lock(d_setlock);
     for (d_index = 0; d_index < noutput_items; d_index += d_fftsize) {
 
-        if ((gr::high_res_timer_now() - d_last_time) > d_update_time) {
+        // Skip chunks the display has no use for
+        if (!d_worker->wants_input())
+            continue;
 
-            // Trigger off tag, if active
-            if ((d_trigger_mode == TRIG_MODE_TAG) && !d_triggered) {
-                _test_trigger_tags(d_index, d_fftsize);
-                if (d_triggered) {
-                    // If not enough from tag position, early exit
-                    if ((d_index + d_fftsize) >= noutput_items)
-                        return d_index;
-                }
-            }
-
-            for (int n = 0; n < d_nconnections; n++) {
-                // Fill up residbuf with d_fftsize number of items
-                in = (const float*)input_items[n];
-                memcpy(d_residbufs[n], &in[d_index], sizeof(float) * d_fftsize);
-
-                fft(d_fbuf, d_residbufs[n], d_fftsize);
-                for (int x = 0; x < d_fftsize; x++) {
-                    d_magbufs[n][x] = (double)((1.0 - d_fftavg) * d_magbufs[n][x] +
-                                               (d_fftavg)*d_fbuf[x]);
-                }
-                // volk_32f_convert_64f(d_magbufs[n], d_fbuf, d_fftsize);
-            }
+        // Trigger off tag, if active
+        if ((d_trigger_mode == TRIG_MODE_TAG) && !d_triggered) {
+            _test_trigger_tags(d_index, d_fftsize);
+            if (!d_triggered)
+                continue;
 
-            // Test trigger off signal power in d_magbufs
-            if ((d_trigger_mode == TRIG_MODE_NORM) ||
-                (d_trigger_mode == TRIG_MODE_AUTO)) {
-                _test_trigger_norm(d_fftsize, d_magbufs);
-            }
+            // If not enough from tag position, early exit
+            if ((d_index + d_fftsize) >= noutput_items)
+                return d_index;
+        }
 
-            // If a trigger (FREE always triggers), plot and reset state
-            if (d_triggered) {
-                d_last_time = gr::high_res_timer_now();
-                d_qApplication->postEvent(d_main_gui,
-                                          new FreqUpdateEvent(d_magbufs, d_fftsize));
-                _reset();
-            }
+        // The FFT, averaging and plotting happen on the worker thread
+        for (int n = 0; n < d_nconnections; n++) {
+            in = (const float*)input_items[n];
+            gr_complex* dst = d_worker->input(n);
+            for (int x = 0; x < d_fftsize; x++)
+                dst[x] = in[d_index + x];
         }
+        d_worker->publish(gr::high_res_timer_now());
     }
 
     return noutput_items;
 }
 
+bool freq_sink_f_impl::display_frame(const std::vector<double*>& points,
+                                     int fftsize,
+                                     gr::high_res_timer_type t)
+{
+    gr::thread::scoped_lock lock(d_setlock);
+
+    // Drop frames computed before an FFT size change
+    if (fftsize != d_fftsize)
+        return false;
+
+    for (int n = 0; n < d_nconnections; n++)
+        memcpy(d_magbufs[n], points[n], sizeof(double) * fftsize);
+
+    // Test trigger off signal power in d_magbufs
+    if ((d_trigger_mode == TRIG_MODE_NORM) || (d_trigger_mode == TRIG_MODE_AUTO)) {
+        _test_trigger_norm(d_fftsize, d_magbufs);
+    }
+
+    // If a trigger (FREE always triggers), plot and reset state
+    if (!d_triggered)
+        return false;
+
+    d_last_time = gr::high_res_timer_now();
+    d_qApplication->postEvent(
+        d_main_gui, new FreqFrameEvent(d_magbufs, d_fftsize, d_worker->display_token()));
+    _reset();
+    return true;
+}
+
+
 void freq_sink_f_impl::handle_pdus(pmt::pmt_t msg)
 {
     size_t len;
@@ -0,0 +1,236 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "spectrum_worker.h"
+
+#include <volk/volk.h>
+#include <boost/bind.hpp>
+
+#include <string.h>
+
+namespace gr {
+namespace qtgui {
+
+namespace {
+
+// Deleter of display tokens; the flag outlives the worker if the
+// event is still queued when the sink goes away.
+struct clear_busy {
+    boost::shared_ptr<boost::atomic<bool>> flag;
+    void operator()(void*) const { flag->store(false); }
+};
+
+} // namespace
+
+spectrum_worker::spectrum_worker(int nconnections, frame_handler handler)
+    : d_nconnections(nconnections),
+      d_handler(handler),
+      d_state(1),
+      d_write(0),
+      d_read(2),
+      d_fftsize(1024),
+      d_done(false),
+      d_wintype(filter::firdes::WIN_NONE),
+      d_fftavg(1.0),
+      d_update_time(0),
+      d_last_display(0),
+      d_gui_busy(new boost::atomic<bool>(false)),
+      d_plan_size(0),
+      d_plan_wintype(filter::firdes::WIN_NONE),
+      d_fft(NULL),
+      d_fft_shift(1),
+      d_psd(NULL),
+      d_tmp(NULL)
+{
+    for (int i = 0; i < 3; i++) {
+        d_slots[i].data.resize(d_nconnections);
+        d_slots[i].fftsize = 0;
+        d_slots[i].time = 0;
+    }
+    d_thread = gr::thread::thread(boost::bind(&spectrum_worker::run, this));
+}
+
+spectrum_worker::~spectrum_worker()
+{
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_done = true;
+    }
+    d_cond.notify_one();
+    d_thread.join();
+    free_buffers();
+}
+
+void spectrum_worker::set_fft_size(int fftsize) { d_fftsize = fftsize; }
+
+void spectrum_worker::set_window(filter::firdes::win_type wintype)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_wintype = wintype;
+}
+
+void spectrum_worker::set_average(float fftavg)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    d_fftavg = fftavg;
+}
+
+void spectrum_worker::set_update_time(gr::high_res_timer_type ticks)
+{
+    d_update_time.store(ticks);
+    d_last_display.store(0);
+}
+
+bool spectrum_worker::wants_input() const
+{
+    if ((d_state.load() & FRESH) || d_gui_busy->load())
+        return false;
+    return (gr::high_res_timer_now() - d_last_display.load()) > d_update_time.load();
+}
+
+gr_complex* spectrum_worker::input(int n)
+{
+    std::vector<gr_complex>& buf = d_slots[d_write].data[n];
+    if ((int)buf.size() != d_fftsize)
+        buf.resize(d_fftsize);
+    return &buf[0];
+}
+
+void spectrum_worker::publish(gr::high_res_timer_type t)
+{
+    d_slots[d_write].fftsize = d_fftsize;
+    d_slots[d_write].time = t;
+    d_write = d_state.exchange(d_write | FRESH) & 3;
+
+    // Pass through the mutex so the worker cannot miss the wakeup
+    // between testing d_state and going to sleep.
+    { gr::thread::scoped_lock lock(d_mutex); }
+    d_cond.notify_one();
+}
+
+boost::shared_ptr<void> spectrum_worker::display_token()
+{
+    d_gui_busy->store(true);
+    clear_busy deleter = { d_gui_busy };
+    return boost::shared_ptr<void>(static_cast<void*>(NULL), deleter);
+}
+
+void spectrum_worker::run()
+{
+    while (true) {
+        filter::firdes::win_type wintype;
+        float fftavg;
+        {
+            gr::thread::scoped_lock lock(d_mutex);
+            while (!d_done && !(d_state.load() & FRESH))
+                d_cond.wait(lock);
+            if (d_done)
+                return;
+            wintype = d_wintype;
+            fftavg = d_fftavg;
+        }
+
+        d_read = d_state.exchange(d_read) & 3;
+        const slot& s = d_slots[d_read];
+        const int n = s.fftsize;
+        prepare(n, wintype);
+
+        for (int i = 0; i < d_nconnections; i++) {
+            if (d_window.size()) {
+                volk_32fc_32f_multiply_32fc(
+                    d_fft->get_inbuf(), &s.data[i][0], &d_window.front(), n);
+            } else {
+                memcpy(d_fft->get_inbuf(), &s.data[i][0], sizeof(gr_complex) * n);
+            }
+
+            d_fft->execute(); // compute the fft
+
+            volk_32fc_s32f_x2_power_spectral_density_32f(
+                d_psd, d_fft->get_outbuf(), n, 1.0, n);
+            d_fft_shift.shift(d_psd, n);
+
+            // avg += fftavg * (psd - avg)
+            volk_32f_x2_subtract_32f(d_tmp, d_psd, d_avg[i], n);
+            volk_32f_s32f_multiply_32f(d_tmp, d_tmp, fftavg, n);
+            volk_32f_x2_add_32f(d_avg[i], d_avg[i], d_tmp, n);
+            volk_32f_convert_64f(d_out[i], d_avg[i], n);
+        }
+
+        if (d_handler(d_out, n, s.time))
+            d_last_display.store(gr::high_res_timer_now());
+    }
+}
+
+void spectrum_worker::prepare(int fftsize, filter::firdes::win_type wintype)
+{
+    bool rebuild_window = wintype != d_plan_wintype;
+
+    if (fftsize != d_plan_size) {
+        free_buffers();
+
+        d_fft = new fft::fft_complex(fftsize, true);
+        d_fft_shift.resize(fftsize);
+
+        size_t alignment = volk_get_alignment();
+        d_psd = (float*)volk_malloc(fftsize * sizeof(float), alignment);
+        d_tmp = (float*)volk_malloc(fftsize * sizeof(float), alignment);
+        for (int i = 0; i < d_nconnections; i++) {
+            d_avg.push_back((float*)volk_malloc(fftsize * sizeof(float), alignment));
+            d_out.push_back((double*)volk_malloc(fftsize * sizeof(double), alignment));
+            memset(d_avg[i], 0, fftsize * sizeof(float));
+        }
+
+        d_plan_size = fftsize;
+        rebuild_window = true;
+    }
+
+    if (rebuild_window) {
+        d_window.clear();
+        if (wintype != filter::firdes::WIN_NONE) {
+            d_window = filter::firdes::window(wintype, fftsize, 6.76);
+        }
+        d_plan_wintype = wintype;
+    }
+}
+
+void spectrum_worker::free_buffers()
+{
+    delete d_fft;
+    d_fft = NULL;
+    volk_free(d_psd);
+    volk_free(d_tmp);
+    d_psd = d_tmp = NULL;
+    for (size_t i = 0; i < d_avg.size(); i++) {
+        volk_free(d_avg[i]);
+        volk_free(d_out[i]);
+    }
+    d_avg.clear();
+    d_out.clear();
+    d_plan_size = 0;
+}
+
+} /* namespace qtgui */
+} /* namespace gr */
@@ -0,0 +1,181 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_QTGUI_SPECTRUM_WORKER_H
+#define INCLUDED_QTGUI_SPECTRUM_WORKER_H
+
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/fft/fft_shift.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/high_res_timer.h>
+#include <gnuradio/qtgui/spectrumUpdateEvents.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+namespace gr {
+namespace qtgui {
+
+/*!
+ * \brief Computes averaged power spectra for the frequency and
+ * waterfall sinks on a thread of its own.
+ *
+ * work() calls wants_input() for each FFT-sized chunk and only when
+ * it returns true fills input() and calls publish(). That is at most
+ * once per update interval, only after the worker has picked up the
+ * last chunk, and only while the GUI is not still drawing the last
+ * frame, so the scheduler thread never runs an FFT and no FFT is
+ * computed that cannot be displayed.
+ *
+ * Chunks go from work() to the worker through a triple buffer: each
+ * side owns one slot and trades it for the third with one atomic
+ * exchange. The worker windows, transforms, converts to dB and
+ * averages each chunk, then hands the result to the frame handler.
+ */
+class spectrum_worker : boost::noncopyable
+{
+public:
+    /*!
+     * Called on the worker thread with one buffer of \p fftsize
+     * averaged dB values per input and the time the chunk was
+     * published. Returns true if the frame was sent to the GUI.
+     */
+    typedef boost::function<bool(
+        const std::vector<double*>& points, int fftsize, gr::high_res_timer_type t)>
+        frame_handler;
+
+    spectrum_worker(int nconnections, frame_handler handler);
+    ~spectrum_worker();
+
+    //! Takes effect with the next published chunk; called from work().
+    void set_fft_size(int fftsize);
+    void set_window(filter::firdes::win_type wintype);
+    void set_average(float fftavg);
+    void set_update_time(gr::high_res_timer_type ticks);
+
+    //! True if work() should publish the current chunk.
+    bool wants_input() const;
+
+    //! The slot work() fills for input \p n, fftsize items long.
+    gr_complex* input(int n);
+
+    //! Hands the filled slots to the worker.
+    void publish(gr::high_res_timer_type t);
+
+    /*!
+     * \brief Returns a token that holds off new input until the GUI
+     * is done with the frame it accompanies.
+     *
+     * The frame handler attaches it to the event it posts; Qt deletes
+     * posted events once they are delivered.
+     */
+    boost::shared_ptr<void> display_token();
+
+private:
+    struct slot {
+        std::vector<std::vector<gr_complex>> data;
+        int fftsize;
+        gr::high_res_timer_type time;
+    };
+
+    enum { FRESH = 4 }; // set in d_state while the middle slot is unread
+
+    int d_nconnections;
+    frame_handler d_handler;
+
+    slot d_slots[3];
+    boost::atomic<unsigned> d_state; // middle slot index | FRESH
+    unsigned d_write;                // owned by work()
+    unsigned d_read;                 // owned by the worker
+    int d_fftsize;                   // size of the slots work() fills
+
+    gr::thread::mutex d_mutex; // guards the settings below and wakeups
+    gr::thread::condition_variable d_cond;
+    bool d_done;
+    filter::firdes::win_type d_wintype;
+    float d_fftavg;
+
+    boost::atomic<gr::high_res_timer_type> d_update_time;
+    boost::atomic<gr::high_res_timer_type> d_last_display;
+    boost::shared_ptr<boost::atomic<bool>> d_gui_busy;
+
+    // Owned by the worker thread
+    int d_plan_size;
+    filter::firdes::win_type d_plan_wintype;
+    fft::fft_complex* d_fft;
+    fft::fft_shift<float> d_fft_shift;
+    std::vector<float> d_window;
+    float* d_psd;
+    float* d_tmp;
+    std::vector<float*> d_avg;
+    std::vector<double*> d_out;
+
+    gr::thread::thread d_thread;
+
+    void run();
+    void prepare(int fftsize, filter::firdes::win_type wintype);
+    void free_buffers();
+};
+
+/*!
+ * \brief FreqUpdateEvent carrying a spectrum_worker display token.
+ */
+class FreqFrameEvent : public FreqUpdateEvent
+{
+public:
+    FreqFrameEvent(const std::vector<double*>& points,
+                   uint64_t npoints,
+                   boost::shared_ptr<void> token)
+        : FreqUpdateEvent(points, npoints), d_token(token)
+    {
+    }
+
+private:
+    boost::shared_ptr<void> d_token;
+};
+
+/*!
+ * \brief WaterfallUpdateEvent carrying a spectrum_worker display token.
+ */
+class WaterfallFrameEvent : public WaterfallUpdateEvent
+{
+public:
+    WaterfallFrameEvent(const std::vector<double*>& points,
+                        uint64_t npoints,
+                        gr::high_res_timer_type t,
+                        boost::shared_ptr<void> token)
+        : WaterfallUpdateEvent(points, npoints, t), d_token(token)
+    {
+    }
+
+private:
+    boost::shared_ptr<void> d_token;
+};
+
+} /* namespace qtgui */
+} /* namespace gr */
+
+#endif /* INCLUDED_QTGUI_SPECTRUM_WORKER_H */
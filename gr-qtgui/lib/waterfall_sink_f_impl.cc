@@ -111,6 +111,13 @@ waterfall_sink_f_impl::waterfall_sink_f_impl(int fftsize,
 
     buildwindow();
 
+    d_worker = new spectrum_worker(
+        d_nconnections,
+        boost::bind(&waterfall_sink_f_impl::display_frame, this, _1, _2, _3));
+    d_worker->set_fft_size(d_fftsize);
+    d_worker->set_window(d_wintype);
+    d_worker->set_average(d_fftavg);
+
     initialize();
 
     // setup bw input port
@@ -133,6 +140,9 @@ waterfall_sink_f_impl::waterfall_sink_f_impl(int fftsize,
 
 waterfall_sink_f_impl::~waterfall_sink_f_impl()
 {
+    // Stop the worker first; it posts to the GUI
+    delete d_worker;
+
     if (!d_main_gui->isClosed())
         d_main_gui->close();
 
@@ -246,6 +256,7 @@ void waterfall_sink_f_impl::set_update_time(double t)
     d_update_time = t * tps;
     d_main_gui->setUpdateTime(t);
     d_last_time = 0;
+    d_worker->set_update_time(d_update_time);
 }
 
 void waterfall_sink_f_impl::set_title(const std::string& title)
@@ -348,6 +359,7 @@ void waterfall_sink_f_impl::windowreset()
     if (d_wintype != newwintype) {
         d_wintype = newwintype;
         buildwindow();
+        d_worker->set_window(d_wintype);
     }
 }
 
@@ -365,6 +377,7 @@ void waterfall_sink_f_impl::fftresize()
 
     int newfftsize = d_main_gui->getFFTSize();
     d_fftavg = d_main_gui->getFFTAverage();
+    d_worker->set_average(d_fftavg);
 
     if (newfftsize != d_fftsize) {
 
@@ -399,6 +412,7 @@ void waterfall_sink_f_impl::fftresize()
         // (throws away any currently held data, but who cares?)
         d_fftsize = newfftsize;
         d_index = 0;
+        d_worker->set_fft_size(d_fftsize);
 
         // Reset window to reflect new size
         buildwindow();
@@ -470,24 +484,17 @@ int waterfall_sink_f_impl::work(int noutput_items,
         // If we have enough input for one full FFT, do it
         if (datasize >= resid) {
 
-            if (gr::high_res_timer_now() - d_last_time > d_update_time) {
+            // The FFT and averaging happen on the worker thread
+            if (d_worker->wants_input()) {
                 for (int n = 0; n < d_nconnections; n++) {
                     // Fill up residbuf with d_fftsize number of items
                     in = (const float*)input_items[n];
                     memcpy(d_residbufs[n] + d_index, &in[j], sizeof(float) * resid);
-
-                    fft(d_fbuf, d_residbufs[n], d_fftsize);
-                    for (int x = 0; x < d_fftsize; x++) {
-                        d_magbufs[n][x] = (double)((1.0 - d_fftavg) * d_magbufs[n][x] +
-                                                   (d_fftavg)*d_fbuf[x]);
-                    }
-                    // volk_32f_convert_64f(d_magbufs[n], d_fbuf, d_fftsize);
+                    gr_complex* dst = d_worker->input(n);
+                    for (int x = 0; x < d_fftsize; x++)
+                        dst[x] = d_residbufs[n][x];
                 }
-
-                d_last_time = gr::high_res_timer_now();
-                d_qApplication->postEvent(
-                    d_main_gui,
-                    new WaterfallUpdateEvent(d_magbufs, d_fftsize, d_last_time));
+                d_worker->publish(gr::high_res_timer_now());
             }
 
             d_index = 0;
@@ -507,6 +514,23 @@ int waterfall_sink_f_impl::work(int noutput_items,
     return j;
 }
 
+bool waterfall_sink_f_impl::display_frame(const std::vector<double*>& points,
+                                          int fftsize,
+                                          gr::high_res_timer_type t)
+{
+    gr::thread::scoped_lock lock(d_setlock);
+
+    // Drop frames computed before an FFT size change
+    if (fftsize != d_fftsize)
+        return false;
+
+    d_last_time = t;
+    d_qApplication->postEvent(
+        d_main_gui,
+        new WaterfallFrameEvent(points, fftsize, t, d_worker->display_token()));
+    return true;
+}
+
 void waterfall_sink_f_impl::handle_pdus(pmt::pmt_t msg)
 {
     size_t len;
@@ -50,6 +50,8 @@ public:
      * \param address  ZMQ socket address specifier.
      * \param timeout  Receive timeout in milliseconds, default is 100ms, 1us increments.
      * \param pass_tags Whether source will look for and deserialize tags.
+     *        Both the version 1 headers of earlier releases and the
+     *        current version 2 headers are accepted.
      * \param hwm High Watermark to configure the socket to (-1 => zmq's default)
      */
     static sptr make(size_t itemsize,
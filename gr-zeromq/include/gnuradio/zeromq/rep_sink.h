@@ -52,6 +52,8 @@ public:
      * \param address  ZMQ socket address specifier.
      * \param timeout  Receive timeout in milliseconds, default is 100ms, 1us increments.
      * \param pass_tags Whether sink will serialize and pass tags over the link.
+     *        Tags go in a version 2 header, which sources from releases
+     *        before 3.9 reject; a sender for those must not pass tags.
      * \param hwm High Watermark to configure the socket to (-1 => zmq's default)
      */
     static sptr make(size_t itemsize,
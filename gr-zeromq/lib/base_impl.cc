@@ -70,7 +70,7 @@ base_sink_impl::base_sink_impl(int type,
                                int timeout,
                                bool pass_tags,
                                int hwm)
-    : base_impl(type, itemsize, vlen, timeout, pass_tags)
+    : base_impl(type, itemsize, vlen, timeout, pass_tags), d_pool(new buffer_pool())
 {
     /* Set high watermark */
     if (hwm >= 0) {
@@ -86,29 +86,35 @@ base_sink_impl::base_sink_impl(int type,
     d_socket->bind(address);
 }
 
+base_sink_impl::~base_sink_impl()
+{
+    /* Messages still queued keep the pool alive until ZMQ frees them */
+    d_pool->release();
+}
+
 int base_sink_impl::send_message(const void* in_buf,
                                  const int in_nitems,
                                  const uint64_t in_offset)
 {
     /* Meta-data header */
-    std::string header("");
+    const uint8_t* header = NULL;
+    size_t header_len = 0;
     if (d_pass_tags) {
-        std::vector<gr::tag_t> tags;
-        get_tags_in_range(tags, 0, in_offset, in_offset + in_nitems);
-        header = gen_tag_header(in_offset, tags);
+        get_tags_in_range(d_tags, 0, in_offset, in_offset + in_nitems);
+        const std::vector<uint8_t>& h = d_header.encode(in_offset, d_tags);
+        header = h.data();
+        header_len = h.size();
     }
 
-    /* Create message */
+    /* Create message in a pooled buffer, ZMQ hands it back once sent */
     size_t payload_len = in_nitems * d_vsize;
-    size_t msg_len = d_pass_tags ? payload_len + header.length() : payload_len;
-    zmq::message_t msg(msg_len);
+    size_t msg_len = payload_len + header_len;
+    uint8_t* buf = static_cast<uint8_t*>(d_pool->acquire(msg_len));
 
-    if (d_pass_tags) {
-        memcpy(msg.data(), header.c_str(), header.length());
-        memcpy((uint8_t*)msg.data() + header.length(), in_buf, payload_len);
-    } else {
-        memcpy(msg.data(), in_buf, payload_len);
-    }
+    if (header_len)
+        memcpy(buf, header, header_len);
+    memcpy(buf + header_len, in_buf, payload_len);
+    zmq::message_t msg(buf, msg_len, &buffer_pool::free_buffer, NULL);
 
     /* Send */
 #if USE_NEW_CPPZMQ_SEND_RECV
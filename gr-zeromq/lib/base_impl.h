@@ -23,6 +23,8 @@
 #ifndef INCLUDED_ZEROMQ_BASE_IMPL_H
 #define INCLUDED_ZEROMQ_BASE_IMPL_H
 
+#include "buffer_pool.h"
+#include "tag_headers.h"
 #include "zmq_common_impl.h"
 #include <gnuradio/sync_block.h>
 
@@ -54,8 +56,12 @@ public:
                    int timeout,
                    bool pass_tags,
                    int hwm);
+    virtual ~base_sink_impl();
 
 protected:
+    buffer_pool* d_pool;
+    tag_header_writer d_header;
+    std::vector<gr::tag_t> d_tags;
     int send_message(const void* in_buf, const int in_nitems, const uint64_t in_offset);
 };
 
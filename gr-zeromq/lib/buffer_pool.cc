@@ -0,0 +1,104 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "buffer_pool.h"
+#include <new>
+
+namespace gr {
+namespace zeromq {
+
+namespace {
+// Room for the chunk bookkeeping in front of the data, keeping the
+// data as aligned as operator new returns it
+const size_t CHUNK_HEADER = 64;
+
+// Rounds sizes up so slightly varying messages reuse the same chunks
+const size_t CHUNK_GRANULE = 4096;
+} // namespace
+
+buffer_pool::buffer_pool(size_t max_free) : d_refs(1), d_max_free(max_free) {}
+
+buffer_pool::~buffer_pool()
+{
+    for (size_t i = 0; i < d_free.size(); i++)
+        ::operator delete(d_free[i]);
+}
+
+void* buffer_pool::acquire(size_t len)
+{
+    chunk* c = NULL;
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        for (size_t i = d_free.size(); i > 0; i--) {
+            if (d_free[i - 1]->capacity >= len) {
+                c = d_free[i - 1];
+                d_free.erase(d_free.begin() + (i - 1));
+                break;
+            }
+        }
+    }
+
+    if (!c) {
+        size_t capacity = (len + CHUNK_GRANULE - 1) / CHUNK_GRANULE * CHUNK_GRANULE;
+        c = static_cast<chunk*>(::operator new(CHUNK_HEADER + capacity));
+        c->pool = this;
+        c->capacity = capacity;
+    }
+
+    d_refs.fetch_add(1, boost::memory_order_relaxed);
+    return reinterpret_cast<char*>(c) + CHUNK_HEADER;
+}
+
+void buffer_pool::release() { unref(); }
+
+void buffer_pool::free_buffer(void* data, void* hint)
+{
+    chunk* c = reinterpret_cast<chunk*>(static_cast<char*>(data) - CHUNK_HEADER);
+    c->pool->recycle(c);
+}
+
+void buffer_pool::recycle(chunk* c)
+{
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        if (d_free.size() < d_max_free) {
+            d_free.push_back(c);
+            c = NULL;
+        }
+    }
+    if (c)
+        ::operator delete(c);
+    unref();
+}
+
+void buffer_pool::unref()
+{
+    if (d_refs.fetch_sub(1, boost::memory_order_acq_rel) == 1)
+        delete this;
+}
+
+} /* namespace zeromq */
+} /* namespace gr */
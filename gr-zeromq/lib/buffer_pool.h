@@ -0,0 +1,80 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_ZEROMQ_BUFFER_POOL_H
+#define INCLUDED_ZEROMQ_BUFFER_POOL_H
+
+#include <gnuradio/thread/thread.h>
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace gr {
+namespace zeromq {
+
+/*!
+ * \brief Recycles the buffers the sinks hand to zmq_msg_init_data().
+ *
+ * ZMQ keeps a message until its I/O thread has written it out and
+ * then calls free_buffer() from that thread, so buffers come back
+ * here instead of going through malloc and fresh pages every time.
+ *
+ * Every buffer handed out holds a reference to the pool. The owner
+ * drops its reference with release(); the pool is deleted once the
+ * last queued message has been freed, which can be after the sink
+ * itself is gone.
+ */
+class buffer_pool : boost::noncopyable
+{
+public:
+    explicit buffer_pool(size_t max_free = 16);
+
+    //! Returns a buffer of at least \p len bytes, 16-byte aligned.
+    void* acquire(size_t len);
+
+    //! Drops the owner's reference.
+    void release();
+
+    //! zmq free function for buffers from acquire().
+    static void free_buffer(void* data, void* hint);
+
+private:
+    struct chunk {
+        buffer_pool* pool;
+        size_t capacity;
+    };
+
+    boost::atomic<size_t> d_refs;
+    size_t d_max_free;
+    gr::thread::mutex d_mutex;
+    std::vector<chunk*> d_free;
+
+    ~buffer_pool();
+    void recycle(chunk* c);
+    void unref();
+};
+
+} // namespace zeromq
+} // namespace gr
+
+#endif /* INCLUDED_ZEROMQ_BUFFER_POOL_H */
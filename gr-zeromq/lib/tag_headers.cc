@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2014 Free Software Foundation, Inc.
+ * Copyright 2014,2019 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio.
  *
@@ -20,6 +20,7 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include "tag_headers.h"
 #include <gnuradio/block.h>
 #include <gnuradio/io_signature.h>
 #include <zmq.hpp>
@@ -27,11 +28,139 @@
 #include <sstream>
 
 #define GR_HEADER_MAGIC 0x5FF0
-#define GR_HEADER_VERSION 0x01
+#define GR_HEADER_VERSION 0x02
 
 namespace gr {
 namespace zeromq {
 
+/*
+ * Header layout, all fields in host byte order:
+ *
+ *   uint16 magic, uint8 version, uint64 offset, uint64 ntags
+ *
+ * Version 1 follows with ntags times
+ *
+ *   uint64 offset, serialized key, serialized value, serialized srcid
+ *
+ * Version 2 follows with a symbol table and ntags times
+ *
+ *   uint64 offset, key, value, srcid
+ *
+ * where the symbol table is a uint16 count of (uint16 length, bytes)
+ * entries and key, value and srcid are each a value_type byte
+ * followed by the payload listed below.
+ */
+enum value_type {
+    TV_PMT = 0, // uint32 length, pmt::serialize bytes
+    TV_SYMBOL,  // uint16 index into the symbol table
+    TV_UINT64,  // uint64
+    TV_INT64,   // int64
+    TV_DOUBLE,  // double
+    TV_COMPLEX, // double real, double imaginary
+    TV_TIME,    // uint64 full seconds, double fractional seconds
+    TV_FALSE,
+    TV_TRUE,
+    TV_NIL
+};
+
+namespace {
+
+template <typename T>
+inline void put(std::vector<uint8_t>& buf, T v)
+{
+    size_t n = buf.size();
+    buf.resize(n + sizeof(T));
+    memcpy(&buf[n], &v, sizeof(T));
+}
+
+inline void put_bytes(std::vector<uint8_t>& buf, const void* data, size_t len)
+{
+    size_t n = buf.size();
+    buf.resize(n + len);
+    if (len)
+        memcpy(&buf[n], data, len);
+}
+
+//! Bounds-checked cursor over a received header
+class reader
+{
+public:
+    reader(const void* data, size_t len)
+        : d_begin(static_cast<const uint8_t*>(data)), d_pos(d_begin), d_end(d_begin + len)
+    {
+    }
+
+    template <typename T>
+    T get()
+    {
+        T v;
+        memcpy(&v, take(sizeof(T)), sizeof(T));
+        return v;
+    }
+
+    const uint8_t* take(size_t len)
+    {
+        if ((size_t)(d_end - d_pos) < len)
+            throw std::runtime_error("incoming zmq msg too small to hold gr tag header!");
+        const uint8_t* p = d_pos;
+        d_pos += len;
+        return p;
+    }
+
+    size_t position() const { return d_pos - d_begin; }
+
+private:
+    const uint8_t* d_begin;
+    const uint8_t* d_pos;
+    const uint8_t* d_end;
+};
+
+bool is_time_tuple(const pmt::pmt_t& v)
+{
+    return pmt::is_tuple(v) && pmt::length(v) == 2 &&
+           pmt::is_uint64(pmt::tuple_ref(v, 0)) && pmt::is_real(pmt::tuple_ref(v, 1));
+}
+
+pmt::pmt_t get_value(reader& rd, const std::vector<pmt::pmt_t>& symbols)
+{
+    switch (rd.get<uint8_t>()) {
+    case TV_PMT: {
+        uint32_t len = rd.get<uint32_t>();
+        const char* p = reinterpret_cast<const char*>(rd.take(len));
+        return pmt::deserialize_str(std::string(p, len));
+    }
+    case TV_SYMBOL: {
+        uint16_t index = rd.get<uint16_t>();
+        if (index >= symbols.size())
+            throw std::runtime_error("gr tag header symbol index out of range!");
+        return symbols[index];
+    }
+    case TV_UINT64:
+        return pmt::from_uint64(rd.get<uint64_t>());
+    case TV_INT64:
+        return pmt::from_long(rd.get<int64_t>());
+    case TV_DOUBLE:
+        return pmt::from_double(rd.get<double>());
+    case TV_COMPLEX: {
+        double re = rd.get<double>();
+        return pmt::from_complex(re, rd.get<double>());
+    }
+    case TV_TIME: {
+        uint64_t secs = rd.get<uint64_t>();
+        double frac = rd.get<double>();
+        return pmt::make_tuple(pmt::from_uint64(secs), pmt::from_double(frac));
+    }
+    case TV_FALSE:
+        return pmt::PMT_F;
+    case TV_TRUE:
+        return pmt::PMT_T;
+    case TV_NIL:
+        return pmt::PMT_NIL;
+    default:
+        throw std::runtime_error("unknown gr tag header value type!");
+    }
+}
+
 struct membuf : std::streambuf {
     membuf(void* b, size_t len)
     {
@@ -40,69 +169,162 @@ struct membuf : std::streambuf {
     }
 };
 
-std::string gen_tag_header(uint64_t offset, std::vector<gr::tag_t>& tags)
+size_t parse_tag_header_v1(zmq::message_t& msg,
+                           uint64_t& offset_out,
+                           std::vector<gr::tag_t>& tags_out)
 {
-    std::stringbuf sb("");
-    std::ostream ss(&sb);
+    membuf sb(msg.data(), msg.size());
+    std::istream iss(&sb);
+
+    uint16_t header_magic;
+    uint8_t header_version;
+    uint64_t rcv_ntags;
+
+    iss.read((char*)&header_magic, sizeof(uint16_t));
+    iss.read((char*)&header_version, sizeof(uint8_t));
+    iss.read((char*)&offset_out, sizeof(uint64_t));
+    iss.read((char*)&rcv_ntags, sizeof(uint64_t));
 
-    uint16_t header_magic = GR_HEADER_MAGIC;
-    uint8_t header_version = GR_HEADER_VERSION;
-    uint64_t ntags = (uint64_t)tags.size();
+    for (size_t i = 0; i < rcv_ntags; i++) {
+        gr::tag_t newtag;
+        sb.sgetn((char*)&(newtag.offset), sizeof(uint64_t));
+        newtag.key = pmt::deserialize(sb);
+        newtag.value = pmt::deserialize(sb);
+        newtag.srcid = pmt::deserialize(sb);
+        tags_out.push_back(newtag);
+    }
 
-    ss.write((const char*)&header_magic, sizeof(uint16_t));
-    ss.write((const char*)&header_version, sizeof(uint8_t));
-    ss.write((const char*)&offset, sizeof(uint64_t));
-    ss.write((const char*)&ntags, sizeof(uint64_t));
+    return msg.size() - sb.in_avail();
+}
+
+} // namespace
+
+const std::vector<uint8_t>& tag_header_writer::encode(uint64_t offset,
+                                                      const std::vector<gr::tag_t>& tags)
+{
+    d_body.clear();
+    d_symbols.clear();
 
     for (size_t i = 0; i < tags.size(); i++) {
-        ss.write((const char*)&tags[i].offset, sizeof(uint64_t));
-        pmt::serialize(tags[i].key, sb);
-        pmt::serialize(tags[i].value, sb);
-        pmt::serialize(tags[i].srcid, sb);
+        put<uint64_t>(d_body, tags[i].offset);
+        put_value(tags[i].key);
+        put_value(tags[i].value);
+        put_value(tags[i].srcid);
+    }
+
+    d_header.clear();
+    put<uint16_t>(d_header, GR_HEADER_MAGIC);
+    put<uint8_t>(d_header, GR_HEADER_VERSION);
+    put<uint64_t>(d_header, offset);
+    put<uint64_t>(d_header, tags.size());
+
+    put<uint16_t>(d_header, d_symbols.size());
+    for (size_t i = 0; i < d_symbols.size(); i++) {
+        const std::string& name = pmt::symbol_to_string(d_symbols[i]);
+        put<uint16_t>(d_header, name.size());
+        put_bytes(d_header, name.data(), name.size());
     }
 
-    return sb.str();
+    put_bytes(d_header, d_body.data(), d_body.size());
+    return d_header;
+}
+
+void tag_header_writer::put_value(const pmt::pmt_t& value)
+{
+    int index;
+    if (pmt::is_symbol(value) && (index = symbol_index(value)) >= 0) {
+        put<uint8_t>(d_body, TV_SYMBOL);
+        put<uint16_t>(d_body, index);
+    } else if (pmt::is_uint64(value)) {
+        put<uint8_t>(d_body, TV_UINT64);
+        put<uint64_t>(d_body, pmt::to_uint64(value));
+    } else if (pmt::is_integer(value)) {
+        put<uint8_t>(d_body, TV_INT64);
+        put<int64_t>(d_body, pmt::to_long(value));
+    } else if (pmt::is_real(value)) {
+        put<uint8_t>(d_body, TV_DOUBLE);
+        put<double>(d_body, pmt::to_double(value));
+    } else if (pmt::is_complex(value)) {
+        std::complex<double> z = pmt::to_complex(value);
+        put<uint8_t>(d_body, TV_COMPLEX);
+        put<double>(d_body, z.real());
+        put<double>(d_body, z.imag());
+    } else if (is_time_tuple(value)) {
+        put<uint8_t>(d_body, TV_TIME);
+        put<uint64_t>(d_body, pmt::to_uint64(pmt::tuple_ref(value, 0)));
+        put<double>(d_body, pmt::to_double(pmt::tuple_ref(value, 1)));
+    } else if (pmt::eq(value, pmt::PMT_F)) {
+        put<uint8_t>(d_body, TV_FALSE);
+    } else if (pmt::eq(value, pmt::PMT_T)) {
+        put<uint8_t>(d_body, TV_TRUE);
+    } else if (pmt::is_null(value)) {
+        put<uint8_t>(d_body, TV_NIL);
+    } else {
+        std::string s = pmt::serialize_str(value);
+        put<uint8_t>(d_body, TV_PMT);
+        put<uint32_t>(d_body, s.size());
+        put_bytes(d_body, s.data(), s.size());
+    }
+}
+
+int tag_header_writer::symbol_index(const pmt::pmt_t& sym)
+{
+    // Symbols are interned, so identity is enough; messages carry few
+    // distinct keys and srcids, a linear search beats hashing here.
+    for (size_t i = 0; i < d_symbols.size(); i++) {
+        if (d_symbols[i] == sym)
+            return i;
+    }
+
+    // Table full or name too long: the caller serializes it instead
+    if (d_symbols.size() == 0xFFFF || pmt::symbol_to_string(sym).size() > 0xFFFF)
+        return -1;
+
+    d_symbols.push_back(sym);
+    return d_symbols.size() - 1;
 }
 
 size_t parse_tag_header(zmq::message_t& msg,
                         uint64_t& offset_out,
                         std::vector<gr::tag_t>& tags_out)
 {
-    membuf sb(msg.data(), msg.size());
-    std::istream iss(&sb);
+    reader rd(msg.data(), msg.size());
 
-    size_t min_len =
-        sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint64_t);
-    if (msg.size() < min_len)
-        throw std::runtime_error("incoming zmq msg too small to hold gr tag header!");
-
-    uint16_t header_magic;
-    uint8_t header_version;
-    uint64_t rcv_ntags;
-
-    iss.read((char*)&header_magic, sizeof(uint16_t));
-    iss.read((char*)&header_version, sizeof(uint8_t));
+    uint16_t header_magic = rd.get<uint16_t>();
+    uint8_t header_version = rd.get<uint8_t>();
 
     if (header_magic != GR_HEADER_MAGIC)
         throw std::runtime_error("gr header magic does not match!");
 
-    if (header_version != 1)
+    if (header_version == 0 || header_version > GR_HEADER_VERSION)
         throw std::runtime_error("gr header version too high!");
 
-    iss.read((char*)&offset_out, sizeof(uint64_t));
-    iss.read((char*)&rcv_ntags, sizeof(uint64_t));
+    offset_out = rd.get<uint64_t>();
+    uint64_t rcv_ntags = rd.get<uint64_t>();
+
+    if (header_version == 1)
+        return parse_tag_header_v1(msg, offset_out, tags_out);
+
+    uint16_t nsymbols = rd.get<uint16_t>();
+    std::vector<pmt::pmt_t> symbols(nsymbols);
+    for (size_t i = 0; i < nsymbols; i++) {
+        uint16_t len = rd.get<uint16_t>();
+        const char* p = reinterpret_cast<const char*>(rd.take(len));
+        symbols[i] = pmt::string_to_symbol(std::string(p, len));
+    }
 
     for (size_t i = 0; i < rcv_ntags; i++) {
         gr::tag_t newtag;
-        sb.sgetn((char*)&(newtag.offset), sizeof(uint64_t));
-        newtag.key = pmt::deserialize(sb);
-        newtag.value = pmt::deserialize(sb);
-        newtag.srcid = pmt::deserialize(sb);
+        newtag.offset = rd.get<uint64_t>();
+        newtag.key = get_value(rd, symbols);
+        newtag.value = get_value(rd, symbols);
+        newtag.srcid = get_value(rd, symbols);
         tags_out.push_back(newtag);
     }
 
-    return msg.size() - sb.in_avail();
+    return rd.position();
 }
+
 } /* namespace zeromq */
 } /* namespace gr */
 
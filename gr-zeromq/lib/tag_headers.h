@@ -27,12 +27,39 @@
 #include <gnuradio/io_signature.h>
 #include <zmq.hpp>
 #include <cstring>
-#include <sstream>
+#include <vector>
 
 namespace gr {
 namespace zeromq {
 
-std::string gen_tag_header(uint64_t offset, std::vector<gr::tag_t>& tags);
+/*!
+ * \brief Encodes tag headers into a buffer that is reused between
+ * messages.
+ *
+ * Writes header version 2: symbols used as keys, srcids or values
+ * are stored once per message in a table and referenced by index,
+ * and uint64, integer, double, complex, boolean and (uint64, double)
+ * time tuple values are stored inline. Anything else falls back to
+ * pmt::serialize. Receivers from before version 2 reject these
+ * headers.
+ */
+class tag_header_writer
+{
+public:
+    //! Returns the header for \p tags; valid until the next call.
+    const std::vector<uint8_t>& encode(uint64_t offset,
+                                       const std::vector<gr::tag_t>& tags);
+
+private:
+    std::vector<uint8_t> d_header;
+    std::vector<uint8_t> d_body;
+    std::vector<pmt::pmt_t> d_symbols;
+
+    void put_value(const pmt::pmt_t& value);
+    int symbol_index(const pmt::pmt_t& sym);
+};
+
+//! Parses a version 1 or 2 header; returns the header length.
 size_t parse_tag_header(zmq::message_t& msg,
                         uint64_t& offset_out,
                         std::vector<gr::tag_t>& tags_out);
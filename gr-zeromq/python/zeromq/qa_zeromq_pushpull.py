@@ -22,7 +22,22 @@
 
 
 from gnuradio import gr, gr_unittest, blocks, zeromq
+import pmt
+import struct
 import time
+import zmq
+
+# A version 1 tag header as sent by earlier releases: offset 100, one
+# tag at 102 with key 'key', value uint64 42 and srcid 'src'. The
+# header fields are in host (here little-endian) order, the pmts are
+# serialized big-endian.
+v1_header = (b'\xf0\x5f' b'\x01'
+             b'\x64\x00\x00\x00\x00\x00\x00\x00'
+             b'\x01\x00\x00\x00\x00\x00\x00\x00'
+             b'\x66\x00\x00\x00\x00\x00\x00\x00'
+             b'\x02\x00\x03key'
+             b'\x0b\x00\x00\x00\x00\x00\x00\x00\x2a'
+             b'\x02\x00\x03src')
 
 class qa_zeromq_pushpull (gr_unittest.TestCase):
 
@@ -54,5 +69,77 @@ class qa_zeromq_pushpull (gr_unittest.TestCase):
         self.send_tb.wait()
         self.assertFloatTuplesAlmostEqual(sink.data(), src_data)
 
+    def test_002_tags (self):
+        # Every value kind the header stores inline, a symbol used
+        # more than once, and one that needs pmt::serialize
+        src_data = [float(x) for x in range(100)]
+        srcid = pmt.intern("src")
+        values = [
+            ("u64", pmt.from_uint64(1 << 40)),
+            ("i64", pmt.from_long(-5)),
+            ("dbl", pmt.from_double(1.5)),
+            ("cpx", pmt.from_complex(1 + 2j)),
+            ("bool", pmt.PMT_T),
+            ("time", pmt.make_tuple(pmt.from_uint64(12), pmt.from_double(0.25))),
+            ("sym", pmt.intern("sym")),
+            ("vec", pmt.init_f32vector(3, [1.0, 2.0, 3.0])),
+        ]
+        tags = [gr.tag_utils.python_to_tag((10 * i + 1, pmt.intern(k), v, srcid))
+                for i, (k, v) in enumerate(values)]
+
+        src = blocks.vector_source_f(src_data, False, 1, tags)
+        zeromq_push_sink = zeromq.push_sink(gr.sizeof_float, 1, "tcp://127.0.0.1:0",
+                                            100, True)
+        address = zeromq_push_sink.last_endpoint()
+        zeromq_pull_source = zeromq.pull_source(gr.sizeof_float, 1, address, 100, True)
+        sink = blocks.vector_sink_f()
+        self.send_tb.connect(src, zeromq_push_sink)
+        self.recv_tb.connect(zeromq_pull_source, sink)
+        self.recv_tb.start()
+        time.sleep(0.5)
+        self.send_tb.start()
+        time.sleep(0.5)
+        self.recv_tb.stop()
+        self.send_tb.stop()
+        self.recv_tb.wait()
+        self.send_tb.wait()
+
+        self.assertFloatTuplesAlmostEqual(sink.data(), src_data)
+        rx_tags = sorted(sink.tags(), key=lambda t: t.offset)
+        self.assertEqual(len(rx_tags), len(values))
+        for i, (t, (k, v)) in enumerate(zip(rx_tags, values)):
+            self.assertEqual(t.offset, 10 * i + 1)
+            self.assertEqual(pmt.symbol_to_string(t.key), k)
+            self.assertTrue(pmt.equal(t.value, v), k)
+            self.assertTrue(pmt.eq(t.srcid, srcid))
+
+    def test_003_v1_header (self):
+        # Headers from senders of earlier releases are still accepted
+        zmq_context = zmq.Context()
+        push_socket = zmq_context.socket(zmq.PUSH)
+        push_socket.bind("tcp://127.0.0.1:0")
+        address = push_socket.getsockopt(zmq.LAST_ENDPOINT).decode()
+
+        src_data = [1.0, 2.0, 3.0, 4.0]
+        zeromq_pull_source = zeromq.pull_source(gr.sizeof_float, 1, address, 100, True)
+        sink = blocks.vector_sink_f()
+        self.recv_tb.connect(zeromq_pull_source, sink)
+        self.recv_tb.start()
+        time.sleep(0.5)
+        push_socket.send(v1_header + struct.pack('<4f', *src_data))
+        time.sleep(0.5)
+        self.recv_tb.stop()
+        self.recv_tb.wait()
+        push_socket.close()
+        zmq_context.term()
+
+        self.assertFloatTuplesAlmostEqual(sink.data(), src_data)
+        tags = sink.tags()
+        self.assertEqual(len(tags), 1)
+        self.assertEqual(tags[0].offset, 2)
+        self.assertEqual(pmt.symbol_to_string(tags[0].key), "key")
+        self.assertEqual(pmt.to_uint64(tags[0].value), 42)
+        self.assertEqual(pmt.symbol_to_string(tags[0].srcid), "src")
+
 if __name__ == '__main__':
     gr_unittest.run(qa_zeromq_pushpull)